@@ -0,0 +1,107 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Benchmark.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "bench/Benchmark.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace xma;
+
+Benchmark::Benchmark(int _iterations, int _warmup, QString _filter) : iterations(std::max(1, _iterations)), warmup(std::max(0, _warmup)), filter(_filter)
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+bool Benchmark::isEnabled(QString name) const
+{
+	return filter.isEmpty() || name.contains(filter, Qt::CaseInsensitive);
+}
+
+bool Benchmark::run(QString name, int items, std::function<void()> body, std::function<void()> setup)
+{
+	if (!isEnabled(name))
+		return false;
+
+	for (int i = 0; i < warmup; i++)
+	{
+		if (setup) setup();
+		body();
+	}
+
+	std::vector<double> times;
+	QElapsedTimer timer;
+	for (int i = 0; i < iterations; i++)
+	{
+		if (setup) setup();
+		timer.start();
+		body();
+		times.push_back(timer.nsecsElapsed() * 1e-6);
+	}
+
+	double mean = 0;
+	for (unsigned int i = 0; i < times.size(); i++)
+		mean += times[i];
+	mean /= times.size();
+
+	std::sort(times.begin(), times.end());
+	double median = (times.size() % 2) ? times[times.size() / 2] : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+
+	QJsonObject current;
+	current["name"] = name;
+	current["iterations"] = iterations;
+	current["items"] = items;
+	current["min_ms"] = times.front();
+	current["median_ms"] = median;
+	current["mean_ms"] = mean;
+	current["max_ms"] = times.back();
+	current["per_item_us"] = (items > 0) ? median * 1000.0 / items : 0.0;
+
+	results.append(current);
+
+	std::cerr << name.toStdString() << " : " << median << " ms (median of " << iterations << ")" << std::endl;
+	return true;
+}
+
+void Benchmark::addValue(QString key, double value)
+{
+	if (results.isEmpty())
+		return;
+
+	QJsonObject last = results.last().toObject();
+	last[key] = value;
+	results.replace(results.size() - 1, last);
+}
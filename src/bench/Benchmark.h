@@ -0,0 +1,64 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Benchmark.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QJsonArray>
+
+#include <functional>
+#include <vector>
+
+namespace xma
+{
+	/// Small timing harness for the benchmarks. Each benchmark body is run a number of warmup and timed
+	/// iterations and the statistics are collected as JSON.
+	class Benchmark
+	{
+	public:
+		Benchmark(int iterations, int warmup, QString filter);
+		virtual ~Benchmark();
+
+		//Returns true if the benchmark with the given name passes the filter
+		bool isEnabled(QString name) const;
+
+		//Runs setup (untimed) followed by body for each iteration. items is the number of work items processed by one body call.
+		bool run(QString name, int items, std::function<void()> body, std::function<void()> setup = std::function<void()>());
+
+		//Adds an additional value, e.g. an accuracy measure, to the last benchmark which has been run
+		void addValue(QString key, double value);
+
+		const QJsonArray& getResults() const { return results; }
+
+	private:
+		int iterations;
+		int warmup;
+		QString filter;
+		QJsonArray results;
+	};
+}
+#endif // BENCHMARK_H
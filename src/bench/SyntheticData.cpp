@@ -0,0 +1,427 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file SyntheticData.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "bench/SyntheticData.h"
+
+#include "core/HelperFunctions.h"
+#include "core/Project.h"
+#include "core/Camera.h"
+#include "core/CalibrationImage.h"
+#include "core/Trial.h"
+#include "core/Marker.h"
+#include "core/RigidBody.h"
+#include "core/CineVideo.h"
+
+#include <QDir>
+
+#include <cstring>
+#include <fstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace xma;
+
+namespace
+{
+	//offsets in the cine setup block, see CineVideo::loadCineInfo
+	const int CINE_SETUP_FRAMERATE = 768;
+	const int CINE_SETUP_SOFTWAREVERSION = 800;
+	const int CINE_SETUP_RECBPP = 10112;
+	const int CINE_SETUP_SIZE = 10120;
+
+	template <typename T>
+	void writeValue(std::ofstream& out, T value)
+	{
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	void setValue(std::vector<char>& buffer, int offset, T value)
+	{
+		memcpy(&buffer[offset], &value, sizeof(T));
+	}
+
+	//dark disc with an antialiased border on top of the background
+	void renderDisc(cv::Mat& image, cv::Point2d center, double radius, double contrast)
+	{
+		int x0 = std::max(0, (int) floor(center.x - radius - 1));
+		int x1 = std::min(image.cols - 1, (int) ceil(center.x + radius + 1));
+		int y0 = std::max(0, (int) floor(center.y - radius - 1));
+		int y1 = std::min(image.rows - 1, (int) ceil(center.y + radius + 1));
+
+		for (int y = y0; y <= y1; y++)
+		{
+			unsigned char* row = image.ptr<unsigned char>(y);
+			for (int x = x0; x <= x1; x++)
+			{
+				double d = sqrt((x - center.x) * (x - center.x) + (y - center.y) * (y - center.y));
+				double a = std::min(1.0, std::max(0.0, radius + 0.5 - d));
+				row[x] = cv::saturate_cast<unsigned char>(row[x] * (1.0 - contrast * a));
+			}
+		}
+	}
+}
+
+SyntheticData::SyntheticData(QString _folder, int _nbCameras, int _nbFrames, int _nbMarkers, unsigned int seed) : rng(seed)
+{
+	folder = _folder;
+	nbCameras = _nbCameras;
+	nbFrames = _nbFrames;
+	nbMarkers = _nbMarkers;
+	width = 1024;
+	height = 1024;
+	markerRadius = 2.5;
+
+	computeGroundTruth();
+}
+
+SyntheticData::~SyntheticData()
+{
+	for (unsigned int i = 0; i < cameraMatrices.size(); i++)
+	{
+		cameraMatrices[i].release();
+		rotationVectors[i].release();
+		translationVectors[i].release();
+	}
+}
+
+void SyntheticData::computeGroundTruth()
+{
+	//cameras on a circle at 1m distance looking at the origin
+	for (int c = 0; c < nbCameras; c++)
+	{
+		double azimuth = (nbCameras > 1) ? (-45.0 + 90.0 * c / (nbCameras - 1)) * M_PI / 180.0 : 0.0;
+		double elevation = ((c % 2) ? -10.0 : 10.0) * M_PI / 180.0;
+		cv::Vec3d pos(1000.0 * sin(azimuth) * cos(elevation), 1000.0 * sin(elevation), 1000.0 * cos(azimuth) * cos(elevation));
+
+		cv::Vec3d z = cv::normalize(-pos);
+		cv::Vec3d x = cv::normalize(cv::Vec3d(0, -1, 0).cross(z));
+		cv::Vec3d y = z.cross(x);
+
+		cv::Mat R(3, 3, CV_64F);
+		for (int i = 0; i < 3; i++)
+		{
+			R.at<double>(0, i) = x[i];
+			R.at<double>(1, i) = y[i];
+			R.at<double>(2, i) = z[i];
+		}
+		cv::Mat rvec;
+		cv::Rodrigues(R, rvec);
+		cv::Mat tvec = -R * cv::Mat(pos);
+
+		double f = 2000.0 + 50.0 * c;
+		cv::Mat K = (cv::Mat_<double>(3, 3) << f, 0, 0.5 * width + 3.0 * c, 0, f, 0.5 * height - 2.0 * c, 0, 0, 1);
+
+		cameraMatrices.push_back(K);
+		rotationVectors.push_back(rvec);
+		translationVectors.push_back(tvec);
+	}
+
+	//markers on a sphere with a minimal distance between them. The distance is dropped if the sphere is too crowded.
+	int attempts = 0;
+	while ((int) markerReferences.size() < nbMarkers)
+	{
+		attempts++;
+		cv::Point3d pt(rng.uniform(-1.0, 1.0), rng.uniform(-1.0, 1.0), rng.uniform(-1.0, 1.0));
+		double norm = sqrt(pt.dot(pt));
+		if (norm < 0.1 || norm > 1.0)
+			continue;
+		pt = pt * (30.0 / norm);
+
+		bool valid = true;
+		for (unsigned int i = 0; i < markerReferences.size(); i++)
+		{
+			cv::Point3d diff = markerReferences[i] - pt;
+			if (diff.dot(diff) < 12.0 * 12.0 && attempts < 10000)
+				valid = false;
+		}
+		if (valid) markerReferences.push_back(pt);
+	}
+
+	//smooth trajectory of the rigid body
+	points3D.resize(nbFrames);
+	for (int f = 0; f < nbFrames; f++)
+	{
+		double phase = 2.0 * M_PI * f / std::max(nbFrames, 1);
+		cv::Mat rvec = (cv::Mat_<double>(3, 1) << 0.4 * sin(phase), 0.3 * cos(phase) - 0.3, 0.2 * sin(2.0 * phase));
+		cv::Mat R;
+		cv::Rodrigues(rvec, R);
+		cv::Vec3d t(40.0 * sin(phase), 25.0 * sin(2.0 * phase), 15.0 * cos(phase));
+
+		for (int m = 0; m < nbMarkers; m++)
+		{
+			cv::Mat p = R * cv::Mat(markerReferences[m]) + cv::Mat(t);
+			points3D[f].push_back(cv::Point3d(p.at<double>(0), p.at<double>(1), p.at<double>(2)));
+		}
+	}
+
+	points2D.resize(nbCameras);
+	for (int c = 0; c < nbCameras; c++)
+	{
+		points2D[c].resize(nbFrames);
+		for (int f = 0; f < nbFrames; f++)
+		{
+			cv::projectPoints(points3D[f], rotationVectors[c], translationVectors[c], cameraMatrices[c], cv::noArray(), points2D[c][f]);
+		}
+	}
+}
+
+const cv::Point2d& SyntheticData::getPoint2D(int camera, int frame, int marker) const
+{
+	return points2D[camera][frame][marker];
+}
+
+const cv::Point3d& SyntheticData::getPoint3D(int frame, int marker) const
+{
+	return points3D[frame][marker];
+}
+
+QString SyntheticData::getFrameFilename(int camera, int frame) const
+{
+	return folder + OS_SEP + "cam" + QString::number(camera + 1) + OS_SEP + QString("frame%1.png").arg(frame, 5, 10, QChar('0'));
+}
+
+cv::Mat SyntheticData::renderFrame(int camera, int frame)
+{
+	//background with a soft gradient and noise, seeded by camera and frame
+	cv::Mat image(height, width, CV_8U);
+	for (int y = 0; y < height; y++)
+	{
+		unsigned char* row = image.ptr<unsigned char>(y);
+		for (int x = 0; x < width; x++)
+		{
+			row[x] = (unsigned char)(150 + 40.0 * x / width + 20.0 * y / height);
+		}
+	}
+	cv::Mat noise(height, width, CV_8S);
+	cv::RNG noiseRng(1000 * camera + frame + 1);
+	noiseRng.fill(noise, cv::RNG::NORMAL, 0, 3);
+	cv::add(image, noise, image, cv::noArray(), CV_8U);
+
+	cv::Mat R;
+	cv::Rodrigues(rotationVectors[camera], R);
+	for (int m = 0; m < nbMarkers; m++)
+	{
+		cv::Mat p = R * cv::Mat(points3D[frame][m]) + translationVectors[camera];
+		double radius = cameraMatrices[camera].at<double>(0, 0) * markerRadius / p.at<double>(2);
+		renderDisc(image, points2D[camera][frame][m], radius, 0.6);
+	}
+	return image;
+}
+
+void SyntheticData::createCameras()
+{
+	QDir().mkpath(folder);
+
+	for (int c = 0; c < nbCameras; c++)
+	{
+		QString calibrationFile = folder + OS_SEP + "calibration_cam" + QString::number(c + 1) + ".png";
+		cv::imwrite(calibrationFile.toStdString(), renderFrame(c, 0));
+
+		Camera* cam = new Camera("Camera " + QString::number(c + 1), c);
+		CalibrationImage* image = cam->addImage(calibrationFile);
+		image->setMatrices(rotationVectors[c], translationVectors[c]);
+		cam->setCameraMatrix(cameraMatrices[c]);
+		cam->setResolutions();
+		cam->setCalibrated(true);
+		Project::getInstance()->addCamera(cam);
+	}
+	Project::getInstance()->setCalibation(INTERNAL);
+	Project::getInstance()->checkCalibration();
+}
+
+Trial* SyntheticData::createTrial()
+{
+	std::vector<QStringList> filenames(nbCameras);
+	for (int c = 0; c < nbCameras; c++)
+	{
+		QDir().mkpath(folder + OS_SEP + "cam" + QString::number(c + 1));
+		for (int f = 0; f < nbFrames; f++)
+		{
+			cv::imwrite(getFrameFilename(c, f).toStdString(), renderFrame(c, f));
+			filenames[c] << getFrameFilename(c, f);
+		}
+	}
+
+	Trial* trial = new Trial("Synthetic", filenames);
+	trial->setRecordingSpeed(100);
+	trial->setCutoffFrequency(10);
+	Project::getInstance()->addTrial(trial);
+
+	for (int m = 0; m < nbMarkers; m++)
+	{
+		trial->addMarker();
+		Marker* marker = trial->getMarkers()[m];
+		marker->setDescription("marker" + QString::number(m + 1));
+		marker->setReference3DPoint(markerReferences[m].x, markerReferences[m].y, markerReferences[m].z);
+		for (int c = 0; c < nbCameras; c++)
+		{
+			for (int f = 0; f < nbFrames; f++)
+			{
+				marker->setPoint(c, f, points2D[c][f][m].x, points2D[c][f][m].y, SET, false);
+			}
+			marker->setSize(c, 0, 2.0 * cameraMatrices[c].at<double>(0, 0) * markerRadius / 1000.0);
+		}
+	}
+
+	trial->addRigidBody();
+	RigidBody* rb = trial->getRigidBodies()[0];
+	rb->setDescription("RigidBody");
+	for (int m = 0; m < nbMarkers; m++)
+	{
+		rb->addPointIdx(m, false);
+	}
+	rb->setReferenceMarkerReferences();
+
+	return trial;
+}
+
+QString SyntheticData::writeCine(int camera, int bitDepth)
+{
+	QString filename = folder + OS_SEP + "cam" + QString::number(camera + 1) + "_" + QString::number(bitDepth) + "bit.cine";
+	std::ofstream out(filename.toStdString(), std::ofstream::binary);
+
+	const int sizeImage = width * height * 10 / 8;
+	const DWORD offImageHeader = 44;
+	const DWORD offSetup = offImageHeader + 40;
+	const DWORD offImageOffsets = offSetup + CINE_SETUP_SIZE;
+	const unsigned long long firstImage = offImageOffsets + 8ull * nbFrames;
+
+	//CINEFILEHEADER
+	out.write("CI", 2);
+	writeValue<WORD>(out, 44);
+	writeValue<WORD>(out, 0);
+	writeValue<WORD>(out, 1);
+	writeValue<LONG>(out, 0);
+	writeValue<DWORD>(out, nbFrames);
+	writeValue<LONG>(out, 0);
+	writeValue<DWORD>(out, nbFrames);
+	writeValue<DWORD>(out, offImageHeader);
+	writeValue<DWORD>(out, offSetup);
+	writeValue<DWORD>(out, offImageOffsets);
+	writeValue<DWORD>(out, 0);
+	writeValue<DWORD>(out, 0);
+
+	//BITMAPINFOHEADER, packed 10 bit
+	writeValue<DWORD>(out, 40);
+	writeValue<LONG>(out, width);
+	writeValue<LONG>(out, height);
+	writeValue<WORD>(out, 1);
+	writeValue<WORD>(out, 16);
+	writeValue<DWORD>(out, 256);
+	writeValue<DWORD>(out, sizeImage);
+	writeValue<LONG>(out, 0);
+	writeValue<LONG>(out, 0);
+	writeValue<DWORD>(out, 0);
+	writeValue<DWORD>(out, 0);
+
+	//SETUP
+	std::vector<char> setup(CINE_SETUP_SIZE, 0);
+	setValue<UINT>(setup, CINE_SETUP_FRAMERATE, 100);
+	setValue<UINT>(setup, CINE_SETUP_SOFTWAREVERSION, 800);
+	setValue<UINT>(setup, CINE_SETUP_RECBPP, bitDepth);
+	out.write(&setup[0], setup.size());
+
+	//image offsets
+	for (int f = 0; f < nbFrames; f++)
+	{
+		writeValue<unsigned long long>(out, firstImage + (unsigned long long) f * (8 + sizeImage));
+	}
+
+	//images are stored bottom up with 4 pixels in 5 bytes
+	std::vector<unsigned char> packed(sizeImage);
+	for (int f = 0; f < nbFrames; f++)
+	{
+		cv::Mat image = renderFrame(camera, f);
+		cv::flip(image, image, 0);
+
+		const unsigned char* px = image.ptr<unsigned char>();
+		unsigned char* dst = &packed[0];
+		for (int i = 0; i < width * height; i += 4, px += 4, dst += 5)
+		{
+			unsigned short v[4];
+			for (int k = 0; k < 4; k++)
+				v[k] = (px[k] << 2) | (px[k] >> 6);
+
+			dst[0] = v[0] >> 2;
+			dst[1] = ((v[0] & 0x03) << 6) | (v[1] >> 4);
+			dst[2] = ((v[1] & 0x0F) << 4) | (v[2] >> 6);
+			dst[3] = ((v[2] & 0x3F) << 2) | (v[3] >> 8);
+			dst[4] = v[3] & 0xFF;
+		}
+
+		writeValue<DWORD>(out, 8);
+		writeValue<DWORD>(out, sizeImage);
+		out.write(reinterpret_cast<const char*>(&packed[0]), packed.size());
+	}
+	out.close();
+
+	return filename;
+}
+
+QString SyntheticData::createBeadGrid(std::vector<cv::Point2d>& distorted, std::vector<cv::Point2d>& references)
+{
+	distorted.clear();
+	references.clear();
+
+	//hexagonal grid centered in the image with a radial distortion
+	const double dY = 24.0;
+	const double dX = sin(M_PI / 3.0) * dY;
+	const double k = -1.5e-7;
+	const cv::Point2d center(0.5 * width, 0.5 * height);
+	const int nbCols = (int)(0.5 * width / dX) + 1;
+	const int nbRows = (int)(0.5 * height / dY) + 1;
+
+	cv::Mat image(height, width, CV_8U, cv::Scalar(200));
+	for (int i = -nbCols; i <= nbCols; i++)
+	{
+		for (int j = -nbRows; j <= nbRows; j++)
+		{
+			cv::Point2d ref(center.x + i * dX, center.y + j * dY + ((i % 2) ? 0.5 * dY : 0.0));
+			cv::Point2d diff = ref - center;
+			double r2 = diff.dot(diff);
+			cv::Point2d dist = center + diff * (1.0 + k * r2);
+
+			if (dist.x < 10 || dist.y < 10 || dist.x > width - 10 || dist.y > height - 10)
+				continue;
+
+			references.push_back(ref);
+			distorted.push_back(dist);
+			renderDisc(image, dist, 6.0, 0.7);
+		}
+	}
+
+	QDir().mkpath(folder);
+	QString filename = folder + OS_SEP + "beadgrid.png";
+	cv::imwrite(filename.toStdString(), image);
+	return filename;
+}
@@ -0,0 +1,93 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file SyntheticData.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+#include <QStringList>
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace xma
+{
+	class Trial;
+
+	/// Deterministic synthetic inputs for the benchmarks. Cameras are placed on a circle around a rigid body
+	/// of spherical markers which moves on a smooth trajectory. All images and videos are rendered from the
+	/// known ground truth and written to the given folder.
+	class SyntheticData
+	{
+	public:
+		SyntheticData(QString folder, int nbCameras, int nbFrames, int nbMarkers, unsigned int seed = 42);
+		virtual ~SyntheticData();
+
+		//Creates calibrated cameras and adds them to the project
+		void createCameras();
+		//Renders the marker images and creates a trial with markers and a rigid body. The 2D points of all markers are set.
+		Trial* createTrial();
+		//Writes the frames of a camera as a packed 10 bit cine file. With bitDepth 12 the file uses the 12 bit lookup.
+		QString writeCine(int camera, int bitDepth);
+		//Hexagonal bead grid with a radial distortion. Writes the bead image and returns the distorted and reference grid positions.
+		QString createBeadGrid(std::vector<cv::Point2d>& distorted, std::vector<cv::Point2d>& references);
+
+		int getWidth() const { return width; }
+		int getHeight() const { return height; }
+		int getNbFrames() const { return nbFrames; }
+		int getNbMarkers() const { return nbMarkers; }
+		int getNbCameras() const { return nbCameras; }
+		double getMarkerRadius() const { return markerRadius; }
+
+		const cv::Point2d& getPoint2D(int camera, int frame, int marker) const;
+		const cv::Point3d& getPoint3D(int frame, int marker) const;
+		QString getFrameFilename(int camera, int frame) const;
+
+	private:
+		void computeGroundTruth();
+		cv::Mat renderFrame(int camera, int frame);
+
+		QString folder;
+		int nbCameras;
+		int nbFrames;
+		int nbMarkers;
+		int width;
+		int height;
+		double markerRadius;
+		cv::RNG rng;
+
+		std::vector<cv::Mat> cameraMatrices;
+		std::vector<cv::Mat> rotationVectors;
+		std::vector<cv::Mat> translationVectors;
+
+		std::vector<cv::Point3d> markerReferences;
+		//[frame][marker]
+		std::vector<std::vector<cv::Point3d> > points3D;
+		//[camera][frame][marker]
+		std::vector<std::vector<std::vector<cv::Point2d> > > points2D;
+	};
+}
+#endif // SYNTHETICDATA_H
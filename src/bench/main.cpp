@@ -0,0 +1,435 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file main.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "bench/Benchmark.h"
+#include "bench/SyntheticData.h"
+
+#include "core/Project.h"
+#include "core/Camera.h"
+#include "core/Trial.h"
+#include "core/Marker.h"
+#include "core/RigidBody.h"
+#include "core/Image.h"
+#include "core/CineVideo.h"
+#include "core/UndistortionObject.h"
+#include "core/HelperFunctions.h"
+
+#include "processing/MarkerDetection.h"
+#include "processing/MarkerTracking.h"
+#include "processing/LocalUndistortion.h"
+#include "processing/FilterBank.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+
+#include <iostream>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/ocl.hpp>
+
+using namespace xma;
+
+static void benchmarkDetection(Benchmark& bench, SyntheticData& data)
+{
+	std::vector<std::unique_ptr<Image> > images;
+	for (int c = 0; c < data.getNbCameras(); c++)
+		images.emplace_back(new Image(data.getFrameFilename(c, 0), false));
+
+	//start a few pixels away from the true position
+	double error = 0;
+	int count = 0;
+	if (!bench.run("detection/detectionPoint", data.getNbCameras() * data.getNbMarkers(), [&]()
+	{
+		error = 0;
+		count = 0;
+		for (int c = 0; c < data.getNbCameras(); c++)
+		{
+			for (int m = 0; m < data.getNbMarkers(); m++)
+			{
+				cv::Point2d truth = data.getPoint2D(c, 0, m);
+				cv::Point2d pt = MarkerDetection::detectionPoint(images[c].get(), 0, truth + cv::Point2d(2.5, -1.5), 30, 5);
+				error += cv::norm(pt - truth);
+				count++;
+			}
+		}
+	}))
+		return;
+
+	if (count > 0) bench.addValue("error_px", error / count);
+}
+
+static void benchmarkTracking(Benchmark& bench, SyntheticData& data, Trial* trial)
+{
+	const int nbFrames = std::min(data.getNbFrames() - 1, 20);
+	int frame = 0;
+
+	//one iteration tracks all markers in all cameras over nbFrames frames
+	if (!bench.run("tracking/templateMatching", nbFrames * data.getNbCameras() * data.getNbMarkers(), [&]()
+	{
+		for (frame = 0; frame < nbFrames; frame++)
+		{
+			trial->setActiveFrame(frame);
+			std::vector<MarkerTracking*> trackers;
+			for (int c = 0; c < data.getNbCameras(); c++)
+			{
+				for (int m = 0; m < data.getNbMarkers(); m++)
+				{
+					trackers.push_back(new MarkerTracking(c, 0, frame, frame + 1, m, true));
+				}
+			}
+			trial->setActiveFrame(frame + 1);
+
+			QEventLoop loop;
+			for (auto tracker : trackers)
+				QObject::connect(tracker, SIGNAL(trackMarker_finished()), &loop, SLOT(quit()));
+			for (auto tracker : trackers)
+				tracker->trackMarker();
+			loop.exec();
+		}
+	}, [&]()
+	{
+		for (int m = 0; m < data.getNbMarkers(); m++)
+		{
+			for (int c = 0; c < data.getNbCameras(); c++)
+			{
+				for (int f = 1; f <= nbFrames; f++)
+					trial->getMarkers()[m]->setPoint(c, f, -2, -2, UNDEFINED, false);
+			}
+		}
+	}))
+		return;
+
+	double error = 0;
+	int count = 0;
+	for (int m = 0; m < data.getNbMarkers(); m++)
+	{
+		for (int c = 0; c < data.getNbCameras(); c++)
+		{
+			for (int f = 1; f <= nbFrames; f++)
+			{
+				if (trial->getMarkers()[m]->getStatus2D()[c][f] > UNDEFINED)
+				{
+					error += cv::norm(trial->getMarkers()[m]->getPoints2D()[c][f] - data.getPoint2D(c, f, m));
+					count++;
+				}
+			}
+		}
+	}
+	if (count > 0) bench.addValue("error_px", error / count);
+	bench.addValue("tracked", count);
+
+	//restore the ground truth
+	for (int m = 0; m < data.getNbMarkers(); m++)
+	{
+		for (int c = 0; c < data.getNbCameras(); c++)
+		{
+			for (int f = 0; f < data.getNbFrames(); f++)
+			{
+				cv::Point2d pt = data.getPoint2D(c, f, m);
+				trial->getMarkers()[m]->setPoint(c, f, pt.x, pt.y, SET, false);
+			}
+		}
+	}
+	trial->setActiveFrame(0);
+}
+
+static void benchmarkTriangulation(Benchmark& bench, SyntheticData& data, Trial* trial)
+{
+	const int items = data.getNbFrames() * data.getNbMarkers();
+
+	std::vector<std::pair<QString, void (Marker::*)(int)> > methods;
+	methods.push_back(std::make_pair(QString("triangulation/Zisserman"), &Marker::reconstruct3DPointZisserman));
+	methods.push_back(std::make_pair(QString("triangulation/ZissermanIncremental"), &Marker::reconstruct3DPointZissermanIncremental));
+	methods.push_back(std::make_pair(QString("triangulation/ZissermanMatlab"), &Marker::reconstruct3DPointZissermanMatlab));
+	methods.push_back(std::make_pair(QString("triangulation/ZissermanIncrementalMatlab"), &Marker::reconstruct3DPointZissermanIncrementalMatlab));
+	methods.push_back(std::make_pair(QString("triangulation/RayIntersection"), &Marker::reconstruct3DPointRayIntersection));
+
+	for (auto& method : methods)
+	{
+		if (!bench.run(method.first, items, [&]()
+			{
+				for (auto marker : trial->getMarkers())
+				{
+					for (int f = 0; f < data.getNbFrames(); f++)
+						(marker->*method.second)(f);
+				}
+			}))
+			continue;
+
+		double error = 0;
+		for (int m = 0; m < data.getNbMarkers(); m++)
+		{
+			for (int f = 0; f < data.getNbFrames(); f++)
+				error += cv::norm(trial->getMarkers()[m]->getPoints3D()[f] - data.getPoint3D(f, m));
+		}
+		bench.addValue("error_mm", error / items);
+	}
+
+	//leave the trial with a consistent reconstruction for the following benchmarks
+	for (auto marker : trial->getMarkers())
+		marker->update(true);
+}
+
+static void benchmarkRigidBody(Benchmark& bench, SyntheticData& data, Trial* trial)
+{
+	RigidBody* rb = trial->getRigidBodies()[0];
+	if (bench.run("rigidbody/computePose", data.getNbFrames(), [&]()
+	{
+		for (int f = 0; f < data.getNbFrames(); f++)
+			rb->computePose(f);
+	}))
+		bench.addValue("error3D_mm", rb->getError3D(false));
+}
+
+static void benchmarkFilter(Benchmark& bench, SyntheticData& data, Trial* trial)
+{
+	const double cutoff = trial->getCutoffFrequency();
+	Marker* marker = trial->getMarkers()[0];
+	std::vector<cv::Point3d> points = marker->getPoints3D().row().toVector();
+	std::vector<markerStatus> status = marker->getStatus3D().row().toVector();
+	std::vector<cv::Point3d> points_out;
+	std::vector<markerStatus> status_out;
+
+	bench.run("filter/filterMarker", data.getNbFrames(), [&]()
+	{
+		marker->filterMarker(cutoff, points, status, points_out, status_out);
+	});
+
+	RigidBody* rb = trial->getRigidBodies()[0];
+	bench.run("filter/filterTransformations", data.getNbFrames(), [&]()
+	{
+		rb->filterTransformations();
+	});
+
+	//long multi channel signal for the plain filter
+	const int length = 100000;
+	const int channels = 6;
+	std::vector<double> signal(length * channels);
+	std::vector<double> filtered(length * channels);
+	cv::RNG rng(7);
+	for (int i = 0; i < length; i++)
+	{
+		for (int k = 0; k < channels; k++)
+			signal[i * channels + k] = sin(0.01 * i * (k + 1)) + rng.gaussian(0.1);
+	}
+	bench.run("filter/butterworth", length * channels, [&]()
+	{
+		FilterBank::getInstance()->filtfilt(2, 10.0, 100.0, &signal[0], &filtered[0], length, channels);
+	});
+}
+
+static void benchmarkCine(Benchmark& bench, SyntheticData& data)
+{
+	const int bitDepths[] = { 10, 12 };
+	for (int bits : bitDepths)
+	{
+		QString name = "cine/decode" + QString::number(bits) + "bit";
+		if (!bench.isEnabled(name))
+			continue;
+
+		QString filename = data.writeCine(0, bits);
+		CineVideo video(QStringList() << filename);
+		bench.run(name, data.getNbFrames(), [&]()
+		{
+			for (int f = 0; f < data.getNbFrames(); f++)
+				video.setActiveFrame(f);
+		});
+
+		//compare the last frame against the rendered image
+		cv::Mat decoded, reference;
+		video.getImage()->getImage(decoded);
+		Image rendered(data.getFrameFilename(0, data.getNbFrames() - 1), false);
+		rendered.getImage(reference);
+		if (decoded.size() == reference.size() && decoded.type() == reference.type())
+			bench.addValue("max_abs_diff", cv::norm(decoded, reference, cv::NORM_INF));
+	}
+}
+
+static void benchmarkUndistortion(Benchmark& bench, SyntheticData& data)
+{
+	std::vector<cv::Point2d> distorted, references;
+	QString beadImage = data.createBeadGrid(distorted, references);
+
+	//the raw local weighted mean fit on the known correspondences
+	cv::Mat detectedPts(distorted.size(), 1, CV_64FC2);
+	cv::Mat controlPts(references.size(), 1, CV_64FC2);
+	for (unsigned int i = 0; i < distorted.size(); i++)
+	{
+		detectedPts.at<cv::Vec2d>(i) = cv::Vec2d(distorted[i].x, distorted[i].y);
+		controlPts.at<cv::Vec2d>(i) = cv::Vec2d(references[i].x, references[i].y);
+	}
+	cv::Mat A, B, radii;
+	bench.run("undistortion/computeLWM", distorted.size(), [&]()
+	{
+		LocalUndistortion::computeLWM(detectedPts, controlPts, A, B, radii);
+	});
+
+	//the complete undistortion on the bead grid. This replaces the undistortion of the first camera.
+	Camera* cam = Project::getInstance()->getCameras()[0];
+	cam->loadUndistortionImage(beadImage);
+	UndistortionObject* undistortion = cam->getUndistortionObject();
+	undistortion->setDetectedPoints(distorted);
+
+	bench.run("undistortion/computeUndistortion", distorted.size(), [&]()
+	{
+		LocalUndistortion::computeUndistortionBlocking(0);
+	});
+
+	if (!undistortion->isComputed())
+	{
+		std::cerr << "Warning: Undistortion could not be computed" << std::endl;
+		return;
+	}
+
+	const int nbPoints = 10000;
+	std::vector<cv::Point2d> points;
+	cv::RNG rng(11);
+	for (int i = 0; i < nbPoints; i++)
+		points.push_back(cv::Point2d(rng.uniform(50.0, data.getWidth() - 50.0), rng.uniform(50.0, data.getHeight() - 50.0)));
+
+	double error = 0;
+	if (bench.run("undistortion/transformPoint", 2 * nbPoints, [&]()
+	{
+		error = 0;
+		for (auto& pt : points)
+		{
+			cv::Point2d undistorted = undistortion->transformPoint(pt, true);
+			cv::Point2d redistorted = undistortion->transformPoint(undistorted, false);
+			error += cv::norm(redistorted - pt);
+		}
+	}))
+		bench.addValue("roundtrip_error_px", error / nbPoints);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("xmalab_bench");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("XMALab performance benchmarks on deterministic synthetic data");
+	parser.addHelpOption();
+
+	QCommandLineOption framesOption("frames", "Number of frames", "n", "100");
+	QCommandLineOption markersOption("markers", "Number of markers", "n", "8");
+	QCommandLineOption camerasOption("cameras", "Number of cameras", "n", "2");
+	QCommandLineOption iterationsOption("iterations", "Timed iterations per benchmark", "n", "5");
+	QCommandLineOption warmupOption("warmup", "Warmup iterations per benchmark", "n", "1");
+	QCommandLineOption filterOption("filter", "Only run benchmarks whose name contains the given text", "text");
+	QCommandLineOption outputOption("output", "Write the JSON results to the file instead of stdout", "file");
+	QCommandLineOption dataOption("data", "Folder for the synthetic data. A temporary folder is used by default", "folder");
+	parser.addOption(framesOption);
+	parser.addOption(markersOption);
+	parser.addOption(camerasOption);
+	parser.addOption(iterationsOption);
+	parser.addOption(warmupOption);
+	parser.addOption(filterOption);
+	parser.addOption(outputOption);
+	parser.addOption(dataOption);
+	parser.process(app);
+
+	const int nbFrames = std::max(2, parser.value(framesOption).toInt());
+	const int nbMarkers = std::max(3, parser.value(markersOption).toInt());
+	const int nbCameras = std::max(2, parser.value(camerasOption).toInt());
+
+	QTemporaryDir tmpDir;
+	QString folder = parser.isSet(dataOption) ? parser.value(dataOption) : tmpDir.path();
+	if (folder.isEmpty())
+	{
+		std::cerr << "Error: Could not create a folder for the synthetic data" << std::endl;
+		return 1;
+	}
+
+	Benchmark bench(parser.value(iterationsOption).toInt(), parser.value(warmupOption).toInt(), parser.value(filterOption));
+
+	SyntheticData data(folder, nbCameras, nbFrames, nbMarkers);
+	data.createCameras();
+	Trial* trial = data.createTrial();
+	trial->setActiveFrame(0);
+
+	benchmarkDetection(bench, data);
+	benchmarkTracking(bench, data, trial);
+	benchmarkTriangulation(bench, data, trial);
+	benchmarkRigidBody(bench, data, trial);
+	benchmarkFilter(bench, data, trial);
+	benchmarkCine(bench, data);
+	//has to run last as it changes the first camera
+	benchmarkUndistortion(bench, data);
+
+	QJsonObject config;
+	config["frames"] = nbFrames;
+	config["markers"] = nbMarkers;
+	config["cameras"] = nbCameras;
+	config["width"] = data.getWidth();
+	config["height"] = data.getHeight();
+	config["iterations"] = parser.value(iterationsOption).toInt();
+	config["warmup"] = parser.value(warmupOption).toInt();
+
+	QJsonObject system;
+	system["threads"] = QThread::idealThreadCount();
+	system["poolThreads"] = QThreadPool::globalInstance()->maxThreadCount();
+	system["cpu"] = QSysInfo::currentCpuArchitecture();
+	system["os"] = QSysInfo::prettyProductName();
+	system["opencv"] = QString(CV_VERSION);
+	system["opencl"] = cv::ocl::useOpenCL();
+
+	QJsonObject root;
+	root["config"] = config;
+	root["system"] = system;
+	root["results"] = bench.getResults();
+
+	QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+	if (parser.isSet(outputOption))
+	{
+		QFile file(parser.value(outputOption));
+		if (!file.open(QIODevice::WriteOnly))
+		{
+			std::cerr << "Error: Could not write " << parser.value(outputOption).toStdString() << std::endl;
+			return 1;
+		}
+		file.write(json);
+		file.close();
+	}
+	else
+	{
+		std::cout << json.constData() << std::endl;
+	}
+
+	return 0;
+}
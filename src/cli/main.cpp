@@ -0,0 +1,303 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file main.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "ui/ProjectFileIO.h"
+
+#include "core/Settings.h"
+#include "core/Project.h"
+#include "core/Camera.h"
+#include "core/Trial.h"
+#include "core/CalibrationImage.h"
+#include "core/UndistortionObject.h"
+#include "core/HelperFunctions.h"
+
+#include "processing/LocalUndistortion.h"
+#include "processing/MultiCameraCalibration.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+using namespace xma;
+
+//Headless counterpart of MainWindow::loadProjectFinished and MainWindow::UndistortionAfterloadProjectFinished
+static void setupProject()
+{
+	bool hasCalibration = false;
+	for (auto c : Project::getInstance()->getCameras())
+	{
+		if (c->getCalibrationImages().size() > 0)
+			hasCalibration = true;
+	}
+
+	if (!hasCalibration)
+	{
+		Project::getInstance()->setCalibation(NO_CALIBRATION);
+		if (Project::getInstance()->getTrials().size() > 0)
+			Project::getInstance()->getTrials()[0]->setCameraSizes();
+	}
+
+	std::vector<int> cameras;
+	for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
+	{
+		cameras.push_back(i);
+	}
+
+	QtConcurrent::blockingMap(cameras, [](const int& i)
+	{
+		Camera* camera = Project::getInstance()->getCameras()[i];
+		if (camera->hasUndistortion() && camera->getUndistortionObject()->isComputed())
+		{
+			LocalUndistortion::computeUndistortionBlocking(i, true);
+		}
+		else if (!camera->hasUndistortion())
+		{
+			camera->undistort();
+		}
+	});
+
+	if (Project::getInstance()->getCalibration() == NO_CALIBRATION)
+		return;
+
+	for (auto camera : Project::getInstance()->getCameras())
+	{
+		bool calibrated = false;
+		for (auto image : camera->getCalibrationImages())
+		{
+			if (image->isCalibrated() > 0) calibrated = true;
+		}
+		if (calibrated)
+		{
+			camera->setCalibrated(true);
+			camera->setRecalibrationRequired(0);
+			MultiCameraCalibration::reproject(camera->getID());
+		}
+		else
+		{
+			std::cerr << "Warning: Camera " << camera->getName().toStdString() << " is not calibrated" << std::endl;
+		}
+	}
+}
+
+static bool exportTrial(Trial* trial, const QString& outputPath, bool export3D, bool export2D, bool exportTransformations,
+                        bool exportImages, bool filter3D, const QString& imageFormat, bool filterImages)
+{
+	bool success = true;
+	Settings* settings = Settings::getInstance();
+	QString base = outputPath + OS_SEP + trial->getName();
+	QDir().mkpath(base);
+
+	if (export3D && trial->getMarkers().size() > 0)
+	{
+		std::vector<int> markers;
+		for (unsigned int i = 0; i < trial->getMarkers().size(); i++)
+			markers.push_back(i);
+
+		double filter_frequency = -1;
+		if (filter3D)
+		{
+			if (trial->getRecordingSpeed() <= 0 || trial->getCutoffFrequency() <= 0)
+			{
+				std::cerr << "Error: Recording speed or Cutoff frequency are not set for trial " << trial->getName().toStdString() << std::endl;
+				return false;
+			}
+			filter_frequency = trial->getCutoffFrequency();
+		}
+
+		QString target = base + OS_SEP + trial->getName() + "_3D_points.csv";
+		if (settings->getBoolSetting("Export3DSingle"))
+		{
+			target = base + OS_SEP + "3D_points" + OS_SEP;
+			QDir().mkpath(target);
+		}
+		success &= trial->save3dPoints(markers, target
+			, settings->getBoolSetting("Export3DMulti")
+			, settings->getBoolSetting("Export3DHeader")
+			, filter_frequency
+			, settings->getBoolSetting("Export3DOffsetCols"), 0, trial->getNbImages() - 1);
+	}
+
+	if (export2D && trial->getMarkers().size() > 0)
+	{
+		QString target = base + OS_SEP + trial->getName() + "_2D_points.csv";
+		if (settings->getBoolSetting("Export2DSingle"))
+		{
+			target = base + OS_SEP + "2D_points" + OS_SEP;
+			QDir().mkpath(target);
+		}
+		trial->save2dPoints(target
+			, settings->getBoolSetting("Export2DMulti")
+			, settings->getBoolSetting("Export2DDistorted")
+			, settings->getBoolSetting("Export2DCount1")
+			, settings->getBoolSetting("Export2DYUp")
+			, settings->getBoolSetting("Export2DHeader")
+			, settings->getBoolSetting("Export2DOffsetCols"));
+	}
+
+	if (exportTransformations && trial->getRigidBodies().size() > 0)
+	{
+		bool filtered = settings->getBoolSetting("ExportTransFiltered");
+		if (filtered && (trial->getRecordingSpeed() <= 0 || trial->getCutoffFrequency() <= 0))
+		{
+			std::cerr << "Error: Recording speed or Cutoff frequency are not set for trial " << trial->getName().toStdString() << std::endl;
+			return false;
+		}
+
+		std::vector<int> bodies;
+		for (unsigned int i = 0; i < trial->getRigidBodies().size(); i++)
+			bodies.push_back(i);
+
+		QString target = base + OS_SEP + trial->getName() + "_transformations.csv";
+		if (settings->getBoolSetting("ExportTransSingle"))
+		{
+			target = base + OS_SEP + "Transformations" + OS_SEP;
+			QDir().mkpath(target);
+		}
+		trial->saveRigidBodyTransformations(bodies, target
+			, settings->getBoolSetting("ExportTransMulti")
+			, settings->getBoolSetting("ExportTransHeader")
+			, filtered
+			, settings->getBoolSetting("ExportTransOffsetCols"), 0, trial->getNbImages() - 1);
+	}
+
+	if (exportImages)
+	{
+		QString target = base + OS_SEP + "Images" + OS_SEP;
+		QDir().mkpath(target);
+		trial->saveTrialImages(target, trial->getStartFrame(), trial->getEndFrame(), imageFormat, filterImages);
+	}
+
+	return success;
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	Settings::getInstance();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Headless batch processing of XMALab projects. The export options are the ones last used in the XMALab export dialogs.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("project", "XMALab project file (.xma)");
+	parser.addPositionalArgument("output", "Output folder");
+
+	QCommandLineOption trialOption("trial", "Only process the given trial. Can be given multiple times.", "name");
+	QCommandLineOption points3DOption("3d", "Export 3D points.");
+	QCommandLineOption points2DOption("2d", "Export 2D points.");
+	QCommandLineOption transformationsOption("transformations", "Export rigid body transformations.");
+	QCommandLineOption imagesOption("images", "Export undistorted trial images.");
+	QCommandLineOption filter3DOption("filter-3d", "Filter the exported 3D points with the cutoff frequency of the trial.");
+	QCommandLineOption cutoffOption("cutoff", "Override the cutoff frequency of the trials.", "Hz");
+	QCommandLineOption imageFormatOption("image-format", "Format of the exported images (tif, jpg, png).", "format", "tif");
+	QCommandLineOption filterImagesOption("filter-images", "Apply the image filter to the exported images.");
+	QCommandLineOption threadsOption("threads", "Number of worker threads. Defaults to all cores.", "n");
+	parser.addOption(trialOption);
+	parser.addOption(points3DOption);
+	parser.addOption(points2DOption);
+	parser.addOption(transformationsOption);
+	parser.addOption(imagesOption);
+	parser.addOption(filter3DOption);
+	parser.addOption(cutoffOption);
+	parser.addOption(imageFormatOption);
+	parser.addOption(filterImagesOption);
+	parser.addOption(threadsOption);
+	parser.process(app);
+
+	const QStringList args = parser.positionalArguments();
+	if (args.size() != 2)
+	{
+		parser.showHelp(1);
+	}
+
+	bool export3D = parser.isSet(points3DOption);
+	bool export2D = parser.isSet(points2DOption);
+	bool exportTransformations = parser.isSet(transformationsOption);
+	bool exportImages = parser.isSet(imagesOption);
+	if (!export3D && !export2D && !exportTransformations && !exportImages)
+	{
+		export3D = true;
+		export2D = true;
+		exportTransformations = true;
+	}
+
+	if (parser.isSet(threadsOption))
+	{
+		int threads = parser.value(threadsOption).toInt();
+		if (threads > 0)
+		{
+			QThreadPool::globalInstance()->setMaxThreadCount(threads);
+			cv::setNumThreads(threads);
+		}
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	ProjectFileIO::getInstance()->setHeadless(true);
+	if (ProjectFileIO::getInstance()->loadProject(args[0], "") != 0)
+	{
+		std::cerr << "Error: Could not load project " << args[0].toStdString() << std::endl;
+		return 2;
+	}
+	setupProject();
+	std::cerr << "Loaded " << args[0].toStdString() << " in " << timer.restart() << " ms" << std::endl;
+
+	QStringList trialNames = parser.values(trialOption);
+	bool success = true;
+	for (auto trial : Project::getInstance()->getTrials())
+	{
+		if (trial->getIsDefault() || (!trialNames.isEmpty() && !trialNames.contains(trial->getName())))
+			continue;
+
+		if (parser.isSet(cutoffOption))
+			trial->setCutoffFrequency(parser.value(cutoffOption).toDouble());
+
+		trial->setRequiresRecomputation(true);
+		trial->recomputeData();
+		std::cerr << "Recomputed " << trial->getName().toStdString() << " (" << trial->getNbImages() << " frames) in " << timer.restart() << " ms" << std::endl;
+
+		if (!exportTrial(trial, args[1], export3D, export2D, exportTransformations, exportImages,
+		                 parser.isSet(filter3DOption), parser.value(imageFormatOption), parser.isSet(filterImagesOption)))
+		{
+			std::cerr << "Error: Export of " << trial->getName().toStdString() << " failed" << std::endl;
+			success = false;
+		}
+		std::cerr << "Exported " << trial->getName().toStdString() << " in " << timer.restart() << " ms" << std::endl;
+	}
+
+	ProjectFileIO::getInstance()->removeTmpDir();
+	return success ? 0 : 3;
+}
@@ -0,0 +1,382 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AviIndex.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/AviIndex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace xma;
+
+namespace
+{
+	const quint32 CACHE_MAGIC = 0x584d4149; //XMAI
+	const quint32 CACHE_VERSION = 1;
+
+	const unsigned int AVIIF_KEYFRAME = 0x10;
+	const unsigned int AVI_INDEX_OF_CHUNKS = 0x01;
+	const unsigned int AVISTDINDEX_DELTAFRAME = 0x80000000;
+
+	struct SuperIndexEntry
+	{
+		unsigned long long offset;
+		unsigned int size;
+	};
+
+	bool readFourCC(std::ifstream& in, char* fourcc)
+	{
+		in.read(fourcc, 4);
+		return in.good();
+	}
+
+	template <typename T>
+	bool readValue(std::ifstream& in, T& value)
+	{
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return in.good();
+	}
+
+	bool isFourCC(const char* fourcc, const char* value)
+	{
+		return memcmp(fourcc, value, 4) == 0;
+	}
+
+	//video chunk of the given stream, i.e. ##db or ##dc
+	bool isVideoChunk(const char* ckid, int stream)
+	{
+		return ckid[0] == '0' + stream / 10 && ckid[1] == '0' + stream % 10 && ckid[2] == 'd' && (ckid[3] == 'b' || ckid[3] == 'c');
+	}
+
+	//Reads the strl lists of the hdrl list. Returns the number of the first video stream and its OpenDML super index.
+	int parseHeaderList(std::ifstream& in, std::streamoff pos, std::streamoff end, std::vector<SuperIndexEntry>& superIndex)
+	{
+		int stream = 0;
+		int videoStream = -1;
+		char fourcc[4];
+		unsigned int size;
+
+		while (pos + 8 <= end)
+		{
+			in.seekg(pos);
+			if (!readFourCC(in, fourcc) || !readValue(in, size))
+				break;
+
+			char listType[4];
+			if (isFourCC(fourcc, "LIST") && readFourCC(in, listType) && isFourCC(listType, "strl"))
+			{
+				bool isVideo = false;
+				std::streamoff sub = pos + 12;
+				std::streamoff subEnd = pos + 8 + size;
+				while (sub + 8 <= subEnd)
+				{
+					char subFourcc[4];
+					unsigned int subSize;
+					in.seekg(sub);
+					if (!readFourCC(in, subFourcc) || !readValue(in, subSize))
+						break;
+
+					if (isFourCC(subFourcc, "strh"))
+					{
+						char fccType[4];
+						isVideo = readFourCC(in, fccType) && isFourCC(fccType, "vids") && videoStream < 0;
+						if (isVideo)
+							videoStream = stream;
+					}
+					else if (isFourCC(subFourcc, "indx") && isVideo)
+					{
+						unsigned short longsPerEntry;
+						unsigned char indexSubType, indexType;
+						unsigned int entriesInUse;
+						char chunkId[4];
+						readValue(in, longsPerEntry);
+						readValue(in, indexSubType);
+						readValue(in, indexType);
+						readValue(in, entriesInUse);
+						readFourCC(in, chunkId);
+						in.seekg(12, std::ios::cur);
+						//only the super index of index chunks is supported, the entries have to fit into the chunk
+						if (indexType == 0 && longsPerEntry == 4 && subSize >= 24 && entriesInUse <= (subSize - 24) / 16)
+						{
+							for (unsigned int i = 0; i < entriesInUse && in.good(); i++)
+							{
+								SuperIndexEntry entry;
+								unsigned int duration;
+								readValue(in, entry.offset);
+								readValue(in, entry.size);
+								readValue(in, duration);
+								if (in.good())
+									superIndex.push_back(entry);
+							}
+						}
+					}
+					sub += 8 + subSize + (subSize & 1);
+				}
+				stream++;
+			}
+			pos += 8 + size + (size & 1);
+		}
+		return videoStream;
+	}
+}
+
+AviIndex::AviIndex() : nbFrames(0)
+{
+}
+
+AviIndex::~AviIndex()
+{
+}
+
+bool AviIndex::isKeyFrame(int frame) const
+{
+	if (!isValid())
+		return true;
+	return std::binary_search(keyFrames.begin(), keyFrames.end(), frame);
+}
+
+int AviIndex::getKeyFrame(int frame) const
+{
+	if (!isValid())
+		return frame;
+
+	std::vector<int>::const_iterator it = std::upper_bound(keyFrames.begin(), keyFrames.end(), frame);
+	if (it == keyFrames.begin())
+		return 0;
+	return *(--it);
+}
+
+bool AviIndex::load(const QString& filename)
+{
+	nbFrames = 0;
+	keyFrames.clear();
+
+	QFileInfo info(filename);
+	if (!info.exists())
+		return false;
+
+	long long size = info.size();
+	long long modified = info.lastModified().toMSecsSinceEpoch();
+
+	QString cacheFolder = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/aviindex";
+	QString key = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+	QString cacheFile = cacheFolder + "/" + key + ".idx";
+
+	if (readCache(cacheFile, size, modified))
+		return true;
+
+	if (!parse(filename))
+	{
+		nbFrames = 0;
+		keyFrames.clear();
+		return false;
+	}
+
+	if (!cacheFolder.isEmpty() && QDir().mkpath(cacheFolder))
+		writeCache(cacheFile, size, modified);
+
+	return true;
+}
+
+bool AviIndex::parse(const QString& filename)
+{
+#ifdef _MSC_VER
+	std::ifstream in(filename.toStdWString(), std::ios::binary);
+#else
+	std::ifstream in(filename.toStdString(), std::ios::binary);
+#endif
+	if (!in.is_open())
+		return false;
+
+	in.seekg(0, std::ios::end);
+	std::streamoff fileSize = in.tellg();
+	in.seekg(0);
+
+	char fourcc[4];
+	char formType[4];
+	unsigned int riffSize;
+	if (!readFourCC(in, fourcc) || !readValue(in, riffSize) || !readFourCC(in, formType)
+		|| !isFourCC(fourcc, "RIFF") || !isFourCC(formType, "AVI "))
+		return false;
+
+	std::vector<SuperIndexEntry> superIndex;
+	int videoStream = -1;
+	std::streamoff idx1Pos = -1;
+	unsigned int idx1Size = 0;
+
+	std::streamoff pos = 12;
+	std::streamoff end = 8 + (std::streamoff) riffSize;
+	while (pos + 8 <= end)
+	{
+		unsigned int size;
+		in.seekg(pos);
+		if (!readFourCC(in, fourcc) || !readValue(in, size))
+			break;
+
+		char listType[4];
+		if (isFourCC(fourcc, "LIST") && readFourCC(in, listType) && isFourCC(listType, "hdrl"))
+		{
+			videoStream = parseHeaderList(in, pos + 12, pos + 8 + size, superIndex);
+		}
+		else if (isFourCC(fourcc, "idx1"))
+		{
+			idx1Pos = pos + 8;
+			idx1Size = size;
+		}
+		pos += 8 + size + (size & 1);
+	}
+
+	if (videoStream < 0)
+		return false;
+
+	int frame = 0;
+	if (!superIndex.empty())
+	{
+		//OpenDML, one standard index chunk per RIFF segment. Deltaframes are marked by the highest bit of the size.
+		for (unsigned int s = 0; s < superIndex.size(); s++)
+		{
+			in.clear();
+			in.seekg((std::streamoff) superIndex[s].offset);
+
+			char indexFourcc[4];
+			unsigned int indexSize;
+			unsigned short longsPerEntry;
+			unsigned char indexSubType, indexType;
+			unsigned int entriesInUse;
+			char chunkId[4];
+			unsigned long long baseOffset;
+			unsigned int reserved;
+			if (!readFourCC(in, indexFourcc) || !readValue(in, indexSize)
+				|| !readValue(in, longsPerEntry) || !readValue(in, indexSubType) || !readValue(in, indexType)
+				|| !readValue(in, entriesInUse) || !readFourCC(in, chunkId) || !readValue(in, baseOffset) || !readValue(in, reserved))
+				return false;
+			if (indexType != AVI_INDEX_OF_CHUNKS || longsPerEntry != 2)
+				return false;
+			//the entry count is read from the file and has to fit into the chunk before it is allocated
+			if (indexSize < 24 || entriesInUse > (indexSize - 24) / 8 || (std::streamoff) superIndex[s].offset + 8 + indexSize > fileSize)
+				return false;
+
+			std::vector<unsigned int> entries(2 * entriesInUse);
+			if (entriesInUse > 0 && !in.read(reinterpret_cast<char*>(&entries[0]), entries.size() * sizeof(unsigned int)))
+				return false;
+
+			for (unsigned int i = 0; i < entriesInUse; i++, frame++)
+			{
+				if (!(entries[2 * i + 1] & AVISTDINDEX_DELTAFRAME))
+					keyFrames.push_back(frame);
+			}
+		}
+	}
+	else if (idx1Pos >= 0)
+	{
+		if (idx1Pos + idx1Size > fileSize)
+			return false;
+
+		std::vector<char> entries(idx1Size - idx1Size % 16);
+		in.clear();
+		in.seekg(idx1Pos);
+		if (!entries.empty() && !in.read(&entries[0], entries.size()))
+			return false;
+
+		for (unsigned int i = 0; i < entries.size(); i += 16)
+		{
+			if (!isVideoChunk(&entries[i], videoStream))
+				continue;
+
+			unsigned int flags;
+			memcpy(&flags, &entries[i + 4], sizeof(unsigned int));
+			if (flags & AVIIF_KEYFRAME)
+				keyFrames.push_back(frame);
+			frame++;
+		}
+	}
+
+	nbFrames = frame;
+	//the first frame has to be decodable
+	if (nbFrames == 0 || keyFrames.empty() || keyFrames[0] != 0)
+		return false;
+
+	return true;
+}
+
+bool AviIndex::readCache(const QString& cacheFile, long long size, long long modified)
+{
+	QFile file(cacheFile);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream in(&file);
+	quint32 magic, version;
+	qint64 cachedSize, cachedModified;
+	qint32 frames, count;
+	in >> magic >> version >> cachedSize >> cachedModified >> frames >> count;
+	if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION
+		|| cachedSize != size || cachedModified != modified || frames <= 0 || count <= 0 || count > frames)
+		return false;
+
+	keyFrames.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		qint32 keyFrame;
+		in >> keyFrame;
+		keyFrames[i] = keyFrame;
+	}
+	if (in.status() != QDataStream::Ok)
+	{
+		keyFrames.clear();
+		return false;
+	}
+
+	nbFrames = frames;
+	return true;
+}
+
+void AviIndex::writeCache(const QString& cacheFile, long long size, long long modified)
+{
+	QFile file(cacheFile);
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+
+	QDataStream out(&file);
+	out << CACHE_MAGIC << CACHE_VERSION << (qint64) size << (qint64) modified << (qint32) nbFrames << (qint32) keyFrames.size();
+	for (unsigned int i = 0; i < keyFrames.size(); i++)
+	{
+		out << (qint32) keyFrames[i];
+	}
+	file.close();
+}
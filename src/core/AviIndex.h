@@ -0,0 +1,64 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AviIndex.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef AVIINDEX_H_
+#define AVIINDEX_H_
+
+#include <QString>
+#include <vector>
+
+namespace xma
+{
+	/// Keyframe index of the video stream of an avi file. The index is read from the OpenDML (AVI 2.0) or the
+	/// idx1 index of the file and cached in the user cache folder, keyed by the path, size and modification time.
+	class AviIndex
+	{
+	public:
+		AviIndex();
+		virtual ~AviIndex();
+
+		//Loads the index from the cache or parses the file. Returns false if the file has no usable index.
+		bool load(const QString& filename);
+
+		bool isValid() const { return nbFrames > 0; }
+		int getNbFrames() const { return nbFrames; }
+		bool isIntraOnly() const { return isValid() && (int)keyFrames.size() == nbFrames; }
+		bool isKeyFrame(int frame) const;
+		//Returns the last keyframe at or before frame, or frame itself if the index is not valid
+		int getKeyFrame(int frame) const;
+
+	private:
+		bool parse(const QString& filename);
+		bool readCache(const QString& cacheFile, long long size, long long modified);
+		void writeCache(const QString& cacheFile, long long size, long long modified);
+
+		int nbFrames;
+		//sorted frame numbers of the keyframes
+		std::vector<int> keyFrames;
+	};
+}
+
+#endif /* AVIINDEX_H_ */
@@ -0,0 +1,329 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AviProxy.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/AviProxy.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QStorageInfo>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace xma;
+
+namespace
+{
+	const quint32 PROXY_MAGIC = 0x584d4150; //XMAP
+	const quint32 PROXY_VERSION = 1;
+	//frames start at a page boundary
+	const qint64 HEADER_SIZE = 4096;
+	//bytes read from the start and the end of the video for its hash
+	const qint64 HASH_BLOCK_SIZE = 1 << 20;
+
+	bool isGray(const cv::Mat& frame)
+	{
+		if (frame.channels() == 1)
+			return true;
+
+		std::vector<cv::Mat> planes;
+		cv::split(frame, planes);
+		for (unsigned int i = 1; i < planes.size(); i++)
+		{
+			if (cv::norm(planes[0], planes[i], cv::NORM_INF) > 0)
+				return false;
+		}
+		return true;
+	}
+}
+
+struct AviProxy::Header
+{
+	qint64 sourceSize = 0;
+	qint64 sourceModified = 0;
+	QByteArray sourceHash;
+	qint32 nbFrames = 0;
+	qint32 nbImages = 0;
+	qint32 width = 0;
+	qint32 height = 0;
+	qint32 channels = 0;
+	double fps = 0;
+};
+
+AviProxy::AviProxy() : data(NULL), nbFrames(0), nbImages(0), width(0), height(0), channels(0), fps(0)
+{
+}
+
+AviProxy::~AviProxy()
+{
+	close();
+}
+
+QString AviProxy::getProxyFilename(const QString& filename)
+{
+	QString cacheFolder = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if (cacheFolder.isEmpty())
+		return "";
+
+	QString key = QCryptographicHash::hash(QFileInfo(filename).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+	return cacheFolder + "/aviproxy/" + key + ".proxy";
+}
+
+bool AviProxy::getSourceInfo(const QString& filename, Header& header)
+{
+	QFileInfo info(filename);
+	QFile source(filename);
+	if (!info.exists() || !source.open(QIODevice::ReadOnly))
+		return false;
+
+	header.sourceSize = info.size();
+	header.sourceModified = info.lastModified().toMSecsSinceEpoch();
+
+	//hashing the whole video would take as long as decoding it, the first and last block catch rewritten files
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(source.read(HASH_BLOCK_SIZE));
+	if (header.sourceSize > HASH_BLOCK_SIZE)
+	{
+		source.seek(std::max(HASH_BLOCK_SIZE, header.sourceSize - HASH_BLOCK_SIZE));
+		hash.addData(source.read(HASH_BLOCK_SIZE));
+	}
+	header.sourceHash = hash.result();
+	return true;
+}
+
+bool AviProxy::readHeader(const uchar* buffer, qint64 size, Header& header)
+{
+	if (size < HEADER_SIZE)
+		return false;
+
+	QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(buffer), HEADER_SIZE);
+	QDataStream in(raw);
+	quint32 magic, version;
+	in >> magic >> version;
+	if (in.status() != QDataStream::Ok || magic != PROXY_MAGIC || version != PROXY_VERSION)
+		return false;
+
+	in >> header.sourceSize >> header.sourceModified >> header.sourceHash >> header.nbFrames >> header.nbImages
+		>> header.width >> header.height >> header.channels >> header.fps;
+	if (in.status() != QDataStream::Ok || header.nbFrames <= 0 || header.width <= 0 || header.height <= 0
+		|| (header.channels != 1 && header.channels != 3))
+		return false;
+
+	qint64 frameBytes = (qint64) header.width * header.height * header.channels;
+	return size >= HEADER_SIZE + header.nbFrames * frameBytes;
+}
+
+QByteArray AviProxy::writeHeader(const Header& header)
+{
+	QByteArray raw;
+	QDataStream out(&raw, QIODevice::WriteOnly);
+	out << PROXY_MAGIC << PROXY_VERSION << header.sourceSize << header.sourceModified << header.sourceHash << header.nbFrames << header.nbImages
+		<< header.width << header.height << header.channels << header.fps;
+	raw.resize(HEADER_SIZE, '\0');
+	return raw;
+}
+
+bool AviProxy::open(const QString& filename)
+{
+	close();
+
+	Header source;
+	if (!getSourceInfo(filename, source))
+		return false;
+
+	QString proxyFile = getProxyFilename(filename);
+	if (proxyFile.isEmpty() || !QFileInfo::exists(proxyFile))
+		return false;
+
+	file.setFileName(proxyFile);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	uchar* mapped = file.map(0, file.size());
+	Header header;
+	if (mapped == NULL || !readHeader(mapped, file.size(), header) || header.sourceSize != source.sourceSize
+		|| header.sourceModified != source.sourceModified || header.sourceHash != source.sourceHash)
+	{
+		if (mapped != NULL)
+			file.unmap(mapped);
+		file.close();
+		return false;
+	}
+
+	data = mapped;
+	nbFrames = header.nbFrames;
+	nbImages = header.nbImages;
+	width = header.width;
+	height = header.height;
+	channels = header.channels;
+	fps = header.fps;
+	return true;
+}
+
+void AviProxy::close()
+{
+	if (data != NULL)
+		file.unmap(data);
+	if (file.isOpen())
+		file.close();
+
+	data = NULL;
+	nbFrames = 0;
+	nbImages = 0;
+}
+
+bool AviProxy::getFrame(int frameNumber, cv::Mat& frame) const
+{
+	if (data == NULL || frameNumber < 0 || frameNumber >= nbFrames)
+		return false;
+
+	size_t frameBytes = (size_t) width * height * channels;
+	frame = cv::Mat(height, width, CV_8UC(channels), data + HEADER_SIZE + frameNumber * frameBytes);
+	return true;
+}
+
+bool AviProxy::isUpToDate(const QString& filename)
+{
+	AviProxy proxy;
+	return proxy.open(filename);
+}
+
+bool AviProxy::build(const QString& filename, std::function<bool(int)> progress)
+{
+	Header header;
+	QString proxyFile = getProxyFilename(filename);
+	if (proxyFile.isEmpty() || !getSourceInfo(filename, header) || !QDir().mkpath(QFileInfo(proxyFile).absolutePath()))
+		return false;
+
+	QFile out(proxyFile + ".part");
+	//gray videos are often decoded to 3 identical channels, those are stored with one channel until a colored frame shows up
+	int channels = 0;
+	bool restart = true;
+	while (restart)
+	{
+		restart = false;
+
+		cv::VideoCapture cap(filename.toStdString());
+		if (!cap.isOpened() || !out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+			return false;
+
+		header.nbImages = (int)(cap.get(cv::CAP_PROP_FRAME_COUNT) + 0.45);
+		header.fps = cap.get(cv::CAP_PROP_FPS);
+		header.nbFrames = 0;
+		out.write(writeHeader(header));
+
+		cv::Mat frame, converted;
+		while ((header.nbImages <= 0 || header.nbFrames < header.nbImages) && cap.read(frame) && !frame.empty())
+		{
+			if (frame.depth() != CV_8U || (frame.channels() != 1 && frame.channels() != 3))
+				break;
+
+			if (header.nbFrames == 0)
+			{
+				header.width = frame.cols;
+				header.height = frame.rows;
+				if (channels == 0)
+					channels = isGray(frame) ? 1 : 3;
+				header.channels = channels;
+
+				qint64 required = HEADER_SIZE + (qint64) std::max(header.nbImages, 1) * header.width * header.height * header.channels;
+				if (QStorageInfo(QFileInfo(proxyFile).absolutePath()).bytesAvailable() < required)
+				{
+					std::cerr << "Not enough disk space for the proxy of " << filename.toStdString() << std::endl;
+					out.remove();
+					return false;
+				}
+			}
+			else if (frame.cols != header.width || frame.rows != header.height)
+			{
+				break;
+			}
+
+			if (channels == 1 && frame.channels() == 3)
+			{
+				if (!isGray(frame))
+				{
+					channels = 3;
+					restart = true;
+					break;
+				}
+				cv::extractChannel(frame, converted, 0);
+			}
+			else if (channels == 3 && frame.channels() == 1)
+			{
+				cv::cvtColor(frame, converted, cv::COLOR_GRAY2BGR);
+			}
+			else
+			{
+				converted = frame.isContinuous() ? frame : frame.clone();
+			}
+
+			qint64 frameBytes = (qint64) converted.total() * converted.elemSize();
+			if (out.write(reinterpret_cast<const char*>(converted.data), frameBytes) != frameBytes)
+			{
+				out.remove();
+				return false;
+			}
+			header.nbFrames++;
+
+			if (progress && !progress(header.nbFrames))
+			{
+				out.remove();
+				return false;
+			}
+		}
+
+		if (restart)
+			out.close();
+	}
+
+	//the video must not have been changed while it was read
+	Header source;
+	if (header.nbFrames == 0 || !getSourceInfo(filename, source) || source.sourceSize != header.sourceSize
+		|| source.sourceModified != header.sourceModified || source.sourceHash != header.sourceHash)
+	{
+		out.remove();
+		return false;
+	}
+
+	out.seek(0);
+	out.write(writeHeader(header));
+	out.close();
+
+	QFile::remove(proxyFile);
+	return out.rename(proxyFile);
+}
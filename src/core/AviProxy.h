@@ -0,0 +1,82 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AviProxy.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef AVIPROXY_H_
+#define AVIPROXY_H_
+
+#include <QFile>
+#include <QString>
+#include <functional>
+#include <opencv2/core.hpp>
+
+namespace xma
+{
+	/// Uncompressed 8-bit copy of the frames of an avi file, stored in the user cache folder. Frames are kept
+	/// in their original order at fixed offsets so the file can be memory mapped and every frame is addressable
+	/// without decoding. A proxy is only used if the size, modification time and hash of the video still match.
+	class AviProxy
+	{
+	public:
+		AviProxy();
+		virtual ~AviProxy();
+
+		//Maps the proxy of the file. Returns false if there is no proxy or it is outdated.
+		bool open(const QString& filename);
+		void close();
+
+		bool isOpen() const { return data != NULL; }
+		//number of frames stored in the proxy
+		int getNbFrames() const { return nbFrames; }
+		//number of frames and fps reported by the decoder when the proxy was built
+		int getNbImages() const { return nbImages; }
+		double getFPS() const { return fps; }
+
+		//Sets frame to the mapped data of the frame without copying it. The data must not be modified.
+		bool getFrame(int frameNumber, cv::Mat& frame) const;
+
+		//Decodes the file and writes its proxy. progress is called with the number of written frames and cancels the build if it returns false.
+		static bool build(const QString& filename, std::function<bool(int)> progress = nullptr);
+		static bool isUpToDate(const QString& filename);
+		static QString getProxyFilename(const QString& filename);
+
+	private:
+		struct Header;
+		static bool readHeader(const uchar* buffer, qint64 size, Header& header);
+		static QByteArray writeHeader(const Header& header);
+		static bool getSourceInfo(const QString& filename, Header& header);
+
+		QFile file;
+		uchar* data;
+		int nbFrames;
+		int nbImages;
+		int width;
+		int height;
+		int channels;
+		double fps;
+	};
+}
+
+#endif /* AVIPROXY_H_ */
@@ -32,84 +32,199 @@
 #include <QtCore/QFileInfo>
 #include <opencv2/highgui.hpp>
 #include "Project.h"
+#include "Settings.h"
+#include <algorithm>
+#include <cstdlib>
 using namespace xma;
 
 AviVideo::AviVideo(QStringList _filenames) : VideoStream(_filenames)
 {
     lastFrame = -1;
-    cap = std::make_unique<cv::VideoCapture>(filenames.at(0).toStdString());
-    reloadFile();
+    nextFrame = -1;
+    frameCacheSize = 0;
+    frameCacheMemory = 0;
 }
 
 AviVideo::~AviVideo()
 {
-    if (cap && cap->isOpened())
-        cap->release();
+    close();
 }
 
 void AviVideo::setActiveFrame(int _activeFrame)
 {
+    activeFrame = _activeFrame;
+    open();
     if (lastFrame == _activeFrame)
         return;
 
     lastFrame = _activeFrame;
-    if (!cap || !cap->isOpened())
+    if (!proxy.isOpen() && (!cap || !cap->isOpened()))
         return;
     if (_activeFrame >= 0 && _activeFrame < nbImages)
     {
-        cap->set(cv::CAP_PROP_POS_FRAMES, _activeFrame);
-
         cv::Mat frame;
-        cap->read(frame);
-        if (frame.channels() > 1)
+        if (decodeFrame(_activeFrame, frame))
+            setImage(frame);
+        updateMemoryUsage(frameCacheMemory);
+    }
+}
+
+bool AviVideo::decodeFrame(int frameNumber, cv::Mat& frame)
+{
+    //proxy frames are mapped and do not need to be cached
+    if (proxy.getFrame(frameNumber, frame))
+        return true;
+
+    if (!openCapture())
+        return false;
+
+    std::map<int, cv::Mat>::iterator it = frameCache.find(frameNumber);
+    if (it != frameCache.end())
+    {
+        frame = it->second;
+        return true;
+    }
+
+    //without an index every frame is treated as keyframe, i.e. we only read on if it is the next frame
+    int keyFrame = index.getKeyFrame(frameNumber);
+    if (nextFrame < keyFrame || nextFrame > frameNumber)
+    {
+        cap->set(cv::CAP_PROP_POS_FRAMES, keyFrame);
+        nextFrame = keyFrame;
+    }
+
+    //decode the frames in between, the last ones are kept for stepping backwards
+    while (nextFrame < frameNumber)
+    {
+        if (frameNumber - nextFrame <= (int) frameCacheSize)
         {
-            if (isFlipped)
-                cv::flip(frame, frame, 1);
-            image->setImage(frame, true);
+            cv::Mat skipped;
+            if (!cap->read(skipped))
+            {
+                nextFrame = -1;
+                return false;
+            }
+            addToCache(nextFrame, skipped);
         }
-        else
+        else if (!cap->grab())
         {
-            if (isFlipped)
-                cv::flip(frame, frame, 1);
-            image->setImage(frame);
+            nextFrame = -1;
+            return false;
         }
-        frame.release();
+        nextFrame++;
+    }
+
+    if (!cap->read(frame) || frame.empty())
+    {
+        nextFrame = -1;
+        return false;
+    }
+    nextFrame++;
+    addToCache(frameNumber, frame);
+    return true;
+}
+
+void AviVideo::addToCache(int frameNumber, const cv::Mat& frame)
+{
+    if (frameCacheSize == 0)
+        return;
+
+    std::map<int, cv::Mat>::iterator existing = frameCache.find(frameNumber);
+    if (existing != frameCache.end())
+        frameCacheMemory -= existing->second.total() * existing->second.elemSize();
+    frameCache[frameNumber] = frame;
+    frameCacheMemory += frame.total() * frame.elemSize();
+
+    //drop the frames furthest away from the current one
+    while (frameCache.size() > frameCacheSize)
+    {
+        std::map<int, cv::Mat>::iterator first = frameCache.begin();
+        std::map<int, cv::Mat>::iterator last = --frameCache.end();
+        std::map<int, cv::Mat>::iterator dropped = (std::abs(first->first - frameNumber) >= std::abs(last->first - frameNumber)) ? first : last;
+        frameCacheMemory -= dropped->second.total() * dropped->second.elemSize();
+        frameCache.erase(dropped);
     }
 }
 
+void AviVideo::setImage(const cv::Mat& frame)
+{
+    //the frame may be shared with the cache and must not be modified
+    cv::Mat output = frame;
+    if (isFlipped)
+        cv::flip(frame, output, 1);
+
+    setDecodedImage(output, output.channels() > 1);
+}
+
 QString AviVideo::getFrameName(int frameNumber)
 {
     QFileInfo info(filenames.at(0));
     return info.fileName() + " Frame " + QString::number(frameNumber + 1);
 }
 
-void AviVideo::reloadFile()
+void AviVideo::closeFile()
 {
     if (cap && cap->isOpened())
         cap->release();
+    cap.reset();
+    proxy.close();
+    frameCache.clear();
+    frameCacheMemory = 0;
+    nextFrame = -1;
+    lastFrame = -1;
+}
+
+VideoStream* AviVideo::createStream(QStringList _filenames)
+{
+    return new AviVideo(_filenames);
+}
+
+bool AviVideo::openCapture()
+{
+    if (cap)
+        return cap->isOpened();
+
     cap = std::make_unique<cv::VideoCapture>(filenames.at(0).toStdString());
+    if (!cap->isOpened())
+        return false;
+
+    //the index is only used if it agrees with the decoder
+    double frnb(cap->get(cv::CAP_PROP_FRAME_COUNT));
+    if (!index.load(filenames.at(0)) || index.getNbFrames() != (int)(frnb + 0.45))
+        index = AviIndex();
+    return true;
+}
 
-    if (cap->isOpened())
+void AviVideo::openFile()
+{
+    frameCache.clear();
+    frameCacheMemory = 0;
+    frameCacheSize = std::max(0, Settings::getInstance()->getIntSetting("VideoFrameCacheSize"));
+    nextFrame = -1;
+    lastFrame = -1;
+
+    //with an up to date proxy the decoder is only opened for frames missing in the proxy
+    if (proxy.open(filenames.at(0)))
+    {
+        nbImages = proxy.getNbImages();
+        fps = proxy.getFPS();
+    }
+    else if (openCapture())
     {
         double frnb(cap->get(cv::CAP_PROP_FRAME_COUNT));
         nbImages = (int)(frnb + 0.45);
         fps = cap->get(cv::CAP_PROP_FPS);
+    }
 
+    if (proxy.isOpen() || (cap && cap->isOpened()))
+    {
+        int frameNumber = (activeFrame >= 0 && activeFrame < nbImages) ? activeFrame : 0;
         cv::Mat frame;
-        cap->read(frame);
-        if (frame.channels() > 1)
+        if (decodeFrame(frameNumber, frame))
         {
-            if (isFlipped)
-                cv::flip(frame, frame, 1);
-            image->setImage(frame, true);
+            setImage(frame);
+            lastFrame = frameNumber;
         }
-        else
-        {
-            if (isFlipped)
-                cv::flip(frame, frame, 1);
-            image->setImage(frame);
-        }
-        frame.release();
     }
+    updateMemoryUsage(frameCacheMemory);
 }
-
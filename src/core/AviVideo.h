@@ -28,6 +28,9 @@
 #define AVIVIDEO_H_
 
 #include <core/VideoStream.h>
+#include <core/AviIndex.h>
+#include <core/AviProxy.h>
+#include <map>
 #include <memory>
 #include <opencv2/highgui.hpp>
 
@@ -41,10 +44,31 @@ namespace xma
 
 		void setActiveFrame(int _activeFrame) override;
 		QString getFrameName(int frameNumber) override;
-		void reloadFile() override;
+
+	protected:
+		void openFile() override;
+		void closeFile() override;
+		VideoStream* createStream(QStringList _filenames) override;
+
 	private:
+		//Opens the decoder, which is only needed for frames not stored in the proxy
+		bool openCapture();
+		//Decodes a frame. Reads forward from the current position if the frame is in the current GOP, otherwise seeks to its keyframe.
+		bool decodeFrame(int frameNumber, cv::Mat& frame);
+		void addToCache(int frameNumber, const cv::Mat& frame);
+		void setImage(const cv::Mat& frame);
+
 		int lastFrame;
+		//frame which will be returned by the next read of the capture, -1 if unknown
+		int nextFrame;
 		std::unique_ptr<cv::VideoCapture> cap;
+		AviIndex index;
+		AviProxy proxy;
+
+		//recently decoded frames, used when stepping backwards within a GOP
+		std::map<int, cv::Mat> frameCache;
+		unsigned int frameCacheSize;
+		size_t frameCacheMemory;
 	};
 }
 
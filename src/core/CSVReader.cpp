@@ -0,0 +1,327 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file CSVReader.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/CSVReader.h"
+
+#include <QFile>
+#include <QAtomicInt>
+#include <QtConcurrent/QtConcurrent>
+
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+using namespace xma;
+
+namespace
+{
+	const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	inline bool equalsNoCase(const char* begin, const char* end, const char* word)
+	{
+		for (; begin != end && *word; ++begin, ++word)
+		{
+			if (tolower(*begin) != *word) return false;
+		}
+		return begin == end && !*word;
+	}
+}
+
+CSVReader::CSVReader()
+{
+}
+
+CSVReader::~CSVReader()
+{
+	clear();
+}
+
+bool CSVReader::open(QString filename)
+{
+	clear();
+
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	qint64 size = file.size();
+	buffer.resize(size + 1);
+	if (size > 0 && file.read(buffer.data(), size) != size)
+	{
+		clear();
+		return false;
+	}
+	buffer[size] = '\0';
+	file.close();
+
+	//split lines, accepts \n, \r\n and \r and skips empty lines
+	size_t pos = 0;
+	size_t start = 0;
+	while (pos < (size_t) size)
+	{
+		char c = buffer[pos];
+		if (c == '\n' || c == '\r')
+		{
+			if (pos > start)
+			{
+				lineBegin.push_back(start);
+				lineEnd.push_back(pos);
+			}
+			if (c == '\r' && pos + 1 < (size_t) size && buffer[pos + 1] == '\n')
+				pos++;
+			start = pos + 1;
+		}
+		pos++;
+	}
+	if ((size_t) size > start)
+	{
+		lineBegin.push_back(start);
+		lineEnd.push_back(size);
+	}
+
+	return true;
+}
+
+void CSVReader::clear()
+{
+	buffer.clear();
+	lineBegin.clear();
+	lineEnd.clear();
+}
+
+int CSVReader::getNbRows() const
+{
+	return lineBegin.size();
+}
+
+int CSVReader::getNbColumns(int row) const
+{
+	if (row < 0 || row >= getNbRows())
+		return 0;
+
+	int count = 1;
+	for (size_t i = lineBegin[row]; i < lineEnd[row]; i++)
+	{
+		if (buffer[i] == ',') count++;
+	}
+	return count;
+}
+
+bool CSVReader::getField(int row, int col, const char*& begin, const char*& end) const
+{
+	if (row < 0 || row >= getNbRows() || col < 0)
+		return false;
+
+	const char* p = buffer.data() + lineBegin[row];
+	const char* line_end = buffer.data() + lineEnd[row];
+
+	for (int c = 0; c < col; c++)
+	{
+		while (p != line_end && *p != ',') p++;
+		if (p == line_end) return false;
+		p++;
+	}
+
+	begin = p;
+	while (p != line_end && *p != ',') p++;
+	end = p;
+
+	return true;
+}
+
+QString CSVReader::getField(int row, int col) const
+{
+	const char* begin;
+	const char* end;
+	if (!getField(row, col, begin, end))
+		return "";
+
+	return QString::fromUtf8(begin, end - begin);
+}
+
+void CSVReader::parseNumeric(int firstRow, int nbColumns, std::vector<double>& values, const std::function<void(double)>& progress) const
+{
+	int nbRows = getNbRows() - firstRow;
+	if (nbRows <= 0 || nbColumns <= 0)
+	{
+		values.clear();
+		return;
+	}
+
+	values.assign((size_t) nbRows * nbColumns, std::numeric_limits<double>::quiet_NaN());
+
+	std::vector<int> chunks;
+	for (int r = 0; r < nbRows; r += chunkSize)
+	{
+		chunks.push_back(r);
+	}
+
+	QAtomicInt chunksDone(0);
+	int nbChunks = chunks.size();
+
+	QtConcurrent::blockingMap(chunks, [&](const int& chunkStart)
+	{
+		int chunkEnd = std::min(chunkStart + chunkSize, nbRows);
+		for (int r = chunkStart; r < chunkEnd; r++)
+		{
+			const char* p = buffer.data() + lineBegin[firstRow + r];
+			const char* line_end = buffer.data() + lineEnd[firstRow + r];
+			double* out = &values[(size_t) r * nbColumns];
+
+			for (int c = 0; c < nbColumns && p <= line_end; c++)
+			{
+				const char* field_end = p;
+				while (field_end != line_end && *field_end != ',') field_end++;
+
+				double value;
+				if (parseDouble(p, field_end, value))
+					out[c] = value;
+
+				p = field_end + 1;
+			}
+		}
+
+		int done = chunksDone.fetchAndAddOrdered(1) + 1;
+		if (progress) progress(((double) done) / nbChunks);
+	});
+}
+
+bool CSVReader::parseDouble(const char* begin, const char* end, double& value)
+{
+	while (begin != end && isSpace(*begin)) begin++;
+	while (end != begin && isSpace(*(end - 1))) end--;
+	if (begin == end)
+		return false;
+
+	const char* p = begin;
+	bool negative = false;
+	if (*p == '-' || *p == '+')
+	{
+		negative = (*p == '-');
+		p++;
+	}
+
+	if (equalsNoCase(p, end, "nan"))
+	{
+		value = std::numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+	if (equalsNoCase(p, end, "inf") || equalsNoCase(p, end, "infinity"))
+	{
+		value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+		return true;
+	}
+
+	unsigned long long mantissa = 0;
+	int nbDigits = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+
+	for (; p != end && *p >= '0' && *p <= '9'; p++)
+	{
+		hasDigits = true;
+		if (mantissa == 0 && *p == '0') continue;
+		if (nbDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			nbDigits++;
+		}
+		else
+		{
+			exponent++;
+		}
+	}
+	if (p != end && *p == '.')
+	{
+		p++;
+		for (; p != end && *p >= '0' && *p <= '9'; p++)
+		{
+			hasDigits = true;
+			if (mantissa == 0 && *p == '0')
+			{
+				exponent--;
+				continue;
+			}
+			if (nbDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				nbDigits++;
+				exponent--;
+			}
+		}
+	}
+	if (!hasDigits)
+		return false;
+
+	if (p != end && (*p == 'e' || *p == 'E'))
+	{
+		p++;
+		bool negativeExp = false;
+		if (p != end && (*p == '-' || *p == '+'))
+		{
+			negativeExp = (*p == '-');
+			p++;
+		}
+		if (p == end || *p < '0' || *p > '9')
+			return false;
+
+		int exp = 0;
+		for (; p != end && *p >= '0' && *p <= '9'; p++)
+		{
+			if (exp < 10000) exp = exp * 10 + (*p - '0');
+		}
+		exponent += negativeExp ? -exp : exp;
+	}
+	if (p != end)
+		return false;
+
+	//exact for mantissas up to 2^53 and exponents representable as exact powers of 10
+	if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+	{
+		value = (double) mantissa;
+		value = (exponent < 0) ? value / pow10[-exponent] : value * pow10[exponent];
+		if (negative) value = -value;
+		return true;
+	}
+
+	//rare case, fall back to the locale independent stream parser
+	std::istringstream in(std::string(begin, end));
+	in.imbue(std::locale::classic());
+	in >> value;
+	return !in.fail();
+}
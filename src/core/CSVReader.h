@@ -0,0 +1,69 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file CSVReader.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QString>
+#include <vector>
+#include <functional>
+
+namespace xma
+{
+	/// Reads a comma separated file into memory once and gives access to its fields without
+	/// copying them. Numeric blocks are parsed in parallel chunks of rows.
+	class CSVReader
+	{
+	public:
+		CSVReader();
+		virtual ~CSVReader();
+
+		bool open(QString filename);
+		void clear();
+
+		int getNbRows() const;
+		int getNbColumns(int row) const;
+
+		QString getField(int row, int col) const;
+		bool getField(int row, int col, const char*& begin, const char*& end) const;
+
+		//Parses the rows [firstRow, getNbRows()) into a row-major table with nbColumns values per row.
+		//Missing, empty or unparsable fields are set to NaN. progress is called with values between 0 and 1
+		//from the worker threads.
+		void parseNumeric(int firstRow, int nbColumns, std::vector<double>& values, const std::function<void(double)>& progress = nullptr) const;
+
+		static bool parseDouble(const char* begin, const char* end, double& value);
+
+	private:
+		std::vector<char> buffer;
+		std::vector<size_t> lineBegin;
+		std::vector<size_t> lineEnd;
+
+		static const int chunkSize = 4096;
+	};
+}
+
+#endif // CSVREADER_H
@@ -0,0 +1,147 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file CSVWriter.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/CSVWriter.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace xma;
+
+CSVWriter::CSVWriter()
+{
+}
+
+CSVWriter::~CSVWriter()
+{
+}
+
+void CSVWriter::append(const char* text)
+{
+	buffer.append(text);
+}
+
+void CSVWriter::append(const std::string& text)
+{
+	buffer.append(text);
+}
+
+void CSVWriter::append(const QString& text)
+{
+	buffer.append(text.toStdString());
+}
+
+void CSVWriter::append(char c)
+{
+	buffer.push_back(c);
+}
+
+void CSVWriter::append(int value)
+{
+	char tmp[16];
+	std::to_chars_result result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+	buffer.append(tmp, result.ptr);
+}
+
+void CSVWriter::append(double value)
+{
+	char tmp[32];
+	buffer.append(tmp, formatDouble(tmp, value));
+}
+
+char* CSVWriter::formatDouble(char* out, double value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	//general format with precision 12 is specified to match printf("%.12g")
+	return std::to_chars(out, out + 32, value, std::chars_format::general, 12).ptr;
+#else
+	int length = std::snprintf(out, 32, "%.12g", value);
+	return out + std::max(0, std::min(length, 31));
+#endif
+}
+
+void CSVWriter::appendRows(int nbRows, const std::function<void(CSVWriter& writer, int row)>& formatRow)
+{
+	if (nbRows <= 0)
+		return;
+
+	int nbBlocks = (nbRows + rowsPerBlock - 1) / rowsPerBlock;
+	if (nbBlocks == 1)
+	{
+		for (int row = 0; row < nbRows; row++)
+			formatRow(*this, row);
+		return;
+	}
+
+	std::vector<CSVWriter> blocks(nbBlocks);
+	std::vector<int> blockIndices(nbBlocks);
+	for (int b = 0; b < nbBlocks; b++)
+		blockIndices[b] = b;
+
+	QtConcurrent::blockingMap(blockIndices, [&](const int& b)
+	{
+		int end = std::min(nbRows, (b + 1) * rowsPerBlock);
+		for (int row = b * rowsPerBlock; row < end; row++)
+			formatRow(blocks[b], row);
+	});
+
+	size_t size = buffer.size();
+	for (int b = 0; b < nbBlocks; b++)
+		size += blocks[b].buffer.size();
+	buffer.reserve(size);
+	for (int b = 0; b < nbBlocks; b++)
+		buffer.append(blocks[b].buffer);
+}
+
+void CSVWriter::reserve(size_t size)
+{
+	buffer.reserve(size);
+}
+
+void CSVWriter::clear()
+{
+	buffer.clear();
+}
+
+bool CSVWriter::write(const QString& filename) const
+{
+	std::ofstream outfile(filename.toStdString());
+	if (!outfile.is_open())
+		return false;
+
+	outfile.write(buffer.data(), buffer.size());
+	outfile.close();
+	return !outfile.fail();
+}
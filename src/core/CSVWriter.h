@@ -0,0 +1,73 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file CSVWriter.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <QString>
+#include <string>
+#include <functional>
+
+namespace xma
+{
+	/// Builds a comma separated file in memory and writes it with a single write. Numbers are
+	/// formatted like a std::ostream with precision 12, so files are identical to the ones written
+	/// with operator<<, but without the locale and stream overhead. Blocks of rows can be formatted
+	/// in parallel with appendRows.
+	class CSVWriter
+	{
+	public:
+		CSVWriter();
+		virtual ~CSVWriter();
+
+		void append(const char* text);
+		void append(const std::string& text);
+		void append(const QString& text);
+		void append(char c);
+		void append(int value);
+		void append(double value);
+
+		//Calls formatRow for the rows [0, nbRows) on blocks of rows in parallel and appends the rows in order
+		void appendRows(int nbRows, const std::function<void(CSVWriter& writer, int row)>& formatRow);
+
+		const std::string& getBuffer() const { return buffer; }
+		void reserve(size_t size);
+		void clear();
+
+		//Writes the buffer in text mode like the std::ofstream based exporters
+		bool write(const QString& filename) const;
+
+		//Formats value as printf("%.12g") into out, which needs room for 32 characters. Returns the end of the text.
+		static char* formatDouble(char* out, double value);
+
+	private:
+		std::string buffer;
+
+		static const int rowsPerBlock = 512;
+	};
+}
+
+#endif // CSVWRITER_H
@@ -33,8 +33,10 @@
 #include "core/Camera.h"
 #include "core/UndistortionObject.h"
 #include "core/HelperFunctions.h"
+#include "gl/OverlayBuffer.h"
 
 #include <QFileInfo>
+#include <QImageReader>
 #include <fstream>
 #include "Project.h"
 
@@ -42,19 +44,28 @@ using namespace xma;
 
 CalibrationImage::CalibrationImage(Camera* _camera, QString _imageFileName, bool createImage) : camera(_camera), imageFileName(_imageFileName), calibrated(0), nbInlier(0)
 {
-	if (createImage){
-		image = new Image(imageFileName, _camera->isFlipped());
-
-		width = image->getWidth();
-		height = image->getHeight();
-
-		undistortedImage = new Image(image);
+	hasImageFile = createImage;
+	undistortedImageValid = false;
+	image = NULL;
+	undistortedImage = NULL;
+	width = 0;
+	height = 0;
+
+	if (hasImageFile){
+		//only read the header, the image is decoded on first access
+		QImageReader reader(imageFileName);
+		QSize size = reader.size();
+		if (size.isValid())
+		{
+			width = size.width();
+			height = size.height();
+		}
+		else
+		{
+			loadImage();
+			releaseImages();
+		}
 	} 
-	else
-	{
-		image = NULL;
-		undistortedImage = NULL;
-	}
 
 	rotationvector.create(3, 1,CV_64F);
 	translationvector.create(3, 1,CV_64F);
@@ -63,13 +74,18 @@ CalibrationImage::CalibrationImage(Camera* _camera, QString _imageFileName, bool
 
 CalibrationImage::~CalibrationImage()
 {
-	if(image) delete image;
-	if (undistortedImage) delete undistortedImage;
+	releaseImages();
 
 	rotationvector.release();
 	translationvector.release();
 }
 
+void CalibrationImage::setCalibrated(int value)
+{
+	calibrated = value;
+	camera->setDirty();
+}
+
 void CalibrationImage::reset()
 {
 	rotationvector.release();
@@ -102,6 +118,108 @@ QString CalibrationImage::getFilenameBase()
 	return info.completeBaseName();
 }
 
+Image* CalibrationImage::getImage()
+{
+	if (hasImageFile && !image)
+		loadImage();
+
+	return image;
+}
+
+Image* CalibrationImage::getUndistortedImage()
+{
+	if (hasImageFile && (!undistortedImage || !undistortedImageValid))
+		updateUndistortedImage();
+
+	return undistortedImage;
+}
+
+bool CalibrationImage::isLoaded()
+{
+	return image != NULL;
+}
+
+void CalibrationImage::releaseImages()
+{
+	if (image) delete image;
+	if (undistortedImage) delete undistortedImage;
+	image = NULL;
+	undistortedImage = NULL;
+	undistortedImageValid = false;
+}
+
+void CalibrationImage::invalidateUndistortedImage()
+{
+	undistortedImageValid = false;
+}
+
+size_t CalibrationImage::getMemorySize()
+{
+	size_t size = 0;
+	if (image) size += image->getMemorySize();
+	if (undistortedImage) size += undistortedImage->getMemorySize();
+	return size;
+}
+
+void CalibrationImage::loadImage()
+{
+	image = new Image(imageFileName, camera->isFlipped());
+
+	width = image->getWidth();
+	height = image->getHeight();
+}
+
+void CalibrationImage::updateUndistortedImage()
+{
+	Image* source = getImage();
+	if (!undistortedImage)
+		undistortedImage = new Image(source);
+	undistortedImageValid = true;
+
+	undistortImage(source, undistortedImage);
+}
+
+void CalibrationImage::undistortImage(Image* source, Image* target)
+{
+	if (Project::getInstance()->getCalibration() != INTERNAL)
+		return;
+
+	cv::Mat imageMat;
+	if (camera->getUndistortionObject() && camera->getUndistortionObject()->isComputed())
+	{
+		camera->getUndistortionObject()->undistort(source, target);
+		if (!camera->hasModelDistortion())
+			return;
+		target->getImage(imageMat);
+	}
+	else
+	{
+		source->getImage(imageMat);
+	}
+
+	if (camera->hasModelDistortion())
+	{
+		cv::remap(imageMat, imageMat, *camera->getUndistortionMapX(), *camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
+	}
+	target->setImage(imageMat);
+	imageMat.release();
+}
+
+void CalibrationImage::decodeImage(cv::Mat& _image, bool undistorted)
+{
+	//decodes into local images so the cached ones are left untouched
+	Image source(imageFileName, camera->isFlipped());
+	if (!undistorted)
+	{
+		source.getImage(_image);
+		return;
+	}
+
+	Image target(&source);
+	undistortImage(&source, &target);
+	target.getImage(_image);
+}
+
 void CalibrationImage::loadTextures()
 {
 	if (Project::getInstance()->getCalibration() != INTERNAL)
@@ -142,11 +260,13 @@ void CalibrationImage::init(int nbPoints)
 
 void CalibrationImage::setDetectedPoints(std::vector<cv::Point2d>& points)
 {
+	camera->setDirty();
 	detectedPoints_ALL = points;
 }
 
 void CalibrationImage::setPointsUndistorted(std::vector<cv::Point2d>& _detectedPoints, std::vector<cv::Point2d>& _projectedPoints, std::vector<bool>& _Inlier)
 {
+	camera->setDirty();
 	detectedPointsUndistorted = _detectedPoints;
 	projectedPointsUndistorted = _projectedPoints;
 
@@ -238,6 +358,7 @@ void CalibrationImage::computeError()
 
 void CalibrationImage::setMatrices(cv::Mat& _rotationvector, cv::Mat& _translationvector)
 {
+	camera->setDirty();
 	rotationvector = _rotationvector.clone();
 	translationvector = _translationvector.clone();
 	setCalibrated(1);
@@ -254,37 +375,37 @@ cv::Mat CalibrationImage::getTranslationVector()
 }
 
 
-void CalibrationImage::drawPoints(std::vector<cv::Point2d>& points, bool drawAllPoints)
+void CalibrationImage::drawPoints(std::vector<cv::Point2d>& points, OverlayBuffer& overlay, bool drawAllPoints)
 {
 	if (points.size() != Inlier.size()) return;
 
 	std::vector<int>::const_iterator it_inlier = Inlier.begin();
-	glBegin(GL_LINES);
+	overlay.begin(GL_LINES);
 	for (std::vector<cv::Point2d>::const_iterator it = points.begin(); it != points.end(); ++it,++it_inlier)
 	{
 		if ((*it_inlier) == 1)
 		{
-			glColor3f(0.0, 1.0, 0.0);
+			overlay.color(0.0f, 1.0f, 0.0f);
 		}
 		else if ((*it_inlier) == 0)
 		{
-			glColor3f(1.0, 0.0, 0.0);
+			overlay.color(1.0f, 0.0f, 0.0f);
 		}
 		else if ((*it_inlier) == -1)
 		{
-			glColor3f(0.0, 0.0, 1.0);
+			overlay.color(0.0f, 0.0f, 1.0f);
 			if (!drawAllPoints)continue;
 		}
 
-		glVertex2f((*it).x - 5, (*it).y);
-		glVertex2f((*it).x + 5, (*it).y);
-		glVertex2f((*it).x, (*it).y - 5);
-		glVertex2f((*it).x, (*it).y + 5);
+		overlay.vertex((*it).x - 5, (*it).y);
+		overlay.vertex((*it).x + 5, (*it).y);
+		overlay.vertex((*it).x, (*it).y - 5);
+		overlay.vertex((*it).x, (*it).y + 5);
 	}
-	glEnd();
+	overlay.end();
 }
 
-void CalibrationImage::draw(int type)
+void CalibrationImage::draw(int type, OverlayBuffer& overlay)
 {
 	//if(isCalibrated() <= 0) return;
 
@@ -294,28 +415,28 @@ void CalibrationImage::draw(int type)
 	default:
 		break;
 	case 1:
-		glColor3f(1.0, 0.0, 0.0);
-		glBegin(GL_LINES);
+		overlay.color(1.0f, 0.0f, 0.0f);
+		overlay.begin(GL_LINES);
 		for (std::vector<cv::Point2d>::const_iterator it = detectedPoints_ALL.begin(); it != detectedPoints_ALL.end(); ++it)
 		{
-			glVertex2f((*it).x - 2, (*it).y);
-			glVertex2f((*it).x + 2, (*it).y);
-			glVertex2f((*it).x, (*it).y - 2);
-			glVertex2f((*it).x, (*it).y + 2);
+			overlay.vertex((*it).x - 2, (*it).y);
+			overlay.vertex((*it).x + 2, (*it).y);
+			overlay.vertex((*it).x, (*it).y - 2);
+			overlay.vertex((*it).x, (*it).y + 2);
 		}
-		glEnd();
+		overlay.end();
 		break;
 	case 2:
-		drawPoints(detectedPoints);
+		drawPoints(detectedPoints, overlay);
 		break;
 	case 3:
-		drawPoints(projectedPoints, true);
+		drawPoints(projectedPoints, overlay, true);
 		break;
 	case 4:
-		drawPoints(detectedPointsUndistorted);
+		drawPoints(detectedPointsUndistorted, overlay);
 		break;
 	case 5:
-		drawPoints(projectedPointsUndistorted, true);
+		drawPoints(projectedPointsUndistorted, overlay, true);
 		break;
 	}
 }
@@ -420,6 +541,7 @@ void CalibrationImage::bindTexture(int type)
 
 void CalibrationImage::toggleInlier(double x, double y, bool isDistortedView)
 {
+	camera->setDirty();
 	int idx = -1;
 	double mindist = 20;
 	double dist;
@@ -465,6 +587,7 @@ void CalibrationImage::toggleInlier(double x, double y, bool isDistortedView)
 
 void CalibrationImage::setInlier(int idx, bool value)
 {
+	camera->setDirty();
 	if (value)
 	{
 		Inlier[idx] = 1;
@@ -478,6 +601,7 @@ void CalibrationImage::setInlier(int idx, bool value)
 
 void CalibrationImage::setPoint(int idx, double x, double y, bool distorted)
 {
+	camera->setDirty();
 	if (distorted)
 	{
 		detectedPoints[idx].x = x;
@@ -494,6 +618,7 @@ void CalibrationImage::setPoint(int idx, double x, double y, bool distorted)
 
 void CalibrationImage::setPointManual(double x, double y, bool isDistortedView)
 {
+	camera->setDirty();
 	int idx = -1;
 	double mindist = 20;
 	double dist;
@@ -777,6 +902,7 @@ void CalibrationImage::loadTranslationVector(QString filename)
 
 void CalibrationImage::sortGridByReference(double x, double y)
 {
+	camera->setDirty();
 	Inlier.clear();
 	detectedPoints.clear();
 	detectedPointsUndistorted.clear();
@@ -35,6 +35,7 @@ namespace xma
 {
 	class Camera;
 	class Image;
+	class OverlayBuffer;
 
 	class CalibrationImage
 	{
@@ -57,25 +58,22 @@ namespace xma
 		QString getFilename();
 		QString getFilenameBase();
 
-		Image* getImage()
-		{ 
-			return image;
-		}
-
-		Image* getUndistortedImage()
-		{
-			return undistortedImage;
-		}
+		//images are decoded and undistorted on first access
+		Image* getImage();
+		Image* getUndistortedImage();
+		bool isLoaded();
+		void releaseImages();
+		void invalidateUndistortedImage();
+		//decodes without caching, does not modify the image
+		void decodeImage(cv::Mat& image, bool undistorted);
+		size_t getMemorySize();
 
 		int isCalibrated()
 		{
 			return calibrated;
 		}
 
-		void setCalibrated(int value)
-		{
-			calibrated = value;
-		}
+		void setCalibrated(int value);
 
 		void loadTextures();
 		void reloadTextures();
@@ -121,7 +119,7 @@ namespace xma
 		cv::Mat getRotationVector();
 		cv::Mat getTranslationVector();
 
-		void draw(int type);
+		void draw(int type, OverlayBuffer& overlay);
 		void getDrawTextData(int type, bool distorted, std::vector<double>& x, std::vector<double>& y, std::vector<QString>& text, std::vector<bool>& inlier);
 		void bindTexture(int type);
 
@@ -159,7 +157,7 @@ namespace xma
 	private:
 		void savePoints(std::vector<cv::Point2d>& points, QString filename);
 		void loadPoints(std::vector<cv::Point2d>& points, QString filename);
-		void drawPoints(std::vector<cv::Point2d>& points, bool drawAllPoints = false);
+		void drawPoints(std::vector<cv::Point2d>& points, OverlayBuffer& overlay, bool drawAllPoints = false);
 		void computeError();
 		int calibrated;
 
@@ -169,6 +167,11 @@ namespace xma
 		QString imageFileName;
 
 		//Images
+		void loadImage();
+		void updateUndistortedImage();
+		void undistortImage(Image* source, Image* target);
+		bool hasImageFile;
+		bool undistortedImageValid;
 		Image* image;
 		Image* undistortedImage;
 
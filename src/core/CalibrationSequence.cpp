@@ -82,6 +82,8 @@ void CalibrationSequence::deleteFrame(int id)
 		calibrationImages[id]->init(CalibrationObject::getInstance()->getFrameSpecifications().size());
 	}
 	else{
+		QMutexLocker locker(&cacheMutex);
+		cachedImages.remove(calibrationImages[id]);
 		delete calibrationImages[id];
 		calibrationImages.erase(calibrationImages.begin() + id);
 	}
@@ -156,9 +158,6 @@ void CalibrationSequence::save(QString folder)
 {
 	for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
 	{
-		if (!sequence && (Project::getInstance()->getCalibration() == INTERNAL)) 
-			(*it)->getImage()->save(folder + (*it)->getFilename(),m_camera->isFlipped());
-		
 		if ((*it)->isCalibrated() > 0)
 		{
 			(*it)->savePointsInlier(folder + "data" + OS_SEP + (*it)->getFilenamePointsInlier());
@@ -170,6 +169,20 @@ void CalibrationSequence::save(QString folder)
 	}
 }
 
+void CalibrationSequence::saveImages(QString folder)
+{
+	if (sequence || Project::getInstance()->getCalibration() != INTERNAL)
+		return;
+
+	for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
+	{
+		QMutexLocker locker(&cacheMutex);
+		bool cached = (*it)->isLoaded();
+		(*it)->getImage()->save(folder + (*it)->getFilename(),m_camera->isFlipped());
+		if (!cached) (*it)->releaseImages();
+	}
+}
+
 void CalibrationSequence::loadTextures()
 { 
 	if (!sequence_filename.isEmpty() && sequence == NULL)
@@ -200,13 +213,7 @@ void CalibrationSequence::loadTextures()
 		}
 		undistortedImage->resetImage();
 	}
-	else if (!sequence){
-		for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
-		{
-			(*it)->loadTextures();
-			QApplication::processEvents();
-		}
-	}
+	//textures of image files are created when the frame is displayed
 }
 
 void CalibrationSequence::reloadTextures()
@@ -226,34 +233,14 @@ void CalibrationSequence::undistort()
 	if (Project::getInstance()->getCalibration() != INTERNAL)
 		return;
 
-	if (!sequence){
-		if (m_camera->getUndistortionObject() && m_camera->getUndistortionObject()->isComputed())
-		{
-			for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
-			{
-				m_camera->getUndistortionObject()->undistort((*it)->getImage(), (*it)->getUndistortedImage());
-				if (m_camera->hasModelDistortion())
-				{
-					cv::Mat imageMat;
-					(*it)->getUndistortedImage()->getImage(imageMat);
-					cv::remap(imageMat, imageMat, *m_camera->getUndistortionMapX(), *m_camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-					(*it)->getUndistortedImage()->setImage(imageMat);
-					imageMat.release();
-				}
-			}
-		}
-		else if (m_camera->hasModelDistortion())
-		{
-			for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
-			{			
-				cv::Mat imageMat;
-				(*it)->getImage()->getImage(imageMat);
-				cv::remap(imageMat, imageMat, *m_camera->getUndistortionMapX(), *m_camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-				(*it)->getUndistortedImage()->setImage(imageMat);
-				imageMat.release();
-			}
-		}
+	//undistorted images are recomputed on their next access
+	cacheMutex.lock();
+	for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
+	{
+		(*it)->invalidateUndistortedImage();
 	}
+	lastUndistorted = -1;
+	cacheMutex.unlock();
 
 	for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
 	{
@@ -263,7 +250,9 @@ void CalibrationSequence::undistort()
 
 Image* CalibrationSequence::getImage(int id, bool dist)
 {
+	QMutexLocker locker(&cacheMutex);
 	if (!sequence){
+		touchImage(calibrationImages[id]);
 		if (dist)
 		{
 			return calibrationImages[id]->getImage();
@@ -288,10 +277,52 @@ Image* CalibrationSequence::getImage(int id, bool dist)
 	}
 }
 
+void CalibrationSequence::getImage(int id, bool dist, cv::Mat& image)
+{
+	QMutexLocker locker(&cacheMutex);
+	if (!sequence){
+		if (calibrationImages[id]->isLoaded())
+		{
+			if (dist)
+			{
+				calibrationImages[id]->getImage()->getImage(image);
+			}
+			else
+			{
+				calibrationImages[id]->getUndistortedImage()->getImage(image);
+			}
+			return;
+		}
+		locker.unlock();
+		calibrationImages[id]->decodeImage(image, !dist);
+	}
+	else{
+		sequence->setActiveFrame(id);
+		if (dist)
+		{
+			sequence->getImage()->getImage(image);
+		}
+		else if (lastUndistorted == id)
+		{
+			undistortedImage->getImage(image);
+		}
+		else
+		{
+			//only the stream access is shared, the undistortion works on a copy
+			Image source(sequence->getImage());
+			locker.unlock();
+			undistortImage(&source, image);
+		}
+	}
+}
+
 void CalibrationSequence::bindTexture(int id, int type)
 {
+	QMutexLocker locker(&cacheMutex);
 	if (!sequence){
+		touchImage(calibrationImages[id]);
 		calibrationImages[id]->bindTexture(type);
+		trimCache(calibrationImages[id]);
 	} 
 	else
 	{
@@ -317,6 +348,33 @@ void CalibrationSequence::bindTexture(int id, int type)
 	}
 }
 
+void CalibrationSequence::touchImage(CalibrationImage* image)
+{
+	cachedImages.remove(image);
+	cachedImages.push_front(image);
+}
+
+void CalibrationSequence::trimCache(CalibrationImage* keep)
+{
+	size_t budget = (size_t) Settings::getInstance()->getIntSetting("CalibrationImageCacheSize") * 1024 * 1024;
+	size_t size = 0;
+	for (std::list<CalibrationImage*>::const_iterator it = cachedImages.begin(); it != cachedImages.end(); ++it)
+	{
+		size += (*it)->getMemorySize();
+	}
+
+	while (size > budget && cachedImages.size() > 1)
+	{
+		CalibrationImage* image = cachedImages.back();
+		if (image == keep)
+			break;
+
+		size -= image->getMemorySize();
+		image->releaseImages();
+		cachedImages.pop_back();
+	}
+}
+
 bool CalibrationSequence::hasCalibrationSequence()
 {
 	return (sequence != NULL);
@@ -346,31 +404,27 @@ void CalibrationSequence::undstortSequenceImage(int id)
 	if (lastUndistorted == id) return;
 	lastUndistorted = id;
 
+	cv::Mat imageMat;
+	undistortImage(sequence->getImage(), imageMat);
+	undistortedImage->setImage(imageMat);
+	imageMat.release();
+}
+
+void CalibrationSequence::undistortImage(Image* source, cv::Mat& image)
+{
 	if (m_camera->getUndistortionObject() && m_camera->getUndistortionObject()->isComputed())
 	{
-		for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
-		{
-			m_camera->getUndistortionObject()->undistort(sequence->getImage(), undistortedImage);
-
-			if (m_camera->hasModelDistortion())
-			{
-				cv::Mat imageMat;
-				undistortedImage->getImage(imageMat);
-				cv::remap(imageMat, imageMat, *m_camera->getUndistortionMapX(), *m_camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-				undistortedImage->setImage(imageMat);
-				imageMat.release();
-			}
-		}
+		Image undistorted(source);
+		m_camera->getUndistortionObject()->undistort(source, &undistorted);
+		undistorted.getImage(image);
 	}
-	else if (m_camera->hasModelDistortion())
+	else
 	{
-		for (std::vector<CalibrationImage*>::iterator it = calibrationImages.begin(); it != calibrationImages.end(); ++it)
-		{
-			cv::Mat imageMat;
-			sequence->getImage()->getImage(imageMat);
-			cv::remap(imageMat, imageMat, *m_camera->getUndistortionMapX(), *m_camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-			undistortedImage->setImage(imageMat);
-			imageMat.release();
-		}
+		source->getImage(image);
+	}
+
+	if (m_camera->hasModelDistortion())
+	{
+		cv::remap(image, image, *m_camera->getUndistortionMapX(), *m_camera->getUndistortionMapY(), cv::INTER_LANCZOS4, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
 	}
 }
@@ -29,9 +29,11 @@
 
 #include <QString>
 #include <QStringList>
+#include <QMutex>
 
 #include <opencv2/opencv.hpp>
 #include <fstream>
+#include <list>
 
 namespace xma
 {
@@ -60,11 +62,14 @@ namespace xma
 		CalibrationImage* addImage(QString fileName);
 
 		void save(QString folder);
+		void saveImages(QString folder);
 		void loadTextures();
 		void reloadTextures();
 
 		void undistort();
 		Image* getImage(int id, bool dist);
+		//thread safe copy of an image, frames which are not cached are released again after the copy
+		void getImage(int id, bool dist, cv::Mat& image);
 		void bindTexture(int id, int type);
 
 		bool hasCalibrationSequence();
@@ -80,9 +85,16 @@ namespace xma
 		Camera* m_camera;
 
 		void undstortSequenceImage(int id);
+		void undistortImage(Image* source, cv::Mat& image);
+		void touchImage(CalibrationImage* image);
+		void trimCache(CalibrationImage* keep);
 		Image* undistortedImage;
 		int lastUndistorted; 
 		QString sequence_filename;
+
+		//least recently used decoded images, most recent first
+		std::list<CalibrationImage*> cachedImages;
+		QMutex cacheMutex;
 	};
 }
 
@@ -74,6 +74,8 @@ Camera::Camera(QString cameraName, int _id) : visible(true), portal_id(-1)
 	updateInfoRequired = false;
 	optimized = false;
 	flipped = false;
+	dirty = true;
+	revision = 0;
 }
 
 Camera::~Camera()
@@ -97,6 +99,7 @@ void Camera::setVisible(bool value)
 
 void Camera::reset()
 {
+	setDirty();
 	cameramatrix.release();
 	cameramatrix.create(3, 3, CV_64F);
 	setCalibrated(false);
@@ -108,6 +111,7 @@ void Camera::reset()
 
 void Camera::deleteFrame(int id)
 {
+	setDirty();
 	calibrationSequence->deleteFrame(id);
 }
 
@@ -201,6 +205,7 @@ cv::Mat* Camera::getUndistortionMapY()
 
 void Camera::setCalibrationSequence(QString filename, int nbImages, int width, int height)
 {
+	setDirty();
 	calibrationSequence->setCalibrationSequence(filename, nbImages, width, height);
 }
 
@@ -233,16 +238,19 @@ double Camera::getCalibrationError()
 
 void Camera::loadImages(QStringList fileNames)
 {
+	setDirty();
 	calibrationSequence->loadImages(fileNames);
 }
 
 CalibrationImage* Camera::addImage(QString fileName)
 {
+	setDirty();
 	return calibrationSequence->addImage(fileName);
 }
 
 void Camera::loadUndistortionImage(QString undistortionImage)
 {
+	setDirty();
 	undistortionObject = new UndistortionObject(this, undistortionImage);
 }
 
@@ -281,6 +289,7 @@ CalibrationSequence* Camera::getCalibrationSequence()
 
 void Camera::setPortalId(int value)
 {
+	setDirty();
 	name = "Camera " + QString::number(value);
 	portal_id = value;
 }
@@ -301,7 +310,6 @@ void Camera::save(QString folder)
 
 	if (undistortionObject)
 	{
-		undistortionObject->getImage()->save(folder + undistortionObject->getFilename(), isFlipped());
 		if (undistortionObject->isComputed())
 		{
 			undistortionObject->savePointsDetected(folder + "data" + OS_SEP + undistortionObject->getFilenamePointsDetected());
@@ -314,6 +322,14 @@ void Camera::save(QString folder)
 	calibrationSequence->save(folder);
 }
 
+void Camera::saveImages(QString folder)
+{
+	if (undistortionObject)
+		undistortionObject->getImage()->save(folder + undistortionObject->getFilename(), isFlipped());
+
+	calibrationSequence->saveImages(folder);
+}
+
 void Camera::loadTextures()
 {
 	if (undistortionObject)
@@ -347,12 +363,14 @@ void Camera::undistort()
 
 void Camera::setCalibrated(bool value)
 {
+	setDirty();
 	calibrated = value;
 	Project::getInstance()->checkCalibration();
 }
 
 void Camera::setCameraMatrix(cv::Mat& _cameramatrix)
 {
+	setDirty();
 	cameramatrix = _cameramatrix.clone();
 	setCalibrated(true);
 }
@@ -364,6 +382,7 @@ cv::Mat Camera::getCameraMatrix()
 
 void Camera::setDistortionCoefficiants(cv::Mat& _distortion_coeff)
 {
+	setDirty();
 	distortion_coeffs = _distortion_coeff.clone();
 	cv::initUndistortRectifyMap(cameramatrix, distortion_coeffs, cv::Mat(), cameramatrix, cv::Size(width, height), CV_32FC1, undistortionMapX, undistortionMapY);
 	model_distortion = true;
@@ -372,6 +391,7 @@ void Camera::setDistortionCoefficiants(cv::Mat& _distortion_coeff)
 
 void Camera::resetDistortion()
 {
+	setDirty();
 	if (model_distortion)
 	{
 		distortion_coeffs = cv::Mat::zeros(8, 1, CV_64F);
@@ -428,6 +448,7 @@ void Camera::saveCameraMatrix(QString filename)
 
 void Camera::loadCameraMatrix(QString filename)
 {
+	setDirty();
 	std::vector<std::vector<double> > values;
 	std::ifstream fin(filename.toStdString());
 	std::istringstream in;
@@ -481,6 +502,7 @@ void Camera::saveUndistortionParam(QString filename)
 
 void Camera::loadUndistortionParam(QString filename)
 {
+	setDirty();
 	std::vector<std::vector<double> > values;
 	std::ifstream fin(filename.toStdString());
 	std::istringstream in;
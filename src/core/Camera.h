@@ -30,6 +30,7 @@
 #include <QString>
 #include <QStringList>
 #include <vector>
+#include <atomic>
 
 #include <opencv2/opencv.hpp>
 
@@ -108,7 +109,9 @@ namespace xma
 		void setPortalId(int value);
 		const int &getPortalId();
 
+		//The images are written separately by saveImages, which can be called from a worker thread
 		void save(QString folder);
+		void saveImages(QString folder);
 		void loadTextures();
 		void reloadTextures();
 
@@ -171,8 +174,30 @@ namespace xma
 
 		void setFlipped(bool value)
 		{
+			//images are saved flipped
+			if (flipped != value)
+				setDirty();
 			flipped = value;
 		}
+
+		//Changed since the project was last saved or loaded, including its calibration images and undistortion.
+		//Unchanged cameras are copied from the previous archive when saving.
+		bool isDirty()
+		{
+			return dirty;
+		}
+
+		void setDirty(bool value = true)
+		{
+			dirty = value;
+			if (value) revision++;
+		}
+
+		//Incremented on every change, used to detect changes independent of saving
+		int getRevision()
+		{
+			return revision;
+		}
 		
 
 		QString getFilenameCameraMatrix();
@@ -227,6 +252,8 @@ namespace xma
 		cv::Mat undistortionMapY;
 
 		bool visible;
+		bool dirty;
+		std::atomic<int> revision;
 	};
 }
 
@@ -157,14 +157,36 @@ void readAndAdvance(T* output, char* & ptr, int length)
 CineVideo::CineVideo(QStringList _filenames) : VideoStream(_filenames)
 {
 	lastFrame = -1;
+}
+
+CineVideo::~CineVideo()
+{
+	close();
+}
+
+void CineVideo::openFile()
+{
 	fileStream = std::make_unique<std::ifstream>(filenames.at(0).toStdString(), std::ifstream::binary);
 	loadCineInfo();
+	//loadCineInfo decodes the first frame
+	lastFrame = 0;
+	if (activeFrame != 0)
+		readFrame(activeFrame);
+	updateMemoryUsage();
 }
 
-CineVideo::~CineVideo()
+void CineVideo::closeFile()
 {
 	if (fileStream && fileStream->is_open())
 		fileStream->close();
+	fileStream.reset();
+	image_addresses.clear();
+	lastFrame = -1;
+}
+
+VideoStream* CineVideo::createStream(QStringList _filenames)
+{
+	return new CineVideo(_filenames);
 }
 
 void CineVideo::unpackImageData(char* packed, unsigned char* unpacked)
@@ -673,7 +695,7 @@ void CineVideo::loadCineInfo()
 			if (isFlipped)
 				cv::flip(imageWithData, imageWithData, 1);
 
-			image->setImage(imageWithData);
+			setDecodedImage(imageWithData);
 			imageWithData.release();
 		}
 
@@ -685,9 +707,16 @@ void CineVideo::loadCineInfo()
 
 void CineVideo::setActiveFrame(int _activeFrame)
 {
+	activeFrame = _activeFrame;
+	open();
 	if (lastFrame == _activeFrame)
 		return;
 
+	readFrame(_activeFrame);
+}
+
+void CineVideo::readFrame(int _activeFrame)
+{
 	lastFrame = _activeFrame;
 	if (!fileStream || !fileStream->is_open())
 		return;
@@ -724,19 +753,12 @@ void CineVideo::setActiveFrame(int _activeFrame)
 		cv::flip(imageWithData, imageWithData, 0);
 		if (isFlipped)
 			cv::flip(imageWithData, imageWithData, 1);
-		image->setImage(imageWithData, false);
+		setDecodedImage(imageWithData);
 		imageWithData.release();
+		updateMemoryUsage();
 	}
 }
 
-void CineVideo::reloadFile()
-{
-	if (fileStream && fileStream->is_open())
-		fileStream->close();
-	fileStream = std::make_unique<std::ifstream>(filenames.at(0).toStdString(), std::ifstream::binary);
-	loadCineInfo();
-}
-
 QString CineVideo::getFrameName(int frameNumber)
 {
     QFileInfo info(filenames.at(0));
@@ -59,7 +59,12 @@ namespace xma
 
 		void setActiveFrame(int _activeFrame) override;
 		QString getFrameName(int frameNumber) override;
-		void reloadFile() override;
+
+	protected:
+		void openFile() override;
+		void closeFile() override;
+		VideoStream* createStream(QStringList _filenames) override;
+
 	private:
 		//IMAGE POSITIONS
 		std::vector<unsigned long long> image_addresses;
@@ -68,6 +73,7 @@ namespace xma
 		void unpackImageData(char* packed, unsigned char* unpacked);
 
 		void loadCineInfo();
+		void readFrame(int _activeFrame);
 
 		int lastFrame;
 
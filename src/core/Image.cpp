@@ -37,6 +37,7 @@
 #include <QFileInfo>
 #include "Project.h"
 #include "Settings.h"
+#include "Tracer.h"
 #include "ui/State.h"
 #include "processing/FilterImage.h"
 
@@ -223,11 +224,25 @@ void Image::resetImage()
 	image_reset = true;
 }
 
+void Image::releaseImage()
+{
+	image.release();
+	image_color.release();
+	image_color_disp.release();
+	image_reset = true;
+}
+
+size_t Image::getMemorySize()
+{
+	return image.total() * image.elemSize() + image_color.total() * image_color.elemSize() + image_color_disp.total() * image_color_disp.elemSize();
+}
+
 void Image::loadTexture()
 {
 	cv::Mat  * tex_image = &image_color;
 	if (!textureLoaded || image_reset)
 	{
+		XMA_TRACE_SCOPE("GLTextureUpload");
 		//if (!textureLoaded)((QGLContext*)(GLSharedWidget::getInstance()->getQGLContext()))->makeCurrent();
 
 		if (colorImage_set != COLOR_ORIGINAL || (Settings::getInstance()->getBoolSetting("VisualFilterEnabled") && State::getInstance()->getWorkspace() == DIGITIZATION && !Settings::getInstance()->getBoolSetting("TrialDrawHideAll")))
@@ -78,6 +78,9 @@ namespace xma
 		void setImage(cv::Mat& image, bool _color = false);
 		void setImage(QString imageFileName, bool flip);
 		void resetImage();
+		//Frees the pixel data, the size is kept
+		void releaseImage();
+		size_t getMemorySize();
 
 	private:
 		cv::Mat image;
@@ -36,28 +36,46 @@ using namespace xma;
 ImageSequence::ImageSequence(QStringList _filenames): VideoStream(_filenames)
 {
 	nbImages = filenames.size();
-
-	image = new Image(filenames.at(0), isFlipped);
 }
 
 ImageSequence::~ImageSequence()
 {
+	close();
 }
 
 void ImageSequence::setActiveFrame(int _activeFrame)
 {
-	image->setImage(filenames.at(_activeFrame),isFlipped);
+	bool wasOpen = isOpen();
+	activeFrame = _activeFrame;
+	open();
+	if (wasOpen)
+	{
+		image->setImage(filenames.at(_activeFrame), isFlipped);
+		nbDecodedFrames++;
+		updateMemoryUsage();
+	}
 }
 
+void ImageSequence::openFile()
+{
+	image->setImage(filenames.at(activeFrame), isFlipped);
+	nbDecodedFrames++;
+	updateMemoryUsage();
+}
 
-QString ImageSequence::getFrameName(int frameNumber)
+void ImageSequence::closeFile()
 {
-	QFileInfo info(filenames.at(frameNumber));
-	return info.fileName();
 }
 
-void ImageSequence::reloadFile()
+VideoStream* ImageSequence::createStream(QStringList _filenames)
 {
-	image->setImage(filenames.at(0), isFlipped);
+	return new ImageSequence(_filenames);
+}
+
+
+QString ImageSequence::getFrameName(int frameNumber)
+{
+	QFileInfo info(filenames.at(frameNumber));
+	return info.fileName();
 }
 
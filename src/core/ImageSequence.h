@@ -39,8 +39,11 @@ namespace xma
 
 		void setActiveFrame(int _activeFrame) override;
 		QString getFrameName(int frameNumber) override;
-		void reloadFile() override;
-	private:
+
+	protected:
+		void openFile() override;
+		void closeFile() override;
+		VideoStream* createStream(QStringList _filenames) override;
 	};
 }
 
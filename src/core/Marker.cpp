@@ -32,20 +32,38 @@
 #include "core/Project.h"
 #include "core/Camera.h"
 #include "core/Trial.h"
+#include "core/RigidBody.h"
 #include "core/HelperFunctions.h"
+#include "core/CSVWriter.h"
+#include "core/Tracer.h"
 
-#include "processing/ButterworthLowPassFilter.h" //should move this dependency
+#include "processing/FilterBank.h" //should move this dependency
 #include "processing/cubic.h" //should move this dependency
+#include "processing/MotionPredictor.h" //should move this dependency
 
 #include <fstream>
+#include <algorithm>
+#include <limits>
 #include "Settings.h"
 
 using namespace xma;
 
+namespace
+{
+	//number of previous frames used for the motion prediction
+	const int predictionWindow = 10;
+	//measurement and process noise of the prediction in pixel and mm
+	const double predictionNoise2D = 0.25;
+	const double predictionProcessNoise2D = 0.05;
+	const double predictionNoise3D = 0.01;
+	const double predictionProcessNoise3D = 0.01;
+}
+
 Marker::Marker(int nbCameras, int size, Trial* _trial)
 {
-	init(nbCameras, size);
 	trial = _trial;
+	storeSlot = -1;
+	init(nbCameras, size);
 	meanSize = -1;
 	thresholdOffset = Settings::getInstance()->getIntSetting("DefaultMarkerThreshold");
 	sizeOverride = -1;
@@ -55,6 +73,39 @@ Marker::Marker(int nbCameras, int size, Trial* _trial)
 	//interpolation = 0;
 	requiresRecomputation = true;
 	hasInterpolation = false;
+	dirty = true;
+	resetTrackingStatistics();
+}
+
+Marker::Marker(const Marker& marker, MarkerStore* snapshotStore)
+{
+	trial = marker.trial;
+	description = marker.description;
+	storeSlot = -1;
+
+	points2D = MarkerPoints2DView(snapshotStore, marker.storeSlot);
+	points2D_projected = MarkerProjectedView(snapshotStore, marker.storeSlot);
+	status2D = MarkerStatus2DView(snapshotStore, marker.storeSlot);
+	error2D = MarkerError2DView(snapshotStore, marker.storeSlot);
+	markerSize = MarkerSizeView(snapshotStore, marker.storeSlot);
+
+	points3D = MarkerPoints3DView(snapshotStore, marker.storeSlot);
+	status3D = MarkerStatus3DView(snapshotStore, marker.storeSlot);
+	error3D = MarkerError3DView(snapshotStore, marker.storeSlot);
+
+	interpolation = marker.interpolation;
+	hasInterpolation = marker.hasInterpolation;
+	meanSize = marker.meanSize;
+	sizeRange = marker.sizeRange;
+	thresholdOffset = marker.thresholdOffset;
+	sizeOverride = marker.sizeOverride;
+	maxPenalty = marker.maxPenalty;
+	method = marker.method;
+	point3D_ref_set = marker.point3D_ref_set;
+	point3D_ref = marker.point3D_ref;
+	requiresRecomputation = marker.requiresRecomputation;
+	dirty = marker.dirty;
+	resetTrackingStatistics();
 }
 
 Marker::~Marker()
@@ -64,6 +115,7 @@ Marker::~Marker()
 
 void Marker::setDescription(QString _description)
 {
+	setDirty();
 	description = _description;
 }
 
@@ -72,33 +124,34 @@ QString Marker::getDescription()
 	return description;
 }
 
-const std::vector<std::vector<markerStatus> >& Marker::getStatus2D()
+const MarkerStatus2DView& Marker::getStatus2D()
 {
 	return status2D;
 }
 
-std::vector<std::vector<cv::Point2d> >& Marker::getPoints2D()
+const MarkerPoints2DView& Marker::getPoints2D()
 {
 	return points2D;
 }
 
-std::vector<std::vector<cv::Point2d> >& Marker::getPoints2D_projected()
+const MarkerProjectedView& Marker::getPoints2D_projected()
 {
 	return points2D_projected;
 }
 
-std::vector<std::vector<double> >& Marker::getError2D()
+const MarkerError2DView& Marker::getError2D()
 {
 	return error2D;
 }
 
-std::vector<cv::Point3d>& Marker::getPoints3D()
+const MarkerPoints3DView& Marker::getPoints3D()
 {
 	return points3D;
 }
 
 void Marker::setReference3DPoint(double x, double y, double z)
 {
+	setDirty();
 	point3D_ref.x = x;
 	point3D_ref.y = y;
 	point3D_ref.z = z;
@@ -107,6 +160,7 @@ void Marker::setReference3DPoint(double x, double y, double z)
 
 void Marker::loadReference3DPoint(QString filename)
 {
+	setDirty();
 	std::ifstream fin(filename.toStdString());
 	std::istringstream in;
 	std::string line;
@@ -144,18 +198,19 @@ bool Marker::Reference3DPointSet()
 	return point3D_ref_set;
 }
 
-const std::vector<markerStatus>& Marker::getStatus3D()
+const MarkerStatus3DView& Marker::getStatus3D()
 {
 	return status3D;
 }
 
-void Marker::setPoint(int camera, int activeFrame, double x, double y, markerStatus status)
+void Marker::setPoint(int camera, int activeFrame, double x, double y, markerStatus status, bool reconstruct)
 {
+	setDirty();
 	points2D[camera][activeFrame].x = x;
 	points2D[camera][activeFrame].y = y;
 	status2D[camera][activeFrame] = status;
 
-	reconstruct3DPoint(activeFrame);
+	if (reconstruct) reconstruct3DPoint(activeFrame);
 }
 
 //void Marker::movePoint(int camera, int activeFrame, double x, double y)
@@ -176,29 +231,67 @@ void Marker::setPoint(int camera, int activeFrame, double x, double y, markerSta
 //	reconstruct3DPoint(activeFrame);
 //}
 
-int Marker::getMarkerPrediction(int camera, int frame, double& x, double& y, bool forward)
+int Marker::getMarkerPrediction(int camera, int frame, double& x, double& y, bool forward, double* searchRadius)
 {
+	if (searchRadius) *searchRadius = -1;
+
 	if (frame < 0 || frame >= (int) points2D[0].size())
 		return 0;
 
 	int dir = forward ? 1 : -1;
+	int predictor = Settings::getInstance()->getIntSetting("TrackingPredictor");
+
+	//the rigid body moves all its markers together, so its pose gives the best prediction
+	double rigidBodyRadius;
+	if (Settings::getInstance()->getBoolSetting("TrackingRigidBodyPrediction") && getRigidBodyPrediction(camera, frame, x, y, forward, rigidBodyRadius))
+	{
+		if (searchRadius) *searchRadius = rigidBodyRadius;
+		return 2;
+	}
 
 	if (frame - 1 * dir >= 0 && frame - 1 * dir < (int) points2D[0].size() && status2D[camera][frame - 1 * dir] > 0)
 	{
-		if (frame - 2 * dir >= 0 && frame - 2 * dir < (int) points2D[0].size() && status2D[camera][frame - 2 * dir] > 0)
+		if (predictor > 0)
+		{
+			//consecutive measurements before the frame, oldest first
+			std::vector<cv::Point2d> measurements;
+			for (int k = predictionWindow; k >= 1; k--)
+			{
+				int f = frame - k * dir;
+				if (f < 0 || f >= (int) points2D[0].size() || status2D[camera][f] <= 0)
+				{
+					measurements.clear();
+					continue;
+				}
+				measurements.push_back(points2D[camera][f]);
+			}
+
+			cv::Point2d prediction, sigma;
+			if (MotionPredictor::predict(measurements, predictionNoise2D, predictionProcessNoise2D, prediction, sigma))
+			{
+				x = prediction.x;
+				y = prediction.y;
+				if (searchRadius) *searchRadius = 3.0 * std::max(sigma.x, sigma.y);
+
+				if (predictor == 2 && Project::getInstance()->getCalibration() != NO_CALIBRATION)
+				{
+					predictFrom3D(camera, frame, dir, x, y, searchRadius);
+				}
+				return 2;
+			}
+		}
+		else if (frame - 2 * dir >= 0 && frame - 2 * dir < (int) points2D[0].size() && status2D[camera][frame - 2 * dir] > 0)
 		{
 			//linear position
 			x = 2 * points2D[camera][frame - 1 * dir].x - points2D[camera][frame - 2 * dir].x;
 			y = 2 * points2D[camera][frame - 1 * dir].y - points2D[camera][frame - 2 * dir].y;
 			return 2;
 		}
-		else
-		{
-			//previous position
-			x = points2D[camera][frame - 1 * dir].x;
-			y = points2D[camera][frame - 1 * dir].y;
-			return 1;
-		}
+
+		//previous position
+		x = points2D[camera][frame - 1 * dir].x;
+		y = points2D[camera][frame - 1 * dir].y;
+		return 1;
 	}
 	else
 	{
@@ -206,8 +299,121 @@ int Marker::getMarkerPrediction(int camera, int frame, double& x, double& y, boo
 	}
 }
 
+bool Marker::getRigidBodyPrediction(int camera, int frame, double& x, double& y, bool forward, double& searchRadius)
+{
+	if (frame < 0 || frame >= (int) points2D[0].size())
+		return false;
+
+	int idx = -1;
+	for (unsigned int i = 0; i < trial->getMarkers().size(); i++)
+	{
+		if (trial->getMarkers()[i] == this)
+		{
+			idx = i;
+			break;
+		}
+	}
+	if (idx < 0)
+		return false;
+
+	Camera* cam = Project::getInstance()->getCameras()[camera];
+	bool found = false;
+	for (std::vector<RigidBody*>::const_iterator rb = trial->getRigidBodies().begin(); rb != trial->getRigidBodies().end(); ++rb)
+	{
+		const std::vector<int>& pointsIdx = (*rb)->getPointsIdx();
+		std::vector<int>::const_iterator it = std::find(pointsIdx.begin(), pointsIdx.end(), idx);
+		if (it == pointsIdx.end())
+			continue;
+
+		std::vector<cv::Point2d> projected;
+		std::vector<double> radii;
+		if (!(*rb)->predictProjection(cam, frame, forward, projected, radii) || projected.size() != pointsIdx.size())
+			continue;
+
+		int pos = it - pointsIdx.begin();
+		double radius = radii[pos];
+		if (!found || radius < searchRadius)
+		{
+			x = projected[pos].x;
+			y = projected[pos].y;
+			searchRadius = radius;
+			found = true;
+		}
+	}
+	return found;
+}
+
+int Marker::getMostConfidentCamera(int frame, bool forward, const std::vector<int>& cameras)
+{
+	int best = -1;
+	double bestRadius = 0;
+	for (std::vector<int>::const_iterator c = cameras.begin(); c != cameras.end(); ++c)
+	{
+		double x, y, radius;
+		//a camera without motion based prediction is the least confident
+		if (getMarkerPrediction(*c, frame, x, y, forward, &radius) != 2 || radius <= 0)
+			radius = std::numeric_limits<double>::max();
+
+		if (best < 0 || radius < bestRadius)
+		{
+			best = *c;
+			bestRadius = radius;
+		}
+	}
+	return best;
+}
+
+bool Marker::predictFrom3D(int camera, int frame, int dir, double& x, double& y, double* searchRadius)
+{
+	std::vector<cv::Point3d> measurements;
+	for (int k = predictionWindow; k >= 1; k--)
+	{
+		int f = frame - k * dir;
+		if (f < 0 || f >= (int) points3D.size() || status3D[f] <= 0)
+		{
+			measurements.clear();
+			continue;
+		}
+		measurements.push_back(points3D[f]);
+	}
+
+	//the 3d positions are noisier than the 2d measurements, so more frames are required
+	cv::Point3d prediction, sigma;
+	if (measurements.size() < 3 || !MotionPredictor::predict(measurements, predictionNoise3D, predictionProcessNoise3D, prediction, sigma))
+		return false;
+
+	Camera* cam = Project::getInstance()->getCameras()[camera];
+	int reference = trial->getReferenceCalibrationImage();
+	cv::Point2d projected = cam->projectPoint(prediction, reference);
+	x = projected.x;
+	y = projected.y;
+
+	if (searchRadius)
+	{
+		//project the 3 sigma ellipsoid along its axes
+		const cv::Point3d axes[3] = { cv::Point3d(3.0 * sigma.x, 0, 0), cv::Point3d(0, 3.0 * sigma.y, 0), cv::Point3d(0, 0, 3.0 * sigma.z) };
+		double radius2 = 0;
+		for (int a = 0; a < 3; a++)
+		{
+			cv::Point2d offset = cam->projectPoint(prediction + axes[a], reference) - projected;
+			radius2 += offset.dot(offset);
+		}
+		*searchRadius = sqrt(radius2);
+	}
+	return true;
+}
+
 void Marker::reconstruct3DPoint(int frame, bool updateAll)
 {
+	setDirty();
+	XMA_TRACE_SCOPE("Triangulation");
+	if (!updateAll && trial->isEditing())
+	{
+		pendingFrames.insert(frame);
+		trial->setFrameEdited(this, frame);
+		return;
+	}
+
 	status3D[frame] = UNDEFINED;
 
 	if (Project::getInstance()->getCalibration() == NO_CALIBRATION)
@@ -236,6 +442,22 @@ void Marker::reconstruct3DPoint(int frame, bool updateAll)
 	if (!updateAll)trial->resetRigidBodyByMarker(this, frame);
 }
 
+void Marker::reconstructPendingFrames()
+{
+	for (std::set<int>::const_iterator it = pendingFrames.begin(); it != pendingFrames.end(); ++it)
+	{
+		reconstruct3DPoint(*it, true);
+	}
+	pendingFrames.clear();
+}
+
+std::vector<int> Marker::takePendingFrames()
+{
+	std::vector<int> frames(pendingFrames.begin(), pendingFrames.end());
+	pendingFrames.clear();
+	return frames;
+}
+
 void Marker::reconstruct3DPointZisserman(int frame)
 {
 	int count = 0;
@@ -627,81 +849,87 @@ double Marker::getSizeRange()
 
 void Marker::setSize(int camera, int frame, double size_value)
 {
+	setDirty();
 	markerSize[camera][frame] = size_value;
 	updateMeanSize();
 }
 
 void Marker::save(QString points_filename, QString status_filename, QString markersize_filename, QString pointsWorld_filename)
 {
+	//markers are already saved in parallel, so each file is formatted into one buffer and written at once
+	CSVWriter writer;
 	if (!points_filename.isEmpty())
 	{
-		std::ofstream outfile(points_filename.toStdString());
-		outfile.precision(12);
 		for (unsigned int j = 0; j < points2D[0].size(); j++)
 		{
 			for (unsigned int i = 0; i < points2D.size(); i++)
 			{
-				outfile << points2D[i][j].x << "," << points2D[i][j].y;
-				if (i != points2D.size() - 1) outfile << ",";
+				writer.append(points2D[i][j].x);
+				writer.append(',');
+				writer.append(points2D[i][j].y);
+				if (i != points2D.size() - 1) writer.append(',');
 			}
-			outfile << std::endl;
+			writer.append('\n');
 		}
-		outfile.close();
+		writer.write(points_filename);
 	}
 
 	if (!status_filename.isEmpty())
 	{
-		std::ofstream outfile_status(status_filename.toStdString());
-		outfile_status.precision(12);
+		writer.clear();
 		for (unsigned int j = 0; j < status2D[0].size(); j++)
 		{
 			for (unsigned int i = 0; i < status2D.size(); i++)
 			{
-				outfile_status << status2D[i][j];
-				if (i != status2D.size() - 1) outfile_status << ",";
+				writer.append(static_cast<int>(status2D[i][j]));
+				if (i != status2D.size() - 1) writer.append(',');
 			}
-			outfile_status << std::endl;
+			writer.append('\n');
 		}
-		outfile_status.close();
+		writer.write(status_filename);
 	}
 
 	if (!markersize_filename.isEmpty())
 	{
-		std::ofstream outfile_size(markersize_filename.toStdString());
-		outfile_size.precision(12);
+		writer.clear();
 		for (unsigned int j = 0; j < markerSize[0].size(); j++)
 		{
 			for (unsigned int i = 0; i < markerSize.size(); i++)
 			{
-				outfile_size << markerSize[i][j];
-				if (i != markerSize.size() - 1) outfile_size << ",";
+				writer.append(markerSize[i][j]);
+				if (i != markerSize.size() - 1) writer.append(',');
 			}
-			outfile_size << std::endl;
+			writer.append('\n');
 		}
-		outfile_size.close();
+		writer.write(markersize_filename);
 	}
 
 	if (!pointsWorld_filename.isEmpty())
 	{
-		std::ofstream outfile_world(pointsWorld_filename.toStdString());
-		outfile_world.precision(12);
+		writer.clear();
 		for (unsigned int j = 0; j < points3D.size(); j++)
 		{
 			if (status3D[j] <= 0)
 			{
-				outfile_world << "NaN" << "," << "NaN" << "," << "NaN" << std::endl;
+				writer.append("NaN,NaN,NaN\n");
 			}
 			else
 			{
-				outfile_world << points3D[j].x << "," << points3D[j].y << "," << points3D[j].z << std::endl;
+				writer.append(points3D[j].x);
+				writer.append(',');
+				writer.append(points3D[j].y);
+				writer.append(',');
+				writer.append(points3D[j].z);
+				writer.append('\n');
 			}
 		}
-		outfile_world.close();
+		writer.write(pointsWorld_filename);
 	}
 }
 
 void Marker::load(QString points_filename, QString status_filename, QString markersize_filename)
 {
+	setDirty();
 	std::ifstream fin;
 	fin.open(points_filename.toStdString());
 	std::istringstream in;
@@ -782,31 +1010,36 @@ void Marker::load(QString points_filename, QString status_filename, QString mark
 
 void Marker::save3DPoints(QString points_filename, QString status_filename)
 {
+	CSVWriter writer;
 	if (!points_filename.isEmpty())
 	{
-		std::ofstream outfile_world(points_filename.toStdString());
-		outfile_world.precision(12);
 		for (unsigned int j = 0; j < points3D.size(); j++)
 		{
-			outfile_world << points3D[j].x << "," << points3D[j].y << "," << points3D[j].z << std::endl;
+			writer.append(points3D[j].x);
+			writer.append(',');
+			writer.append(points3D[j].y);
+			writer.append(',');
+			writer.append(points3D[j].z);
+			writer.append('\n');
 		}
-		outfile_world.close();
+		writer.write(points_filename);
 	}
 
 	if (!status_filename.isEmpty())
 	{
-		std::ofstream outfile_status(status_filename.toStdString());
-		outfile_status.precision(12);
+		writer.clear();
 		for (unsigned int i = 0; i < status3D.size(); i++)
 		{
-			outfile_status << status3D[i] << std::endl;
+			writer.append(static_cast<int>(status3D[i]));
+			writer.append('\n');
 		}
-		outfile_status.close();
+		writer.write(status_filename);
 	}
 }
 
 void Marker::load3DPoints(QString points_filename, QString status_filename)
 {
+	setDirty();
 	std::ifstream fin;
 	fin.open(points_filename.toStdString());
 	std::istringstream in;
@@ -856,7 +1089,9 @@ void Marker::load3DPoints(QString points_filename, QString status_filename)
 
 void Marker::resetMultipleFrames(int camera, int frameStart, int frameEnd, bool toggleUntrackable)
 {
+	setDirty();
 	//fprintf(stderr, "Delete %d - from %d  to %d\n", camera, frameStart, frameEnd);
+	trial->beginEdit();
 	for (int i = frameStart; i <= frameEnd; i++)
 	{
 		if (camera == -1)
@@ -897,12 +1132,14 @@ void Marker::resetMultipleFrames(int camera, int frameStart, int frameEnd, bool
 			reconstruct3DPoint(i);
 		}
 	}
+	trial->commitEdit();
 
 	updateMeanSize();
 }
 
 void Marker::setInterpolation(int frame, interpolationMethod method)
 {
+	setDirty();
 	interpolation[frame] = method;
 }
 
@@ -945,6 +1182,7 @@ void Marker::saveInterpolation(QString filename)
 
 void Marker::loadInterpolation(QString filename)
 {
+	setDirty();
 	std::ifstream fin;
 	fin.open(filename.toStdString());
 	std::istringstream in;
@@ -992,6 +1230,8 @@ void Marker::update(bool updateAll)
 
 bool Marker::isValid(int camera, int frame)
 {
+	reconstructPendingFrames();
+
 	//check Size Min Max
 	if (markerSize[camera][frame] < 1)
 	{
@@ -1034,6 +1274,7 @@ bool Marker::isValid(int camera, int frame)
 
 void Marker::reset(int camera, int frame)
 {
+	setDirty();
 	status2D[camera][frame] = UNDEFINED;
 	points2D[camera][frame].x = -2;
 	points2D[camera][frame].y = -2;
@@ -1053,6 +1294,7 @@ int Marker::getSizeOverride()
 
 void Marker::setSizeOverride(int value)
 {
+	setDirty();
 	sizeOverride = value;
 }
 
@@ -1063,6 +1305,7 @@ int Marker::getThresholdOffset()
 
 void Marker::setThresholdOffset(int value)
 {
+	setDirty();
 	thresholdOffset = value;
 }
 
@@ -1073,6 +1316,7 @@ int Marker::getMaxPenalty()
 
 void Marker::setMaxPenalty(int value)
 {
+	setDirty();
 	maxPenalty = value;
 	if (maxPenalty == 125) {// adjustement of erronous default values
 		maxPenalty = 50; 
@@ -1088,9 +1332,53 @@ int Marker::getMethod()
 
 void Marker::setMethod(int value)
 {
+	setDirty();
 	method = value;
 }
 
+void Marker::recordTracking(double ms, int searchArea)
+{
+	trackingCount++;
+	trackingTimeTotal += ms;
+	if (ms > trackingTimeMax) trackingTimeMax = ms;
+	trackingSearchAreaTotal += searchArea;
+	if (searchArea > trackingSearchAreaMax) trackingSearchAreaMax = searchArea;
+}
+
+int Marker::getTrackingCount()
+{
+	return trackingCount;
+}
+
+double Marker::getTrackingTimeMean()
+{
+	return (trackingCount > 0) ? trackingTimeTotal / trackingCount : 0.0;
+}
+
+double Marker::getTrackingTimeMax()
+{
+	return trackingTimeMax;
+}
+
+double Marker::getTrackingSearchAreaMean()
+{
+	return (trackingCount > 0) ? trackingSearchAreaTotal / trackingCount : 0.0;
+}
+
+int Marker::getTrackingSearchAreaMax()
+{
+	return trackingSearchAreaMax;
+}
+
+void Marker::resetTrackingStatistics()
+{
+	trackingCount = 0;
+	trackingTimeTotal = 0.0;
+	trackingTimeMax = 0.0;
+	trackingSearchAreaTotal = 0.0;
+	trackingSearchAreaMax = 0;
+}
+
 Trial* Marker::getTrial()
 {
 	return trial;
@@ -1106,6 +1394,17 @@ void Marker::setRequiresRecomputation(bool value)
 	requiresRecomputation = value;
 }
 
+bool Marker::isDirty()
+{
+	return dirty;
+}
+
+void Marker::setDirty(bool value)
+{
+	dirty = value;
+	if (value && trial) trial->invalidateData();
+}
+
 bool Marker::filterMarker(double cutoffFrequency, const std::vector <cv::Point3d> &marker_in, const std::vector <markerStatus>& status_in
 	, std::vector <cv::Point3d> &marker_out, std::vector <markerStatus>& status_out)
 {
@@ -1183,6 +1482,7 @@ markerStatus Marker::updateStatus12(int statusOld)
 
 void Marker::updateToProject12()
 {
+	setDirty();
 	for (unsigned int i = 0; i < status3D.size(); i++)
 	{
 		status3D[i] = updateStatus12(status3D[i]);
@@ -1204,11 +1504,20 @@ void Marker::updateToProject12()
 
 void Marker::updateToProject13()
 {
+	setDirty();
 	maxPenalty = maxPenalty / 125 * 50;
 }
 
 void Marker::interpolate()
 {
+	trial->beginEdit();
+	interpolatePoints();
+	trial->commitEdit();
+}
+
+void Marker::interpolatePoints()
+{
+	setDirty();
 	//reset all interpolated
 	for (unsigned int c = 0; c < status2D.size(); c++){
 		for (unsigned int i = 0; i < status2D[c].size(); i++){
@@ -1253,6 +1562,7 @@ void Marker::interpolate()
 				}
 				else
 				{
+					reconstructPendingFrames();
 					if (status3D[f - 1] >= INTERPOLATED)
 					{
 						for (unsigned int c = 0; c < status2D.size(); c++){
@@ -1303,6 +1613,7 @@ void Marker::interpolate()
 		}
 		else
 		{
+			reconstructPendingFrames();
 			for (unsigned int f = 1; f < interpolation.size(); f++){
 				if (status3D[f] < INTERPOLATED && status3D[f - 1] >= INTERPOLATED)
 				{
@@ -1401,6 +1712,8 @@ void Marker::interpolate()
 		else
 		{
 
+			reconstructPendingFrames();
+
 			std::vector<double> YX1;
 			std::vector<double> YY1;
 			std::vector<double> YZ1;
@@ -1520,44 +1833,25 @@ void Marker::filterData(std::vector<int> idx, double cutoffFrequency, const std:
 	}
 	else
 	{
-		std::vector<double> x;
-		std::vector<double> y;
-		std::vector<double> z;
-
+		//x, y and z are filtered together as interleaved channels
+		std::vector<double> xyz(3 * idx.size());
 		for (unsigned int i = 0; i < idx.size(); i++)
 		{
-			x.push_back(marker_in[idx[i]].x);
-			y.push_back(marker_in[idx[i]].y);
-			z.push_back(marker_in[idx[i]].z);
+			xyz[3 * i] = marker_in[idx[i]].x;
+			xyz[3 * i + 1] = marker_in[idx[i]].y;
+			xyz[3 * i + 2] = marker_in[idx[i]].z;
 		}
 
-		std::vector<double> x_out;
-		std::vector<double> y_out;
-		std::vector<double> z_out;
-
-		ButterworthLowPassFilter* filter = new ButterworthLowPassFilter(4, cutoffFrequency, trial->getRecordingSpeed());
-
-		filter->filter(x, x_out);
-		filter->filter(y, y_out);
-		filter->filter(z, z_out);
+		FilterBank::getInstance()->filtfilt(4, cutoffFrequency, trial->getRecordingSpeed(), &xyz[0], &xyz[0], idx.size(), 3);
 
 		for (unsigned int i = 0; i < idx.size(); i++)
 		{
-			marker_out[idx[i]].x = x_out[i];
-			marker_out[idx[i]].y = y_out[i];
-			marker_out[idx[i]].z = z_out[i];
+			marker_out[idx[i]].x = xyz[3 * i];
+			marker_out[idx[i]].y = xyz[3 * i + 1];
+			marker_out[idx[i]].z = xyz[3 * i + 2];
 
 			status_out[idx[i]] = status_in[idx[i]];
 		}
-
-		delete filter;
-
-		x_out.clear();
-		y_out.clear();
-		z_out.clear();
-		x.clear();
-		y.clear();
-		z.clear();
 	}
 }
 
@@ -1728,6 +2022,29 @@ void Marker::updateMeanSize()
 	}
 }
 
+cv::Point2d Marker::getClosestPointOnEpipolarLine(const std::vector<cv::Point2d>& epiline, const cv::Point2d& pt)
+{
+	if (epiline.size() == 1)
+		return epiline[0];
+
+	cv::Point2d closest = pt;
+	double minDist = std::numeric_limits<double>::max();
+	for (unsigned int i = 1; i < epiline.size(); i++)
+	{
+		cv::Point2d d = epiline[i] - epiline[i - 1];
+		double length = d.dot(d);
+		double t = (length > 0) ? std::max(0.0, std::min(1.0, (pt - epiline[i - 1]).dot(d) / length)) : 0.0;
+		cv::Point2d proj = epiline[i - 1] + t * d;
+		double dist = (pt - proj).dot(pt - proj);
+		if (dist < minDist)
+		{
+			minDist = dist;
+			closest = proj;
+		}
+	}
+	return closest;
+}
+
 std::vector<cv::Point2d> Marker::getEpipolarLine(int cameraOrigin, int CameraDestination, int frame)
 {
 	std::vector<cv::Point2d> epiline;
@@ -1834,80 +2151,46 @@ std::vector<cv::Point2d> Marker::getEpipolarLine(int cameraOrigin, int CameraDes
 
 void Marker::clear()
 {
-	for (std::vector<std::vector<cv::Point2d> >::iterator pt_it = points2D.begin(); pt_it != points2D.end(); ++pt_it)
-	{
-		pt_it->clear();
-	}
-
-	for (std::vector<std::vector<cv::Point2d> >::iterator pt_it = points2D_projected.begin(); pt_it != points2D_projected.end(); ++pt_it)
-	{
-		pt_it->clear();
-	}
-
-	for (std::vector<std::vector<markerStatus> >::iterator status_it = status2D.begin(); status_it != status2D.end(); ++status_it)
-	{
-		status_it->clear();
-	}
-	for (std::vector<std::vector<double> >::iterator error_it = error2D.begin(); error_it != error2D.end(); ++error_it)
+	setDirty();
+	if (storeSlot >= 0)
 	{
-		error_it->clear();
+		trial->getMarkerStore().release(storeSlot);
+		storeSlot = -1;
 	}
 
-	for (std::vector<std::vector<double> >::iterator size_it = markerSize.begin(); size_it != markerSize.end(); ++size_it)
-	{
-		size_it->clear();
-	}
-
-	points2D.clear();
-	points2D_projected.clear();
-	status2D.clear();
-	error2D.clear();
-	markerSize.clear();
+	points2D = MarkerPoints2DView();
+	points2D_projected = MarkerProjectedView();
+	status2D = MarkerStatus2DView();
+	error2D = MarkerError2DView();
+	markerSize = MarkerSizeView();
 	interpolation.clear();
-	points3D.clear();
-	status3D.clear();
-	error3D.clear();
+	points3D = MarkerPoints3DView();
+	status3D = MarkerStatus3DView();
+	error3D = MarkerError3DView();
 }
 
 void Marker::init(int nbCameras, int size)
 {
 	clear();
 
-	for (int c = 0; c < nbCameras; c++)
-	{
-		std::vector<cv::Point2d> c_points2D(size, cv::Point2d(-2, -2));
-		std::vector<cv::Point2d> c_points2D_projected(size, cv::Point2d(-2, -2));
-		std::vector<markerStatus> c_status2D(size, UNDEFINED);
-		std::vector<double> c_error2D(size, 0.0);
-		std::vector<double> c_size(size, -1.0);
+	MarkerStore* store = &trial->getMarkerStore();
+	storeSlot = store->allocate(nbCameras, size);
 
-		points2D.push_back(c_points2D);
-		points2D_projected.push_back(c_points2D_projected);
-		status2D.push_back(c_status2D);
-		error2D.push_back(c_error2D);
-		markerSize.push_back(c_size);
-	}
+	points2D = MarkerPoints2DView(store, storeSlot);
+	points2D_projected = MarkerProjectedView(store, storeSlot);
+	status2D = MarkerStatus2DView(store, storeSlot);
+	error2D = MarkerError2DView(store, storeSlot);
+	markerSize = MarkerSizeView(store, storeSlot);
 
-	points3D.resize(size, cv::Point3d(-1000, -1000, -1000));
-	status3D.resize(size, UNDEFINED);
-	error3D.resize(size, 0.0);
+	points3D = MarkerPoints3DView(store, storeSlot);
+	status3D = MarkerStatus3DView(store, storeSlot);
+	error3D = MarkerError3DView(store, storeSlot);
 	interpolation.resize(size, NONE);
 }
 
 void Marker::addFrame()
 {
-	for (unsigned int c = 0; c < points2D.size(); c++)
-	{
-		points2D[c].push_back(cv::Point2d(-2, -2));
-		points2D_projected[c].push_back(cv::Point2d(-2, -2));
-		status2D[c].push_back(UNDEFINED);
-		error2D[c].push_back(0.0);
-		markerSize[c].push_back(-1.0);
-	}
-
-	points3D.push_back(cv::Point3d(-1000, -1000, -1000));
-	status3D.push_back(UNDEFINED);
-	error3D.push_back(0);
+	setDirty();
+	trial->getMarkerStore().resize(storeSlot, points3D.size() + 1);
 	interpolation.push_back(NONE);
 }
-
@@ -29,11 +29,14 @@
 
 #include <QString>
 #include <vector>
+#include <set>
 #include <opencv2/opencv.hpp>
 #include <opencv2/video/tracking.hpp>
 
 #include <QColor>
 
+#include "MarkerStore.h"
+
 #define MIN_marker(a,b) (((a)<(b))?(a):(b))
 
 namespace xma
@@ -51,22 +54,6 @@ namespace xma
 //		MANUAL_REFINED = 6
 //	};
 
-		enum markerStatus
-		{
-			UNTRACKABLE = -30,
-			DELETED = -20,
-			LOST = -10,
-			UNDEFINED = 0,
-			PREDICTED = 10,
-			INTERPOLATED = 20,
-			TRACKED = 40,
-			TRACKED_AND_OPTIMIZED = 45,
-			SET = 50,
-			SET_AND_OPTIMIZED = 55,
-			MANUAL = 60,
-			MANUAL_AND_OPTIMIZED = 65
-		};
-
 		enum interpolationMethod
 		{
 			NONE = 0,
@@ -82,18 +69,21 @@ namespace xma
 	public:
 
 		Marker(int nbCameras, int size, Trial* _trial);
+		//Read only copy of marker whose data is kept in snapshotStore, a copy of the store of the trial. The copy does not own a slot.
+		Marker(const Marker& marker, MarkerStore* snapshotStore);
 		virtual ~Marker();
 
 		void setDescription(QString _description);
 		QString getDescription();
 
-		const std::vector<std::vector<markerStatus> >& getStatus2D();
-		std::vector<std::vector<cv::Point2d> >& getPoints2D();
-		std::vector<std::vector<cv::Point2d> >& getPoints2D_projected();
-		std::vector<std::vector<double> >& getError2D();
+		//Views into the columnar storage of the trial, indexed [camera][frame] and [frame]
+		const MarkerStatus2DView& getStatus2D();
+		const MarkerPoints2DView& getPoints2D();
+		const MarkerProjectedView& getPoints2D_projected();
+		const MarkerError2DView& getError2D();
 
-		const std::vector<markerStatus>& getStatus3D();
-		std::vector<cv::Point3d>& getPoints3D();
+		const MarkerStatus3DView& getStatus3D();
+		const MarkerPoints3DView& getPoints3D();
 
 		void setReference3DPoint(double x, double y, double z);
 		void loadReference3DPoint(QString filename);
@@ -102,15 +92,24 @@ namespace xma
 		cv::Point3d getReference3DPoint();
 		bool Reference3DPointSet();
 
-		void setPoint(int camera, int activeFrame, double x, double y, markerStatus status);
+		void setPoint(int camera, int activeFrame, double x, double y, markerStatus status, bool reconstruct = true);
 		std::vector<cv::Point2d> getEpipolarLine(int cameraOrigin, int CameraDestination, int frame);
+		static cv::Point2d getClosestPointOnEpipolarLine(const std::vector<cv::Point2d>& epiline, const cv::Point2d& pt);
 		void reconstruct3DPoint(int frame, bool updateAll = false);
 		void reconstruct3DPointZisserman(int frame);
 		void reconstruct3DPointZissermanIncremental(int frame);
 		void reconstruct3DPointZissermanMatlab(int frame);
 		void reconstruct3DPointZissermanIncrementalMatlab(int frame);
 		void reconstruct3DPointRayIntersection(int frame);
-		int getMarkerPrediction(int camera, int frame, double& x, double& y, bool forward);
+		void reconstructPendingFrames();
+		std::vector<int> takePendingFrames();
+		//Predicts the position from the previous frames. Returns 0 without prediction, 1 for the previous position and 2 for a motion based prediction.
+		//If searchRadius is given it is set to the 3 sigma radius of the prediction or -1 if unknown.
+		int getMarkerPrediction(int camera, int frame, double& x, double& y, bool forward, double* searchRadius = nullptr);
+		//Predicts the position by extrapolating the pose of the rigid bodies containing the marker. Works also if the marker was occluded in the previous frames.
+		bool getRigidBodyPrediction(int camera, int frame, double& x, double& y, bool forward, double& searchRadius);
+		//Returns the camera with the smallest prediction radius of the given cameras, which is solved first during the epipolar constrained tracking.
+		int getMostConfidentCamera(int frame, bool forward, const std::vector<int>& cameras);
 
 		double getSize();
 		double getSizeRange();
@@ -146,10 +145,23 @@ namespace xma
 		int getMethod();
 		void setMethod(int value);
 
+		//time and search window of the template matching, accumulated over all tracked frames and cameras
+		void recordTracking(double ms, int searchArea);
+		int getTrackingCount();
+		double getTrackingTimeMean();
+		double getTrackingTimeMax();
+		double getTrackingSearchAreaMean();
+		int getTrackingSearchAreaMax();
+		void resetTrackingStatistics();
+
 		Trial* getTrial();
 
 		bool getRequiresRecomputation();
 		void setRequiresRecomputation(bool value);
+
+		//Changed since the project was last saved or loaded. Unchanged markers are copied from the previous archive when saving.
+		bool isDirty();
+		void setDirty(bool value = true);
 		bool filterMarker(double cutoffFrequency, const std::vector <cv::Point3d> &marker_in, const std::vector <markerStatus>& status_in, std::vector <cv::Point3d> &marker_out, std::vector <markerStatus>& status_out);
 
 		void updateToProject12();
@@ -168,6 +180,8 @@ namespace xma
 		void addFrame();
 		void clear();
 		void updateError(int frame);
+		void interpolatePoints();
+		bool predictFrom3D(int camera, int frame, int dir, double& x, double& y, double* searchRadius);
 		void filterData(std::vector<int> idx, double cutoffFrequency, const  std::vector<cv::Point3d>& marker_in, const  std::vector<markerStatus>& status_in, std::vector<cv::Point3d>& marker_out, std::vector<markerStatus>& status_out);
 		markerStatus updateStatus12(int statusOld);
 
@@ -175,14 +189,15 @@ namespace xma
 
 		QString description;
 		int trialIdx;
-		std::vector<std::vector<cv::Point2d> > points2D;
-		std::vector<std::vector<cv::Point2d> > points2D_projected;
-		std::vector<std::vector<markerStatus> > status2D;
-		std::vector<std::vector<double> > error2D;
+		int storeSlot;
+		MarkerPoints2DView points2D;
+		MarkerProjectedView points2D_projected;
+		MarkerStatus2DView status2D;
+		MarkerError2DView error2D;
 		std::vector<interpolationMethod> interpolation;
 		bool hasInterpolation;
 		void updateMeanSize();
-		std::vector<std::vector<double> > markerSize;
+		MarkerSizeView markerSize;
 		double meanSize;
 		double sizeRange;
 
@@ -194,12 +209,21 @@ namespace xma
 
 		bool point3D_ref_set;
 		cv::Point3d point3D_ref;
-		std::vector<cv::Point3d> points3D;
-		std::vector<markerStatus> status3D;
-		std::vector<double> error3D;
+		MarkerPoints3DView points3D;
+		MarkerStatus3DView status3D;
+		MarkerError3DView error3D;
+
+		//frames edited during a trial edit transaction which are not triangulated yet
+		std::set<int> pendingFrames;
 
 		bool requiresRecomputation;
+		bool dirty;
 
+		int trackingCount;
+		double trackingTimeTotal;
+		double trackingTimeMax;
+		double trackingSearchAreaTotal;
+		int trackingSearchAreaMax;
 	};
 }
 
@@ -0,0 +1,233 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file MarkerStore.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/MarkerStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <assert.h>
+
+using namespace xma;
+
+namespace
+{
+	//rows are padded to a multiple of 64 frames so every row starts on a cache line
+	const int frameAlignment = 64;
+
+	int alignFrames(int nbFrames)
+	{
+		return std::max(frameAlignment, (nbFrames + frameAlignment - 1) / frameAlignment * frameAlignment);
+	}
+
+	template <typename T>
+	void reallocateField(T*& data, int nbRows, int oldFrameCapacity, int newRows, int newFrameCapacity)
+	{
+		T* newData = static_cast<T*>(cv::fastMalloc(sizeof(T) * (size_t) newRows * newFrameCapacity));
+		if (data)
+		{
+			for (int r = 0; r < nbRows; r++)
+			{
+				std::memcpy(newData + (size_t) r * newFrameCapacity, data + (size_t) r * oldFrameCapacity, sizeof(T) * oldFrameCapacity);
+			}
+			cv::fastFree(data);
+		}
+		data = newData;
+	}
+
+	template <typename T>
+	void copyField(T*& data, const T* source, size_t count)
+	{
+		if (!source)
+			return;
+		data = static_cast<T*>(cv::fastMalloc(sizeof(T) * count));
+		std::memcpy(data, source, sizeof(T) * count);
+	}
+
+	template <typename T>
+	void freeField(T*& data)
+	{
+		if (data)
+			cv::fastFree(data);
+		data = nullptr;
+	}
+}
+
+MarkerStore::MarkerStore() : nbCameras(0), slotCapacity(0), frameCapacity(0),
+                             points2D(nullptr), points2D_projected(nullptr), status2D(nullptr), error2D(nullptr), markerSize(nullptr),
+                             points3D(nullptr), status3D(nullptr), error3D(nullptr)
+{
+}
+
+MarkerStore::MarkerStore(const MarkerStore& other) : nbCameras(other.nbCameras), slotCapacity(other.slotCapacity), frameCapacity(other.frameCapacity),
+                                                      frames(other.frames), freeSlots(other.freeSlots),
+                                                      points2D(nullptr), points2D_projected(nullptr), status2D(nullptr), error2D(nullptr), markerSize(nullptr),
+                                                      points3D(nullptr), status3D(nullptr), error3D(nullptr)
+{
+	size_t size2D = (size_t) slotCapacity * nbCameras * frameCapacity;
+	size_t size3D = (size_t) slotCapacity * frameCapacity;
+
+	copyField(points2D, other.points2D, size2D);
+	copyField(points2D_projected, other.points2D_projected, size2D);
+	copyField(status2D, other.status2D, size2D);
+	copyField(error2D, other.error2D, size2D);
+	copyField(markerSize, other.markerSize, size2D);
+
+	copyField(points3D, other.points3D, size3D);
+	copyField(status3D, other.status3D, size3D);
+	copyField(error3D, other.error3D, size3D);
+}
+
+MarkerStore::~MarkerStore()
+{
+	freeField(points2D);
+	freeField(points2D_projected);
+	freeField(status2D);
+	freeField(error2D);
+	freeField(markerSize);
+	freeField(points3D);
+	freeField(status3D);
+	freeField(error3D);
+}
+
+int MarkerStore::allocate(int _nbCameras, int nbFrames)
+{
+	if (frames.empty())
+		nbCameras = _nbCameras;
+	assert(_nbCameras == nbCameras);
+
+	int slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		slot = frames.size();
+		frames.push_back(0);
+	}
+
+	int newSlotCapacity = slotCapacity;
+	while (slot >= newSlotCapacity)
+		newSlotCapacity = std::max(8, newSlotCapacity + newSlotCapacity / 4);
+	int newFrameCapacity = nbFrames > frameCapacity ? alignFrames(nbFrames) : frameCapacity;
+
+	if (newSlotCapacity != slotCapacity || newFrameCapacity != frameCapacity)
+		reallocate(newSlotCapacity, newFrameCapacity);
+
+	frames[slot] = nbFrames;
+	setDefault(slot, 0, nbFrames);
+
+	return slot;
+}
+
+void MarkerStore::reserve(int _nbCameras, int nbMarkers, int nbFrames)
+{
+	if (frames.empty())
+		nbCameras = _nbCameras;
+	assert(_nbCameras == nbCameras);
+
+	//released slots are reused before new ones are appended
+	int newSlots = std::max(0, nbMarkers - getNbMarkers() - (int) freeSlots.size());
+	int newSlotCapacity = std::max(slotCapacity, (int) frames.size() + newSlots);
+	int newFrameCapacity = nbFrames > frameCapacity ? alignFrames(nbFrames) : frameCapacity;
+
+	if (newSlotCapacity != slotCapacity || newFrameCapacity != frameCapacity)
+		reallocate(newSlotCapacity, newFrameCapacity);
+}
+
+void MarkerStore::release(int slot)
+{
+	frames[slot] = 0;
+	freeSlots.push_back(slot);
+}
+
+void MarkerStore::resize(int slot, int nbFrames)
+{
+	if (nbFrames > frameCapacity)
+	{
+		//grow geometrically as markers are extended one frame at a time while loading
+		reallocate(slotCapacity, alignFrames(std::max(nbFrames, frameCapacity + frameCapacity / 2)));
+	}
+
+	int oldFrames = frames[slot];
+	frames[slot] = nbFrames;
+	if (nbFrames > oldFrames)
+		setDefault(slot, oldFrames, nbFrames);
+}
+
+int MarkerStore::getNbMarkers() const
+{
+	return frames.size() - freeSlots.size();
+}
+
+size_t MarkerStore::getMemorySize() const
+{
+	size_t bytesPerFrame = nbCameras * (sizeof(cv::Point2d) + sizeof(projectedPoint) + sizeof(signed char) + 2 * sizeof(double))
+		+ sizeof(cv::Point3d) + sizeof(signed char) + sizeof(double);
+	return bytesPerFrame * slotCapacity * frameCapacity;
+}
+
+void MarkerStore::reallocate(int newSlotCapacity, int newFrameCapacity)
+{
+	//only slots which existed before can hold data
+	int nbSlots = std::min((int) frames.size(), slotCapacity);
+	int nbRows2D = nbSlots * nbCameras;
+	int nbRows3D = nbSlots;
+
+	reallocateField(points2D, nbRows2D, frameCapacity, newSlotCapacity * nbCameras, newFrameCapacity);
+	reallocateField(points2D_projected, nbRows2D, frameCapacity, newSlotCapacity * nbCameras, newFrameCapacity);
+	reallocateField(status2D, nbRows2D, frameCapacity, newSlotCapacity * nbCameras, newFrameCapacity);
+	reallocateField(error2D, nbRows2D, frameCapacity, newSlotCapacity * nbCameras, newFrameCapacity);
+	reallocateField(markerSize, nbRows2D, frameCapacity, newSlotCapacity * nbCameras, newFrameCapacity);
+
+	reallocateField(points3D, nbRows3D, frameCapacity, newSlotCapacity, newFrameCapacity);
+	reallocateField(status3D, nbRows3D, frameCapacity, newSlotCapacity, newFrameCapacity);
+	reallocateField(error3D, nbRows3D, frameCapacity, newSlotCapacity, newFrameCapacity);
+
+	slotCapacity = newSlotCapacity;
+	frameCapacity = newFrameCapacity;
+}
+
+void MarkerStore::setDefault(int slot, int start, int end)
+{
+	for (int c = 0; c < nbCameras; c++)
+	{
+		std::fill(getPoints2D(slot, c) + start, getPoints2D(slot, c) + end, cv::Point2d(-2, -2));
+		std::fill(getPoints2D_projected(slot, c) + start, getPoints2D_projected(slot, c) + end, projectedPoint(-2, -2));
+		std::fill(getStatus2D(slot, c) + start, getStatus2D(slot, c) + end, static_cast<signed char>(UNDEFINED));
+		std::fill(getError2D(slot, c) + start, getError2D(slot, c) + end, 0.0);
+		std::fill(getMarkerSize(slot, c) + start, getMarkerSize(slot, c) + end, -1.0);
+	}
+
+	std::fill(getPoints3D(slot) + start, getPoints3D(slot) + end, cv::Point3d(-1000, -1000, -1000));
+	std::fill(getStatus3D(slot) + start, getStatus3D(slot) + end, static_cast<signed char>(UNDEFINED));
+	std::fill(getError3D(slot) + start, getError3D(slot) + end, 0.0);
+}
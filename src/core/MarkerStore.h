@@ -0,0 +1,226 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file MarkerStore.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef MARKERSTORE_H
+#define MARKERSTORE_H
+
+#include <vector>
+#include <cstddef>
+#include <opencv2/core/core.hpp>
+
+namespace xma
+{
+	enum markerStatus
+	{
+		UNTRACKABLE = -30,
+		DELETED = -20,
+		LOST = -10,
+		UNDEFINED = 0,
+		PREDICTED = 10,
+		INTERPOLATED = 20,
+		TRACKED = 40,
+		TRACKED_AND_OPTIMIZED = 45,
+		SET = 50,
+		SET_AND_OPTIMIZED = 55,
+		MANUAL = 60,
+		MANUAL_AND_OPTIMIZED = 65
+	};
+
+#ifdef XMA_FLOAT_PROJECTED_POINTS
+	typedef cv::Point2f projectedPoint;
+#else
+	typedef cv::Point2d projectedPoint;
+#endif
+
+	/// Columnar storage of the marker data of a trial. Every field is kept in a single aligned
+	/// array spanning all markers, laid out as [marker][camera][frame] so the frames of a marker
+	/// and camera are contiguous. Markers allocate a slot and access their data through the
+	/// views below. Allocating, releasing and resizing slots is not thread safe.
+	class MarkerStore
+	{
+	public:
+		MarkerStore();
+		//Deep copy of all slots, used to take snapshots of a trial which can be read from another thread
+		MarkerStore(const MarkerStore& other);
+		MarkerStore& operator=(const MarkerStore&) = delete;
+		virtual ~MarkerStore();
+
+		int allocate(int nbCameras, int nbFrames);
+		//Preallocates the storage for nbMarkers markers to avoid growing it marker by marker
+		void reserve(int nbCameras, int nbMarkers, int nbFrames);
+		void release(int slot);
+		void resize(int slot, int nbFrames);
+
+		int getNbCameras() const { return nbCameras; }
+		int getNbFrames(int slot) const { return frames[slot]; }
+		int getNbMarkers() const;
+		size_t getMemorySize() const;
+
+		cv::Point2d* getPoints2D(int slot, int camera) { return points2D + offset2D(slot, camera); }
+		projectedPoint* getPoints2D_projected(int slot, int camera) { return points2D_projected + offset2D(slot, camera); }
+		signed char* getStatus2D(int slot, int camera) { return status2D + offset2D(slot, camera); }
+		double* getError2D(int slot, int camera) { return error2D + offset2D(slot, camera); }
+		double* getMarkerSize(int slot, int camera) { return markerSize + offset2D(slot, camera); }
+
+		cv::Point3d* getPoints3D(int slot) { return points3D + offset3D(slot); }
+		signed char* getStatus3D(int slot) { return status3D + offset3D(slot); }
+		double* getError3D(int slot) { return error3D + offset3D(slot); }
+
+	private:
+		size_t offset2D(int slot, int camera) const { return ((size_t) slot * nbCameras + camera) * frameCapacity; }
+		size_t offset3D(int slot) const { return (size_t) slot * frameCapacity; }
+
+		void reallocate(int newSlotCapacity, int newFrameCapacity);
+		void setDefault(int slot, int start, int end);
+
+		int nbCameras;
+		int slotCapacity;
+		int frameCapacity;
+		std::vector<int> frames;
+		std::vector<int> freeSlots;
+
+		cv::Point2d* points2D;
+		projectedPoint* points2D_projected;
+		signed char* status2D;
+		double* error2D;
+		double* markerSize;
+
+		cv::Point3d* points3D;
+		signed char* status3D;
+		double* error3D;
+	};
+
+	/// Writable reference to a status stored as a single byte.
+	class MarkerStatusRef
+	{
+	public:
+		explicit MarkerStatusRef(signed char* _value) : value(_value) {}
+
+		operator markerStatus() const { return static_cast<markerStatus>(*value); }
+
+		MarkerStatusRef& operator=(markerStatus status)
+		{
+			*value = static_cast<signed char>(status);
+			return *this;
+		}
+
+		MarkerStatusRef& operator=(const MarkerStatusRef& other)
+		{
+			*value = *other.value;
+			return *this;
+		}
+
+	private:
+		signed char* value;
+	};
+
+	/// The frames of a single field of a marker for one camera.
+	template <typename T>
+	class MarkerStoreRow
+	{
+	public:
+		typedef T& reference;
+
+		MarkerStoreRow(T* _data, int _length) : data(_data), length(_length) {}
+
+		reference operator[](int frame) const { return data[frame]; }
+		size_t size() const { return length; }
+		T* begin() const { return data; }
+		T* end() const { return data + length; }
+		std::vector<T> toVector() const { return std::vector<T>(data, data + length); }
+
+	private:
+		T* data;
+		int length;
+	};
+
+	class MarkerStatusRow
+	{
+	public:
+		typedef MarkerStatusRef reference;
+
+		MarkerStatusRow(signed char* _data, int _length) : data(_data), length(_length) {}
+
+		reference operator[](int frame) const { return MarkerStatusRef(data + frame); }
+		size_t size() const { return length; }
+		std::vector<markerStatus> toVector() const
+		{
+			std::vector<markerStatus> status(length);
+			for (int i = 0; i < length; i++)
+				status[i] = static_cast<markerStatus>(data[i]);
+			return status;
+		}
+
+	private:
+		signed char* data;
+		int length;
+	};
+
+	/// View on a per camera field of a marker, indexed [camera][frame].
+	template <typename Row, typename T, T* (MarkerStore::*Field)(int, int)>
+	class MarkerStoreView2D
+	{
+	public:
+		MarkerStoreView2D() : store(nullptr), slot(-1) {}
+		MarkerStoreView2D(MarkerStore* _store, int _slot) : store(_store), slot(_slot) {}
+
+		Row operator[](int camera) const { return Row((store->*Field)(slot, camera), store->getNbFrames(slot)); }
+		size_t size() const { return store ? store->getNbCameras() : 0; }
+
+	private:
+		MarkerStore* store;
+		int slot;
+	};
+
+	/// View on a 3D field of a marker, indexed [frame].
+	template <typename Row, typename T, T* (MarkerStore::*Field)(int)>
+	class MarkerStoreView3D
+	{
+	public:
+		MarkerStoreView3D() : store(nullptr), slot(-1) {}
+		MarkerStoreView3D(MarkerStore* _store, int _slot) : store(_store), slot(_slot) {}
+
+		typename Row::reference operator[](int frame) const { return row()[frame]; }
+		size_t size() const { return store ? store->getNbFrames(slot) : 0; }
+		Row row() const { return Row((store->*Field)(slot), store->getNbFrames(slot)); }
+
+	private:
+		MarkerStore* store;
+		int slot;
+	};
+
+	typedef MarkerStoreView2D<MarkerStoreRow<cv::Point2d>, cv::Point2d, &MarkerStore::getPoints2D> MarkerPoints2DView;
+	typedef MarkerStoreView2D<MarkerStoreRow<projectedPoint>, projectedPoint, &MarkerStore::getPoints2D_projected> MarkerProjectedView;
+	typedef MarkerStoreView2D<MarkerStatusRow, signed char, &MarkerStore::getStatus2D> MarkerStatus2DView;
+	typedef MarkerStoreView2D<MarkerStoreRow<double>, double, &MarkerStore::getError2D> MarkerError2DView;
+	typedef MarkerStoreView2D<MarkerStoreRow<double>, double, &MarkerStore::getMarkerSize> MarkerSizeView;
+
+	typedef MarkerStoreView3D<MarkerStoreRow<cv::Point3d>, cv::Point3d, &MarkerStore::getPoints3D> MarkerPoints3DView;
+	typedef MarkerStoreView3D<MarkerStatusRow, signed char, &MarkerStore::getStatus3D> MarkerStatus3DView;
+	typedef MarkerStoreView3D<MarkerStoreRow<double>, double, &MarkerStore::getError3D> MarkerError3DView;
+}
+
+#endif // MARKERSTORE_H
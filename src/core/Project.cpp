@@ -255,6 +255,23 @@ void Project::checkCalibration()
 		calibrated = (*it)->isCalibrated() && calibrated;
 }
 
+void Project::setDirty(bool value)
+{
+	for (std::vector<Camera*>::iterator it = cameras.begin(); it != cameras.end(); ++it)
+		(*it)->setDirty(value);
+	for (std::vector<Trial*>::iterator it = trials.begin(); it != trials.end(); ++it)
+		(*it)->setAllDirty(value);
+}
+
+bool Project::isDirty()
+{
+	for (std::vector<Camera*>::iterator it = cameras.begin(); it != cameras.end(); ++it)
+		if ((*it)->isDirty()) return true;
+	for (std::vector<Trial*>::iterator it = trials.begin(); it != trials.end(); ++it)
+		if ((*it)->isDirty()) return true;
+	return false;
+}
+
 void Project::addCamera(Camera* cam)
 {
 	cameras.push_back(cam);
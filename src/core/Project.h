@@ -59,6 +59,10 @@ namespace xma
 		int getNbImagesCalibration();
 		bool isCalibrated();
 		void checkCalibration();
+		//Sets the dirty state of all cameras and trials including their markers and rigid bodies
+		void setDirty(bool value);
+		//True if any camera or trial changed since the project was last saved or loaded
+		bool isDirty();
 
 		void addCamera(Camera* cam);
 		void addTrial(Trial* trial);
@@ -37,10 +37,14 @@
 #include "core/UndistortionObject.h"
 #include "core/CalibrationImage.h"
 #include "core/HelperFunctions.h"
+#include "core/CSVWriter.h"
 #include "core/RigidBodyObj.h"
-#include "processing/ButterworthLowPassFilter.h" //should move this dependency
+#include "core/Tracer.h"
+#include "gl/OverlayBuffer.h"
+#include "processing/FilterBank.h" //should move this dependency
 #include "processing/RigidBodyPoseOptimization.h"
 #include "processing/RigidBodyPoseFrom2D.h"
+#include "processing/MotionPredictor.h"
 
 #include <fstream>
 
@@ -61,6 +65,19 @@
 
 using namespace xma;
 
+namespace
+{
+	//number of previous frames used for the pose prediction
+	const int posePredictionWindow = 10;
+	//measurement and process noise of the pose prediction in radian and mm
+	const double poseRotationNoise = 0.002;
+	const double poseRotationProcessNoise = 0.001;
+	const double poseTranslationNoise = 0.01;
+	const double poseTranslationProcessNoise = 0.01;
+	//3 sigma radius of the marker position relative to the rigid body in pixel if the body has no reprojection error yet
+	const double defaultMeasurementRadius = 1.5;
+}
+
 RigidBody::RigidBody(int size, Trial* _trial)
 {
 	expanded = false;
@@ -75,11 +92,13 @@ RigidBody::RigidBody(int size, Trial* _trial)
 	overrideCutoffFrequency = false;
 	hasOptimizedCoordinates = false;
 	meshScale = 1.0;
+	dirty = true;
 	init(size);
 }
 
 void RigidBody::copyData(RigidBody* rb)
 {
+	setDirty();
 	setDescription(rb->getDescription());
 	clearPointIdx();
 
@@ -202,6 +221,7 @@ Marker* RigidBody::getMarker(int idx)
 
 void RigidBody::clearPointIdx()
 {
+	setDirty();
 	pointsIdx.clear();
 	points3D.clear();
 	referenceNames.clear();
@@ -210,11 +230,13 @@ void RigidBody::clearPointIdx()
 
 void RigidBody::setPointIdx(int idx, int markerIdx)
 {
+	setDirty();
 	pointsIdx[idx] = markerIdx;
 }
 
 void RigidBody::addPointIdx(int idx, bool recompute)
 {
+	setDirty();
 	pointsIdx.push_back(idx);
 	points3D.push_back(cv::Point3d(0, 0, 0));
 	points3D_original.push_back(cv::Point3d(0, 0, 0));
@@ -229,6 +251,7 @@ void RigidBody::addPointIdx(int idx, bool recompute)
 
 void RigidBody::removePointIdx(int idx)
 {
+	setDirty();
 	int pos = std::find(pointsIdx.begin(), pointsIdx.end(), idx) - pointsIdx.begin();
 	if (pos < pointsIdx.size()){
 		points3D.erase(std::remove(points3D.begin(), points3D.end(), points3D[pos]), points3D.end());
@@ -243,6 +266,7 @@ void RigidBody::removePointIdx(int idx)
 
 void RigidBody::updatePointIdx(int idx)
 {
+	setDirty();
 	bool requiresUpdate = false;
 	for (std::vector<int>::iterator it = pointsIdx.begin(); it < pointsIdx.end(); ++it)
 	{
@@ -260,6 +284,7 @@ void RigidBody::updatePointIdx(int idx)
 
 void RigidBody::resetReferences()
 {
+	setDirty();
 	for (unsigned int i = 0; i < referenceNames.size(); i++)
 	{
 		referenceNames[i] = "";
@@ -316,6 +341,16 @@ bool RigidBody::transformPoint(cv::Point3d in, cv::Point3d& out, int frame, bool
 	return false;
 }
 
+bool RigidBody::hasDummyPointsFromRigidBodies()
+{
+	for (unsigned int i = 0; i < dummyRBIndex.size(); i++)
+	{
+		if (dummyRBIndex[i] >= 0)
+			return true;
+	}
+	return false;
+}
+
 bool RigidBody::addMeshModel(QString filename)
 {
 	if (meshmodel != NULL)
@@ -541,6 +576,7 @@ int RigidBody::addDummyPointsForOptimization(std::vector<cv::Point2d>& Pts2D, st
 
 void RigidBody::setReferenceMarkerReferences()
 {
+	setDirty();
 	if (allReferenceMarkerReferencesSet())
 	{
 		for (unsigned int i = 0; i < pointsIdx.size(); i++)
@@ -592,6 +628,7 @@ void RigidBody::clear()
 
 void RigidBody::addFrame()
 {
+	setDirty();
 	rotationvectors.push_back(cv::Vec3d());
 	translationvectors.push_back(cv::Vec3d());
 	rotationvectors_filtered.push_back(cv::Vec3d());
@@ -613,6 +650,7 @@ void RigidBody::addFrame()
 
 void RigidBody::clearAllDummyPoints()
 {
+	setDirty();
 	dummyNames.clear();
 	dummypoints.clear();
 	dummypoints2.clear();
@@ -671,6 +709,7 @@ void RigidBody::init(int size)
 
 void RigidBody::computeCoordinateSystemAverage()
 {
+	setDirty();
 	if (!isReferencesSet())
 	{
 		std::vector<cv::Point3d> points3D_mean;
@@ -821,6 +860,7 @@ void RigidBody::computeCoordinateSystemAverage()
 
 void RigidBody::setOptimized(bool optimized)
 {
+	setDirty();
 	hasOptimizedCoordinates = false;
 	points3D = points3D_original;
 
@@ -978,6 +1018,7 @@ void RigidBody::computeCoordinateSystem(int Frame)
 
 void RigidBody::computePose(int Frame)
 {
+	XMA_TRACE_SCOPE("RigidBodyPose");
 	while (Frame >= (int) poseComputed.size()) addFrame();
 
 	poseComputed[Frame] = 0;
@@ -1504,6 +1545,7 @@ void RigidBody::saveOptimized(QString filename_points3DOptimized, bool withHeade
 
 void RigidBody::load(QString filename_referenceNames, QString filename_points3D)
 {
+	setDirty();
 	std::ifstream fin;
 	std::istringstream in;
 	std::string line;
@@ -1543,6 +1585,7 @@ void RigidBody::load(QString filename_referenceNames, QString filename_points3D)
 
 void RigidBody::loadOptimized(QString filename_points3DOptimized)
 {
+	setDirty();
 	std::ifstream fin;
 	std::istringstream in;
 	std::string line;
@@ -1576,6 +1619,7 @@ void RigidBody::recomputeTransformations()
 	}
 
 	makeRotationsContinous();
+	trial->invalidateData();
 }
 
 void RigidBody::makeRotationsContinous()
@@ -1585,20 +1629,25 @@ void RigidBody::makeRotationsContinous()
 	{
 		if (poseComputed[i - 1] && poseComputed[i])
 		{
-			double d = rotationvectors[i - 1].dot(rotationvectors[i]);
-			double diffangle = d / cv::norm(rotationvectors[i - 1]) / cv::norm(rotationvectors[i]);
-
-			if (180 / M_PI * acos(diffangle) > 150)
-			{
-				double angle = cv::norm(rotationvectors[i]);
-				rotationvectors[i][0] = -rotationvectors[i][0] / angle * (2 * M_PI - angle);
-				rotationvectors[i][1] = -rotationvectors[i][1] / angle * (2 * M_PI - angle);
-				rotationvectors[i][2] = -rotationvectors[i][2] / angle * (2 * M_PI - angle);
-			}
+			makeRotationContinous(rotationvectors[i - 1], rotationvectors[i]);
 		}
 	}
 }
 
+void RigidBody::makeRotationContinous(const cv::Vec3d& previous, cv::Vec3d& rotation)
+{
+	double d = previous.dot(rotation);
+	double diffangle = d / cv::norm(previous) / cv::norm(rotation);
+
+	if (180 / M_PI * acos(diffangle) > 150)
+	{
+		double angle = cv::norm(rotation);
+		rotation[0] = -rotation[0] / angle * (2 * M_PI - angle);
+		rotation[1] = -rotation[1] / angle * (2 * M_PI - angle);
+		rotation[2] = -rotation[2] / angle * (2 * M_PI - angle);
+	}
+}
+
 void RigidBody::filterData(std::vector<int> idx)
 {
 	if (idx.size() <= 12)
@@ -1617,69 +1666,30 @@ void RigidBody::filterData(std::vector<int> idx)
 	}
 	else
 	{
-		std::vector<double> t1;
-		std::vector<double> t2;
-		std::vector<double> t3;
-		std::vector<double> r1;
-		std::vector<double> r2;
-		std::vector<double> r3;
-		std::vector<double> r4;
-
+		//translation and rotation are filtered together as interleaved channels
+		std::vector<double> pose(6 * idx.size());
 		for (unsigned int i = 0; i < idx.size(); i++)
 		{
-			r1.push_back(rotationvectors[idx[i]][0]);
-			r2.push_back(rotationvectors[idx[i]][1]);
-			r3.push_back(rotationvectors[idx[i]][2]);
-
-			t1.push_back(translationvectors[idx[i]][0]);
-			t2.push_back(translationvectors[idx[i]][1]);
-			t3.push_back(translationvectors[idx[i]][2]);
+			for (int j = 0; j < 3; j++)
+			{
+				pose[6 * i + j] = translationvectors[idx[i]][j];
+				pose[6 * i + 3 + j] = rotationvectors[idx[i]][j];
+			}
 		}
 
-		std::vector<double> t1_out;
-		std::vector<double> t2_out;
-		std::vector<double> t3_out;
-		std::vector<double> r1_out;
-		std::vector<double> r2_out;
-		std::vector<double> r3_out;
-
 		double cutoff = (getOverrideCutoffFrequency()) ? getCutoffFrequency() : trial->getCutoffFrequency();
 
-		ButterworthLowPassFilter* filter = new ButterworthLowPassFilter(4, cutoff, trial->getRecordingSpeed());
-
-		filter->filter(t1, t1_out);
-		filter->filter(t2, t2_out);
-		filter->filter(t3, t3_out);
-		filter->filter(r1, r1_out);
-		filter->filter(r2, r2_out);
-		filter->filter(r3, r3_out);
+		FilterBank::getInstance()->filtfilt(4, cutoff, trial->getRecordingSpeed(), &pose[0], &pose[0], idx.size(), 6);
 
 		for (unsigned int i = 0; i < idx.size(); i++)
 		{
-			translationvectors_filtered[idx[i]][0] = t1_out[i];
-			translationvectors_filtered[idx[i]][1] = t2_out[i];
-			translationvectors_filtered[idx[i]][2] = t3_out[i];
-
-			rotationvectors_filtered[idx[i]][0] = r1_out[i];
-			rotationvectors_filtered[idx[i]][1] = r2_out[i];
-			rotationvectors_filtered[idx[i]][2] = r3_out[i];
+			for (int j = 0; j < 3; j++)
+			{
+				translationvectors_filtered[idx[i]][j] = pose[6 * i + j];
+				rotationvectors_filtered[idx[i]][j] = pose[6 * i + 3 + j];
+			}
 			poseFiltered[idx[i]] = 1;
 		}
-
-		delete filter;
-
-		t1_out.clear();
-		t2_out.clear();
-		t3_out.clear();
-		r1_out.clear();
-		r2_out.clear();
-		r3_out.clear();
-		t1.clear();
-		t2.clear();
-		t3.clear();
-		r1.clear();
-		r2.clear();
-		r3.clear();
 	}
 }
 
@@ -1696,7 +1706,7 @@ void RigidBody::filterTransformations()
 		{
 			std::vector<cv::Point3d> marker;
 			std::vector<markerStatus> status;
-			trial->getMarkers()[pointsIdx[i]]->filterMarker(cutoff, trial->getMarkers()[pointsIdx[i]]->getPoints3D(), trial->getMarkers()[pointsIdx[i]]->getStatus3D()
+			trial->getMarkers()[pointsIdx[i]]->filterMarker(cutoff, trial->getMarkers()[pointsIdx[i]]->getPoints3D().row().toVector(), trial->getMarkers()[pointsIdx[i]]->getStatus3D().row().toVector()
 				, marker, status);
 
 			status3d_filtered.push_back(status);
@@ -1933,6 +1943,7 @@ void RigidBody::filterTransformations()
 	{
 		updateError(i, true);
 	}
+	trial->invalidateData();
 }
 
 Trial* RigidBody::getTrial()
@@ -1942,6 +1953,7 @@ Trial* RigidBody::getTrial()
 
 void RigidBody::addDummyPoint(QString name, QString filenamePointRef, QString filenamePointRef2, int markerID, QString filenamePointCoords)
 {
+	setDirty();
 	dummyNames.push_back(name);
 
 	std::ifstream fin;
@@ -2163,9 +2175,9 @@ void RigidBody::saveTransformations(QString filename, bool inverse, bool filtere
 {
 	if (!filename.isEmpty())
 	{
-		std::ofstream outfile(filename.toStdString());
-		outfile.precision(12);
-		for (int i = 0; i < trial->getNbImages(); i++)
+		//the rows are formatted in parallel blocks and written at once
+		CSVWriter writer;
+		writer.appendRows(trial->getNbImages(), [&](CSVWriter& row, int i)
 		{
 			if ((poseComputed[i] && !filtered) || (poseFiltered[i] && filtered))
 			{
@@ -2242,22 +2254,24 @@ void RigidBody::saveTransformations(QString filename, bool inverse, bool filtere
 					m[15] = 1.0;
 				}
 
-				outfile << m[0] << "," << m[1] << "," << m[2] << "," << m[3] << ",";
-				outfile << m[4] << "," << m[5] << "," << m[6] << "," << m[7] << ",";
-				outfile << m[8] << "," << m[9] << "," << m[10] << "," << m[11] << ",";
-				outfile << m[12] << "," << m[13] << "," << m[14] << "," << m[15];
+				for (int c = 0; c < 16; c++)
+				{
+					if (c > 0)
+						row.append(',');
+					row.append(m[c]);
+				}
 			}
 			else
 			{
-				outfile << "NaN,NaN,NaN,NaN,";
-				outfile << "NaN,NaN,NaN,NaN,";
-				outfile << "NaN,NaN,NaN,NaN,";
-				outfile << "NaN,NaN,NaN,NaN";
+				row.append("NaN,NaN,NaN,NaN,");
+				row.append("NaN,NaN,NaN,NaN,");
+				row.append("NaN,NaN,NaN,NaN,");
+				row.append("NaN,NaN,NaN,NaN");
 			}
 
-			outfile << std::endl;
-		}
-		outfile.close();
+			row.append('\n');
+		});
+		writer.write(filename);
 	}
 }
 
@@ -2441,6 +2455,112 @@ std::vector<cv::Point2d> RigidBody::projectToImage(Camera* cam, int Frame, bool
 	return points2D_frame;
 }
 
+bool RigidBody::predictPose(int Frame, bool forward, cv::Vec3d& rotVec, cv::Vec3d& transVec, cv::Vec3d& rotSigma, cv::Vec3d& transSigma)
+{
+	int dir = forward ? 1 : -1;
+
+	//consecutive computed poses before the frame, oldest first
+	std::vector<cv::Point3d> rotations;
+	std::vector<cv::Point3d> translations;
+	for (int k = posePredictionWindow; k >= 1; k--)
+	{
+		int f = Frame - k * dir;
+		if (f < 0 || f >= (int) poseComputed.size() || !poseComputed[f])
+		{
+			rotations.clear();
+			translations.clear();
+			continue;
+		}
+
+		cv::Vec3d rotation = rotationvectors[f];
+		if (!rotations.empty())
+		{
+			const cv::Point3d& last = rotations.back();
+			makeRotationContinous(cv::Vec3d(last.x, last.y, last.z), rotation);
+		}
+		rotations.push_back(cv::Point3d(rotation[0], rotation[1], rotation[2]));
+		translations.push_back(cv::Point3d(translationvectors[f]));
+	}
+
+	cv::Point3d rot, trans, rotS, transS;
+	if (!MotionPredictor::predict(rotations, poseRotationNoise, poseRotationProcessNoise, rot, rotS)
+		|| !MotionPredictor::predict(translations, poseTranslationNoise, poseTranslationProcessNoise, trans, transS))
+		return false;
+
+	rotVec = cv::Vec3d(rot.x, rot.y, rot.z);
+	transVec = cv::Vec3d(trans.x, trans.y, trans.z);
+	rotSigma = cv::Vec3d(rotS.x, rotS.y, rotS.z);
+	transSigma = cv::Vec3d(transS.x, transS.y, transS.z);
+	return true;
+}
+
+bool RigidBody::predictProjection(Camera* cam, int Frame, bool forward, std::vector<cv::Point2d>& points, std::vector<double>& radii)
+{
+	points.clear();
+	radii.clear();
+
+	if (!isReferencesSet() || Project::getInstance()->getCalibration() == NO_CALIBRATION)
+		return false;
+
+	cv::Vec3d rotVec, transVec, rotSigma, transSigma;
+	if (!predictPose(Frame, forward, rotVec, transVec, rotSigma, transSigma))
+		return false;
+
+	//the markers deviate from the body by its reprojection error, which is not contained in the pose
+	int dir = forward ? 1 : -1;
+	double measurementRadius = 0;
+	int count = 0;
+	for (int k = 1; k <= posePredictionWindow; k++)
+	{
+		int f = Frame - k * dir;
+		if (f < 0 || f >= (int) poseComputed.size() || f >= (int) errorMean2D.size() || !poseComputed[f] || errorMean2D[f] <= 0)
+			continue;
+		//the deviation is undefined if a single marker was visible
+		measurementRadius += errorMean2D[f] + (std::isfinite(errorSd2D[f]) ? 3.0 * errorSd2D[f] : 0.0);
+		count++;
+	}
+	measurementRadius = (count > 0) ? measurementRadius / count : defaultMeasurementRadius;
+
+	const std::vector<cv::Point3d>& references = points3D;
+	int reference = trial->getReferenceCalibrationImage();
+
+	//the predicted pose and the poses offset by 3 sigma in each of the 6 parameters
+	std::vector<cv::Mat> rotations;
+	std::vector<cv::Vec3d> translations;
+	for (int p = 0; p <= 6; p++)
+	{
+		cv::Vec3d r = rotVec;
+		cv::Vec3d t = transVec;
+		if (p >= 1 && p <= 3) r[p - 1] += 3.0 * rotSigma[p - 1];
+		if (p >= 4) t[p - 4] += 3.0 * transSigma[p - 4];
+
+		cv::Mat rotMat;
+		cv::Rodrigues(r, rotMat);
+		rotations.push_back(rotMat.t());
+		translations.push_back(t);
+	}
+
+	for (unsigned int i = 0; i < references.size(); i++)
+	{
+		cv::Point2d projected[7];
+		for (int p = 0; p <= 6; p++)
+		{
+			cv::Mat tmp_mat = rotations[p] * (cv::Mat(references[i], true) - cv::Mat(translations[p]));
+			projected[p] = cam->projectPoint(cv::Point3d(tmp_mat.at<double>(0, 0), tmp_mat.at<double>(1, 0), tmp_mat.at<double>(2, 0)), reference);
+		}
+
+		double radius2 = 0;
+		for (int p = 1; p <= 6; p++)
+		{
+			cv::Point2d offset = projected[p] - projected[0];
+			radius2 += offset.dot(offset);
+		}
+		points.push_back(projected[0]);
+		radii.push_back(sqrt(radius2 + measurementRadius * measurementRadius));
+	}
+	return true;
+}
+
 void RigidBody::setMissingPoints(int Frame)
 {
 	if (poseComputed[Frame])
@@ -2464,6 +2584,7 @@ void RigidBody::setMissingPoints(int Frame)
 
 int RigidBody::setReferenceFromFile(QString filename)
 {
+	setDirty();
 	// setup all possibilities
 	QString tmp_names;
 	QString tmp_coords;
@@ -2551,6 +2672,7 @@ int RigidBody::setReferenceFromFile(QString filename)
 
 bool RigidBody::setReferenceFromFrame(int frame)
 {
+	setDirty();
 	bool canSet = true;
 	for (unsigned int i = 0; i < pointsIdx.size(); i++)
 	{
@@ -2584,6 +2706,7 @@ int RigidBody::isReferencesSet()
 
 void RigidBody::setReferencesSet(int value)
 {
+	setDirty();
 	referencesSet = value;
 	updateCenter();
 }
@@ -2636,6 +2759,7 @@ bool RigidBody::getVisible()
 void RigidBody::setVisible(bool value)
 {
 	visible = value;
+	if (trial) trial->invalidateData();
 }
 
 bool RigidBody::getHasOptimizedCoordinates()
@@ -2643,6 +2767,17 @@ bool RigidBody::getHasOptimizedCoordinates()
 	return hasOptimizedCoordinates;
 }
 
+bool RigidBody::isDirty()
+{
+	return dirty;
+}
+
+void RigidBody::setDirty(bool value)
+{
+	dirty = value;
+	if (value && trial) trial->invalidateData();
+}
+
 QColor RigidBody::getColor()
 {
 	return color;
@@ -2651,22 +2786,24 @@ QColor RigidBody::getColor()
 void RigidBody::setColor(QColor value)
 {
 	color.setRgb(value.red(), value.green(), value.blue());
+	if (trial) trial->invalidateData();
 }
 
-void RigidBody::draw2D(Camera* cam, int frame)
+void RigidBody::draw2D(Camera* cam, int frame, OverlayBuffer& overlay)
 {
-	if (visible && (int) poseComputed.size() > frame && (poseComputed[frame] || (Settings::getInstance()->getBoolSetting("TrialDrawFiltered") && poseFiltered[frame])) && isReferencesSet())
+	bool drawFiltered = Settings::getInstance()->getBoolSetting("TrialDrawFiltered");
+	if (visible && (int) poseComputed.size() > frame && (poseComputed[frame] || (drawFiltered && poseFiltered[frame])) && isReferencesSet())
 	{
-		std::vector<cv::Point2d> points2D_projected = projectToImage(cam, frame, true, false, false, Settings::getInstance()->getBoolSetting("TrialDrawFiltered"));
+		std::vector<cv::Point2d> points2D_projected = projectToImage(cam, frame, true, false, false, drawFiltered);
 
+		overlay.begin(GL_LINES);
+		overlay.colorub(color.red(), color.green(), color.blue());
 		for (unsigned int i = 1; i < points2D_projected.size(); i++)
 		{
-			glBegin(GL_LINES);
-			glColor3ub(color.red(), color.green(), color.blue());
-			glVertex2f(points2D_projected[0].x, points2D_projected[0].y);
-			glVertex2f(points2D_projected[i].x, points2D_projected[i].y);
-			glEnd();
+			overlay.vertex(points2D_projected[0].x, points2D_projected[0].y);
+			overlay.vertex(points2D_projected[i].x, points2D_projected[i].y);
 		}
+		overlay.end();
 
 		if (dummyNames.size() > 0)
 		{
@@ -2676,7 +2813,7 @@ void RigidBody::draw2D(Camera* cam, int frame)
 				if (dummyRBIndex[i] >= 0)
 				{
 					cv::Point3d dummy_tmp;
-					if (trial->getRigidBodies()[dummyRBIndex[i]]->transformPoint(dummypoints2[i], dummy_tmp, frame, Settings::getInstance()->getBoolSetting("TrialDrawFiltered")))
+					if (trial->getRigidBodies()[dummyRBIndex[i]]->transformPoint(dummypoints2[i], dummy_tmp, frame, drawFiltered))
 					{
 						count++;
 					}
@@ -2692,44 +2829,42 @@ void RigidBody::draw2D(Camera* cam, int frame)
 			points2D_projected.clear();
 			points2D_projected = projectToImage(cam, frame, true, true);
 
-			glLineStipple(10, 0xAAAA);
-			glEnable(GL_LINE_STIPPLE);
+			overlay.setStipple(true);
+			overlay.begin(GL_LINES);
+			overlay.colorub(color.red(), color.green(), color.blue());
 			for (unsigned int i = 1; i < points2D_projected.size(); i++)
 			{
-				glBegin(GL_LINES);
-				glColor3ub(color.red(), color.green(), color.blue());
-				glVertex2f(points2D_projected[0].x, points2D_projected[0].y);
-				glVertex2f(points2D_projected[i].x, points2D_projected[i].y);
-				glEnd();
+				overlay.vertex(points2D_projected[0].x, points2D_projected[0].y);
+				overlay.vertex(points2D_projected[i].x, points2D_projected[i].y);
 			}
-			glDisable(GL_LINE_STIPPLE);
+			overlay.end();
+			overlay.setStipple(false);
 
 			points2D_projected.clear();
 			points2D_projected = projectToImage(cam, frame, false, true, true);
 
+			overlay.begin(GL_LINES);
+			overlay.colorub(color.red(), color.green(), color.blue());
 			for (unsigned int i = 0; i < points2D_projected.size(); i++)
 			{
 				double x = points2D_projected[i].x;
 				double y = points2D_projected[i].y;
 
-				glBegin(GL_LINES);
-				glColor3ub(color.red(), color.green(), color.blue());
-				glVertex2f(x - 5, y);
-				glVertex2f(x + 5, y);
-				glVertex2f(x, y - 5);
-				glVertex2f(x, y + 5);
-				glEnd();
+				overlay.vertex(x - 5, y);
+				overlay.vertex(x + 5, y);
+				overlay.vertex(x, y - 5);
+				overlay.vertex(x, y + 5);
 			}
+			overlay.end();
 		}
 	}
 }
 
-void RigidBody::draw3D(int frame)
+void RigidBody::draw3D(int frame, OverlayBuffer& overlay)
 {
-	if (visible && (getPoseComputed()[frame] || (Settings::getInstance()->getBoolSetting("TrialDrawFiltered") && getPoseFiltered()[frame])) && isReferencesSet())
+	bool filtered_trans = Settings::getInstance()->getBoolSetting("TrialDrawFiltered");
+	if (visible && (getPoseComputed()[frame] || (filtered_trans && getPoseFiltered()[frame])) && isReferencesSet())
 	{
-		bool filtered_trans = Settings::getInstance()->getBoolSetting("TrialDrawFiltered");
-		glPushMatrix();
 		double m[16];
 		//inversere Rotation = transposed rotation
 		//and opengl requires transposed, so we set R
@@ -2745,38 +2880,41 @@ void RigidBody::draw3D(int frame)
 		}
 		//inverse translation = translation rotated with inverse rotation/transposed rotation
 		//R-1 * -t = R^tr * -t
-		m[12] = m[0] * -getTranslationVector(filtered_trans)[frame][0] + m[4] * -getTranslationVector(filtered_trans)[frame][1] + m[8] * -getTranslationVector(filtered_trans)[frame][2];
-		m[13] = m[1] * -getTranslationVector(filtered_trans)[frame][0] + m[5] * -getTranslationVector(filtered_trans)[frame][1] + m[9] * -getTranslationVector(filtered_trans)[frame][2];
-		m[14] = m[2] * -getTranslationVector(filtered_trans)[frame][0] + m[6] * -getTranslationVector(filtered_trans)[frame][1] + m[10] * -getTranslationVector(filtered_trans)[frame][2];
+		cv::Vec3d t = getTranslationVector(filtered_trans)[frame];
+		m[12] = m[0] * -t[0] + m[4] * -t[1] + m[8] * -t[2];
+		m[13] = m[1] * -t[0] + m[5] * -t[1] + m[9] * -t[2];
+		m[14] = m[2] * -t[0] + m[6] * -t[1] + m[10] * -t[2];
 		m[15] = 1.0;
 
-		glMultMatrixd(m);
+		//same as drawing with glMultMatrixd(m)
+		auto vertex = [&](const cv::Point3d& p)
+		{
+			overlay.vertex(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+				m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+				m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+		};
 
+		overlay.begin(GL_LINES);
+		overlay.colorub(color.red(), color.green(), color.blue());
 		for (unsigned int i = 0; i < points3D.size(); i++)
 		{
-			glColor3ub(color.red(), color.green(), color.blue());
-			glBegin(GL_LINES);
-			glVertex3d(center.x, center.y, center.z);
-			glVertex3d(points3D[i].x, points3D[i].y, points3D[i].z);
-			glEnd();
+			vertex(center);
+			vertex(points3D[i]);
 		}
+		overlay.end();
 
 		if (dummypoints.size() > 0)
 		{
-			glLineStipple(10, 0xAAAA);
-			glEnable(GL_LINE_STIPPLE);
+			overlay.setStipple(true);
+			overlay.begin(GL_LINES);
 			for (unsigned int i = 1; i < dummypoints.size(); i++)
 			{
-				glBegin(GL_LINES);
-				glColor3ub(color.red(), color.green(), color.blue());
-				glVertex3d(center.x, center.y, center.z);
-				glVertex3d(dummypoints[i].x, dummypoints[i].y, dummypoints[i].z);
-				glEnd();
+				vertex(center);
+				vertex(dummypoints[i]);
 			}
-			glDisable(GL_LINE_STIPPLE);
+			overlay.end();
+			overlay.setStipple(false);
 		}
-
-		glPopMatrix();
 	}
 }
 
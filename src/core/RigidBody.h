@@ -40,6 +40,7 @@ namespace xma
 	class Camera;
 	class Marker;
 	class RigidBodyObj;
+	class OverlayBuffer;
 
 
 	class RigidBody
@@ -92,6 +93,11 @@ namespace xma
 		void setOptimized(bool optimized);
 
 		std::vector<cv::Point2d> projectToImage(Camera* cam, int Frame, bool with_center, bool dummy = false, bool dummy_frame = false, bool filtered = false);
+		//Extrapolates the poses of the previous frames in tracking direction to Frame. Sigma is the standard deviation of the prediction.
+		bool predictPose(int Frame, bool forward, cv::Vec3d& rotVec, cv::Vec3d& transVec, cv::Vec3d& rotSigma, cv::Vec3d& transSigma);
+		//Projects the markers with the predicted pose into the camera. radii are the 3 sigma search radii in pixel and contain
+		//the uncertainty of the pose and the reprojection error of the body in the previous frames.
+		bool predictProjection(Camera* cam, int Frame, bool forward, std::vector<cv::Point2d>& points, std::vector<double>& radii);
 		void setMissingPoints(int Frame);
 
 		int setReferenceFromFile(QString filename);
@@ -121,13 +127,19 @@ namespace xma
 
 		bool getHasOptimizedCoordinates();
 
+		//Changed since the project was last saved or loaded. Unchanged rigid bodies are copied from the previous archive when saving.
+		bool isDirty();
+		void setDirty(bool value = true);
+
 		QColor getColor();
 		void setColor(QColor value);
 
-		void draw2D(Camera* cam, int frame);
-		void draw3D(int frame);
+		void draw2D(Camera* cam, int frame, OverlayBuffer& overlay);
+		//the lines are transformed to world coordinates when recorded into the overlay
+		void draw3D(int frame, OverlayBuffer& overlay);
 		void recomputeTransformations();
 		void makeRotationsContinous();
+		static void makeRotationContinous(const cv::Vec3d& previous, cv::Vec3d& rotation);
 		void filterTransformations();
 
 		Trial* getTrial();
@@ -140,6 +152,7 @@ namespace xma
 		bool allReferenceMarkerReferencesSet();
 
 		bool transformPoint(cv::Point3d in, cv::Point3d& out, int frame, bool filtered = false);
+		bool hasDummyPointsFromRigidBodies();
 
 		bool addMeshModel(QString filename);
 		bool hasMeshModel();
@@ -175,6 +188,7 @@ namespace xma
 		bool initialised;
 		int referencesSet;
 		bool hasOptimizedCoordinates;
+		bool dirty;
 		bool overrideCutoffFrequency;
 		double cutoffFrequency;
 
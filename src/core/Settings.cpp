@@ -67,6 +67,11 @@ Settings::Settings()
 	addBoolSetting("ExportAllEnabled", false);
 	addBoolSetting("DisableImageSearch", false);
 	addBoolSetting("RecomputeWhenSaving", false);
+	addIntSetting("VideoFrameCacheSize", 16);
+	addIntSetting("VideoMaxOpenStreams", 16);
+	addIntSetting("VideoMaxMemoryMB", 2048);
+	addIntSetting("AutosaveInterval", 10);
+	addIntSetting("AutosaveRetention", 5);
 
 	//Undistortion
 	addIntSetting("LocalUndistortionNeighbours", 12);
@@ -77,6 +82,7 @@ Settings::Settings()
 	addIntSetting("DetectionMethodForCalibration", 0);
 	addBoolSetting("ShowAdvancedCalibration", false);
 	addBoolSetting("HideWarningsDuringCalibration", false);
+	addIntSetting("CalibrationImageCacheSize", 1024);
 	addIntSetting("IdentificationThresholdCalibration", 15);
 	addIntSetting("OutlierThresholdForCalibration", 10);
 	addBoolSetting("DisableCheckerboardDetection", false);
@@ -91,6 +97,17 @@ Settings::Settings()
 	addBoolSetting("Show3dPointDetailView", false);
 	addBoolSetting("ShowEpiLineDetailView", true);
 	addIntSetting("TriangulationMethod", 1);
+	addIntSetting("TrackingPredictor", 0);
+	addBoolSetting("TrackingRigidBodyPrediction", false);
+	addBoolSetting("TrackingEpipolarConstraint", false);
+	addIntSetting("TrackingEpipolarBandWidth", 6);
+	addBoolSetting("TrackingPyramid", false);
+	addIntSetting("TrackingPyramidSearchArea", 120);
+	addIntSetting("AutoDetectionBlobColor", 0);
+	addFloatSetting("AutoDetectionMaxEpipolarDistance", 3.0);
+	addFloatSetting("AutoDetectionMaxReprojectionError", 2.0);
+	addFloatSetting("AutoDetectionMaxLinkDistance", 2.0);
+	addIntSetting("AutoDetectionMaxGap", 5);
 	addFloatSetting("MaximumReprojectionError", 5.0);
 	addBoolSetting("RetrackOptimizedTrackedPoints", true);
 	addBoolSetting("TrackInterpolatedPoints", true);
@@ -201,6 +218,7 @@ Settings::Settings()
 	addBoolSetting("TrialDrawRigidBodyConstellation", true);
 	addBoolSetting("TrialDrawRigidBodyMeshmodels", true);
 	addBoolSetting("TrialDrawFiltered", false);
+	addBoolSetting("WorldViewDrawTrajectories", false);
 
 
 	addBoolSetting("ShowMarkerStates", false);
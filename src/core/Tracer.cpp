@@ -0,0 +1,253 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Tracer.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/Tracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+using namespace xma;
+
+namespace
+{
+	//65536 spans per thread
+	const int TRACE_BUFFER_CAPACITY = 1 << 16;
+
+	//returns the buffer to the tracer when the thread exits, e.g. when an idle thread of a QThreadPool expires
+	struct ThreadBufferOwner
+	{
+		TraceBuffer* buffer = nullptr;
+
+		~ThreadBufferOwner()
+		{
+			if (buffer)
+				Tracer::getInstance()->releaseThreadBuffer(buffer);
+		}
+	};
+
+	thread_local ThreadBufferOwner threadBuffer;
+
+	long long steadyNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+TraceBuffer::TraceBuffer(int _id, QString _name, int capacity) : id(_id), name(_name), slots(capacity), head(0), begin(0)
+{
+}
+
+void TraceBuffer::getEvents(std::vector<TraceEvent>& out) const
+{
+	size_t end = head.load(std::memory_order_acquire);
+	size_t first = std::max(begin.load(std::memory_order_relaxed), (end > slots.size()) ? end - slots.size() : 0);
+	size_t offset = out.size();
+	for (size_t i = first; i < end; i++)
+	{
+		const Slot& slot = slots[i % slots.size()];
+		TraceEvent event;
+		event.name = slot.name.load(std::memory_order_relaxed);
+		event.start = slot.start.load(std::memory_order_relaxed);
+		event.duration = slot.duration.load(std::memory_order_relaxed);
+		out.push_back(event);
+	}
+
+	//the thread may have overwritten spans while they were copied, they are dropped including the slot
+	//which is written right now
+	std::atomic_thread_fence(std::memory_order_acquire);
+	size_t current = head.load(std::memory_order_relaxed);
+	if (current + 1 > first + slots.size())
+	{
+		size_t overwritten = std::min(current + 1 - slots.size() - first, end - first);
+		out.erase(out.begin() + offset, out.begin() + offset + overwritten);
+	}
+}
+
+void TraceBuffer::clear()
+{
+	begin.store(head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+Tracer* Tracer::getInstance()
+{
+	//spans are recorded from worker threads, so the instance has to be created thread safe
+	static Tracer instance;
+	return &instance;
+}
+
+Tracer::Tracer() : enabled(false), epoch(steadyNanoseconds())
+{
+}
+
+void Tracer::setEnabled(bool value)
+{
+	enabled.store(value, std::memory_order_relaxed);
+}
+
+long long Tracer::now() const
+{
+	return steadyNanoseconds() - epoch;
+}
+
+TraceBuffer* Tracer::getThreadBuffer()
+{
+	if (!threadBuffer.buffer)
+	{
+		QMutexLocker locker(&mutex);
+		QString name;
+		if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread())
+		{
+			name = "Main";
+		}
+		else
+		{
+			name = QThread::currentThread()->objectName();
+			if (name.isEmpty())
+				name = "Worker " + QString::number(freeBuffers.empty() ? buffers.size() : freeBuffers.back()->getId() - 1);
+		}
+
+		if (freeBuffers.empty())
+		{
+			buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer(buffers.size() + 1, name, TRACE_BUFFER_CAPACITY)));
+			threadBuffer.buffer = buffers.back().get();
+		}
+		else
+		{
+			threadBuffer.buffer = freeBuffers.back();
+			threadBuffer.buffer->setName(name);
+			freeBuffers.pop_back();
+		}
+	}
+	return threadBuffer.buffer;
+}
+
+void Tracer::releaseThreadBuffer(TraceBuffer* buffer)
+{
+	QMutexLocker locker(&mutex);
+	freeBuffers.push_back(buffer);
+}
+
+void Tracer::record(const char* name, long long start, long long end)
+{
+	getThreadBuffer()->push(name, start, end - start);
+}
+
+bool Tracer::writeChromeTrace(const QString& filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		return false;
+
+	QMutexLocker locker(&mutex);
+	QTextStream out(&file);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"XMALab\"}}";
+
+	std::vector<TraceEvent> events;
+	for (auto& buffer : buffers)
+	{
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->getId()
+			<< ",\"args\":{\"name\":\"" << buffer->getName() << "\"}}";
+
+		events.clear();
+		buffer->getEvents(events);
+		for (auto& event : events)
+		{
+			//timestamps in microseconds
+			out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"xmalab\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->getId()
+				<< ",\"ts\":" << QString::number(event.start / 1000.0, 'f', 3)
+				<< ",\"dur\":" << QString::number(event.duration / 1000.0, 'f', 3) << "}";
+		}
+	}
+	out << "\n]}\n";
+	out.flush();
+	file.close();
+	return true;
+}
+
+QString Tracer::getSummary()
+{
+	struct Stage
+	{
+		long long count = 0;
+		long long total = 0;
+		long long max = 0;
+	};
+	std::map<std::string, Stage> stages;
+
+	{
+		QMutexLocker locker(&mutex);
+		std::vector<TraceEvent> events;
+		for (auto& buffer : buffers)
+		{
+			events.clear();
+			buffer->getEvents(events);
+			for (auto& event : events)
+			{
+				Stage& stage = stages[event.name];
+				stage.count++;
+				stage.total += event.duration;
+				stage.max = std::max(stage.max, event.duration);
+			}
+		}
+	}
+
+	std::vector<std::pair<std::string, Stage> > sorted(stages.begin(), stages.end());
+	std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Stage>& a, const std::pair<std::string, Stage>& b)
+	{
+		return a.second.total > b.second.total;
+	});
+
+	QString summary = "Trace summary (" + QString::number(sorted.size()) + " stages)";
+	for (auto& stage : sorted)
+	{
+		summary += "\n" + QString::fromStdString(stage.first) + ": " + QString::number(stage.second.count) + " spans, total "
+			+ QString::number(stage.second.total * 1e-6, 'f', 2) + " ms, mean "
+			+ QString::number(stage.second.total * 1e-6 / stage.second.count, 'f', 3) + " ms, max "
+			+ QString::number(stage.second.max * 1e-6, 'f', 2) + " ms";
+	}
+	return summary;
+}
+
+void Tracer::clear()
+{
+	QMutexLocker locker(&mutex);
+	for (auto& buffer : buffers)
+	{
+		buffer->clear();
+	}
+}
@@ -0,0 +1,166 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Tracer.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace xma
+{
+	/// Recorded span. The name has to be a string with static lifetime, e.g. a literal.
+	struct TraceEvent
+	{
+		const char* name;
+		long long start;
+		long long duration;
+	};
+
+	/// Ring buffer of the spans of a single thread. Only the owning thread writes, older spans are overwritten.
+	/// Writing does not lock, readers validate the copied spans against the head afterwards instead, similar to a
+	/// seqlock, and clearing only moves the start of the buffer which the writer never reads.
+	class TraceBuffer
+	{
+	public:
+		TraceBuffer(int id, QString name, int capacity);
+
+		void push(const char* name, long long start, long long duration)
+		{
+			size_t pos = head.load(std::memory_order_relaxed);
+			Slot& slot = slots[pos % slots.size()];
+			//a reader which sees one of the new values also sees the head of the previous push, see getEvents
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.name.store(name, std::memory_order_relaxed);
+			slot.start.store(start, std::memory_order_relaxed);
+			slot.duration.store(duration, std::memory_order_relaxed);
+			head.store(pos + 1, std::memory_order_release);
+		}
+
+		void getEvents(std::vector<TraceEvent>& out) const;
+		void clear();
+
+		int getId() const { return id; }
+		const QString& getName() const { return name; }
+		//the buffer is handed to the next thread once its thread exits, must be called with the lock of the tracer
+		void setName(const QString& _name) { name = _name; }
+
+	private:
+		struct Slot
+		{
+			std::atomic<const char*> name;
+			std::atomic<long long> start;
+			std::atomic<long long> duration;
+		};
+
+		int id;
+		QString name;
+		std::vector<Slot> slots;
+		std::atomic<size_t> head;
+		//spans before this position were cleared
+		std::atomic<size_t> begin;
+	};
+
+	/// Collects timed spans of the processing stages into per thread ring buffers. Recording is switched on
+	/// at runtime, the instrumentation itself only exists if XMA_WITH_TRACING is defined.
+	class Tracer
+	{
+	public:
+		static Tracer* getInstance();
+
+		void setEnabled(bool value);
+		bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+		//nanoseconds since the creation of the tracer
+		long long now() const;
+		void record(const char* name, long long start, long long end);
+
+		//writes all spans in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto
+		bool writeChromeTrace(const QString& filename);
+		//count, total, mean and maximal duration per span name
+		QString getSummary();
+		void clear();
+
+		//called as a thread exits, its spans are kept and the buffer is reused by the next thread which records
+		void releaseThreadBuffer(TraceBuffer* buffer);
+
+	private:
+		Tracer();
+		TraceBuffer* getThreadBuffer();
+
+		std::atomic<bool> enabled;
+		long long epoch;
+		//buffers are only deleted with the tracer, so their number is bounded by the threads recording at the same time
+		std::vector<std::unique_ptr<TraceBuffer> > buffers;
+		std::vector<TraceBuffer*> freeBuffers;
+		QMutex mutex;
+	};
+
+	/// Records the lifetime of the scope as a span
+	class TraceScope
+	{
+	public:
+		explicit TraceScope(const char* _name) : name(nullptr), start(0)
+		{
+			Tracer* tracer = Tracer::getInstance();
+			if (tracer->isEnabled())
+			{
+				name = _name;
+				start = tracer->now();
+			}
+		}
+
+		~TraceScope()
+		{
+			if (name)
+			{
+				Tracer* tracer = Tracer::getInstance();
+				tracer->record(name, start, tracer->now());
+			}
+		}
+
+	private:
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+		const char* name;
+		long long start;
+	};
+}
+
+#ifdef XMA_WITH_TRACING
+#define XMA_TRACE_CONCAT_IMPL(a, b) a##b
+#define XMA_TRACE_CONCAT(a, b) XMA_TRACE_CONCAT_IMPL(a, b)
+#define XMA_TRACE_SCOPE(name) xma::TraceScope XMA_TRACE_CONCAT(xma_trace_scope_, __LINE__)(name)
+#else
+#define XMA_TRACE_SCOPE(name)
+#endif
+
+#endif // TRACER_H
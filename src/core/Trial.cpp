@@ -40,6 +40,10 @@
 #include "core/Settings.h"
 #include "core/UndistortionObject.h"
 #include "core/HelperFunctions.h"
+#include "core/CSVReader.h"
+#include "core/CSVWriter.h"
+#include "core/Tracer.h"
+#include "gl/OverlayBuffer.h"
 
 #include <QFileInfo>
 #include <QDir>
@@ -55,6 +59,8 @@
 #define OS_SEP "/"
 #endif
 #include <QApplication>
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
 #include <opencv2/highgui/highgui.hpp>
 #include "processing/FilterImage.h"
 
@@ -77,6 +83,10 @@ Trial::Trial(QString trialname, std::vector<QStringList>& imageFilenames)
 
 	interpolate3D = false;
 	requiresRecomputation = true;
+	recomputationRequest = 0;
+	dirty = true;
+	editDepth = 0;
+	dataRevision = 0;
 
 	for (std::vector<QStringList>::iterator filenameList = imageFilenames.begin(); filenameList != imageFilenames.end(); ++filenameList)
 	{
@@ -120,7 +130,7 @@ Trial::Trial(QString trialname, std::vector<QStringList>& imageFilenames)
 	
 }
 
-Trial::Trial(QString trialname, QString folder)
+Trial::Trial(QString trialname, QString folder, QString videoInfo)
 {
 	isDefault = false;
 	IsCopyFromDefault = false;
@@ -135,6 +145,10 @@ Trial::Trial(QString trialname, QString folder)
 	activeMarkerIdx = -1;
 	activeBodyIdx = -1;
 	requiresRecomputation = true;
+	recomputationRequest = 0;
+	dirty = true;
+	editDepth = 0;
+	dataRevision = 0;
 
 	for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
 	{
@@ -173,6 +187,18 @@ Trial::Trial(QString trialname, QString folder)
 		videos.push_back(newSequence);
 	}
 
+	//with the cached information the videos are only opened when the trial is used
+	QStringList info = videoInfo.split(";", Qt::SkipEmptyParts);
+	if (info.size() == (int) videos.size())
+	{
+		for (unsigned int i = 0; i < videos.size(); i++)
+		{
+			QStringList values = info.at(i).split(",");
+			if (values.size() == 4)
+				videos[i]->setVideoInfo(values.at(0).toInt(), values.at(1).toDouble(), values.at(2).toInt(), values.at(3).toInt());
+		}
+	}
+
 	nbImages = 0;
 	setNbImages();
 	
@@ -197,6 +223,10 @@ Trial::Trial()
 	nbImages = 1;
 	startFrame = 1;
 	endFrame = 1;
+	recomputationRequest = 0;
+	dirty = true;
+	editDepth = 0;
+	dataRevision = 0;
 }
 
 Trial::~Trial()
@@ -230,6 +260,9 @@ bool Trial::changeTrialData(QString trialname, std::vector<QStringList>& imageFi
 	if (isDefault)
 		return false;
 
+	//the entries of the trial are stored under its name
+	if (name != trialname)
+		setAllDirty(true);
 	name = trialname;
 	std::vector<VideoStream*> video_tmp = videos;
 	videos.clear();
@@ -370,13 +403,47 @@ void Trial::setActiveFrame(int _activeFrame)
 	if (isDefault)
 		return;
 	
+	std::vector<int> cameras;
 	for (int i = 0; i < videos.size(); i++)
 	{
 		if (Project::getInstance()->getCameras()[i]->isVisible())
-			videos[i]->setActiveFrame(activeFrame);
+			cameras.push_back(i);
+	}
+
+	if (cameras.empty())
+		return;
+
+	//open the videos before decoding, as opening may close other videos
+	for (unsigned int i = 0; i < cameras.size(); i++)
+	{
+		videos[cameras[i]]->open();
+	}
+
+	//decode the cameras concurrently, the first one on the calling thread
+	std::vector<QFuture<void> > futures;
+	for (unsigned int i = 1; i < cameras.size(); i++)
+	{
+		futures.push_back(QtConcurrent::run(&Trial::setActiveFrameCamera, this, cameras[i]));
+	}
+	setActiveFrameCamera(cameras[0]);
+
+	for (unsigned int i = 0; i < futures.size(); i++)
+	{
+		futures[i].waitForFinished();
 	}
 }
 
+void Trial::setActiveFrameCamera(int camera)
+{
+	XMA_TRACE_SCOPE("VideoDecode");
+	QElapsedTimer timer;
+	timer.start();
+	int nbDecoded = videos[camera]->getNbDecodedFrames();
+	videos[camera]->setActiveFrame(activeFrame);
+	if (videos[camera]->getNbDecodedFrames() != nbDecoded)
+		videos[camera]->recordDecodeTime(timer.nsecsElapsed() / 1000000.0);
+}
+
 const std::vector<VideoStream*>& Trial::getVideoStreams()
 {
 	return videos;
@@ -388,6 +455,11 @@ const std::vector<Marker*>& Trial::getMarkers()
 	return markers;
 }
 
+MarkerStore& Trial::getMarkerStore()
+{
+	return markerStore;
+}
+
 const std::vector<RigidBody*>& Trial::getRigidBodies()
 {
 	return rigidBodies;
@@ -448,6 +520,13 @@ void Trial::removeRigidBody(int idx)
 	delete rigidBodies[idx];
 	rigidBodies.erase(std::remove(rigidBodies.begin(), rigidBodies.end(), rigidBodies[idx]), rigidBodies.end());
 	if (activeBodyIdx >= (int) rigidBodies.size())activeBodyIdx = rigidBodies.size() - 1;
+
+	//the files of the following rigid bodies are renumbered
+	setDirty();
+	for (unsigned int i = idx; i < rigidBodies.size(); i++)
+	{
+		rigidBodies[i]->setDirty();
+	}
 }
 
 void Trial::addMarker()
@@ -456,8 +535,19 @@ void Trial::addMarker()
 	setActiveMarkerIdx(markers.size() - 1);
 }
 
+void Trial::addMarkers(const std::vector<Marker*>& newMarkers)
+{
+	if (newMarkers.empty())
+		return;
+
+	markers.insert(markers.end(), newMarkers.begin(), newMarkers.end());
+	setActiveMarkerIdx(markers.size() - 1);
+	invalidateData();
+}
+
 void Trial::removeMarker(int idx)
 {
+	editedFrames.erase(markers[idx]);
 	delete markers[idx];
 	markers.erase(std::remove(markers.begin(), markers.end(), markers[idx]), markers.end());
 	if (activeMarkerIdx >= (int) markers.size())setActiveMarkerIdx(markers.size() - 1);
@@ -468,6 +558,13 @@ void Trial::removeMarker(int idx)
 		(*it)->removePointIdx(idx);
 		(*it)->updatePointIdx(idx);
 	}
+
+	//the files of the following markers are renumbered
+	setDirty();
+	for (unsigned int i = idx; i < markers.size(); i++)
+	{
+		markers[i]->setDirty();
+	}
 }
 
 void Trial::addEvent(QString name, QColor color)
@@ -509,6 +606,7 @@ int Trial::getReferenceCalibrationImage()
 
 void Trial::setReferenceCalibrationImage(int value)
 {
+	setDirty();
 	referenceCalibrationImage = value;
 }
 
@@ -519,6 +617,7 @@ double Trial::getRecordingSpeed()
 
 void Trial::setRecordingSpeed(double value)
 {
+	setDirty();
 	recordingSpeed = value;
 }
 
@@ -529,6 +628,7 @@ double Trial::getCutoffFrequency()
 
 void Trial::setCutoffFrequency(double value)
 {
+	setDirty();
 	cutoffFrequency = value;
 }
 
@@ -550,11 +650,11 @@ QString Trial::getName()
 	return name;
 }
 
-void Trial::drawRigidBodies(Camera* cam)
+void Trial::drawRigidBodies(Camera* cam, OverlayBuffer& overlay)
 {
 	for (std::vector<RigidBody *>::const_iterator it = rigidBodies.begin(); it != rigidBodies.end(); ++it)
 	{
-		(*it)->draw2D(cam, activeFrame);
+		(*it)->draw2D(cam, activeFrame, overlay);
 	}
 }
 
@@ -577,145 +677,157 @@ bool Trial::renderMeshes()
 	return render;
 }
 
-void Trial::drawPoints(int cameraId, bool detailView)
+void Trial::drawPoints(int cameraId, bool detailView, OverlayBuffer& overlay)
 {
+	//the settings are only read once per rebuild of the overlay
+	bool drawMarkers = Settings::getInstance()->getBoolSetting("TrialDrawMarkers");
+	bool coloredCross = Settings::getInstance()->getBoolSetting("ShowColoredMarkerCross");
+	bool advancedCrosshair = Settings::getInstance()->getBoolSetting("AdvancedCrosshairDetailView");
+	bool show3dPointDetail = Settings::getInstance()->getBoolSetting("Show3dPointDetailView");
+	bool drawAllProjected = Settings::getInstance()->getBoolSetting("DrawProjected2DpositionsForAllPoints");
+	bool drawEpipolar = Settings::getInstance()->getBoolSetting("TrialDrawEpipolar");
+	bool showEpiLineDetail = Settings::getInstance()->getBoolSetting("ShowEpiLineDetailView");
+
 	int idx = 0;
-	if (Settings::getInstance()->getBoolSetting("TrialDrawMarkers")){
+	if (drawMarkers){
 		if (!detailView)
 		{
-			glBegin(GL_LINES);
+			overlay.begin(GL_LINES);
 			for (std::vector<Marker *>::const_iterator it = markers.begin(); it != markers.end(); ++it)
 			{
 				if (((*it)->getStatus2D()[cameraId][activeFrame] > 0))
 				{
-					if (Settings::getInstance()->getBoolSetting("ShowColoredMarkerCross"))
+					if (coloredCross)
 					{
 						QColor color = (*it)->getStatusColor(cameraId, activeFrame);
-						glColor3f(color.redF(), color.greenF(), color.blueF());
+						overlay.color(color.redF(), color.greenF(), color.blueF());
 					}
 					else{
 						if (idx == activeMarkerIdx)
 						{
-							glColor3f(1.0, 0.0, 0.0);
+							overlay.color(1.0f, 0.0f, 0.0f);
 						}
 						else
 						{
-							glColor3f(0.0, 1.0, 0.0);
+							overlay.color(0.0f, 1.0f, 0.0f);
 						}
 					}
 
-					glVertex2f((*it)->getPoints2D()[cameraId][activeFrame].x - 5, (*it)->getPoints2D()[cameraId][activeFrame].y);
-					glVertex2f((*it)->getPoints2D()[cameraId][activeFrame].x + 5, (*it)->getPoints2D()[cameraId][activeFrame].y);
-					glVertex2f((*it)->getPoints2D()[cameraId][activeFrame].x, (*it)->getPoints2D()[cameraId][activeFrame].y - 5);
-					glVertex2f((*it)->getPoints2D()[cameraId][activeFrame].x, (*it)->getPoints2D()[cameraId][activeFrame].y + 5);
+					cv::Point2d pt = (*it)->getPoints2D()[cameraId][activeFrame];
+					overlay.vertex(pt.x - 5, pt.y);
+					overlay.vertex(pt.x + 5, pt.y);
+					overlay.vertex(pt.x, pt.y - 5);
+					overlay.vertex(pt.x, pt.y + 5);
 				}
 				idx++;
 			}
-			glEnd();
+			overlay.end();
 		}
 		else if (activeMarkerIdx >= 0 && activeMarkerIdx < (int)markers.size())
 		{
 			double x = markers[activeMarkerIdx]->getPoints2D()[cameraId][activeFrame].x;
 			double y = markers[activeMarkerIdx]->getPoints2D()[cameraId][activeFrame].y;
 
-			glBegin(GL_LINES);
-			glColor3f(1.0, 0.0, 0.0);
-			glVertex2f(x - 12, y);
-			glVertex2f(x + 12, y);
-			glVertex2f(x, y - 12);
-			glVertex2f(x, y + 12);
-			glEnd();
+			overlay.begin(GL_LINES);
+			overlay.color(1.0f, 0.0f, 0.0f);
+			overlay.vertex(x - 12, y);
+			overlay.vertex(x + 12, y);
+			overlay.vertex(x, y - 12);
+			overlay.vertex(x, y + 12);
 
-			if (Settings::getInstance()->getBoolSetting("AdvancedCrosshairDetailView"))
+			if (advancedCrosshair)
 			{
-				glBegin(GL_LINES);
 				for (int i = 0; i < 6; i++)
 				{
-					glVertex2f(x - 1, y + i * 2);
-					glVertex2f(x + 1, y + i * 2);
+					overlay.vertex(x - 1, y + i * 2);
+					overlay.vertex(x + 1, y + i * 2);
 
-					glVertex2f(x - 1, y - i * 2);
-					glVertex2f(x + 1, y - i * 2);
+					overlay.vertex(x - 1, y - i * 2);
+					overlay.vertex(x + 1, y - i * 2);
 
-					glVertex2f(x + i * 2, y - 1);
-					glVertex2f(x + i * 2, y + 1);
+					overlay.vertex(x + i * 2, y - 1);
+					overlay.vertex(x + i * 2, y + 1);
 
-					glVertex2f(x - i * 2, y - 1);
-					glVertex2f(x - i * 2, y + 1);
+					overlay.vertex(x - i * 2, y - 1);
+					overlay.vertex(x - i * 2, y + 1);
 				}
-				glEnd();
+				overlay.end();
+
 				double size = markers[activeMarkerIdx]->getSize();;
 				if (size > 0)
 				{
-					glEnable(GL_BLEND);
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-					glBegin(GL_LINES);
-					glColor4f(1.0f, 0.0f, 0.0f, 0.3f);
-					glVertex2f(x - size, y - size);
-					glVertex2f(x - size, y + size);
-
-					glVertex2f(x + size, y - size);
-					glVertex2f(x + size, y + size);
-
-					glVertex2f(x - size, y - size);
-					glVertex2f(x + size, y - size);
-
-					glVertex2f(x - size, y + size);
-					glVertex2f(x + size, y + size);
-					glEnd();
-					glDisable(GL_BLEND);
+					overlay.setBlend(true);
+					overlay.begin(GL_LINES);
+					overlay.color(1.0f, 0.0f, 0.0f, 0.3f);
+					overlay.vertex(x - size, y - size);
+					overlay.vertex(x - size, y + size);
+
+					overlay.vertex(x + size, y - size);
+					overlay.vertex(x + size, y + size);
+
+					overlay.vertex(x - size, y - size);
+					overlay.vertex(x + size, y - size);
+
+					overlay.vertex(x - size, y + size);
+					overlay.vertex(x + size, y + size);
+					overlay.end();
+					overlay.setBlend(false);
 				}
 			}
+			else
+			{
+				overlay.end();
+			}
 		}
 
 		if (activeMarkerIdx >= 0 && activeMarkerIdx < (int)markers.size() && markers[activeMarkerIdx]->getStatus3D()[activeFrame] > 0)
 		{
-			if (!detailView || Settings::getInstance()->getBoolSetting("Show3dPointDetailView"))
+			if (!detailView || show3dPointDetail)
 			{
-				glBegin(GL_LINES);
-				glColor3f(0.0, 1.0, 1.0);
-				glVertex2f(markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].x - 5, markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].y - 5);
-				glVertex2f(markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].x + 5, markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].y + 5);
-				glVertex2f(markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].x + 5, markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].y - 5);
-				glVertex2f(markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].x - 5, markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame].y + 5);
-				glEnd();
+				cv::Point2d pt = markers[activeMarkerIdx]->getPoints2D_projected()[cameraId][activeFrame];
+				overlay.begin(GL_LINES);
+				overlay.color(0.0f, 1.0f, 1.0f);
+				overlay.vertex(pt.x - 5, pt.y - 5);
+				overlay.vertex(pt.x + 5, pt.y + 5);
+				overlay.vertex(pt.x + 5, pt.y - 5);
+				overlay.vertex(pt.x - 5, pt.y + 5);
+				overlay.end();
 			}
 		}
-		if (!detailView  && Settings::getInstance()->getBoolSetting("DrawProjected2DpositionsForAllPoints")) {
+		if (!detailView && drawAllProjected) {
+			overlay.begin(GL_LINES);
+			overlay.color(0.0f, 1.0f, 1.0f);
 			for (std::vector<Marker *>::const_iterator it = markers.begin(); it != markers.end(); ++it)
 			{
 				if ((*it)->getStatus3D()[activeFrame] > 0)
 				{
-					glBegin(GL_LINES);
-					glColor3f(0.0, 1.0, 1.0);
-					glVertex2f((*it)->getPoints2D_projected()[cameraId][activeFrame].x - 5, (*it)->getPoints2D_projected()[cameraId][activeFrame].y - 5);
-					glVertex2f((*it)->getPoints2D_projected()[cameraId][activeFrame].x + 5, (*it)->getPoints2D_projected()[cameraId][activeFrame].y + 5);
-					glVertex2f((*it)->getPoints2D_projected()[cameraId][activeFrame].x + 5, (*it)->getPoints2D_projected()[cameraId][activeFrame].y - 5);
-					glVertex2f((*it)->getPoints2D_projected()[cameraId][activeFrame].x - 5, (*it)->getPoints2D_projected()[cameraId][activeFrame].y + 5);
-					glEnd();
+					cv::Point2d pt = (*it)->getPoints2D_projected()[cameraId][activeFrame];
+					overlay.vertex(pt.x - 5, pt.y - 5);
+					overlay.vertex(pt.x + 5, pt.y + 5);
+					overlay.vertex(pt.x + 5, pt.y - 5);
+					overlay.vertex(pt.x - 5, pt.y + 5);
 				}
 			}
+			overlay.end();
 		}
 	}
-	if (Settings::getInstance()->getBoolSetting("TrialDrawEpipolar") &&
-		(!detailView || Settings::getInstance()->getBoolSetting("ShowEpiLineDetailView")))
+	if (drawEpipolar && (!detailView || showEpiLineDetail))
 	{
-		for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
+		int nbCameras = Project::getInstance()->getCameras().size();
+		for (int i = 0; i < nbCameras; i++)
 		{
-		
 			if (activeMarkerIdx >= 0 && activeMarkerIdx < (int) markers.size() && markers[activeMarkerIdx]->getStatus2D()[i][activeFrame] > 0)
 			{
 				if (cameraId != i)
 				{
 					std::vector<cv::Point2d> epiline = markers[activeMarkerIdx]->getEpipolarLine(i, cameraId, activeFrame);
-					glBegin(GL_LINE_STRIP);
-					glColor3f(0.0, 0.0, 1.0);
+					overlay.begin(GL_LINE_STRIP);
+					overlay.color(0.0f, 0.0f, 1.0f);
 					for (std::vector<cv::Point2d>::const_iterator pt = epiline.begin(); pt != epiline.end(); ++pt)
 					{
-						glVertex2f(pt->x, pt->y);
+						overlay.vertex(pt->x, pt->y);
 					}
-					epiline.clear();
-					glEnd();
+					overlay.end();
 				}
 			}
 		}
@@ -729,6 +841,7 @@ int Trial::getStartFrame()
 
 void Trial::setStartFrame(int value)
 {
+	setDirty();
 	startFrame = value;
 }
 
@@ -739,6 +852,7 @@ int Trial::getEndFrame()
 
 void Trial::setEndFrame(int value)
 {
+	setDirty();
 	endFrame = value;
 }
 
@@ -747,9 +861,63 @@ bool Trial::getRequiresRecomputation()
 	return requiresRecomputation;
 }
 
+int Trial::getRecomputationRequest()
+{
+	return recomputationRequest;
+}
+
+bool Trial::isDirty()
+{
+	if (dirty)
+		return true;
+
+	for (unsigned int i = 0; i < markers.size(); i++)
+	{
+		if (markers[i]->isDirty())
+			return true;
+	}
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		if (rigidBodies[i]->isDirty())
+			return true;
+	}
+	return false;
+}
+
+void Trial::setDirty(bool value)
+{
+	dirty = value;
+	if (value) invalidateData();
+}
+
+int Trial::getDataRevision()
+{
+	return dataRevision;
+}
+
+void Trial::invalidateData()
+{
+	dataRevision++;
+}
+
+void Trial::setAllDirty(bool value)
+{
+	dirty = value;
+	for (unsigned int i = 0; i < markers.size(); i++)
+	{
+		markers[i]->setDirty(value);
+	}
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		rigidBodies[i]->setDirty(value);
+	}
+}
+
 void Trial::setRequiresRecomputation(bool value)
 {
+	setDirty();
 	requiresRecomputation = value;
+	if (value) recomputationRequest++;
 
 	for (unsigned int i = 0; i < getMarkers().size(); i++)
 	{
@@ -778,32 +946,38 @@ void Trial::renameMarkersFromCSV(QString filename)
 
 void Trial::loadMarkersFromCSV(QString filename, bool updateOnly)
 {
-	QString tmp_names;
-	QString tmp_coords;
-
-	std::ifstream fin;
-	fin.open(filename.toStdString());
-	std::istringstream in;
-	std::string line;
-	littleHelper::safeGetline(fin, line);
-	tmp_names = QString::fromStdString(line);
-	littleHelper::safeGetline(fin, line);
-	tmp_coords = QString::fromStdString(line);
-	fin.close();
-
-	QStringList names_list = tmp_names.split(",");
-	QStringList coords_list = tmp_coords.split(",");
+	CSVReader csv;
+	if (!csv.open(filename))
+		return;
 
 	std::vector<cv::Point3d> points3D_tmp;
 	std::vector<QString> referenceNames_tmp;
 
-	for (int i = 0; i < names_list.size() / 3; i++)
+	std::vector<double> coords;
+	int nbColumns = csv.getNbColumns(0);
+	if (csv.getNbRows() > 1)
+	{
+		csv.parseNumeric(1, nbColumns, coords);
+		coords.resize(nbColumns);
+	}
+
+	for (int i = 0; i < nbColumns / 3; i++)
 	{
-		referenceNames_tmp.push_back(names_list.at(3 * i));
+		referenceNames_tmp.push_back(csv.getField(0, 3 * i));
 		referenceNames_tmp[i].replace("_x", "");
-		points3D_tmp.push_back(cv::Point3d(coords_list.at(3 * i).toDouble(), coords_list.at(3 * i + 1).toDouble(), coords_list.at(3 * i + 2).toDouble()));
+		if (coords.empty())
+		{
+			points3D_tmp.push_back(cv::Point3d(0, 0, 0));
+		}
+		else
+		{
+			points3D_tmp.push_back(cv::Point3d(coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]));
+		}
 	}
 
+	if (!updateOnly)
+		markerStore.reserve(Project::getInstance()->getCameras().size(), markers.size() + points3D_tmp.size(), nbImages);
+
 	for (unsigned int i = 0; i < points3D_tmp.size(); i++)
 	{
 		if (!updateOnly){
@@ -938,6 +1112,87 @@ void Trial::recomputeAndFilterRigidBodyTransformations()
 	}
 }
 
+void Trial::recomputeFrame(int frame)
+{
+	for (unsigned int i = 0; i < markers.size(); i++)
+	{
+		if (markers[i]->getRequiresRecomputation()){
+			markers[i]->reconstruct3DPoint(frame, true);
+		}
+		else
+		{
+			markers[i]->reprojectPoint(frame);
+		}
+	}
+
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		rigidBodies[i]->getPoseComputed()[frame] = false;
+	}
+
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		rigidBodies[i]->computePose(frame);
+	}
+}
+
+void Trial::recomputeData()
+{
+	//ensure that the vector sizes of the rigid bodies is of the length of nbImages
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		if ((int) rigidBodies[i]->getPoseComputed().size() != nbImages)
+		{
+			rigidBodies[i]->init(nbImages);
+		}
+	}
+
+	std::vector<int> frames(nbImages);
+	for (int i = 0; i < nbImages; i++)
+	{
+		frames[i] = i;
+	}
+
+	QtConcurrent::blockingMap(frames, [this](const int& frame)
+	{
+		recomputeFrame(frame);
+	});
+
+	filterRigidBodies();
+	setRequiresRecomputation(false);
+}
+
+void Trial::filterRigidBodies()
+{
+	//Rigid bodies with dummy points defined by another rigid body access its poses while filtering.
+	//These are processed after all other rigid bodies have been filtered in parallel.
+	std::vector<RigidBody*> independent;
+	std::vector<RigidBody*> dependent;
+	for (unsigned int i = 0; i < rigidBodies.size(); i++)
+	{
+		if (rigidBodies[i]->hasDummyPointsFromRigidBodies())
+		{
+			dependent.push_back(rigidBodies[i]);
+		}
+		else
+		{
+			independent.push_back(rigidBodies[i]);
+		}
+	}
+
+	QtConcurrent::blockingMap(independent, [](RigidBody* rb)
+	{
+		rb->makeRotationsContinous();
+		rb->filterTransformations();
+	});
+
+	for (unsigned int i = 0; i < dependent.size(); i++)
+	{
+		dependent[i]->makeRotationsContinous();
+		dependent[i]->filterTransformations();
+	}
+}
+
 void Trial::saveRigidBodyTransformations(std::vector<int> _bodies, QString outputfolder, bool onefile, bool headerRow, bool filtered, bool saveColumn, int start, int stop)
 {
 	for (std::vector<int>::const_iterator it = _bodies.begin(); it < _bodies.end(); ++it)
@@ -946,199 +1201,156 @@ void Trial::saveRigidBodyTransformations(std::vector<int> _bodies, QString outpu
 		if (filtered)getRigidBodies()[*it]->filterTransformations();
 	}
 
+	auto appendHeader = [&](CSVWriter& writer, int body)
+	{
+		QString name;
+		QString filterRate = "";
+		if (getRigidBodies()[body]->getDescription().isEmpty())
+		{
+			// Qt6: format rigid body index with zero-padding
+			name = QStringLiteral("RigidBody%1").arg(body + 1, 3, 10, QChar('0'));
+		}
+		else
+		{
+			name = getRigidBodies()[body]->getDescription();
+		}
+
+		if (filtered)
+		{
+			filterRate = "_" + QString::number(getRigidBodies()[body]->getOverrideCutoffFrequency() ? getRigidBodies()[body]->getCutoffFrequency() : getCutoffFrequency()) + "Hz";
+		}
+
+		static const char* columns[16] = { "_R11", "_R12", "_R13", "_01", "_R21", "_R22", "_R23", "_02",
+			"_R31", "_R32", "_R33", "_03", "_TX", "_TY", "_TZ", "_1" };
+		std::string nameStr = name.toStdString();
+		std::string filterStr = filterRate.toStdString();
+		for (int c = 0; c < 16; c++)
+		{
+			if (c > 0)
+				writer.append(',');
+			writer.append(nameStr + columns[c] + filterStr);
+		}
+	};
+
+	auto appendTransformation = [&](CSVWriter& writer, int body, int f)
+	{
+		double trans[16];
+		if (getRigidBodies()[body]->getTransformationMatrix(f, filtered, &trans[0]))
+		{
+			for (int c = 0; c < 16; c++)
+			{
+				if (c > 0)
+					writer.append(',');
+				writer.append(trans[c]);
+			}
+		}
+		else
+		{
+			writer.append("NaN,NaN,NaN,NaN,");
+			writer.append("NaN,NaN,NaN,NaN,");
+			writer.append("NaN,NaN,NaN,NaN,");
+			writer.append("NaN,NaN,NaN,NaN");
+		}
+	};
+
+	if (!saveColumn)
+	{
+		start = 0;
+		stop = nbImages - 1;
+	}
+
 	if (onefile)
 	{
-		std::ofstream outfile(outputfolder.toStdString());
-		outfile.precision(12);
+		CSVWriter writer;
 		if (headerRow)
 		{
 			if (saveColumn)
 			{
-				outfile << "Frame" << ",";
+				writer.append("Frame,");
 			}
 			for (std::vector<int>::const_iterator it = _bodies.begin(); it < _bodies.end(); ++it)
 			{
-				QString name;
-				QString filterRate = "";
-				if (getRigidBodies()[*it]->getDescription().isEmpty())
-				{
-					// Qt6: format rigid body index with zero-padding
-					name = QStringLiteral("RigidBody%1").arg(*it + 1, 3, 10, QChar('0'));
-				}
-				else
-				{
-					name = getRigidBodies()[*it]->getDescription();
-				}
-
-				if (filtered)
-				{
-					filterRate = "_" + QString::number(getRigidBodies()[*it]->getOverrideCutoffFrequency() ? getRigidBodies()[*it]->getCutoffFrequency() : getCutoffFrequency()) + "Hz";
-				}
-
-				outfile << name.toStdString() << "_R11" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R12" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R13" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_01" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R21" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R22" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R23" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_02" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R31" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R32" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R33" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_03" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TX" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TY" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TZ" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_1" << filterRate.toStdString();
+				appendHeader(writer, *it);
 
 				if (it != _bodies.end() - 1)
 				{
-					outfile << ",";
+					writer.append(',');
 				}
 				else
 				{
-					outfile << '\n';
+					writer.append('\n');
 				}
 			}
 		}
-		double trans[16];
-		if (!saveColumn)
-		{
-			start = 0;
-			stop = nbImages - 1;
-		}
-		for (int f = start; f < stop + 1; f++)
+
+		//the rows are formatted in parallel blocks
+		writer.appendRows(stop - start + 1, [&](CSVWriter& row, int r)
 		{
+			int f = start + r;
 			if (saveColumn)
 			{
-				outfile << f + 1 << ",";
+				row.append(f + 1);
+				row.append(',');
 			}
 			for (std::vector<int>::const_iterator it = _bodies.begin(); it < _bodies.end(); ++it)
 			{
-				if (getRigidBodies()[*it]->getTransformationMatrix(f, filtered, &trans[0]))
-				{
-					outfile << trans[0] << "," << trans[1] << "," << trans[2] << "," << trans[3] << ",";
-					outfile << trans[4] << "," << trans[5] << "," << trans[6] << "," << trans[7] << ",";
-					outfile << trans[8] << "," << trans[9] << "," << trans[10] << "," << trans[11] << ",";
-					outfile << trans[12] << "," << trans[13] << "," << trans[14] << "," << trans[15];
-				}
-				else
-				{
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN";
-				}
+				appendTransformation(row, *it, f);
 
 				if (it != _bodies.end() - 1)
 				{
-					outfile << ",";
+					row.append(',');
 				}
 				else
 				{
-					outfile << '\n';
+					row.append('\n');
 				}
 			}
-		}
-		
-		outfile.close();
+		});
+		writer.write(outputfolder);
 	}
 	else
 	{
-		for (std::vector<int>::const_iterator it = _bodies.begin(); it < _bodies.end(); ++it)
+		//one file per rigid body, the bodies are written in parallel
+		QtConcurrent::blockingMap(_bodies, [&](const int& body)
 		{
 			QString filename;
 			if (filtered)
 			{
 				// Qt6: format filename using QString::arg for rigid body index
-				filename = outputfolder + QStringLiteral("RigidBody%1_").arg(*it + 1, 3, 10, QChar('0'))
-					+ getRigidBodies()[*it]->getDescription() + "_transformationFiltered_"
-					+ QString::number(getRigidBodies()[*it]->getOverrideCutoffFrequency() ? getRigidBodies()[*it]->getCutoffFrequency() : getCutoffFrequency()) + "Hz.csv";
+				filename = outputfolder + QStringLiteral("RigidBody%1_").arg(body + 1, 3, 10, QChar('0'))
+					+ getRigidBodies()[body]->getDescription() + "_transformationFiltered_"
+					+ QString::number(getRigidBodies()[body]->getOverrideCutoffFrequency() ? getRigidBodies()[body]->getCutoffFrequency() : getCutoffFrequency()) + "Hz.csv";
 			}
 			else
 			{
 				// Qt6: format filename for unfiltered rigid body
-				filename = outputfolder + QStringLiteral("RigidBody%1_").arg(*it + 1, 3, 10, QChar('0'))
-					+ getRigidBodies()[*it]->getDescription() + "_transformation.csv";
+				filename = outputfolder + QStringLiteral("RigidBody%1_").arg(body + 1, 3, 10, QChar('0'))
+					+ getRigidBodies()[body]->getDescription() + "_transformation.csv";
 			}
 
-			std::ofstream outfile(filename.toStdString());
-			outfile.precision(12);
+			CSVWriter writer;
 			if (headerRow)
 			{
 				if (saveColumn)
 				{
-					outfile << "Frame" << ",";
-				}
-				QString name;
-				QString filterRate = "";
-				if (getRigidBodies()[*it]->getDescription().isEmpty())
-				{
-					// Qt6: format rigid body index with zero-padding
-					name = QStringLiteral("RigidBody%1").arg(*it + 1, 3, 10, QChar('0'));
-				}
-				else
-				{
-					name = getRigidBodies()[*it]->getDescription();
-				}
-
-				if (filtered)
-				{
-					filterRate = "_" + QString::number(getRigidBodies()[*it]->getOverrideCutoffFrequency() ? getRigidBodies()[*it]->getCutoffFrequency() : getCutoffFrequency()) + "Hz";
+					writer.append("Frame,");
 				}
-
-				outfile << name.toStdString() << "_R11" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R12" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R13" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_01" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R21" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R22" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R23" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_02" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R31" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R32" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_R33" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_03" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TX" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TY" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_TZ" << filterRate.toStdString() << ","
-					<< name.toStdString() << "_1" << filterRate.toStdString();
-
-				outfile << '\n';
+				appendHeader(writer, body);
+				writer.append('\n');
 			}
 
-			double trans[16];
-			if (!saveColumn)
-			{
-				start = 0;
-				stop = nbImages - 1;
-			}
 			for (int f = start; f < stop + 1; f++)
 			{
 				if (saveColumn)
 				{
-					outfile << f + 1 << ",";
-				}
-				if (getRigidBodies()[*it]->getTransformationMatrix(f, filtered, &trans[0]))
-				{
-					outfile << trans[0] << "," << trans[1] << "," << trans[2] << "," << trans[3] << ",";
-					outfile << trans[4] << "," << trans[5] << "," << trans[6] << "," << trans[7] << ",";
-					outfile << trans[8] << "," << trans[9] << "," << trans[10] << "," << trans[11] << ",";
-					outfile << trans[12] << "," << trans[13] << "," << trans[14] << "," << trans[15];
-				}
-				else
-				{
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN,";
-					outfile << "NaN,NaN,NaN,NaN";
+					writer.append(f + 1);
+					writer.append(',');
 				}
-
-				outfile << '\n';
+				appendTransformation(writer, body, f);
+				writer.append('\n');
 			}
-			outfile.close();
-		}
+			writer.write(filename);
+		});
 	}
 }
 
@@ -1518,45 +1730,132 @@ void Trial::resetRigidBodyByMarker(Marker* marker, int frame)
 	}
 }
 
+void Trial::beginEdit()
+{
+	editDepth++;
+}
+
+void Trial::commitEdit()
+{
+	if (editDepth <= 0)
+		return;
+
+	editDepth--;
+	if (editDepth > 0 || editedFrames.empty())
+		return;
+
+	//triangulate all frames which have not been reconstructed yet
+	std::vector<std::pair<Marker*, int> > markerFrames;
+	for (std::map<Marker*, std::set<int> >::const_iterator it = editedFrames.begin(); it != editedFrames.end(); ++it)
+	{
+		std::vector<int> pending = it->first->takePendingFrames();
+		for (std::vector<int>::const_iterator f = pending.begin(); f != pending.end(); ++f)
+		{
+			markerFrames.push_back(std::make_pair(it->first, *f));
+		}
+	}
+
+	QtConcurrent::blockingMap(markerFrames, [](const std::pair<Marker*, int>& markerFrame)
+	{
+		markerFrame.first->reconstruct3DPoint(markerFrame.second, true);
+	});
+
+	//compute the pose once per frame for each rigid body using one of the edited markers. Bodies with a dummy
+	//reference read the pose of another body of the same frame, so the frames are computed in parallel and
+	//the bodies of a frame in index order like in recomputeFrame
+	std::map<int, std::vector<RigidBody*> > frameBodies;
+	for (std::vector<RigidBody*>::const_iterator rb = rigidBodies.begin(); rb != rigidBodies.end(); ++rb)
+	{
+		std::set<int> frames;
+		for (std::vector<int>::const_iterator idx = (*rb)->getPointsIdx().begin(); idx != (*rb)->getPointsIdx().end(); ++idx)
+		{
+			if (*idx >= (int) markers.size())
+				continue;
+
+			std::map<Marker*, std::set<int> >::const_iterator edited = editedFrames.find(markers[*idx]);
+			if (edited != editedFrames.end())
+				frames.insert(edited->second.begin(), edited->second.end());
+		}
+
+		for (std::set<int>::const_iterator f = frames.begin(); f != frames.end(); ++f)
+		{
+			frameBodies[*f].push_back(*rb);
+		}
+	}
+	editedFrames.clear();
+
+	std::vector<std::pair<int, std::vector<RigidBody*> > > bodyFrames(frameBodies.begin(), frameBodies.end());
+	QtConcurrent::blockingMap(bodyFrames, [](const std::pair<int, std::vector<RigidBody*> >& bodyFrame)
+	{
+		for (std::vector<RigidBody*>::const_iterator rb = bodyFrame.second.begin(); rb != bodyFrame.second.end(); ++rb)
+		{
+			(*rb)->computePose(bodyFrame.first);
+		}
+	});
+	invalidateData();
+}
+
+bool Trial::isEditing()
+{
+	return editDepth > 0;
+}
+
+void Trial::setFrameEdited(Marker* marker, int frame)
+{
+	editedFrames[marker].insert(frame);
+}
+
 bool Trial::save3dPoints(std::vector<int> _markers, QString outputfolder, bool onefile, bool headerRow, double filterFrequency, bool saveColumn, int start, int stop)
 {
-	//create TmpData
-	std::vector<std::vector <cv::Point3d> > points3D;
-	std::vector<std::vector <markerStatus> > status3D;
-	for (std::vector<int>::const_iterator it = _markers.begin(); it < _markers.end(); ++it)
+	//create TmpData, the markers are filtered in parallel
+	std::vector<std::vector <cv::Point3d> > points3D(_markers.size());
+	std::vector<std::vector <markerStatus> > status3D(_markers.size());
+	std::vector<int> filterSuccess(_markers.size(), 1);
+	std::vector<int> indices(_markers.size());
+	for (unsigned int i = 0; i < indices.size(); i++)
 	{
-		std::vector <cv::Point3d> marker;
-		std::vector <markerStatus> status;
+		indices[i] = i;
+	}
+
+	QtConcurrent::blockingMap(indices, [&](const int& i)
+	{
+		Marker* m = getMarkers()[_markers[i]];
 		//filter Data
 		if (filterFrequency > 0.0)
 		{
-			if (!getMarkers()[*it]->filterMarker(filterFrequency, getMarkers()[*it]->getPoints3D(), getMarkers()[*it]->getStatus3D(), marker, status))
-			{
-				return false;
-			}
+			filterSuccess[i] = m->filterMarker(filterFrequency, m->getPoints3D().row().toVector(), m->getStatus3D().row().toVector(), points3D[i], status3D[i]);
 		}
 		//Copy Data
 		else{
 			for (int f = 0; f < nbImages; f++)
 			{
-				marker.push_back(cv::Point3d(getMarkers()[*it]->getPoints3D()[f]));
-				status.push_back(getMarkers()[*it]->getStatus3D()[f]);
+				points3D[i].push_back(cv::Point3d(m->getPoints3D()[f]));
+				status3D[i].push_back(m->getStatus3D()[f]);
 			}
 		}
-		points3D.push_back(marker);
-		status3D.push_back(status);
+	});
+
+	for (unsigned int i = 0; i < filterSuccess.size(); i++)
+	{
+		if (!filterSuccess[i])
+			return false;
+	}
+
+	if (!saveColumn)
+	{
+		start = 0;
+		stop = nbImages - 1;
 	}
 
-	//Write to File
+	//Write to File, the rows are formatted in parallel blocks
 	if (onefile)
 	{
-		std::ofstream outfile(outputfolder.toStdString());
-		outfile.precision(12);
+		CSVWriter writer;
 		if (headerRow)
 		{
 			if (saveColumn)
 			{
-				outfile << "Frame" << ",";
+				writer.append("Frame,");
 			}
 			for (std::vector<int>::const_iterator it = _markers.begin(); it < _markers.end(); ++it)
 			{
@@ -1575,114 +1874,114 @@ bool Trial::save3dPoints(std::vector<int> _markers, QString outputfolder, bool o
 					name = name + "_" + QString::number(filterFrequency) + "Hz";
 				}
 
-				outfile << name.toStdString() << "_X" << "," << name.toStdString() << "_Y" << "," << name.toStdString() << "_Z";
+				writer.append(name + "_X," + name + "_Y," + name + "_Z");
 
 				if (it != _markers.end() - 1)
 				{
-					outfile << ",";
+					writer.append(',');
 				}
 				else
 				{
-					outfile << '\n';
+					writer.append('\n');
 				}
 			}
 		}
-		if (!saveColumn)
-		{
-			start = 0;
-			stop = nbImages - 1;
-		}
-		for (int f = start; f < stop+1; f++)
+		writer.appendRows(stop - start + 1, [&](CSVWriter& row, int r)
 		{
+			int f = start + r;
 			if (saveColumn)
 			{
-				outfile << f + 1 << ",";
+				row.append(f + 1);
+				row.append(',');
 			}
 			for (unsigned int i = 0; i < points3D.size(); i++)
 			{
 				if (status3D[i][f] <= 0)
 				{
-					outfile << "NaN" << "," << "NaN" << "," << "NaN";
+					row.append("NaN,NaN,NaN");
 				}
 				else
 				{
-					outfile << points3D[i][f].x << "," << points3D[i][f].y << "," << points3D[i][f].z;
+					row.append(points3D[i][f].x);
+					row.append(',');
+					row.append(points3D[i][f].y);
+					row.append(',');
+					row.append(points3D[i][f].z);
 				}
 
 				if (i != points3D.size() - 1)
 				{
-					outfile << ",";
+					row.append(',');
 				}
 				else
 				{
-					outfile << '\n';
+					row.append('\n');
 				}
 			}
-		}
-		outfile.close();
+		});
+		writer.write(outputfolder);
 	}
 	else
 	{
-		int count = 0;
-		for (std::vector<int>::const_iterator it = _markers.begin(); it < _markers.end(); ++it)
+		//one file per marker, the markers are written in parallel
+		QtConcurrent::blockingMap(indices, [&](const int& count)
 		{
-			QString filename = outputfolder + "Marker" + QString("%1").arg(*it + 1, 3, 10, QChar('0')) + "_" + getMarkers()[*it]->getDescription() + "_points3d";
+			int idx = _markers[count];
+			QString filename = outputfolder + "Marker" + QString("%1").arg(idx + 1, 3, 10, QChar('0')) + "_" + getMarkers()[idx]->getDescription() + "_points3d";
 			if (filterFrequency > 0.0)
 			{
 				filename = filename + "_" + QString::number(filterFrequency) + "Hz";
 			}
 			filename = filename + ".csv";
 
-			std::ofstream outfile(filename.toStdString());
-			outfile.precision(12);
+			CSVWriter writer;
 			if (headerRow)
 			{
 				if (saveColumn)
 				{
-					outfile << "Frame" << ",";
+					writer.append("Frame,");
 				}
 				QString name;
-				if (getMarkers()[*it]->getDescription().isEmpty())
+				if (getMarkers()[idx]->getDescription().isEmpty())
 				{
-					name = QStringLiteral("marker%1").arg(*it + 1, 3, 10, QChar('0'));
+					name = QStringLiteral("marker%1").arg(idx + 1, 3, 10, QChar('0'));
 				}
 				else
 				{
-					name = getMarkers()[*it]->getDescription();
+					name = getMarkers()[idx]->getDescription();
 				}
 				if (filterFrequency > 0.0)
 				{
 					name = name + "_" + QString::number(filterFrequency) + "Hz";
 				}
-				outfile << name.toStdString() << "_X" << "," << name.toStdString() << "_Y" << "," << name.toStdString() << "_Z";
+				writer.append(name + "_X," + name + "_Y," + name + "_Z");
 
-				outfile << '\n';
-			}
-			if (!saveColumn)
-			{
-				start = 0;
-				stop = nbImages - 1;
+				writer.append('\n');
 			}
 			for (int f = start; f < stop + 1; f++)
 			{
 				if (saveColumn)
 				{
-					outfile << f + 1 << ",";
+					writer.append(f + 1);
+					writer.append(',');
 				}
 				if (status3D[count][f] <= 0)
 				{
-					outfile << "NaN" << "," << "NaN" << "," << "NaN";
+					writer.append("NaN,NaN,NaN");
 				}
 				else
 				{
-					outfile << points3D[count][f].x << "," << points3D[count][f].y << "," << points3D[count][f].z;
+					writer.append(points3D[count][f].x);
+					writer.append(',');
+					writer.append(points3D[count][f].y);
+					writer.append(',');
+					writer.append(points3D[count][f].z);
 				}
 
-				outfile << '\n';
+				writer.append('\n');
 			}
-			count++;
-			outfile.close();
-		}
+			writer.write(filename);
+		});
 	}
 
 	//clear tmpData
@@ -1702,309 +2001,375 @@ void Trial::save2dPoints(QString outputfolder, bool onefile, bool distorted, boo
 	int start = (id == -1) ? 0 : id;
 	int end = (id == -1) ? Project::getInstance()->getCameras().size() : id + 1;
 
-	if (onefile)
+	auto appendPoint = [&](CSVWriter& writer, unsigned int i, unsigned int j, int f)
 	{
-		std::ofstream outfile(outputfolder.toStdString());
-		outfile.precision(12);
-		if (headerRow)
+		if (getMarkers()[i]->getStatus2D()[j][f] > 0)
 		{
-			if (offsetCols)
+			double x;
+			double y;
+			if (distorted)
 			{
-				for (unsigned int j = start; j < end; j++)
-				{
-					outfile << "cam" << j << "_offset";
-				}
+				x = getMarkers()[i]->getPoints2D()[j][f].x;
+				y = getMarkers()[i]->getPoints2D()[j][f].y;
+			}
+			else
+			{
+				cv::Point2d pt = Project::getInstance()->getCameras()[j]->undistortPoint(getMarkers()[i]->getPoints2D()[j][f], true);
+				x = pt.x;
+				y = pt.y;
 			}
 
-			for (unsigned int i = 0; i < getMarkers().size(); i++)
+			if (yinvert)
 			{
-				QString name;
-				if (getMarkers()[i]->getDescription().isEmpty())
+				y = Project::getInstance()->getCameras()[j]->getHeight() - y - 1;
+			}
+
+			if (offset1)
+			{
+				y += 1;
+				x += 1;
+			}
+			writer.append(x);
+			writer.append(',');
+			writer.append(y);
+		}
+		else
+		{
+			writer.append("NaN,NaN");
+		}
+	};
+
+	auto appendOffsets = [&](CSVWriter& writer, bool header)
+	{
+		if (offsetCols)
+		{
+			for (int j = start; j < end; j++)
+			{
+				if (header)
 				{
-					name = "marker" + QString("%1").arg(i + 1, 3, 10, QChar('0'));
+					writer.append("cam");
+					writer.append(j);
+					writer.append("_offset");
 				}
 				else
 				{
-					name = getMarkers()[i]->getDescription();
+					writer.append("0,");
 				}
+			}
+		}
+	};
+
+	auto markerName = [&](unsigned int i)
+	{
+		if (getMarkers()[i]->getDescription().isEmpty())
+		{
+			return "marker" + QString("%1").arg(i + 1, 3, 10, QChar('0'));
+		}
+		return getMarkers()[i]->getDescription();
+	};
+
+	if (onefile)
+	{
+		CSVWriter writer;
+		if (headerRow)
+		{
+			appendOffsets(writer, true);
 
-				for (unsigned int j = start; j < end; j++)
+			for (unsigned int i = 0; i < getMarkers().size(); i++)
+			{
+				std::string name = markerName(i).toStdString();
+				for (int j = start; j < end; j++)
 				{
-					outfile << name.toStdString() << "_cam" << j + 1 << "_X" << "," << name.toStdString() << "_cam" << j + 1 << "_Y";
+					writer.append(name + "_cam");
+					writer.append(j + 1);
+					writer.append("_X," + name + "_cam");
+					writer.append(j + 1);
+					writer.append("_Y");
 
 					if (i != getMarkers().size() - 1 || j != end- 1)
 					{
-						outfile << ",";
+						writer.append(',');
 					}
 					else
 					{
-						outfile << '\n';
+						writer.append('\n');
 					}
 				}
 			}
 		}
 
-		for (int f = 0; f < nbImages; f++)
+		//the rows are formatted in parallel blocks
+		writer.appendRows(nbImages, [&](CSVWriter& row, int f)
 		{
-			if (offsetCols)
-			{
-				for (unsigned int j = start; j < end; j++)
-				{
-					outfile << 0.0 << ",";
-				}
-			}
+			appendOffsets(row, false);
 			for (unsigned int i = 0; i < getMarkers().size(); i++)
 			{
-				for (unsigned int j = start; j < end; j++)
+				for (int j = start; j < end; j++)
 				{
-					if (getMarkers()[i]->getStatus2D()[j][f] > 0)
-					{
-						double x;
-						double y;
-						if (distorted)
-						{
-							x = getMarkers()[i]->getPoints2D()[j][f].x;
-							y = getMarkers()[i]->getPoints2D()[j][f].y;
-						}
-						else
-						{
-							cv::Point2d pt = Project::getInstance()->getCameras()[j]->undistortPoint(getMarkers()[i]->getPoints2D()[j][f], true);
-							x = pt.x;
-							y = pt.y;
-						}
-
-						if (yinvert)
-						{
-							y = Project::getInstance()->getCameras()[j]->getHeight() - y - 1;
-						}
-
-						if (offset1)
-						{
-							y += 1;
-							x += 1;
-						}
-						outfile << x << "," << y;
-					}
-					else
-					{
-						outfile << "NaN" << "," << "NaN";
-					}
+					appendPoint(row, i, j, f);
 
 					if (i != getMarkers().size() - 1 || j != end - 1)
 					{
-						outfile << ",";
+						row.append(',');
 					}
 					else
 					{
-						outfile << '\n';
+						row.append('\n');
 					}
 				}
 			}
-		}
-		outfile.close();
+		});
+		writer.write(outputfolder);
 	}
 	else
 	{
-		for (unsigned int i = 0; i < getMarkers().size(); i++)
+		//one file per marker, the markers are written in parallel
+		std::vector<int> indices(getMarkers().size());
+		for (unsigned int i = 0; i < indices.size(); i++)
+		{
+			indices[i] = i;
+		}
+
+		QtConcurrent::blockingMap(indices, [&](const int& i)
 		{
 			QString filename = outputfolder + "Marker" + QString("%1").arg(i + 1, 3, 10, QChar('0')) + "_" + getMarkers()[i]->getDescription() + "_points2d.csv";
-			std::ofstream outfile(filename.toStdString());
-			outfile.precision(12);
+			CSVWriter writer;
 			if (headerRow)
 			{
-				if (offsetCols)
-				{
-					for (unsigned int j = start; j < end; j++)
-					{
-						outfile << "cam" << j << "_offset";
-					}
-				}
+				appendOffsets(writer, true);
 
-				QString name;
-				if (getMarkers()[i]->getDescription().isEmpty())
+				std::string name = markerName(i).toStdString();
+				for (int j = start; j < end; j++)
 				{
-					name = "marker" + QString("%1").arg(i + 1, 3, 10, QChar('0'));
-				}
-				else
-				{
-					name = getMarkers()[i]->getDescription();
-				}
-
-				for (unsigned int j = start; j < end; j++)
-				{
-					outfile << name.toStdString() << "_cam" << j + 1 << "_X" << "," << name.toStdString() << "_cam" << j + 1 << "_Y";
+					writer.append(name + "_cam");
+					writer.append(j + 1);
+					writer.append("_X," + name + "_cam");
+					writer.append(j + 1);
+					writer.append("_Y");
 
 					if (j != end - 1)
 					{
-						outfile << ",";
+						writer.append(',');
 					}
 					else
 					{
-						outfile << '\n';
+						writer.append('\n');
 					}
 				}
 			}
 
 			for (int f = 0; f < nbImages; f++)
 			{
-				if (offsetCols)
-				{
-					for (unsigned int j = start; j < end; j++)
-					{
-						outfile << 0.0 << ",";
-					}
-				}
+				appendOffsets(writer, false);
 
-				for (unsigned int j = start; j < end; j++)
+				for (int j = start; j < end; j++)
 				{
-					if (getMarkers()[i]->getStatus2D()[j][f] > 0)
-					{
-						double x;
-						double y;
-						if (distorted)
-						{
-							x = getMarkers()[i]->getPoints2D()[j][f].x;
-							y = getMarkers()[i]->getPoints2D()[j][f].y;
-						}
-						else
-						{
-							cv::Point2d pt = Project::getInstance()->getCameras()[j]->undistortPoint(getMarkers()[i]->getPoints2D()[j][f], true);
-							x = pt.x;
-							y = pt.y;
-						}
-
-						if (yinvert)
-						{
-							y = Project::getInstance()->getCameras()[j]->getHeight() - y - 1;
-						}
-
-						if (offset1)
-						{
-							y += 1;
-							x += 1;
-						}
-						outfile << x << "," << y;
-					}
-					else
-					{
-						outfile << "NaN" << "," << "NaN";
-					}
+					appendPoint(writer, i, j, f);
 
 					if (j != end - 1)
 					{
-						outfile << ",";
+						writer.append(',');
 					}
 					else
 					{
-						outfile << '\n';
+						writer.append('\n');
 					}
 				}
 			}
 
-			outfile.close();
-		}
+			writer.write(filename);
+		});
 	}
 }
 
 int Trial::load2dPoints(QString input, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, bool statusSet)
 {
-	std::vector<Marker *> newMarkers;
+	Parsed2DPoints points;
+	if (!parse2dPoints(input, distorted, offset1, yinvert, headerRow, offsetCols, points))
+		return 0;
 
-	std::ifstream fin;
-	fin.open(input.toStdString());
-	std::istringstream in;
-	std::string line;
-	QString tmp_names;
-	QStringList list;
+	return add2dPoints(points, statusSet);
+}
 
-	bool firstRun = true;
-	bool readHeader = headerRow;
-	int frame = 0;
-	int offset = offsetCols ? Project::getInstance()->getCameras().size() : 0;
+bool Trial::parse2dPoints(QString input, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, Parsed2DPoints& points, const std::function<void(double)>& progress)
+{
+	//Reads the file into a buffer and does not modify the trial, it can therefore run in a worker thread.
+	//Use add2dPoints to create the markers from the buffer.
+	points.names.clear();
+	points.values.clear();
+	points.nbMarkers = 0;
+	points.nbFrames = 0;
 
-	while (!littleHelper::safeGetline(fin, line).eof())
+	CSVReader csv;
+	if (!csv.open(input) || csv.getNbRows() == 0)
+		return false;
+
+	int nbCameras = Project::getInstance()->getCameras().size();
+	int offset = offsetCols ? nbCameras : 0;
+	int nbColumns = csv.getNbColumns(0);
+	int nbNewMarker = (nbColumns - offset) / 2 / nbCameras;
+	if (nbNewMarker <= 0)
+		return false;
+
+	for (int i = 0; i < nbNewMarker; i++)
 	{
-		if (!line.empty())
+		QString name;
+		if (headerRow)
 		{
-			QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-			tmp_names = QString::fromStdString(line);
-			list = tmp_names.split(",");
-
-			if (firstRun)
+			name = csv.getField(0, i * 2 * nbCameras + offset);
+			name.replace("_cam1_X", "");
+			while (name.startsWith(" "))
 			{
-				int nbNewMarker = (list.size() - offset) / 2 / Project::getInstance()->getCameras().size();
-				for (int i = 0; i < nbNewMarker; i++)
-				{
-					addMarker();
-					newMarkers.push_back(markers[markers.size() - 1]);
-				}
-				firstRun = false;
+				name = name.right(name.length() - 1);
+			}
+			while (name.endsWith(" "))
+			{
+				name = name.left(name.length() - 1);
 			}
+		}
+		points.names.push_back(name);
+	}
+
+	//parse all values at once, the first half of the progress
+	std::vector<double> values;
+	csv.parseNumeric(headerRow ? 1 : 0, nbColumns, values, [&progress](double p)
+	{
+		if (progress) progress(0.5 * p);
+	});
+
+	int nbFrames = std::min((int) (values.size() / nbColumns), nbImages);
+	int rowSize = nbNewMarker * nbCameras * 2;
+	points.nbMarkers = nbNewMarker;
+	points.nbFrames = nbFrames;
+	points.values.resize((size_t) nbFrames * rowSize);
+
+	//convert the points to undistorted image coordinates, the second half of the progress
+	const int blockSize = 1024;
+	std::vector<int> blocks;
+	for (int f = 0; f < nbFrames; f += blockSize)
+	{
+		blocks.push_back(f);
+	}
 
-			if (readHeader)
+	QAtomicInt blocksDone(0);
+	int nbBlocks = blocks.size();
+
+	QtConcurrent::blockingMap(blocks, [&](const int& block)
+	{
+		int frameEnd = std::min(block + blockSize, nbFrames);
+		for (int frame = block; frame < frameEnd; frame++)
+		{
+			const double* row = &values[(size_t) frame * nbColumns + offset];
+			double* out = &points.values[(size_t) frame * rowSize];
+			for (int k = 0; k < nbNewMarker * nbCameras; k++)
 			{
-				for (unsigned int i = 0; i < newMarkers.size(); i++)
+				int j = k % nbCameras;
+				double x = row[2 * k];
+				double y = row[2 * k + 1];
+				if (!std::isnan(x) && !std::isnan(y))
 				{
-					QString name = list.at(i * 2 * Project::getInstance()->getCameras().size() + offset);
-					name.replace("_cam1_X", "");
-					while (name.startsWith(" "))
+					if (offset1)
 					{
-						name = name.right(name.length() - 1);
+						x -= 1;
+						y -= 1;
 					}
-					while (name.endsWith(" "))
+
+					if (yinvert)
+					{
+						y = Project::getInstance()->getCameras()[j]->getHeight() - y - 1;
+					}
+
+					if (!distorted)
 					{
-						name = name.left(name.length() - 1);
+						cv::Point2d pt = Project::getInstance()->getCameras()[j]->undistortPoint(cv::Point2d(x, y), false);
+						x = pt.x;
+						y = pt.y;
 					}
-					newMarkers[i]->setDescription(name);
 				}
-				readHeader = false;
+				out[2 * k] = x;
+				out[2 * k + 1] = y;
 			}
-			else
-			{
-				for (unsigned int i = 0; i < newMarkers.size(); i++)
-				{
-					for (unsigned int j = 0; j < Project::getInstance()->getCameras().size(); j++)
-					{
-						if (!list.at(i * Project::getInstance()->getCameras().size() * 2 + 2 * j + offset).contains("NaN")
-							&& !list.at(i * Project::getInstance()->getCameras().size() * 2 + 2 * j + 1 + offset).contains("NaN"))
-						{
-							double x = list.at(i * Project::getInstance()->getCameras().size() * 2 + 2 * j + offset).toDouble();
-							double y = list.at(i * Project::getInstance()->getCameras().size() * 2 + 2 * j + 1 + offset).toDouble();
+		}
 
-							if (offset1)
-							{
-								x -= 1;
-								y -= 1;
-							}
+		int done = blocksDone.fetchAndAddOrdered(1) + 1;
+		if (progress) progress(0.5 + 0.5 * done / nbBlocks);
+	});
 
-							if (yinvert)
-							{
-								y = Project::getInstance()->getCameras()[j]->getHeight() - y - 1;
-							}
+	return true;
+}
 
-							if (!distorted)
-							{
-								cv::Point2d pt = Project::getInstance()->getCameras()[j]->undistortPoint(cv::Point2d(x,y), false);
-								x = pt.x;
-								y = pt.y;
-							}
+int Trial::add2dPoints(const Parsed2DPoints& points, bool statusSet)
+{
+	std::vector<Marker *> newMarkers = create2dPointMarkers(points);
+	set2dPoints(points, newMarkers, statusSet);
+	addMarkers(newMarkers);
+	return newMarkers.size();
+}
 
-							newMarkers[i]->setPoint(j, frame, x, y, statusSet ? SET : TRACKED);
-						}
-					}
-				}
-				frame++;
-			}
-		}
+std::vector<Marker*> Trial::create2dPointMarkers(const Parsed2DPoints& points)
+{
+	//reserving the store reallocates the data of all markers, so this has to run on the gui thread
+	std::vector<Marker *> newMarkers;
+	if (points.nbMarkers <= 0)
+		return newMarkers;
+
+	int nbCameras = Project::getInstance()->getCameras().size();
+	markerStore.reserve(nbCameras, markerStore.getNbMarkers() + points.nbMarkers, nbImages);
+	for (int i = 0; i < points.nbMarkers; i++)
+	{
+		newMarkers.push_back(new Marker(nbCameras, nbImages, this));
+		if (!points.names[i].isEmpty())
+			newMarkers[i]->setDescription(points.names[i]);
 	}
+	return newMarkers;
+}
 
+void Trial::set2dPoints(const Parsed2DPoints& points, const std::vector<Marker*>& newMarkers, bool statusSet, const std::function<void(double)>& progress)
+{
+	//set points directly and triangulate once per frame
+	const int blockSize = 1024;
+	std::vector<std::pair<int, int> > blocks;
 	for (unsigned int i = 0; i < newMarkers.size(); i++)
 	{
-		newMarkers[i]->update();
+		for (int f = 0; f < points.nbFrames; f += blockSize)
+		{
+			blocks.push_back(std::make_pair(i, f));
+		}
 	}
-	fin.close();
 
-	return newMarkers.size();
+	int nbCameras = Project::getInstance()->getCameras().size();
+	int rowSize = points.nbMarkers * nbCameras * 2;
+	markerStatus status = statusSet ? SET : TRACKED;
+	std::atomic<int> nbFinished(0);
+	int nbBlocks = blocks.size();
+
+	QtConcurrent::blockingMap(blocks, [&](const std::pair<int, int>& block)
+	{
+		Marker* marker = newMarkers[block.first];
+		int frameEnd = std::min(block.second + blockSize, points.nbFrames);
+		for (int frame = block.second; frame < frameEnd; frame++)
+		{
+			const double* row = &points.values[(size_t) frame * rowSize + block.first * nbCameras * 2];
+			for (int j = 0; j < nbCameras; j++)
+			{
+				if (std::isnan(row[2 * j]) || std::isnan(row[2 * j + 1]))
+					continue;
+
+				marker->setPoint(j, frame, row[2 * j], row[2 * j + 1], status, false);
+			}
+			//new markers are not part of a rigid body yet, so no pose has to be updated
+			marker->reconstruct3DPoint(frame, true);
+		}
+
+		int finished = ++nbFinished;
+		if (progress && finished * 100 / nbBlocks != (finished - 1) * 100 / nbBlocks)
+			progress((double) finished / nbBlocks);
+	});
+
+	for (unsigned int i = 0; i < newMarkers.size(); i++)
+	{
+		newMarkers[i]->setRequiresRecomputation(false);
+	}
 }
 
 void Trial::saveReprojectionErrors(QString outputfolder) {
@@ -2304,6 +2669,7 @@ const QString& Trial::getTrialDate() const
 
 void Trial::setInterpolate3D(bool val)
 {
+	setDirty();
 	interpolate3D = val;
 }
 
@@ -2334,6 +2700,7 @@ void Trial::setIsCopyFromDefault(bool value)
 
 void Trial::clearMarkerAndRigidBodies()
 {
+	setDirty();
 	for (std::vector<RigidBody*>::iterator rigidBody = rigidBodies.begin(); rigidBody != rigidBodies.end(); ++rigidBody)
 	{
 		delete *rigidBody;
@@ -2417,7 +2784,7 @@ void Trial::setCameraSizes()
 {
 	for (int i = 0; i < videos.size(); i++)
 	{
-		Project::getInstance()->getCameras()[i]->setResolution(videos[i]->getImage()->getWidth(), videos[i]->getImage()->getHeight());
+		Project::getInstance()->getCameras()[i]->setResolution(videos[i]->getWidth(), videos[i]->getHeight());
 	}
 }
 
@@ -2425,13 +2792,31 @@ bool Trial::checkTrialImageSizeValid()
 {
 	for (int i = 0; i < videos.size(); i++)
 	{
-		if (Project::getInstance()->getCameras()[i]->getWidth() != videos[i]->getImage()->getWidth() ||
-			Project::getInstance()->getCameras()[i]->getHeight() != videos[i]->getImage()->getHeight())
+		if (Project::getInstance()->getCameras()[i]->getWidth() != videos[i]->getWidth() ||
+			Project::getInstance()->getCameras()[i]->getHeight() != videos[i]->getHeight())
 			return false;
 	}
 	return true;
 }
 
+QString Trial::getVideoInfo()
+{
+	QStringList info;
+	for (unsigned int i = 0; i < videos.size(); i++)
+	{
+		info << QString::number(videos[i]->getNbImages()) + "," + QString::number(videos[i]->getFPS(), 'g', 12) + "," + QString::number(videos[i]->getWidth()) + "," + QString::number(videos[i]->getHeight());
+	}
+	return info.join(";");
+}
+
+void Trial::closeVideos()
+{
+	for (unsigned int i = 0; i < videos.size(); i++)
+	{
+		videos[i]->close();
+	}
+}
+
 void Trial::saveVR(QString folder)
 {
 	for (auto rb : rigidBodies)
@@ -28,10 +28,15 @@
 #define TRIAL_H
 
 #include <vector>
+#include <map>
+#include <set>
+#include <functional>
+#include <atomic>
 #include <QString>
 #include <QStringList>
 #include "VideoStream.h"
 #include "EventData.h"
+#include "MarkerStore.h"
 
 namespace xma
 {
@@ -40,12 +45,24 @@ namespace xma
 	class Marker;
 	class Camera;
 	class VideoStream;
+	class OverlayBuffer;
+
+	/// 2D points of a csv file which are parsed, but not yet added as markers to a trial
+	struct Parsed2DPoints
+	{
+		QStringList names;
+		//undistorted x and y per frame, marker and camera, NaN if the point is not set
+		std::vector<double> values;
+		int nbMarkers = 0;
+		int nbFrames = 0;
+	};
 
 	class Trial
 	{
 	public:
 		Trial(QString trialname, std::vector<QStringList>& imageFilenames);
-		Trial(QString trialname, QString folder);
+		//videoInfo is the cached frame count, frame rate and resolution of the videos as returned by getVideoInfo. If it is given the videos are not opened.
+		Trial(QString trialname, QString folder, QString videoInfo = "");
 		Trial();
 		virtual ~Trial();
 
@@ -62,6 +79,7 @@ namespace xma
 		void setReferenceCalibrationImage(int value);
 
 		const std::vector<Marker *>& getMarkers();
+		MarkerStore& getMarkerStore();
 		const std::vector<RigidBody *>& getRigidBodies();
 		const std::vector<EventData*>& getEvents();
 
@@ -78,6 +96,7 @@ namespace xma
 		void addRigidBody();
 		void removeRigidBody(int idx);
 		void addMarker();
+		void addMarkers(const std::vector<Marker*>& newMarkers);
 		void removeMarker(int idx);
 		void addEvent(QString name, QColor color);
 		void removeEvent(int idx);
@@ -91,10 +110,11 @@ namespace xma
 		void bindTextures();
 		void save(QString path);
 
-		void drawRigidBodies(Camera* cam);
+		//The overlays are recorded into the buffer, which is only rebuilt by the views if something changed
+		void drawRigidBodies(Camera* cam, OverlayBuffer& overlay);
 		void drawRigidBodiesMesh();
 		bool renderMeshes();
-		void drawPoints(int cameraId, bool detailView);
+		void drawPoints(int cameraId, bool detailView, OverlayBuffer& overlay);
 
 		int getStartFrame();
 		void setStartFrame(int value);
@@ -103,6 +123,19 @@ namespace xma
 
 		bool getRequiresRecomputation();
 		void setRequiresRecomputation(bool value);
+		//Incremented whenever a recomputation is requested, used to detect requests made during a recomputation
+		int getRecomputationRequest();
+
+		//Changed since the project was last saved or loaded, including its markers and rigid bodies.
+		//The precision info and marker distances of unchanged trials are copied from the previous archive when saving.
+		bool isDirty();
+		void setDirty(bool value = true);
+		void setAllDirty(bool value);
+
+		//Incremented on every change of the markers and rigid bodies, but not on frame changes. Views rebuild
+		//geometry which spans several frames if it differs. Can be called from worker threads.
+		int getDataRevision();
+		void invalidateData();
 
 		void renameMarkersFromCSV(QString filename);
 		void loadMarkersFromCSV(QString filename, bool updateOnly = false);
@@ -118,6 +151,12 @@ namespace xma
 		bool save3dPoints(std::vector<int> _markers, QString outputfolder, bool onefile, bool headerRow, double filterFrequency, bool saveColumn, int start, int stop);
 		void save2dPoints(QString outputfolder, bool onefile, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, int id = -1);
 		int load2dPoints(QString outputfolder, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, bool statusSet);
+		bool parse2dPoints(QString input, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, Parsed2DPoints& points, const std::function<void(double)>& progress = nullptr);
+		int add2dPoints(const Parsed2DPoints& points, bool statusSet);
+		//add2dPoints in steps: the markers are created on the gui thread, as the marker store is reallocated. Their points
+		//can then be set in a worker thread, as they are not part of the trial until they are passed to addMarkers.
+		std::vector<Marker*> create2dPointMarkers(const Parsed2DPoints& points);
+		void set2dPoints(const Parsed2DPoints& points, const std::vector<Marker*>& newMarkers, bool statusSet, const std::function<void(double)>& progress = nullptr);
 		void saveReprojectionErrors(QString outputfolder);
 
 
@@ -126,8 +165,21 @@ namespace xma
 		void saveMarkerToMarkerDistances(QString filename, int from, int to);
 		void savePrecisionInfo(QString filename, int from, int to);
 		void recomputeAndFilterRigidBodyTransformations();
+		//Triangulates the markers and computes the rigid body poses of a single frame
+		void recomputeFrame(int frame);
+		//Blocking version of ThreadScheduler::updateTrialData which recomputes all frames in parallel
+		void recomputeData();
+		//Makes the rotations continous and filters the transformations of all rigid bodies in parallel
+		void filterRigidBodies();
 		void resetRigidBodyByMarker(Marker* marker, int frame);
 
+		//Edit transactions. While a transaction is open, setPoint only records the
+		//edited frames and the triangulation and pose updates are run once per frame on commit.
+		void beginEdit();
+		void commitEdit();
+		bool isEditing();
+		void setFrameEdited(Marker* marker, int frame);
+
 		void getDrawTextData(int cam, int frame, std::vector<double>& x, std::vector<double>& y, std::vector<QString>& text);
 
 		void saveXMLData(QString filename);
@@ -165,6 +217,9 @@ namespace xma
 
 		void setCameraSizes();
 		bool checkTrialImageSizeValid();
+		QString getVideoInfo();
+		//Closes the videos to release their file handles and decoded frames. They are reopened on their next use.
+		void closeVideos();
 
 		void saveVR(QString folder);
 		void setNbImagesFromConfig(int _nbImages);
@@ -173,6 +228,7 @@ namespace xma
 	private:
 		QString name;
 		void setNbImages();
+		void setActiveFrameCamera(int camera);
 		
 		int activeFrame;
 		int activeMarkerIdx;
@@ -191,9 +247,16 @@ namespace xma
 		std::vector<VideoStream*> videos;
 		std::vector<RigidBody*> rigidBodies;
 		std::vector<Marker*> markers;
+		MarkerStore markerStore;
 		std::vector<EventData*> events;
 
 		bool requiresRecomputation;
+		int recomputationRequest;
+		bool dirty;
+		std::atomic<int> dataRevision;
+
+		int editDepth;
+		std::map<Marker*, std::set<int> > editedFrames;
 
 		bool hasStudyData;
 
@@ -32,6 +32,7 @@
 #include "core/Image.h"
 #include "core/Camera.h"
 #include "core/HelperFunctions.h"
+#include "gl/OverlayBuffer.h"
 
 #include <QFileInfo>
 #include <fstream>
@@ -143,8 +144,15 @@ bool UndistortionObject::undistort(QString filenameIn, QString filenameOut)
 	return success;
 }
 
+void UndistortionObject::setComputed(bool value)
+{
+	computed = value;
+	camera->setDirty();
+}
+
 void UndistortionObject::setDetectedPoints(std::vector<cv::Point2d>& points)
 {
+	camera->setDirty();
 	points_detected.clear();
 	for (std::vector<cv::Point2d>::const_iterator it = points.begin(); it != points.end(); ++it)
 	{
@@ -163,6 +171,7 @@ void UndistortionObject::getDetectedPoints(std::vector<cv::Point2d>& points)
 
 void UndistortionObject::removeOutlier(double threshold_circle, double threshold_border)
 {
+	camera->setDirty();
 	cv::Point2f center;
 	float radius;
 	std::vector<cv::Point2f> points_float;
@@ -202,6 +211,7 @@ void UndistortionObject::removeOutlier(double threshold_circle, double threshold
 
 void UndistortionObject::setGridPoints(std::vector<cv::Point2d>& points_distorted, std::vector<cv::Point2d>& points_references, std::vector<bool>& points_inlier)
 {
+	camera->setDirty();
 	points_grid_distorted.clear();
 	for (std::vector<cv::Point2d>::const_iterator it = points_distorted.begin(); it != points_distorted.end(); ++it)
 	{
@@ -290,6 +300,7 @@ int UndistortionObject::findClosestPoint(std::vector<cv::Point2d>& points, doubl
 
 void UndistortionObject::toggleOutlier(int vispoints, double x, double y)
 {
+	camera->setDirty();
 	int idx = -1;
 
 	switch (vispoints)
@@ -459,47 +470,45 @@ cv::Point2d UndistortionObject::transformPoint(cv::Point2d pt, bool undistort, b
 	return pt_out;
 }
 
-void UndistortionObject::drawPoints(std::vector<cv::Point2d>& points)
+void UndistortionObject::drawPoints(std::vector<cv::Point2d>& points, OverlayBuffer& overlay)
 {
 	std::vector<bool>::const_iterator it_inlier = points_grid_inlier.begin();
-	glBegin(GL_LINES);
+	overlay.begin(GL_LINES);
 	for (std::vector<cv::Point2d>::const_iterator it = points.begin(); it != points.end(); ++it,++it_inlier)
 	{
 		if ((*it_inlier))
 		{
-			glColor3f(0.0f, 0.8f, 0.0f);
+			overlay.color(0.0f, 0.8f, 0.0f);
 		}
 		else
 		{
-			glColor3f(0.8f, 0.0f, 0.0f);
+			overlay.color(0.8f, 0.0f, 0.0f);
 		}
-		glVertex2f((*it).x - 2, (*it).y);
-		glVertex2f((*it).x + 2, (*it).y);
-		glVertex2f((*it).x, (*it).y - 2);
-		glVertex2f((*it).x, (*it).y + 2);
+		overlay.vertex((*it).x - 2, (*it).y);
+		overlay.vertex((*it).x + 2, (*it).y);
+		overlay.vertex((*it).x, (*it).y - 2);
+		overlay.vertex((*it).x, (*it).y + 2);
 	}
 
-	glEnd();
 	if (points.size() > 0)
 	{
 		if ((points_grid_inlier[0]))
 		{
-			glColor3f(0.0f, 0.8f, 0.0f);
+			overlay.color(0.0f, 0.8f, 0.0f);
 		}
 		else
 		{
-			glColor3f(0.8f, 0.0f, 0.0f);
+			overlay.color(0.8f, 0.0f, 0.0f);
 		}
-		glBegin(GL_LINES);
-		glVertex2f(points[0].x - 5, points[0].y);
-		glVertex2f(points[0].x + 5, points[0].y);
-		glVertex2f(points[0].x, points[0].y - 5);
-		glVertex2f(points[0].x, points[0].y + 5);
-		glEnd();
+		overlay.vertex(points[0].x - 5, points[0].y);
+		overlay.vertex(points[0].x + 5, points[0].y);
+		overlay.vertex(points[0].x, points[0].y - 5);
+		overlay.vertex(points[0].x, points[0].y + 5);
 	}
+	overlay.end();
 }
 
-void UndistortionObject::drawData(int type)
+void UndistortionObject::drawData(int type, OverlayBuffer& overlay)
 {
 	switch (type)
 	{
@@ -507,37 +516,37 @@ void UndistortionObject::drawData(int type)
 	default:
 		break;
 	case 1:
-		glColor3f(1.0, 0.0, 0.0);
-		glBegin(GL_LINES);
+		overlay.color(1.0f, 0.0f, 0.0f);
+		overlay.begin(GL_LINES);
 		for (std::vector<cv::Point2d>::const_iterator it = points_detected.begin(); it != points_detected.end(); ++it)
 		{
-			glVertex2f((*it).x - 2, (*it).y);
-			glVertex2f((*it).x + 2, (*it).y);
-			glVertex2f((*it).x, (*it).y - 2);
-			glVertex2f((*it).x, (*it).y + 2);
+			overlay.vertex((*it).x - 2, (*it).y);
+			overlay.vertex((*it).x + 2, (*it).y);
+			overlay.vertex((*it).x, (*it).y - 2);
+			overlay.vertex((*it).x, (*it).y + 2);
 		}
-		glEnd();
+		overlay.end();
 		break;
 	case 2:
-		drawPoints(points_grid_distorted);
+		drawPoints(points_grid_distorted, overlay);
 		break;
 	case 3:
-		drawPoints(points_grid_undistorted);
+		drawPoints(points_grid_undistorted, overlay);
 		break;
 	case 4:
-		drawPoints(points_grid_references);
+		drawPoints(points_grid_references, overlay);
 		break;
 	}
 
 	if (isCenterSet())
 	{
-		glColor3f(0.0, 0.0, 1.0);
-		glBegin(GL_LINES);
-		glVertex2f(center.x - 5, center.y - 5);
-		glVertex2f(center.x + 5, center.y + 5);
-		glVertex2f(center.x + 5, center.y - 5);
-		glVertex2f(center.x - 5, center.y + 5);
-		glEnd();
+		overlay.color(0.0f, 0.0f, 1.0f);
+		overlay.begin(GL_LINES);
+		overlay.vertex(center.x - 5, center.y - 5);
+		overlay.vertex(center.x + 5, center.y + 5);
+		overlay.vertex(center.x + 5, center.y - 5);
+		overlay.vertex(center.x - 5, center.y + 5);
+		overlay.end();
 	}
 }
 
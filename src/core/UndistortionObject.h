@@ -39,6 +39,7 @@ namespace xma
 {
 	class Camera;
 	class Image;
+	class OverlayBuffer;
 
 	class UndistortionObject
 	{
@@ -62,10 +63,7 @@ namespace xma
 			return computed;
 		}
 
-		void setComputed(bool value)
-		{
-			computed = value;
-		}
+		void setComputed(bool value);
 
 		bool undistort(Image* distorted, Image* undistorted);
 		bool undistort(Image* distorted, QString filenameOut, bool filter = false);
@@ -150,7 +148,7 @@ namespace xma
 		void loadTextures();
 		void reloadTextures();
 
-		void drawData(int type);
+		void drawData(int type, OverlayBuffer& overlay);
 		void bindTexture(int type);
 
 		std::vector<bool>& getInlier()
@@ -202,7 +200,7 @@ namespace xma
 
 		void savePoints(std::vector<cv::Point2d>& points, QString filename);
 		void loadPoints(std::vector<cv::Point2d>& points, QString filename);
-		void drawPoints(std::vector<cv::Point2d>& points);
+		void drawPoints(std::vector<cv::Point2d>& points, OverlayBuffer& overlay);
 		int findClosestPoint(std::vector<cv::Point2d>& points, double x, double y, double macDistSquare = 100);
 		void computeError();
 
@@ -29,6 +29,7 @@
 #endif
 
 #include "core/VideoStream.h"
+#include "core/VideoStreamPool.h"
 #include "core/HelperFunctions.h"
 
 #include <fstream>
@@ -44,6 +45,14 @@ VideoStream::VideoStream(QStringList _filenames)
 	image = new Image("",false);
 	nbImages = -1;
 	fps = 0;
+	activeFrame = 0;
+	opened = false;
+	pooled = true;
+	infoLoaded = false;
+	width = 0;
+	height = 0;
+	memoryUsage = 0;
+	nbDecodedFrames = 0;
 
 	Filename = "";
 	FileID = -1;
@@ -62,14 +71,106 @@ VideoStream::VideoStream(QStringList _filenames)
 	Lab = "";
 	portalID = -1;
 	isFlipped = false;
-	
+
+	resetDecodeStatistics();
 }
 
 VideoStream::~VideoStream()
 {
+	VideoStreamPool::getInstance()->remove(this);
 	delete image;
 }
 
+void VideoStream::open()
+{
+	if (!opened)
+	{
+		QMutexLocker locker(&openMutex);
+		if (!opened)
+		{
+			openFile();
+			width = image->getWidth();
+			height = image->getHeight();
+			infoLoaded = true;
+			opened = true;
+		}
+	}
+	if (pooled)
+		VideoStreamPool::getInstance()->touch(this);
+}
+
+VideoStream* VideoStream::createReader()
+{
+	VideoStream* reader = createStream(filenames);
+	reader->pooled = false;
+	reader->setFlipped(isFlipped);
+	return reader;
+}
+
+void VideoStream::close()
+{
+	QMutexLocker locker(&openMutex);
+	if (!opened)
+		return;
+
+	closeFile();
+	image->releaseImage();
+	memoryUsage = 0;
+	opened = false;
+	locker.unlock();
+
+	VideoStreamPool::getInstance()->remove(this);
+}
+
+void VideoStream::reloadFile()
+{
+	close();
+	open();
+}
+
+bool VideoStream::isOpen()
+{
+	return opened;
+}
+
+size_t VideoStream::getMemoryUsage()
+{
+	return memoryUsage;
+}
+
+void VideoStream::updateMemoryUsage(size_t cacheSize)
+{
+	memoryUsage = image->getMemorySize() + cacheSize;
+}
+
+void VideoStream::setDecodedImage(cv::Mat& frame, bool color)
+{
+	image->setImage(frame, color);
+	nbDecodedFrames++;
+}
+
+int VideoStream::getNbDecodedFrames()
+{
+	return nbDecodedFrames;
+}
+
+void VideoStream::setVideoInfo(int _nbImages, double _fps, int _width, int _height)
+{
+	if (opened)
+		return;
+
+	nbImages = _nbImages;
+	fps = _fps;
+	width = _width;
+	height = _height;
+	infoLoaded = true;
+}
+
+bool VideoStream::hasVideoInfo()
+{
+	return infoLoaded;
+}
+
 
 QStringList VideoStream::getFilenames()
 {
@@ -78,24 +179,86 @@ QStringList VideoStream::getFilenames()
 
 int VideoStream::getNbImages()
 {
+	if (!infoLoaded) open();
 	return nbImages;
 }
 
 Image* VideoStream::getImage()
 {
+	if (!opened) open();
 	return image;
 }
 
 void VideoStream::bindTexture()
 {
-	image->bindTexture();
+	getImage()->bindTexture();
 }
 
 double VideoStream::getFPS()
 {
+	if (!infoLoaded) open();
 	return fps;
 }
 
+int VideoStream::getWidth()
+{
+	if (!infoLoaded) open();
+	return width;
+}
+
+int VideoStream::getHeight()
+{
+	if (!infoLoaded) open();
+	return height;
+}
+
+void VideoStream::recordDecodeTime(double ms)
+{
+	int bin = 0;
+	double upper = 1.0;
+	while (ms >= upper && bin < nbDecodeHistogramBins - 1)
+	{
+		bin++;
+		upper *= 2.0;
+	}
+	decodeHistogram[bin]++;
+	decodeTimeTotal += ms;
+	if (ms > decodeTimeMax) decodeTimeMax = ms;
+}
+
+const std::vector<int>& VideoStream::getDecodeHistogram()
+{
+	return decodeHistogram;
+}
+
+int VideoStream::getDecodeCount()
+{
+	int count = 0;
+	for (unsigned int i = 0; i < decodeHistogram.size(); i++)
+	{
+		count += decodeHistogram[i];
+	}
+	return count;
+}
+
+double VideoStream::getDecodeTimeMean()
+{
+	int count = getDecodeCount();
+	return (count > 0) ? decodeTimeTotal / count : 0.0;
+}
+
+double VideoStream::getDecodeTimeMax()
+{
+	return decodeTimeMax;
+}
+
+void VideoStream::resetDecodeStatistics()
+{
+	decodeHistogram.assign(nbDecodeHistogramBins, 0);
+	decodeTimeTotal = 0;
+	decodeTimeMax = 0;
+}
+
 void VideoStream::parseXMLData(int id, QString xml_data)
 {
 	QString Filename_tmp;
@@ -391,8 +554,12 @@ const int& VideoStream::getPortalID() const
 
 void VideoStream::setFlipped(bool flipped)
 {
+	if (isFlipped == flipped)
+		return;
+
 	isFlipped = flipped;
-	reloadFile();
+	if (opened)
+		reloadFile();
 }
 
 QString VideoStream::getFileBasename()
@@ -29,6 +29,9 @@
 
 #include "core/Image.h"
 #include <QStringList>
+#include <QMutex>
+#include <atomic>
+#include <vector>
 
 namespace xma
 {
@@ -41,7 +44,7 @@ namespace xma
 		virtual void setActiveFrame(int _activeFrame) = 0;
 
 		virtual QString getFrameName(int frameNumber) = 0;
-		virtual void reloadFile() = 0;
+		void reloadFile();
 
 		QStringList getFilenames();
 		QString getFileBasename();
@@ -51,6 +54,34 @@ namespace xma
 		Image* getImage();
 		void bindTexture();
 		double getFPS();
+		int getWidth();
+		int getHeight();
+
+		//The file is opened lazily on the first access to the images and can be closed by the VideoStreamPool to release the decoded frames.
+		void open();
+		void close();
+		bool isOpen();
+		//Creates a second stream on the same files, e.g. for a worker job which must not move the displayed frame.
+		//It decodes independently of this stream, is not closed by the VideoStreamPool and has to be deleted by the caller.
+		VideoStream* createReader();
+		//Memory of the decoded frames, updated after each decode so it can be queried while other threads decode
+		size_t getMemoryUsage();
+
+		//Frame count, frame rate and resolution as cached in the project file, so the stream does not have to be opened to query them.
+		void setVideoInfo(int _nbImages, double _fps, int _width, int _height);
+		bool hasVideoInfo();
+
+		//Number of frames decoded so far, setActiveFrame does not decode if the frame is already active
+		int getNbDecodedFrames();
+
+		//decode latency of setActiveFrame, bins are <1, 1-2, 2-4, ... 128-256 and >256 ms
+		static const int nbDecodeHistogramBins = 10;
+		void recordDecodeTime(double ms);
+		const std::vector<int>& getDecodeHistogram();
+		int getDecodeCount();
+		double getDecodeTimeMean();
+		double getDecodeTimeMax();
+		void resetDecodeStatistics();
 
 
 		void parseXMLData(int id, QString xml_data);
@@ -75,11 +106,36 @@ namespace xma
 		void setFlipped(bool flipped);
 		
 	protected:
+		//Opens the file, reads the frame count and frame rate and decodes the active frame
+		virtual void openFile() = 0;
+		//Releases the file handles and caches
+		virtual void closeFile() = 0;
+		//Creates an unopened stream of the same type
+		virtual VideoStream* createStream(QStringList _filenames) = 0;
+		void updateMemoryUsage(size_t cacheSize = 0);
+		//Sets the decoded frame as image of the stream
+		void setDecodedImage(cv::Mat& frame, bool color = false);
+
 		Image* image;
 		int nbImages;
 		QStringList filenames;
 		double fps;
 		bool isFlipped;
+		int activeFrame;
+
+		QMutex openMutex;
+		std::atomic<bool> opened;
+		//streams opened by the project are managed by the VideoStreamPool, readers are not
+		bool pooled;
+		bool infoLoaded;
+		int width;
+		int height;
+		std::atomic<size_t> memoryUsage;
+		std::atomic<int> nbDecodedFrames;
+
+		std::vector<int> decodeHistogram;
+		double decodeTimeTotal;
+		double decodeTimeMax;
 		
 	protected:
 		QString Filename;
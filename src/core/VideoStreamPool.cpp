@@ -0,0 +1,159 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file VideoStreamPool.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "core/VideoStreamPool.h"
+#include "core/VideoStream.h"
+#include "core/Project.h"
+#include "core/Settings.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <algorithm>
+#include <vector>
+
+using namespace xma;
+
+VideoStreamPool* VideoStreamPool::getInstance()
+{
+	//streams are opened from the decoding threads, so the instance has to be created thread safe
+	static VideoStreamPool instance;
+	return &instance;
+}
+
+VideoStreamPool::VideoStreamPool()
+{
+	evictionScheduled = false;
+	//the limits are read once, they are looked up on every frame step
+	maxStreams = std::max(1, Settings::getInstance()->getIntSetting("VideoMaxOpenStreams"));
+	maxMemory = (size_t) std::max(0, Settings::getInstance()->getIntSetting("VideoMaxMemoryMB")) * 1024 * 1024;
+}
+
+void VideoStreamPool::touch(VideoStream* stream)
+{
+	bool guiThread = !QCoreApplication::instance() || QThread::currentThread() == QCoreApplication::instance()->thread();
+	{
+		QMutexLocker locker(&mutex);
+		std::list<VideoStream*>::iterator it = std::find(streams.begin(), streams.end(), stream);
+		if (it != streams.end())
+			streams.erase(it);
+		streams.push_front(stream);
+
+		//other threads may still decode from the streams which would be closed, so the gui thread closes them
+		if (!guiThread)
+		{
+			if (evictionScheduled)
+				return;
+			evictionScheduled = true;
+		}
+	}
+
+	if (guiThread)
+	{
+		evict();
+	}
+	else
+	{
+		QMetaObject::invokeMethod(QCoreApplication::instance(), []()
+		{
+			VideoStreamPool::getInstance()->evict();
+		}, Qt::QueuedConnection);
+	}
+}
+
+void VideoStreamPool::evict()
+{
+	size_t minimumOpen = std::max((size_t) 1, Project::getInstance()->getCameras().size());
+
+	std::vector<VideoStream*> closing;
+	{
+		QMutexLocker locker(&mutex);
+		evictionScheduled = false;
+
+		size_t memory = 0;
+		for (std::list<VideoStream*>::const_iterator s = streams.begin(); s != streams.end(); ++s)
+		{
+			memory += (*s)->getMemoryUsage();
+		}
+
+		//close the least recently used streams
+		while (streams.size() > minimumOpen && (streams.size() > maxStreams || (maxMemory > 0 && memory > maxMemory)))
+		{
+			size_t usage = streams.back()->getMemoryUsage();
+			memory = (memory > usage) ? memory - usage : 0;
+			closing.push_back(streams.back());
+			streams.pop_back();
+		}
+	}
+
+	//closing locks the stream, so it is done without holding the pool
+	for (std::vector<VideoStream*>::iterator s = closing.begin(); s != closing.end(); ++s)
+	{
+		(*s)->close();
+	}
+}
+
+void VideoStreamPool::remove(VideoStream* stream)
+{
+	QMutexLocker locker(&mutex);
+	streams.remove(stream);
+}
+
+void VideoStreamPool::closeAll()
+{
+	std::vector<VideoStream*> closing;
+	{
+		QMutexLocker locker(&mutex);
+		closing.assign(streams.begin(), streams.end());
+		streams.clear();
+	}
+
+	for (std::vector<VideoStream*>::iterator s = closing.begin(); s != closing.end(); ++s)
+	{
+		(*s)->close();
+	}
+}
+
+int VideoStreamPool::getNbOpenStreams()
+{
+	QMutexLocker locker(&mutex);
+	return streams.size();
+}
+
+size_t VideoStreamPool::getMemoryUsage()
+{
+	QMutexLocker locker(&mutex);
+	size_t memory = 0;
+	for (std::list<VideoStream*>::const_iterator s = streams.begin(); s != streams.end(); ++s)
+	{
+		memory += (*s)->getMemoryUsage();
+	}
+	return memory;
+}
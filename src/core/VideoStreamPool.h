@@ -0,0 +1,70 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file VideoStreamPool.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef VIDEOSTREAMPOOL_H
+#define VIDEOSTREAMPOOL_H
+
+#include <QMutex>
+
+#include <list>
+
+namespace xma
+{
+	class VideoStream;
+
+	/// Keeps track of the opened video streams of the project. Streams are opened lazily on their first use and the
+	/// least recently used ones are closed if more than VideoMaxOpenStreams streams are open or if their decoded
+	/// frames use more than VideoMaxMemoryMB. The most recently used streams, one per camera, are never closed, so
+	/// the streams of the active trial stay open. Streams are only closed on the gui thread, other threads only
+	/// update the order of use and schedule the eviction.
+	class VideoStreamPool
+	{
+	public:
+		static VideoStreamPool* getInstance();
+
+		//Marks the stream as used and closes other streams if the limits are exceeded
+		void touch(VideoStream* stream);
+		void remove(VideoStream* stream);
+		void closeAll();
+
+		int getNbOpenStreams();
+		size_t getMemoryUsage();
+
+	private:
+		VideoStreamPool();
+		//Closes the least recently used streams if the limits are exceeded, must be called from the gui thread
+		void evict();
+
+		QMutex mutex;
+		bool evictionScheduled;
+		size_t maxStreams;
+		size_t maxMemory;
+		//open streams, most recently used first
+		std::list<VideoStream*> streams;
+	};
+}
+
+#endif //VIDEOSTREAMPOOL_H
@@ -0,0 +1,222 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file OverlayBuffer.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#include <GL/glew.h>
+
+#include "gl/OverlayBuffer.h"
+
+#include <cstddef>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <OpenGL/glu.h>
+#else
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#include <GL/glu.h>
+#endif
+
+using namespace xma;
+
+OverlayBuffer::OverlayBuffer() : stipple(false), blend(false), vboId(0), vboSize(0), uploaded(false)
+{
+	currentColor[0] = 255;
+	currentColor[1] = 255;
+	currentColor[2] = 255;
+	currentColor[3] = 255;
+}
+
+OverlayBuffer::~OverlayBuffer()
+{
+	if (vboId != 0) glDeleteBuffers(1, &vboId);
+}
+
+void OverlayBuffer::clear()
+{
+	vertices.clear();
+	batches.clear();
+	stipple = false;
+	blend = false;
+	uploaded = false;
+}
+
+bool OverlayBuffer::isEmpty() const
+{
+	return batches.empty();
+}
+
+void OverlayBuffer::setStipple(bool value)
+{
+	stipple = value;
+}
+
+void OverlayBuffer::setBlend(bool value)
+{
+	blend = value;
+}
+
+void OverlayBuffer::begin(unsigned int mode)
+{
+	//independent primitives are appended to the previous batch if the state is the same
+	bool independent = mode == GL_LINES || mode == GL_POINTS || mode == GL_TRIANGLES;
+	if (independent && !batches.empty())
+	{
+		Batch& last = batches.back();
+		if (last.mode == mode && last.stipple == stipple && last.blend == blend && last.first + last.count == (int)vertices.size())
+		{
+			last.count = -1;
+			return;
+		}
+	}
+
+	Batch batch;
+	batch.mode = mode;
+	batch.stipple = stipple;
+	batch.blend = blend;
+	batch.first = vertices.size();
+	batch.count = -1;
+	batches.push_back(batch);
+}
+
+void OverlayBuffer::end()
+{
+	if (batches.empty())
+		return;
+
+	Batch& last = batches.back();
+	last.count = vertices.size() - last.first;
+	if (last.count == 0)
+		batches.pop_back();
+	uploaded = false;
+}
+
+void OverlayBuffer::color(float r, float g, float b, float a)
+{
+	currentColor[0] = (unsigned char)(r * 255.0f + 0.5f);
+	currentColor[1] = (unsigned char)(g * 255.0f + 0.5f);
+	currentColor[2] = (unsigned char)(b * 255.0f + 0.5f);
+	currentColor[3] = (unsigned char)(a * 255.0f + 0.5f);
+}
+
+void OverlayBuffer::colorub(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+	currentColor[0] = r;
+	currentColor[1] = g;
+	currentColor[2] = b;
+	currentColor[3] = a;
+}
+
+void OverlayBuffer::vertex(float x, float y, float z)
+{
+	Vertex v;
+	v.x = x;
+	v.y = y;
+	v.z = z;
+	v.rgba[0] = currentColor[0];
+	v.rgba[1] = currentColor[1];
+	v.rgba[2] = currentColor[2];
+	v.rgba[3] = currentColor[3];
+	vertices.push_back(v);
+}
+
+void OverlayBuffer::render()
+{
+	if (batches.empty())
+		return;
+
+	if (vboId == 0)
+		glGenBuffers(1, &vboId);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vboId);
+	if (!uploaded)
+	{
+		unsigned int size = vertices.size() * sizeof(Vertex);
+		if (size > vboSize)
+		{
+			glBufferData(GL_ARRAY_BUFFER, size, &vertices[0], GL_DYNAMIC_DRAW);
+			vboSize = size;
+		}
+		else
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, &vertices[0]);
+		}
+		uploaded = true;
+	}
+
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(Vertex), (const GLvoid*)offsetof(Vertex, x));
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), (const GLvoid*)offsetof(Vertex, rgba));
+
+	std::vector<GLint> firsts;
+	std::vector<GLsizei> counts;
+	for (unsigned int i = 0; i < batches.size();)
+	{
+		//draw all following batches with the same mode and state at once
+		const Batch& batch = batches[i];
+		firsts.clear();
+		counts.clear();
+		for (; i < batches.size() && batches[i].mode == batch.mode && batches[i].stipple == batch.stipple && batches[i].blend == batch.blend; i++)
+		{
+			firsts.push_back(batches[i].first);
+			counts.push_back(batches[i].count);
+		}
+
+		if (batch.stipple)
+		{
+			glLineStipple(10, 0xAAAA);
+			glEnable(GL_LINE_STIPPLE);
+		}
+		if (batch.blend)
+		{
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		if (firsts.size() == 1)
+		{
+			glDrawArrays(batch.mode, firsts[0], counts[0]);
+		}
+		else
+		{
+			glMultiDrawArrays(batch.mode, &firsts[0], &counts[0], firsts.size());
+		}
+
+		if (batch.stipple) glDisable(GL_LINE_STIPPLE);
+		if (batch.blend) glDisable(GL_BLEND);
+	}
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	//the current color is undefined after drawing with a color array
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+}
@@ -0,0 +1,90 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file OverlayBuffer.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef OVERLAYBUFFER_H_
+#define OVERLAYBUFFER_H_
+
+#include <vector>
+
+namespace xma
+{
+	/// Retained-mode buffer for lines and points drawn on top of the views. The primitives are recorded
+	/// with an immediate-mode like interface (begin/color/vertex/end) only when the content changes and
+	/// rendered from a single vertex buffer object. Consecutive primitives with the same mode and state
+	/// are drawn with one call.
+	class OverlayBuffer
+	{
+	public:
+		OverlayBuffer();
+		//the GL context of the view has to be current, as the buffer object is deleted
+		~OverlayBuffer();
+
+		void clear();
+		bool isEmpty() const;
+
+		//state applied to the primitives started afterwards
+		void setStipple(bool value);
+		void setBlend(bool value);
+
+		void begin(unsigned int mode);
+		void end();
+
+		void color(float r, float g, float b, float a = 1.0f);
+		void colorub(unsigned char r, unsigned char g, unsigned char b, unsigned char a = 255);
+		void vertex(float x, float y, float z = 0.0f);
+
+		void render();
+
+	private:
+		struct Vertex
+		{
+			float x, y, z;
+			unsigned char rgba[4];
+		};
+
+		struct Batch
+		{
+			unsigned int mode;
+			bool stipple;
+			bool blend;
+			int first;
+			int count;
+		};
+
+		std::vector<Vertex> vertices;
+		std::vector<Batch> batches;
+
+		unsigned char currentColor[4];
+		bool stipple;
+		bool blend;
+
+		unsigned int vboId;
+		unsigned int vboSize;
+		bool uploaded;
+	};
+}
+
+#endif // OVERLAYBUFFER_H_
@@ -109,8 +109,11 @@ void VertexBuffer::render()
 	mutex.lock();
 	if (!m_initialised)
 	{
-		if (!m_dataReady) 
+		if (!m_dataReady)
+		{
+			mutex.unlock();
 			return;
+		}
 
 		setupVBO();
 	}
@@ -140,6 +143,9 @@ void VertexBuffer::render()
 	glDrawElements(GL_TRIANGLES, m_numvertices, GL_UNSIGNED_INT, NULL);
 
 	//unload
+	if (tboId) glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	if (nboId) glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	mutex.unlock();
@@ -0,0 +1,613 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AutoMarkerDetection.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/AutoMarkerDetection.h"
+#include "processing/BlobDetection.h"
+#include "processing/LinearAssignment.h"
+
+#include "ui/MainWindow.h"
+#include "ui/PointsDockWidget.h"
+#include "ui/PlotWindow.h"
+#include "ui/ConfirmationDialog.h"
+
+#include "core/Project.h"
+#include "core/Camera.h"
+#include "core/Trial.h"
+#include "core/Marker.h"
+#include "core/VideoStream.h"
+#include "core/Settings.h"
+
+#include <QtCore>
+#include <QtConcurrent/QtConcurrent>
+
+#include <limits>
+#include <algorithm>
+#include <iostream>
+
+using namespace xma;
+
+namespace
+{
+	//candidates seen in fewer frames are considered noise
+	const int minCandidateFrames = 5;
+
+	cv::Matx33d fundamentalMatrix(const cv::Mat& P0, const cv::Mat& P1)
+	{
+		cv::Mat center;
+		cv::SVD::solveZ(P0, center);
+		cv::Mat e = P1 * center;
+
+		cv::Mat ex = (cv::Mat_<double>(3, 3) << 0, -e.at<double>(2, 0), e.at<double>(1, 0),
+			e.at<double>(2, 0), 0, -e.at<double>(0, 0),
+			-e.at<double>(1, 0), e.at<double>(0, 0), 0);
+
+		cv::Mat P0inv;
+		cv::invert(P0, P0inv, cv::DECOMP_SVD);
+		cv::Mat F = ex * P1 * P0inv;
+		return cv::Matx33d(F.ptr<double>());
+	}
+
+	//mean distance of the points to the epipolar lines of the other point
+	double epipolarDistance(const cv::Matx33d& F, const cv::Point2d& p0, const cv::Point2d& p1)
+	{
+		cv::Vec3d x0(p0.x, p0.y, 1.0);
+		cv::Vec3d x1(p1.x, p1.y, 1.0);
+		cv::Vec3d l1 = F * x0;
+		cv::Vec3d l0 = F.t() * x1;
+		double n1 = std::sqrt(l1[0] * l1[0] + l1[1] * l1[1]);
+		double n0 = std::sqrt(l0[0] * l0[0] + l0[1] * l0[1]);
+		if (n0 == 0.0 || n1 == 0.0)
+			return std::numeric_limits<double>::infinity();
+		return 0.5 * (std::abs(l1.dot(x1)) / n1 + std::abs(l0.dot(x0)) / n0);
+	}
+}
+
+AutoMarkerDetection::AutoMarkerDetection(Trial* trial, int frameStart, int frameEnd) : ThreadedProcessing("Detect Markers")
+{
+	m_trial = trial;
+	m_frameStart = frameStart;
+	m_frameEnd = frameEnd;
+
+	m_maxEpipolarDistance = 0;
+	m_maxReprojectionError = 0;
+	m_maxLinkDistance = 0;
+	m_maxGap = 0;
+
+	m_nbBlobs = 0;
+	m_nbDetections = 0;
+	m_loadTime = 0;
+	m_detectionTime = 0;
+	m_matchingTime = 0;
+	m_linkingTime = 0;
+}
+
+AutoMarkerDetection::~AutoMarkerDetection()
+{
+}
+
+void AutoMarkerDetection::process()
+{
+	int nbCameras = Project::getInstance()->getCameras().size();
+	if (nbCameras < 2 || Project::getInstance()->getCalibration() == NO_CALIBRATION)
+		return;
+
+	m_params = BlobDetection::getDetectorParams(-1);
+	m_params.blobColor = Settings::getInstance()->getIntSetting("AutoDetectionBlobColor");
+	m_maxEpipolarDistance = Settings::getInstance()->getFloatSetting("AutoDetectionMaxEpipolarDistance");
+	m_maxReprojectionError = Settings::getInstance()->getFloatSetting("AutoDetectionMaxReprojectionError");
+	m_maxLinkDistance = Settings::getInstance()->getFloatSetting("AutoDetectionMaxLinkDistance");
+	m_maxGap = std::max(1, Settings::getInstance()->getIntSetting("AutoDetectionMaxGap"));
+
+	for (int c = 0; c < nbCameras; c++)
+	{
+		m_projections.push_back(Project::getInstance()->getCameras()[c]->getProjectionMatrix(m_trial->getReferenceCalibrationImage()).clone());
+	}
+	for (int c = 0; c < nbCameras; c++)
+	{
+		m_fundamental.push_back(fundamentalMatrix(m_projections[0], m_projections[c]));
+	}
+
+	for (int c = 0; c < nbCameras; c++)
+	{
+		m_streams.push_back(m_trial->getVideoStreams()[c]->createReader());
+		m_streams.back()->open();
+	}
+
+	//markers continue from the frames before the range
+	std::vector<LinkState> markerStates(m_trial->getMarkers().size());
+	for (unsigned int m = 0; m < markerStates.size(); m++)
+	{
+		markerStates[m].frame = -1;
+		Marker* marker = m_trial->getMarkers()[m];
+		for (int f = std::max(0, m_frameStart - m_maxGap); f < m_frameStart; f++)
+		{
+			if (marker->getStatus3D()[f] > 0)
+				updateState(markerStates[m], marker->getPoints3D()[f], f, m_maxGap);
+		}
+	}
+
+	//frames are processed in batches to bound the number of images held in memory
+	int batchSize = 2 * QThread::idealThreadCount();
+	QElapsedTimer timer;
+	for (int batchStart = m_frameStart; batchStart <= m_frameEnd; batchStart += batchSize)
+	{
+		std::vector<DetectionFrame> frames(std::min(batchSize, m_frameEnd - batchStart + 1));
+		for (unsigned int i = 0; i < frames.size(); i++)
+		{
+			frames[i].frame = batchStart + i;
+			frames[i].images.resize(nbCameras);
+			frames[i].points2D.resize(nbCameras);
+			frames[i].undistorted.resize(nbCameras);
+		}
+
+		timer.start();
+		loadImages(frames);
+		m_loadTime += timer.nsecsElapsed() / 1000000.0;
+
+		timer.restart();
+		std::vector<std::pair<int, int> > tasks;
+		for (unsigned int i = 0; i < frames.size(); i++)
+		{
+			for (int c = 0; c < nbCameras; c++)
+			{
+				tasks.push_back(std::make_pair(i, c));
+			}
+		}
+		QtConcurrent::blockingMap(tasks, [this, &frames](const std::pair<int, int>& task)
+		{
+			detectBlobs(frames[task.first], task.second);
+		});
+		m_detectionTime += timer.nsecsElapsed() / 1000000.0;
+
+		timer.restart();
+		QtConcurrent::blockingMap(frames, [this](DetectionFrame& frame)
+		{
+			matchFrame(frame);
+		});
+		m_matchingTime += timer.nsecsElapsed() / 1000000.0;
+
+		//linking depends on the previous frames
+		timer.restart();
+		for (unsigned int i = 0; i < frames.size(); i++)
+		{
+			for (int c = 0; c < nbCameras; c++)
+			{
+				m_nbBlobs += frames[i].points2D[c].size();
+			}
+			m_nbDetections += frames[i].detections.size();
+			linkFrame(frames[i], markerStates);
+		}
+		m_linkingTime += timer.nsecsElapsed() / 1000000.0;
+	}
+
+	m_candidates.erase(std::remove_if(m_candidates.begin(), m_candidates.end(), [](const Candidate& candidate)
+	{
+		return candidate.frames.size() < (unsigned int) minCandidateFrames;
+	}), m_candidates.end());
+
+	for (unsigned int c = 0; c < m_streams.size(); c++)
+	{
+		delete m_streams[c];
+	}
+	m_streams.clear();
+}
+
+void AutoMarkerDetection::loadImages(std::vector<DetectionFrame>& frames)
+{
+	//each video is decoded sequentially, the cameras concurrently
+	std::vector<int> cameras(m_projections.size());
+	for (unsigned int c = 0; c < cameras.size(); c++)
+		cameras[c] = c;
+
+	QtConcurrent::blockingMap(cameras, [this, &frames](const int& c)
+	{
+		VideoStream* stream = m_streams[c];
+		for (unsigned int i = 0; i < frames.size(); i++)
+		{
+			stream->setActiveFrame(frames[i].frame);
+			stream->getImage()->getImage(frames[i].images[c]);
+		}
+	});
+}
+
+void AutoMarkerDetection::detectBlobs(DetectionFrame& frame, int camera)
+{
+	BlobDetection::detectBlobs(frame.images[camera], m_params, frame.points2D[camera]);
+	frame.images[camera].release();
+
+	Camera* cam = Project::getInstance()->getCameras()[camera];
+	for (unsigned int i = 0; i < frame.points2D[camera].size(); i++)
+	{
+		frame.undistorted[camera].push_back(cam->undistortPoint(frame.points2D[camera][i], true));
+	}
+}
+
+void AutoMarkerDetection::matchFrame(DetectionFrame& frame)
+{
+	int nbCameras = m_projections.size();
+	const std::vector<cv::Point2d>& pts0 = frame.undistorted[0];
+	const std::vector<cv::Point2d>& pts1 = frame.undistorted[1];
+	if (pts0.empty() || pts1.empty())
+		return;
+
+	auto createDetection = [&frame, nbCameras](int idx0, int idx1)
+	{
+		Detection detection;
+		detection.points2D.assign(nbCameras, cv::Point2d(-2, -2));
+		detection.undistorted.assign(nbCameras, cv::Point2d(-2, -2));
+		detection.detected.assign(nbCameras, 0);
+		detection.points2D[0] = frame.points2D[0][idx0];
+		detection.undistorted[0] = frame.undistorted[0][idx0];
+		detection.detected[0] = 1;
+		detection.points2D[1] = frame.points2D[1][idx1];
+		detection.undistorted[1] = frame.undistorted[1][idx1];
+		detection.detected[1] = 1;
+		detection.error = 0;
+		return detection;
+	};
+
+	//the blobs of the first two cameras are matched by the reprojection error of the triangulated point,
+	//only pairs close to the epipolar line are triangulated
+	const double forbidden = std::numeric_limits<double>::infinity();
+	cv::Mat cost(pts0.size(), pts1.size(), CV_64F, cv::Scalar(forbidden));
+	for (unsigned int i = 0; i < pts0.size(); i++)
+	{
+		for (unsigned int j = 0; j < pts1.size(); j++)
+		{
+			if (epipolarDistance(m_fundamental[1], pts0[i], pts1[j]) > m_maxEpipolarDistance)
+				continue;
+
+			Detection detection = createDetection(i, j);
+			if (triangulate(detection))
+				cost.at<double>(i, j) = detection.error;
+		}
+	}
+
+	std::vector<int> assignment;
+	LinearAssignment::solve(cost, assignment, m_maxReprojectionError);
+
+	std::vector<Detection> detections;
+	for (unsigned int i = 0; i < assignment.size(); i++)
+	{
+		if (assignment[i] < 0)
+			continue;
+
+		detections.push_back(createDetection(i, assignment[i]));
+		triangulate(detections.back());
+	}
+
+	//the points of the other cameras are assigned by their distance to the projected 3D points
+	for (int c = 2; c < nbCameras && !detections.empty(); c++)
+	{
+		const std::vector<cv::Point2d>& pts = frame.undistorted[c];
+		if (pts.empty())
+			continue;
+
+		cv::Mat costCamera(detections.size(), pts.size(), CV_64F);
+		for (unsigned int i = 0; i < detections.size(); i++)
+		{
+			cv::Point2d projected = project(c, detections[i].point3D);
+			for (unsigned int j = 0; j < pts.size(); j++)
+			{
+				costCamera.at<double>(i, j) = cv::norm(projected - pts[j]);
+			}
+		}
+
+		LinearAssignment::solve(costCamera, assignment, m_maxEpipolarDistance);
+		for (unsigned int i = 0; i < assignment.size(); i++)
+		{
+			if (assignment[i] < 0)
+				continue;
+
+			detections[i].points2D[c] = frame.points2D[c][assignment[i]];
+			detections[i].undistorted[c] = pts[assignment[i]];
+			detections[i].detected[c] = 1;
+		}
+	}
+
+	for (unsigned int i = 0; i < detections.size(); i++)
+	{
+		if ((nbCameras == 2 || triangulate(detections[i])) && detections[i].error <= m_maxReprojectionError)
+			frame.detections.push_back(detections[i]);
+	}
+}
+
+void AutoMarkerDetection::linkFrame(const DetectionFrame& frame, std::vector<LinkState>& markerStates)
+{
+	int f = frame.frame;
+	int nbCameras = m_projections.size();
+	const std::vector<Marker*>& markers = m_trial->getMarkers();
+	const std::vector<Detection>& detections = frame.detections;
+
+	//markers set in this frame claim their detection, the others are searched at their extrapolated position
+	std::vector<int> refs;
+	std::vector<cv::Point3d> refPoints;
+	std::vector<char> refSet;
+	for (unsigned int m = 0; m < markers.size(); m++)
+	{
+		if (markers[m]->getStatus3D()[f] > 0)
+		{
+			refs.push_back(m);
+			refPoints.push_back(markers[m]->getPoints3D()[f]);
+			refSet.push_back(1);
+		}
+		else if (markerStates[m].frame >= 0 && f - markerStates[m].frame <= m_maxGap)
+		{
+			refs.push_back(m);
+			refPoints.push_back(markerStates[m].point + markerStates[m].velocity * (f - markerStates[m].frame));
+			refSet.push_back(0);
+		}
+	}
+
+	std::vector<char> used(detections.size(), 0);
+	std::vector<int> assignment;
+	if (!refs.empty() && !detections.empty())
+	{
+		cv::Mat cost(refs.size(), detections.size(), CV_64F);
+		for (unsigned int r = 0; r < refs.size(); r++)
+		{
+			for (unsigned int d = 0; d < detections.size(); d++)
+			{
+				cost.at<double>(r, d) = cv::norm(refPoints[r] - detections[d].point3D);
+			}
+		}
+		LinearAssignment::solve(cost, assignment, m_maxLinkDistance);
+	}
+	else
+	{
+		assignment.assign(refs.size(), -1);
+	}
+
+	for (unsigned int r = 0; r < refs.size(); r++)
+	{
+		int m = refs[r];
+		if (assignment[r] >= 0)
+			used[assignment[r]] = 1;
+
+		if (refSet[r])
+		{
+			updateState(markerStates[m], refPoints[r], f, m_maxGap);
+			continue;
+		}
+		if (assignment[r] < 0)
+			continue;
+
+		const Detection& detection = detections[assignment[r]];
+		MarkerLink link;
+		link.marker = m;
+		link.frame = f;
+		link.points2D = detection.points2D;
+		link.detected = detection.detected;
+
+		//points which were deleted or marked untrackable are kept
+		bool hasPoints = false;
+		for (int c = 0; c < nbCameras; c++)
+		{
+			markerStatus status = markers[m]->getStatus2D()[c][f];
+			if (status != UNDEFINED && status != LOST)
+				link.detected[c] = 0;
+			hasPoints = hasPoints || link.detected[c];
+		}
+		if (hasPoints)
+			m_links.push_back(link);
+
+		updateState(markerStates[m], detection.point3D, f, m_maxGap);
+	}
+
+	//the remaining detections continue or start new marker candidates
+	std::vector<int> unused;
+	for (unsigned int d = 0; d < detections.size(); d++)
+	{
+		if (!used[d])
+			unused.push_back(d);
+	}
+	if (unused.empty())
+		return;
+
+	std::vector<int> open;
+	for (unsigned int k = 0; k < m_candidates.size(); k++)
+	{
+		if (f - m_candidates[k].state.frame <= m_maxGap)
+			open.push_back(k);
+	}
+
+	std::vector<int> candidateAssignment(open.size(), -1);
+	if (!open.empty())
+	{
+		cv::Mat cost(open.size(), unused.size(), CV_64F);
+		for (unsigned int k = 0; k < open.size(); k++)
+		{
+			const LinkState& state = m_candidates[open[k]].state;
+			cv::Point3d predicted = state.point + state.velocity * (f - state.frame);
+			for (unsigned int d = 0; d < unused.size(); d++)
+			{
+				cost.at<double>(k, d) = cv::norm(predicted - detections[unused[d]].point3D);
+			}
+		}
+		LinearAssignment::solve(cost, candidateAssignment, m_maxLinkDistance);
+	}
+
+	std::vector<char> linked(unused.size(), 0);
+	for (unsigned int k = 0; k < open.size(); k++)
+	{
+		if (candidateAssignment[k] < 0)
+			continue;
+
+		const Detection& detection = detections[unused[candidateAssignment[k]]];
+		Candidate& candidate = m_candidates[open[k]];
+		candidate.frames.push_back(f);
+		candidate.detections.push_back(detection);
+		updateState(candidate.state, detection.point3D, f, m_maxGap);
+		linked[candidateAssignment[k]] = 1;
+	}
+
+	for (unsigned int d = 0; d < unused.size(); d++)
+	{
+		if (linked[d])
+			continue;
+
+		Candidate candidate;
+		candidate.state.frame = -1;
+		candidate.frames.push_back(f);
+		candidate.detections.push_back(detections[unused[d]]);
+		updateState(candidate.state, detections[unused[d]].point3D, f, m_maxGap);
+		m_candidates.push_back(candidate);
+	}
+}
+
+bool AutoMarkerDetection::triangulate(Detection& detection)
+{
+	int count = 0;
+	for (unsigned int c = 0; c < detection.detected.size(); c++)
+	{
+		if (detection.detected[c]) count++;
+	}
+	if (count < 2)
+		return false;
+
+	cv::Mat A(2 * count, 4, CV_64F);
+	count = 0;
+	for (unsigned int c = 0; c < detection.detected.size(); c++)
+	{
+		if (!detection.detected[c])
+			continue;
+
+		const cv::Mat& P = m_projections[c];
+		for (int k = 0; k < 4; k++)
+		{
+			A.at<double>(count * 2 + 0, k) = detection.undistorted[c].x * P.at<double>(2, k) - P.at<double>(0, k);
+			A.at<double>(count * 2 + 1, k) = detection.undistorted[c].y * P.at<double>(2, k) - P.at<double>(1, k);
+		}
+		count++;
+	}
+
+	cv::Mat X;
+	cv::SVD::solveZ(A, X);
+	double w = X.at<double>(3, 0);
+	if (w == 0.0)
+		return false;
+
+	detection.point3D = cv::Point3d(X.at<double>(0, 0) / w, X.at<double>(1, 0) / w, X.at<double>(2, 0) / w);
+
+	detection.error = 0;
+	for (unsigned int c = 0; c < detection.detected.size(); c++)
+	{
+		if (detection.detected[c])
+			detection.error += cv::norm(project(c, detection.point3D) - detection.undistorted[c]);
+	}
+	detection.error /= count;
+
+	return true;
+}
+
+cv::Point2d AutoMarkerDetection::project(int camera, const cv::Point3d& pt)
+{
+	const cv::Mat& P = m_projections[camera];
+	double x = P.at<double>(0, 0) * pt.x + P.at<double>(0, 1) * pt.y + P.at<double>(0, 2) * pt.z + P.at<double>(0, 3);
+	double y = P.at<double>(1, 0) * pt.x + P.at<double>(1, 1) * pt.y + P.at<double>(1, 2) * pt.z + P.at<double>(1, 3);
+	double w = P.at<double>(2, 0) * pt.x + P.at<double>(2, 1) * pt.y + P.at<double>(2, 2) * pt.z + P.at<double>(2, 3);
+	return cv::Point2d(x / w, y / w);
+}
+
+void AutoMarkerDetection::updateState(LinkState& state, const cv::Point3d& pt, int frame, int maxGap)
+{
+	if (state.frame >= 0 && frame > state.frame && frame - state.frame <= maxGap)
+	{
+		state.velocity = (pt - state.point) * (1.0 / (frame - state.frame));
+	}
+	else
+	{
+		state.velocity = cv::Point3d(0, 0, 0);
+	}
+	state.point = pt;
+	state.frame = frame;
+}
+
+void AutoMarkerDetection::process_finished()
+{
+	int nbCameras = Project::getInstance()->getCameras().size();
+
+	//the linked points are triangulated and the rigid bodies updated once for all frames
+	if (!m_links.empty())
+	{
+		m_trial->beginEdit();
+		for (std::vector<MarkerLink>::const_iterator link = m_links.begin(); link != m_links.end(); ++link)
+		{
+			Marker* marker = m_trial->getMarkers()[link->marker];
+			for (int c = 0; c < nbCameras; c++)
+			{
+				if (link->detected[c])
+					marker->setPoint(c, link->frame, link->points2D[c].x, link->points2D[c].y, TRACKED);
+			}
+		}
+		m_trial->commitEdit();
+	}
+
+	std::cout << "Auto detection frames " << m_frameStart + 1 << " - " << m_frameEnd + 1 << " : " << m_nbBlobs << " blobs, " << m_nbDetections << " matched points, "
+		<< m_links.size() << " points linked to markers, " << m_candidates.size() << " new marker candidates" << std::endl;
+	std::cout << "Load " << m_loadTime << " ms, detection " << m_detectionTime << " ms, matching " << m_matchingTime << " ms, linking " << m_linkingTime << " ms" << std::endl;
+	for (unsigned int k = 0; k < m_candidates.size(); k++)
+	{
+		const cv::Point3d& pt = m_candidates[k].detections[0].point3D;
+		std::cout << "Candidate " << k + 1 << " : frames " << m_candidates[k].frames.front() + 1 << " - " << m_candidates[k].frames.back() + 1
+			<< " (" << m_candidates[k].frames.size() << " frames) starting at " << pt.x << " " << pt.y << " " << pt.z << std::endl;
+	}
+
+	if (!m_candidates.empty() && ConfirmationDialog::getInstance()->showConfirmationDialog(
+		QString::number(m_candidates.size()) + " new marker candidates were detected. Do you want to add them as new markers?"))
+	{
+		std::vector<Marker*> newMarkers;
+		for (unsigned int k = 0; k < m_candidates.size(); k++)
+		{
+			Marker* marker = new Marker(nbCameras, m_trial->getNbImages(), m_trial);
+			marker->setDescription(QString("Candidate %1").arg(k + 1));
+			for (unsigned int i = 0; i < m_candidates[k].frames.size(); i++)
+			{
+				const Detection& detection = m_candidates[k].detections[i];
+				for (int c = 0; c < nbCameras; c++)
+				{
+					if (detection.detected[c])
+						marker->setPoint(c, m_candidates[k].frames[i], detection.points2D[c].x, detection.points2D[c].y, TRACKED, false);
+				}
+				//new markers are not part of a rigid body yet, so no pose has to be updated
+				marker->reconstruct3DPoint(m_candidates[k].frames[i], true);
+			}
+			newMarkers.push_back(marker);
+		}
+		m_trial->addMarkers(newMarkers);
+	}
+
+	m_links.clear();
+	m_candidates.clear();
+
+	MainWindow::getInstance()->redrawGL();
+	PointsDockWidget::getInstance()->reloadListFromObject();
+	PlotWindow::getInstance()->updateMarkers(true);
+}
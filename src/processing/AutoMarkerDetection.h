@@ -0,0 +1,136 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file AutoMarkerDetection.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef AUTOMARKERDETECTION_H
+#define AUTOMARKERDETECTION_H
+
+#include "processing/ThreadedProcessing.h"
+
+#include <opencv2/opencv.hpp>
+
+namespace xma
+{
+	class Trial;
+	class VideoStream;
+
+	/// Detects the markers in whole frames of a trial. Blobs are detected in all cameras of a frame range in parallel,
+	/// matched between the cameras by their epipolar distance and reprojection error with an optimal assignment and
+	/// linked over time to the existing markers by their 3D distance. Frames in which a marker is not set yet are
+	/// filled with the linked points. Detections which can not be linked are grouped over time and reported as new
+	/// marker candidates.
+	class AutoMarkerDetection : public ThreadedProcessing
+	{
+		Q_OBJECT;
+
+	public:
+		//frames are 0-based and inclusive
+		AutoMarkerDetection(Trial* trial, int frameStart, int frameEnd);
+		virtual ~AutoMarkerDetection();
+
+	protected:
+		void process() override;
+		void process_finished() override;
+
+	private:
+		//a point matched across the cameras
+		struct Detection
+		{
+			std::vector<cv::Point2d> points2D;
+			std::vector<cv::Point2d> undistorted;
+			std::vector<char> detected;
+			cv::Point3d point3D;
+			double error;
+		};
+
+		struct DetectionFrame
+		{
+			int frame;
+			std::vector<cv::Mat> images;
+			std::vector<std::vector<cv::Point2d> > points2D;
+			std::vector<std::vector<cv::Point2d> > undistorted;
+			std::vector<Detection> detections;
+		};
+
+		//points set for a marker in a frame in which it was not set before
+		struct MarkerLink
+		{
+			int marker;
+			int frame;
+			std::vector<cv::Point2d> points2D;
+			std::vector<char> detected;
+		};
+
+		//last position of a marker or candidate, extrapolated with constant velocity over gaps
+		struct LinkState
+		{
+			cv::Point3d point;
+			cv::Point3d velocity;
+			int frame;
+		};
+
+		struct Candidate
+		{
+			LinkState state;
+			std::vector<int> frames;
+			std::vector<Detection> detections;
+		};
+
+		void loadImages(std::vector<DetectionFrame>& frames);
+		void detectBlobs(DetectionFrame& frame, int camera);
+		void matchFrame(DetectionFrame& frame);
+		void linkFrame(const DetectionFrame& frame, std::vector<LinkState>& markerStates);
+
+		bool triangulate(Detection& detection);
+		cv::Point2d project(int camera, const cv::Point3d& pt);
+		static void updateState(LinkState& state, const cv::Point3d& pt, int frame, int maxGap);
+
+		Trial* m_trial;
+		int m_frameStart;
+		int m_frameEnd;
+		//readers owned by the job, so the displayed frames of the trial are not moved
+		std::vector<VideoStream*> m_streams;
+
+		//settings and calibration are read once for all frames
+		cv::SimpleBlobDetector::Params m_params;
+		std::vector<cv::Mat> m_projections;
+		std::vector<cv::Matx33d> m_fundamental;
+		double m_maxEpipolarDistance;
+		double m_maxReprojectionError;
+		double m_maxLinkDistance;
+		int m_maxGap;
+
+		std::vector<MarkerLink> m_links;
+		std::vector<Candidate> m_candidates;
+
+		int m_nbBlobs;
+		int m_nbDetections;
+		double m_loadTime;
+		double m_detectionTime;
+		double m_matchingTime;
+		double m_linkingTime;
+	};
+}
+#endif // AUTOMARKERDETECTION_H
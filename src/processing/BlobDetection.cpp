@@ -56,19 +56,8 @@ BlobDetection::~BlobDetection()
 {
 }
 
-void BlobDetection::process()
+cv::SimpleBlobDetector::Params BlobDetection::getDetectorParams(int image)
 {
-	tmpPoints.clear();
-	cv::Mat image;
-	if (m_image < 0)
-	{
-		Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getImage()->getImage(image);
-	}
-	else
-	{
-		Project::getInstance()->getCameras()[m_camera]->getCalibrationSequence()->getImage(m_image,true)->getImage(image);
-	}
-
 	cv::SimpleBlobDetector::Params paramsBlob;
 
 	paramsBlob.thresholdStep = Settings::getInstance()->getFloatSetting("BlobDetectorThresholdStep");
@@ -78,7 +67,7 @@ void BlobDetection::process()
 	paramsBlob.minDistBetweenBlobs = Settings::getInstance()->getFloatSetting("BlobDetectorMinDistBetweenBlobs");
 
 	paramsBlob.filterByColor = Settings::getInstance()->getBoolSetting("BlobDetectorFilterByColor");
-	if (m_image < 0 || CalibrationObject::getInstance()->hasWhiteBlobs())
+	if (image < 0 || CalibrationObject::getInstance()->hasWhiteBlobs())
 	{
 		paramsBlob.blobColor = Settings::getInstance()->getIntSetting("BlobDetectorBlobColor");
 	}
@@ -103,15 +92,36 @@ void BlobDetection::process()
 	paramsBlob.minConvexity = Settings::getInstance()->getFloatSetting("BlobDetectorMinConvexity");
 	paramsBlob.maxConvexity = Settings::getInstance()->getFloatSetting("BlobDetectorMaxConvexity");
 
-	cv::Ptr<cv::SimpleBlobDetector> detector = cv::SimpleBlobDetector::create(paramsBlob);
+	return paramsBlob;
+}
+
+void BlobDetection::detectBlobs(const cv::Mat& image, const cv::SimpleBlobDetector::Params& params, std::vector<cv::Point2d>& points)
+{
+	cv::Ptr<cv::SimpleBlobDetector> detector = cv::SimpleBlobDetector::create(params);
 	std::vector<cv::KeyPoint> keypoints;
 
 	detector->detect(image, keypoints);
 
 	for (unsigned int i = 0; i < keypoints.size(); i++)
 	{
-		tmpPoints.push_back(cv::Point2d(keypoints[i].pt.x, keypoints[i].pt.y));
+		points.push_back(cv::Point2d(keypoints[i].pt.x, keypoints[i].pt.y));
 	}
+}
+
+void BlobDetection::process()
+{
+	tmpPoints.clear();
+	cv::Mat image;
+	if (m_image < 0)
+	{
+		Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getImage()->getImage(image);
+	}
+	else
+	{
+		Project::getInstance()->getCameras()[m_camera]->getCalibrationSequence()->getImage(m_image, true, image);
+	}
+
+	detectBlobs(image, getDetectorParams(m_image), tmpPoints);
 	image.release();
 }
 
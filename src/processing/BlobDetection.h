@@ -44,6 +44,10 @@ namespace xma
 		BlobDetection(int camera, int image);
 		virtual ~BlobDetection();
 
+		//image < 0 selects the parameters for the undistortion grid
+		static cv::SimpleBlobDetector::Params getDetectorParams(int image);
+		static void detectBlobs(const cv::Mat& image, const cv::SimpleBlobDetector::Params& params, std::vector<cv::Point2d>& points);
+
 	protected:
 		void process() override;
 		void process_finished() override;
@@ -0,0 +1,89 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file BuildVideoProxy.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/BuildVideoProxy.h" 
+
+#include "core/Project.h"
+#include "core/Trial.h"
+#include "core/AviVideo.h"
+#include "core/AviProxy.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+#include <iostream>
+
+using namespace xma;
+
+BuildVideoProxy::BuildVideoProxy(QString filename) : ThreadedProcessing("Build Video Proxy"), m_filename{ filename }, m_success{ false }
+{
+}
+
+BuildVideoProxy::~BuildVideoProxy()
+{
+}
+
+void BuildVideoProxy::process()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	int nbFrames = 0;
+	m_success = AviProxy::build(m_filename, [&nbFrames](int frames) { nbFrames = frames; return true; });
+
+	if (m_success)
+	{
+		std::cout << "Built proxy for " << m_filename.toStdString() << " : " << nbFrames << " frames in " << timer.elapsed() << " ms" << std::endl;
+	}
+	else
+	{
+		std::cerr << "Failed to build proxy for " << m_filename.toStdString() << std::endl;
+	}
+}
+
+void BuildVideoProxy::process_finished()
+{
+	if (!m_success)
+		return;
+
+	//streams which are already open switch to the proxy
+	QString path = QFileInfo(m_filename).absoluteFilePath();
+	for (auto trial : Project::getInstance()->getTrials())
+	{
+		for (auto stream : trial->getVideoStreams())
+		{
+			if (dynamic_cast<AviVideo*>(stream) != NULL && stream->isOpen()
+				&& QFileInfo(stream->getFilenames().at(0)).absoluteFilePath() == path)
+			{
+				stream->reloadFile();
+			}
+		}
+	}
+}
@@ -20,37 +20,32 @@
 //  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
 //  ----------------------------------
 //  
-///\file UpdateTrialFrame.h
+///\file BuildVideoProxy.h
 ///\author Benjamin Knorlein
-///\date 11/20/2015
-
-#ifndef UPDATETRIALFRAME_H
-#define UPDATETRIALFRAME_H
+///\date 10/19/2026
 
+#ifndef BUILDVIDEOPROXY_H
+#define BUILDVIDEOPROXY_H
 
 #include "processing/ThreadedProcessing.h"
 
 namespace xma
 {
-	class Trial;
-
-	class UpdateTrialFrame : public ThreadedProcessing
+	class BuildVideoProxy : public ThreadedProcessing
 	{
 		Q_OBJECT;
 
 	public:
-		UpdateTrialFrame(Trial* trial, int frame);
-		virtual ~UpdateTrialFrame();
+		BuildVideoProxy(QString filename);
+		virtual ~BuildVideoProxy();
 
 	protected:
 		void process() override;
 		void process_finished() override;
 
 	private:
-		int m_frame;
-		Trial* m_trial;
+		QString m_filename;
+		bool m_success;
 	};
 }
-#endif // MARKERTRACKING_H
-
-
+#endif // BUILDVIDEOPROXY_H
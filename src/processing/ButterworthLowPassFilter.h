@@ -37,7 +37,7 @@
 *  Longmont, CO 80501, USA
 *
 *------------------------------------
-* The filtfilt funtion is taken from http://stackoverflow.com/questions/17675053/matlabs-filtfilt-algorithm/27270420#27270420
+* The zero-phase filtering is done by the FilterBank
 *
 */
 
@@ -57,9 +57,12 @@ namespace xma
 		ButterworthLowPassFilter(int order, double cutOffFrequency, double recordingFrequency);
 		virtual ~ButterworthLowPassFilter();
 		void filter(std::vector<double>& in, std::vector<double>& out);
+		void getCoefficients(std::vector<double>& b, std::vector<double>& a) const;
 
 	private:
 		int n; // filter order
+		double cutOff; // cutoff frequency
+		double recording; // recording frequency
 		double* dcof; // d coefficients
 		int* ccof; // c coefficients
 		double sf; // scaling factor
@@ -0,0 +1,131 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file CalibrationSequenceDetection.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/CalibrationSequenceDetection.h"
+#include "processing/BlobDetection.h"
+
+#include "core/Project.h"
+#include "core/Camera.h"
+#include "core/Image.h"
+#include "core/CalibrationImage.h"
+#include "core/UndistortionObject.h"
+#include "core/CalibrationSequence.h"
+
+#include <QtCore>
+#include <QtConcurrent/QtConcurrent>
+
+using namespace xma;
+
+CalibrationSequenceDetection::CalibrationSequenceDetection() : ThreadedProcessing("Detect Points")
+{
+	m_totalTime = 0;
+}
+
+CalibrationSequenceDetection::~CalibrationSequenceDetection()
+{
+}
+
+void CalibrationSequenceDetection::addFrame(int camera, int image)
+{
+	DetectionFrame frame;
+	frame.camera = camera;
+	frame.image = image;
+	frame.loadTime = 0;
+	frame.detectionTime = 0;
+	m_frames.push_back(frame);
+}
+
+void CalibrationSequenceDetection::process()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	m_paramsBlob = BlobDetection::getDetectorParams(0);
+	m_paramsUndistortion = BlobDetection::getDetectorParams(-1);
+
+	//bound the number of frames which are held in memory at the same time
+	QThreadPool pool;
+	pool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount(), (int) m_frames.size())));
+
+	QtConcurrent::blockingMap(&pool, m_frames, [this](DetectionFrame& frame)
+	{
+		detectFrame(frame);
+	});
+
+	m_totalTime = timer.nsecsElapsed() / 1000000.0;
+}
+
+void CalibrationSequenceDetection::detectFrame(DetectionFrame& frame)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	cv::Mat image;
+	Camera* camera = Project::getInstance()->getCameras()[frame.camera];
+	if (frame.image < 0)
+	{
+		camera->getUndistortionObject()->getImage()->getImage(image);
+	}
+	else
+	{
+		camera->getCalibrationSequence()->getImage(frame.image, true, image);
+	}
+	frame.loadTime = timer.nsecsElapsed() / 1000000.0;
+	timer.restart();
+
+	BlobDetection::detectBlobs(image, (frame.image < 0) ? m_paramsUndistortion : m_paramsBlob, frame.points);
+	frame.detectionTime = timer.nsecsElapsed() / 1000000.0;
+	image.release();
+}
+
+void CalibrationSequenceDetection::process_finished()
+{
+	double loadTime = 0;
+	double detectionTime = 0;
+	for (std::vector<DetectionFrame>::iterator frame = m_frames.begin(); frame != m_frames.end(); ++frame)
+	{
+		if (frame->image < 0)
+		{
+			Project::getInstance()->getCameras()[frame->camera]->getUndistortionObject()->setDetectedPoints(frame->points);
+			std::cout << "Detection Camera " << frame->camera + 1 << " Undistortion";
+		}
+		else
+		{
+			Project::getInstance()->getCameras()[frame->camera]->getCalibrationImages()[frame->image]->setDetectedPoints(frame->points);
+			std::cout << "Detection Camera " << frame->camera + 1 << " Frame " << frame->image + 1;
+		}
+		std::cout << " : " << frame->points.size() << " points, load " << frame->loadTime << " ms, detection " << frame->detectionTime << " ms" << std::endl;
+		loadTime += frame->loadTime;
+		detectionTime += frame->detectionTime;
+	}
+	std::cout << "Detected " << m_frames.size() << " frames in " << m_totalTime << " ms (load " << loadTime << " ms, detection " << detectionTime << " ms)" << std::endl;
+
+	m_frames.clear();
+}
@@ -20,57 +20,52 @@
 //  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
 //  ----------------------------------
 //  
-///\file UpdateTrialFrame.cpp
+///\file CalibrationSequenceDetection.h
 ///\author Benjamin Knorlein
-///\date 11/20/2015
+///\date 10/19/2026
 
-#ifdef _MSC_VER
-#define _CRT_SECURE_NO_WARNINGS
-#endif
+#ifndef CALIBRATIONSEQUENCEDETECTION_H
+#define CALIBRATIONSEQUENCEDETECTION_H
 
-#include "processing/UpdateTrialFrame.h" 
+#include "processing/ThreadedProcessing.h"
 
-#include "core/Trial.h"
-#include "core/Marker.h"
-#include "core/RigidBody.h"
-using namespace xma;
+#include <opencv2/opencv.hpp>
 
-
-UpdateTrialFrame::UpdateTrialFrame(Trial* trial, int frame) : ThreadedProcessing("Update Trial"), m_frame(frame)
+namespace xma
 {
-	m_trial = trial;
-}
+	class CalibrationSequenceDetection : public ThreadedProcessing
+	{
+		Q_OBJECT;
 
-UpdateTrialFrame::~UpdateTrialFrame()
-{
-}
+	public:
+		CalibrationSequenceDetection();
+		virtual ~CalibrationSequenceDetection();
 
+		//image -1 detects the undistortion grid of the camera
+		void addFrame(int camera, int image);
 
-void UpdateTrialFrame::process()
-{
-	for (unsigned int i = 0; i < m_trial->getMarkers().size(); i++)
-	{
-		if (m_trial->getMarkers()[i]->getRequiresRecomputation()){
-			m_trial->getMarkers()[i]->reconstruct3DPoint(m_frame, true);
-		}
-		else
+	protected:
+		void process() override;
+		void process_finished() override;
+
+	private:
+		struct DetectionFrame
 		{
-			m_trial->getMarkers()[i]->reprojectPoint(m_frame);
-		}
-	}
+			int camera;
+			int image;
+			std::vector<cv::Point2d> points;
+			double loadTime;
+			double detectionTime;
+		};
 
-	for (unsigned int i = 0; i < m_trial->getRigidBodies().size(); i++)
-	{
-		m_trial->getRigidBodies()[i]->getPoseComputed()[m_frame] = false; 
-	}
+		void detectFrame(DetectionFrame& frame);
 
-	for (unsigned int i = 0; i < m_trial->getRigidBodies().size(); i++)
-	{
-		m_trial->getRigidBodies()[i]->computePose(m_frame);
-	}
-}
+		std::vector<DetectionFrame> m_frames;
+		double m_totalTime;
 
-void UpdateTrialFrame::process_finished()
-{
+		//detector parameters are read once for the whole sequence
+		cv::SimpleBlobDetector::Params m_paramsBlob;
+		cv::SimpleBlobDetector::Params m_paramsUndistortion;
+	};
 }
-
+#endif // CALIBRATIONSEQUENCEDETECTION_H
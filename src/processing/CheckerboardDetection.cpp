@@ -88,26 +88,67 @@ void CheckerboardDetection::detectCorner()
 	ProgressDialog::getInstance()->showProgressbar(0, 0, "Detect Corner");
 }
 
+bool CheckerboardDetection::findCorners(const cv::Mat& image, int nbHorizontalSquares, int nbVerticalSquares, std::vector<cv::Point2d>& points)
+{
+	const int maxCoarseSize = 1024;
+	cv::Size patternSize(nbHorizontalSquares, nbVerticalSquares);
+	std::vector<cv::Point2f> corners;
+	bool pattern_found = false;
+
+	//search the pattern on a pyramid level with at most maxCoarseSize pixels per side
+	cv::Mat coarse = image;
+	double scale = 1.0;
+	while (std::max(coarse.cols, coarse.rows) > maxCoarseSize)
+	{
+		cv::Mat tmp;
+		cv::pyrDown(coarse, tmp);
+		coarse = tmp;
+		scale *= 2.0;
+	}
+
+	if (scale > 1.0)
+	{
+		pattern_found = findChessboardCorners(coarse, patternSize, corners, cv::CALIB_CB_ADAPTIVE_THRESH);
+		if (pattern_found)
+		{
+			cv::cornerSubPix(coarse, corners, cv::Size(5, 5), cv::Size(-1, -1),
+				cv::TermCriteria(cv::TermCriteria::MAX_ITER + cv::TermCriteria::EPS, 30, 0.1));
+
+			for (unsigned int i = 0; i < corners.size(); i++)
+			{
+				corners[i].x = (corners[i].x + 0.5) * scale - 0.5;
+				corners[i].y = (corners[i].y + 0.5) * scale - 0.5;
+			}
+		}
+	}
+
+	//fall back to the full resolution search
+	if (!pattern_found)
+	{
+		corners.clear();
+		pattern_found = findChessboardCorners(image, patternSize, corners, cv::CALIB_CB_ADAPTIVE_THRESH);
+	}
+
+	if (pattern_found) cv::cornerSubPix(image, corners, cv::Size(11, 11), cv::Size(-1, -1),
+		cv::TermCriteria(cv::TermCriteria::MAX_ITER + cv::TermCriteria::EPS, 30, 0.1));
+
+	for (unsigned int i = 0; i < corners.size(); i++)
+	{
+		points.push_back(cv::Point2d(corners[i].x, corners[i].y));
+	}
+
+	return pattern_found;
+}
+
 void CheckerboardDetection::detectCorner_thread()
 {
 	tmpPoints.clear();
 	cv::Mat image;
 
-	Project::getInstance()->getCameras()[m_camera]->getCalibrationSequence()->getImage(m_image,true)->getImage(image);
+	Project::getInstance()->getCameras()[m_camera]->getCalibrationSequence()->getImage(m_image, true, image);
 
 	if (!viaHomography){
-		std::vector<cv::Point2f> tmpPoints2;
-		bool pattern_found = findChessboardCorners(image, cv::Size(CalibrationObject::getInstance()->getNbHorizontalSquares(), CalibrationObject::getInstance()->getNbVerticalSquares()), tmpPoints2,
-			cv::CALIB_CB_ADAPTIVE_THRESH);
-
-		if (pattern_found) cv::cornerSubPix(image, tmpPoints2, cv::Size(11, 11), cv::Size(-1, -1),
-			cv::TermCriteria(cv::TermCriteria::MAX_ITER + cv::TermCriteria::EPS, 30, 0.1));
-
-		for (unsigned int i = 0; i < tmpPoints2.size(); i++)
-		{
-			tmpPoints.push_back(cv::Point2d(tmpPoints2[i].x, tmpPoints2[i].y));
-		}
-		tmpPoints2.clear();
+		findCorners(image, CalibrationObject::getInstance()->getNbHorizontalSquares(), CalibrationObject::getInstance()->getNbVerticalSquares(), tmpPoints);
 	}
 	else
 	{
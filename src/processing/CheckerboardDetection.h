@@ -44,6 +44,9 @@ namespace xma
 		virtual ~CheckerboardDetection();
 		void detectCorner();
 
+		//coarse-to-fine chessboard search, high resolution images are searched on a downsampled pyramid level first
+		static bool findCorners(const cv::Mat& image, int nbHorizontalSquares, int nbVerticalSquares, std::vector<cv::Point2d>& points);
+
 		int m_camera;
 		//if -1 undistortion;
 		int m_image;
@@ -0,0 +1,192 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file FilterBank.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+///
+/// The padding and initial conditions follow Matlab's filtfilt as in the implementation from
+/// http://stackoverflow.com/questions/17675053/matlabs-filtfilt-algorithm/27270420#27270420
+/// which was used by ButterworthLowPassFilter before.
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/FilterBank.h"
+#include "processing/ButterworthLowPassFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace xma;
+
+FilterBank* FilterBank::getInstance()
+{
+	//thread-safe initialisation as the bank is used from worker threads
+	static FilterBank instance;
+	return &instance;
+}
+
+FilterBank::FilterBank()
+{
+}
+
+FilterBank::~FilterBank()
+{
+	coefficientCache.clear();
+}
+
+const FilterBank::Coefficients& FilterBank::getCoefficients(int order, double cutOffFrequency, double recordingFrequency)
+{
+	QMutexLocker lock(&mutex);
+
+	//entries are never removed, so references stay valid after the lock is released
+	std::tuple<int, double, double> key(order, cutOffFrequency, recordingFrequency);
+	std::map<std::tuple<int, double, double>, Coefficients>::iterator it = coefficientCache.find(key);
+	if (it != coefficientCache.end())
+		return it->second;
+
+	Coefficients& coefficients = coefficientCache[key];
+	ButterworthLowPassFilter design(order, cutOffFrequency, recordingFrequency);
+	design.getCoefficients(coefficients.b, coefficients.a);
+
+	//initial conditions for a step response, solve (I - A) zi = b(2:n+1) - b(1) * a(2:n+1)
+	const int n = order;
+	std::vector<double> sp(n * n, 0.0);
+	std::vector<double> rhs(n);
+	for (int r = 0; r < n; r++)
+	{
+		sp[r * n] = (r == 0) ? 1.0 + coefficients.a[1] : coefficients.a[r + 1];
+		if (r > 0) sp[r * n + r] = 1.0;
+		if (r < n - 1) sp[r * n + r + 1] = -1.0;
+		rhs[r] = coefficients.b[r + 1] - coefficients.a[r + 1] * coefficients.b[0];
+	}
+
+	//gaussian elimination with partial pivoting
+	for (int c = 0; c < n; c++)
+	{
+		int pivot = c;
+		for (int r = c + 1; r < n; r++)
+		{
+			if (fabs(sp[r * n + c]) > fabs(sp[pivot * n + c])) pivot = r;
+		}
+		if (pivot != c)
+		{
+			for (int k = 0; k < n; k++) std::swap(sp[c * n + k], sp[pivot * n + k]);
+			std::swap(rhs[c], rhs[pivot]);
+		}
+		for (int r = c + 1; r < n; r++)
+		{
+			double f = sp[r * n + c] / sp[c * n + c];
+			for (int k = c; k < n; k++) sp[r * n + k] -= f * sp[c * n + k];
+			rhs[r] -= f * rhs[c];
+		}
+	}
+	coefficients.zi.resize(n);
+	for (int r = n - 1; r >= 0; r--)
+	{
+		double sum = rhs[r];
+		for (int k = r + 1; k < n; k++) sum -= sp[r * n + k] * coefficients.zi[k];
+		coefficients.zi[r] = sum / sp[r * n + r];
+	}
+
+	return coefficients;
+}
+
+void FilterBank::filterChannels(const Coefficients& coefficients, double* data, double* state, double* input, int length, int nbChannels, bool backward)
+{
+	//transposed direct form II, applied in place. The channel loops are innermost and run over contiguous memory.
+	const int n = coefficients.b.size() - 1;
+	const double* b = &coefficients.b[0];
+	const double* a = &coefficients.a[0];
+
+	const int step = backward ? -nbChannels : nbChannels;
+	double* x = backward ? data + (length - 1) * nbChannels : data;
+
+	for (int k = 0; k < n; k++)
+	{
+		for (int c = 0; c < nbChannels; c++)
+			state[k * nbChannels + c] = coefficients.zi[k] * x[c];
+	}
+
+	for (int i = 0; i < length; i++, x += step)
+	{
+		//x is overwritten by the output, the state update needs both
+		for (int c = 0; c < nbChannels; c++)
+			input[c] = x[c];
+
+		for (int c = 0; c < nbChannels; c++)
+			x[c] = b[0] * input[c] + state[c];
+
+		for (int k = 0; k < n - 1; k++)
+		{
+			double* s = state + k * nbChannels;
+			const double* sNext = s + nbChannels;
+			for (int c = 0; c < nbChannels; c++)
+				s[c] = b[k + 1] * input[c] + sNext[c] - a[k + 1] * x[c];
+		}
+
+		double* s = state + (n - 1) * nbChannels;
+		for (int c = 0; c < nbChannels; c++)
+			s[c] = b[n] * input[c] - a[n] * x[c];
+	}
+}
+
+void FilterBank::filtfilt(int order, double cutOffFrequency, double recordingFrequency, const double* in, double* out, int length, int nbChannels)
+{
+	const int nfact = getPaddingLength(order);
+	if (length <= nfact)
+		throw std::domain_error("Input data too short! Data must have length more than 3 times filter order.");
+
+	const Coefficients& coefficients = getCoefficients(order, cutOffFrequency, recordingFrequency);
+
+	//padded signal followed by the filter state and a copy of the current input sample
+	const int paddedLength = length + 2 * nfact;
+	std::vector<double> work((paddedLength + order + 1) * nbChannels);
+	double* signal = &work[0];
+	double* state = signal + paddedLength * nbChannels;
+	double* input = state + order * nbChannels;
+
+	//reflect the signal at both ends to remove transients
+	const double* first = in;
+	const double* last = in + (length - 1) * nbChannels;
+	for (int i = 0; i < nfact; i++)
+	{
+		const double* left = in + (nfact - i) * nbChannels;
+		const double* right = in + (length - 2 - i) * nbChannels;
+		double* padLeft = signal + i * nbChannels;
+		double* padRight = signal + (nfact + length + i) * nbChannels;
+		for (int c = 0; c < nbChannels; c++)
+		{
+			padLeft[c] = 2 * first[c] - left[c];
+			padRight[c] = 2 * last[c] - right[c];
+		}
+	}
+	std::copy(in, in + length * nbChannels, signal + nfact * nbChannels);
+
+	filterChannels(coefficients, signal, state, input, paddedLength, nbChannels, false);
+	filterChannels(coefficients, signal, state, input, paddedLength, nbChannels, true);
+
+	std::copy(signal + nfact * nbChannels, signal + (nfact + length) * nbChannels, out);
+}
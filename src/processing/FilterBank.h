@@ -0,0 +1,75 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file FilterBank.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <QMutex>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace xma
+{
+	/// Zero-phase Butterworth low pass filtering of several channels at once.
+	/// Filter coefficients and initial conditions are designed once per (order, cutoff, recording frequency)
+	/// and cached, so that filtering many markers or rigid bodies does not redesign the filter for every segment.
+	/// The bank is thread-safe and can be used from several worker threads in parallel.
+	class FilterBank
+	{
+	public:
+		static FilterBank* getInstance();
+		virtual ~FilterBank();
+
+		/// Number of samples reflected at each end of a segment. Segments need to be longer than this.
+		static int getPaddingLength(int order)
+		{
+			return 3 * order;
+		}
+
+		/// Forward-backward filtering of nbChannels signals of the given length. in and out are stored
+		/// interleaved, i.e. sample i of channel c is at [i * nbChannels + c], and may point to the same data.
+		void filtfilt(int order, double cutOffFrequency, double recordingFrequency, const double* in, double* out, int length, int nbChannels);
+
+	private:
+		FilterBank();
+
+		struct Coefficients
+		{
+			std::vector<double> b;
+			std::vector<double> a;
+			std::vector<double> zi;
+		};
+
+		const Coefficients& getCoefficients(int order, double cutOffFrequency, double recordingFrequency);
+		void filterChannels(const Coefficients& coefficients, double* data, double* state, double* input, int length, int nbChannels, bool backward);
+
+		std::map<std::tuple<int, double, double>, Coefficients> coefficientCache;
+		QMutex mutex;
+	};
+}
+#endif // FILTERBANK_H
@@ -0,0 +1,88 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Import2DPoints.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/Import2DPoints.h" 
+
+#include "core/Trial.h"
+
+#include <QCoreApplication>
+
+using namespace xma;
+
+Import2DPoints::Import2DPoints(Trial* trial, QStringList filenames, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, bool statusSet) : ThreadedProcessing(),
+	m_trial(trial), m_filenames(filenames), m_distorted(distorted), m_offset1(offset1), m_yinvert(yinvert), m_headerRow(headerRow), m_offsetCols(offsetCols), m_statusSet(statusSet)
+{
+}
+
+Import2DPoints::~Import2DPoints()
+{
+}
+
+void Import2DPoints::process()
+{
+	//parsing and setting the points are each reported as half of the progress
+	int nbFiles = m_filenames.size();
+	m_points.resize(nbFiles);
+	for (int i = 0; i < nbFiles; i++)
+	{
+		m_trial->parse2dPoints(m_filenames.at(i), m_distorted, m_offset1, m_yinvert, m_headerRow, m_offsetCols, m_points[i],
+			[this, i, nbFiles](double progress)
+		{
+			emit signal_progress(50.0 * (i + progress) / nbFiles);
+		});
+	}
+
+	//the marker store is reallocated while the markers are created, which must not happen while the gui draws
+	QMetaObject::invokeMethod(QCoreApplication::instance(), [this]()
+	{
+		for (unsigned int i = 0; i < m_points.size(); i++)
+		{
+			m_markers.push_back(m_trial->create2dPointMarkers(m_points[i]));
+		}
+	}, Qt::BlockingQueuedConnection);
+
+	for (int i = 0; i < nbFiles; i++)
+	{
+		m_trial->set2dPoints(m_points[i], m_markers[i], m_statusSet, [this, i, nbFiles](double progress)
+		{
+			emit signal_progress(50.0 + 50.0 * (i + progress) / nbFiles);
+		});
+	}
+}
+
+void Import2DPoints::process_finished()
+{
+	for (unsigned int i = 0; i < m_markers.size(); i++)
+	{
+		m_trial->addMarkers(m_markers[i]);
+	}
+	m_markers.clear();
+	m_points.clear();
+}
@@ -0,0 +1,70 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file Import2DPoints.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef IMPORT2DPOINTS_H
+#define IMPORT2DPOINTS_H
+
+#include "processing/ThreadedProcessing.h"
+
+#include <QStringList>
+#include <vector>
+
+namespace xma
+{
+	class Trial;
+	class Marker;
+	struct Parsed2DPoints;
+
+	class Import2DPoints : public ThreadedProcessing
+	{
+		Q_OBJECT;
+
+	public:
+		Import2DPoints(Trial* trial, QStringList filenames, bool distorted, bool offset1, bool yinvert, bool headerRow, bool offsetCols, bool statusSet);
+		virtual ~Import2DPoints();
+
+		signals:
+		void signal_progress(double progress);
+
+	protected:
+		void process() override;
+		void process_finished() override;
+
+	private:
+		Trial* m_trial;
+		QStringList m_filenames;
+		bool m_distorted;
+		bool m_offset1;
+		bool m_yinvert;
+		bool m_headerRow;
+		bool m_offsetCols;
+		bool m_statusSet;
+
+		std::vector<Parsed2DPoints> m_points;
+		std::vector<std::vector<Marker*> > m_markers;
+	};
+}
+#endif // IMPORT2DPOINTS_H
@@ -0,0 +1,147 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file LinearAssignment.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/LinearAssignment.h"
+
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace xma;
+
+double LinearAssignment::solve(const cv::Mat& cost, std::vector<int>& assignment, double maxCost)
+{
+	assignment.assign(cost.rows, -1);
+	if (cost.rows == 0 || cost.cols == 0)
+		return 0;
+
+	//the algorithm needs at least as many columns as rows
+	bool transposed = cost.rows > cost.cols;
+	cv::Mat a = transposed ? cost.t() : cost.clone();
+	int n = a.rows;
+	int m = a.cols;
+
+	//forbidden pairs get a cost larger than any complete assignment of allowed pairs,
+	//so the number of forbidden pairs is minimized first and they are dropped afterwards
+	double maxAllowed = 0;
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < m; j++)
+		{
+			double c = a.at<double>(i, j);
+			if (std::isfinite(c) && c <= maxCost)
+				maxAllowed = std::max(maxAllowed, c);
+		}
+	}
+	double forbidden = (maxAllowed + 1.0) * (n + 1);
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < m; j++)
+		{
+			double& c = a.at<double>(i, j);
+			if (!std::isfinite(c) || c > maxCost)
+				c = forbidden;
+		}
+	}
+
+	//potentials u, v and the row p[j] assigned to column j, all 1-based with 0 as virtual row/column
+	const double inf = std::numeric_limits<double>::max();
+	std::vector<double> u(n + 1, 0), v(m + 1, 0), minv(m + 1);
+	std::vector<int> p(m + 1, 0), way(m + 1, 0);
+	std::vector<char> used(m + 1);
+
+	for (int i = 1; i <= n; i++)
+	{
+		p[0] = i;
+		int j0 = 0;
+		std::fill(minv.begin(), minv.end(), inf);
+		std::fill(used.begin(), used.end(), 0);
+		do
+		{
+			used[j0] = 1;
+			int i0 = p[j0];
+			int j1 = 0;
+			double delta = inf;
+			const double* row = a.ptr<double>(i0 - 1);
+			for (int j = 1; j <= m; j++)
+			{
+				if (used[j])
+					continue;
+				double cur = row[j - 1] - u[i0] - v[j];
+				if (cur < minv[j])
+				{
+					minv[j] = cur;
+					way[j] = j0;
+				}
+				if (minv[j] < delta)
+				{
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+			for (int j = 0; j <= m; j++)
+			{
+				if (used[j])
+				{
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else
+				{
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		}
+		while (p[j0] != 0);
+
+		do
+		{
+			int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		}
+		while (j0);
+	}
+
+	double total = 0;
+	for (int j = 1; j <= m; j++)
+	{
+		if (p[j] == 0 || a.at<double>(p[j] - 1, j - 1) >= forbidden)
+			continue;
+
+		total += a.at<double>(p[j] - 1, j - 1);
+		if (transposed)
+			assignment[j - 1] = p[j] - 1;
+		else
+			assignment[p[j] - 1] = j - 1;
+	}
+	return total;
+}
@@ -0,0 +1,46 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file LinearAssignment.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef LINEARASSIGNMENT_H
+#define LINEARASSIGNMENT_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace xma
+{
+	/// Minimum cost assignment of the rows to the columns of a rectangular cost matrix solved
+	/// with the Hungarian method in O(n^2 m). Entries above maxCost are not allowed, rows which
+	/// can not be assigned get -1.
+	class LinearAssignment
+	{
+	public:
+		//cost is a CV_64F matrix, returns the total cost of the assigned pairs
+		static double solve(const cv::Mat& cost, std::vector<int>& assignment, double maxCost);
+	};
+}
+
+#endif // LINEARASSIGNMENT_H
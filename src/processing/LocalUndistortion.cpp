@@ -52,7 +52,6 @@ int LocalUndistortion::nbInstances = 0;
 LocalUndistortion::LocalUndistortion(int camera): QObject()
 {
 	m_camera = camera;
-	nbInstances++;
 }
 
 LocalUndistortion::~LocalUndistortion()
@@ -61,6 +60,7 @@ LocalUndistortion::~LocalUndistortion()
 
 void LocalUndistortion::computeUndistortion(bool recompute)
 {
+	nbInstances++;
 	hasReferences = recompute;
 
 	if (hasReferences)
@@ -75,7 +75,34 @@ void LocalUndistortion::computeUndistortion(bool recompute)
 	ProgressDialog::getInstance()->showProgressbar(0, 0, "Local Undistortion");
 }
 
+void LocalUndistortion::computeUndistortionBlocking(int camera, bool recompute)
+{
+	LocalUndistortion localUndistortion(camera);
+	localUndistortion.hasReferences = recompute;
+
+	if (localUndistortion.hasReferences)
+		Project::getInstance()->getCameras()[camera]->getUndistortionObject()->getGridPoints(localUndistortion.tmpPoints_distorted, localUndistortion.tmpPoints_references, localUndistortion.tmpPoints_inlier);
+
+	localUndistortion.localUndistortion_thread();
+	localUndistortion.releaseData();
+}
+
 void LocalUndistortion::localUndistortion_threadFinished()
+{
+	releaseData();
+
+	delete m_FutureWatcher;
+	nbInstances--;
+	if (nbInstances == 0)
+	{
+		ProgressDialog::getInstance()->closeProgressbar();
+		MainWindow::getInstance()->redrawGL();
+		emit localUndistortion_finished();
+	}
+	delete this;
+}
+
+void LocalUndistortion::releaseData()
 {
 	detectedPoints.clear();
 	tmpPoints_distorted.clear();
@@ -92,16 +119,6 @@ void LocalUndistortion::localUndistortion_threadFinished()
 	A_inverse.release();
 	B_inverse.release();
 	radii_inverse.release();
-
-	delete m_FutureWatcher;
-	nbInstances--;
-	if (nbInstances == 0)
-	{
-		ProgressDialog::getInstance()->closeProgressbar();
-		MainWindow::getInstance()->redrawGL();
-		emit localUndistortion_finished();
-	}
-	delete this;
 }
 
 void LocalUndistortion::localUndistortion_thread()
@@ -136,18 +153,20 @@ void LocalUndistortion::setupCorrespondances()
 	tmpPoints_references.clear();
 	tmpPoints_inlier.clear();
 
+	detectedIndex.build(detectedPoints);
+
 	std::vector<cv::Point2d> center;
 	if (Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->isCenterSet())
 	{
-		findNClosestPoint(1, Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getCenter(), center, detectedPoints, false);
+		findNClosestPoint(1, Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getCenter(), center, detectedIndex, false);
 	}
 	else
 	{
 		cv::Point2d imageCenter(0.5 * Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getWidth(), 0.5 * Project::getInstance()->getCameras()[m_camera]->getUndistortionObject()->getHeight());
-		findNClosestPoint(1, imageCenter, center, detectedPoints, false);
+		findNClosestPoint(1, imageCenter, center, detectedIndex, false);
 	}
 
-	double orient = getHexagonalGridOrientation(center[0], detectedPoints) / 180 * M_PI;
+	double orient = getHexagonalGridOrientation(center[0], detectedIndex) / 180 * M_PI;
 
 	double dY = getHexagonalGridSize(center[0]);
 
@@ -170,6 +189,7 @@ void LocalUndistortion::setupCorrespondances()
 		detectedPoints[i].x += center[0].x; //translate center to cp
 		detectedPoints[i].y += center[0].y;
 	}
+	detectedIndex.build(detectedPoints);
 
 	setupHexagonalGrid(center[0], dY);
 
@@ -264,6 +284,11 @@ int LocalUndistortion::computeLWM(cv::Mat& detectedPts, cv::Mat& controlPts, cv:
 
 	double maxRadius = 0;
 
+	//spatial index for the neighbour queries of all control points
+	NearestNeighbourIndex index;
+	index.build(controlPts);
+	nbNeighbours = (std::min)(nbNeighbours, index.size());
+
 	// Parallelize the control point loop
 	cv::parallel_for_(cv::Range(0, controlPts.rows), [&](const cv::Range& range)
 	{
@@ -271,46 +296,24 @@ int LocalUndistortion::computeLWM(cv::Mat& detectedPts, cv::Mat& controlPts, cv:
 		cv::Mat X(6, nbNeighbours, CV_64F);
 		cv::Mat ucp(1, nbNeighbours, CV_64F);
 		cv::Mat vcp(1, nbNeighbours, CV_64F);
-		cv::Mat tmpXY(controlPts.size(), CV_64FC2);
-		std::vector<cv::Mat> tmpXY_splitted(2);
 		cv::Mat X_inv;
-		cv::Mat all_pts_Matx2(controlPts.rows, 1, CV_64F);
-		cv::Mat all_pts_Maty2(controlPts.rows, 1, CV_64F);
-		cv::Mat all_pts_Matx2y2(controlPts.rows, 1, CV_64F);
-		cv::Mat all_pts_MatEuclideanDistance(controlPts.rows, 1, CV_64F);
-		cv::Mat all_pts_Idx(controlPts.rows, 1, CV_32S);
+		std::vector<int> neighbours;
+		std::vector<double> distances;
 
 		for (int i = range.start; i < range.end; i++)
 		{
-			//find closest point
-			{
-				//substract pt
-				const double curr_x = controlPts.at<double>(i, 0);
-				const double curr_y = controlPts.at<double>(i, 1);
-				tmpXY = controlPts - cv::Scalar(curr_x, curr_y);
-
-				//split channels to 2 matrices
-				cv::split(tmpXY, tmpXY_splitted);
-				
-				//compute norm of rows - optimized
-				cv::multiply(tmpXY_splitted[0], tmpXY_splitted[0], all_pts_Matx2);
-				cv::multiply(tmpXY_splitted[1], tmpXY_splitted[1], all_pts_Maty2);
-				cv::add(all_pts_Matx2, all_pts_Maty2, all_pts_Matx2y2);
-				cv::sqrt(all_pts_Matx2y2, all_pts_MatEuclideanDistance);
-
-				//sortIndices to find closest
-				cv::sortIdx(all_pts_MatEuclideanDistance, all_pts_Idx, cv::SORT_EVERY_COLUMN + cv::SORT_ASCENDING);
-			}
-			
+			//find closest points
+			index.knn(index.getPoint(i), nbNeighbours, neighbours, &distances);
+
 			//set radius of influence
-			const double current_radius = all_pts_MatEuclideanDistance.at<double>(all_pts_Idx.at<int>(nbNeighbours - 1));
+			const double current_radius = distances[nbNeighbours - 1];
 			radii.at<double>(i) = current_radius;
 			
 			//set up matrix eqn for polynomial of order=2
 			//set ucp,vcp and X
 			for (int j = 0; j < nbNeighbours; j++)
 			{
-				const int idx = all_pts_Idx.at<int>(j);
+				const int idx = neighbours[j];
 				const double xcp = controlPts.at<double>(idx, 0);
 				const double ycp = controlPts.at<double>(idx, 1);
 
@@ -518,55 +521,17 @@ void LocalUndistortion::createLookupTable(cv::Mat& controlPts, cv::Mat& A, cv::M
 	grid_pts.clear();
 }
 
-bool LocalUndistortion::findNClosestPoint(int numberPoints, cv::Point2d pt, std::vector<cv::Point2d>& closest_pts, std::vector<cv::Point2d> all_pts, bool skipfirst)
+bool LocalUndistortion::findNClosestPoint(int numberPoints, cv::Point2d pt, std::vector<cv::Point2d>& closest_pts, const NearestNeighbourIndex& index, bool skipfirst)
 {
-	// Check if input vector is empty (fixes OpenCV 4.11.0 compatibility)
-	if (all_pts.empty()) {
-		closest_pts.clear();
-		return false;
-	}
-	
-	cv::Mat all_pts_Mat(all_pts, true);
-	//substract pt
-	all_pts_Mat = all_pts_Mat - cv::Scalar(pt.x, pt.y);
-
-	//split channels to 2 matrices
-	std::vector<cv::Mat> all_pts_Matsplitted;
-	cv::split(all_pts_Mat, all_pts_Matsplitted);
-
-	//compute norm of rows
-	cv::Mat all_pts_Matx2;
-	cv::Mat all_pts_Maty2;
-	cv::Mat all_pts_Matx2y2;
-	cv::Mat all_pts_MatEuclideanDistance;	cv::multiply(all_pts_Matsplitted.at(0), all_pts_Matsplitted.at(0), all_pts_Matx2);
-	cv::multiply(all_pts_Matsplitted.at(1), all_pts_Matsplitted.at(1), all_pts_Maty2);
-	cv::add(all_pts_Matx2, all_pts_Maty2, all_pts_Matx2y2);
-	cv::sqrt(all_pts_Matx2y2, all_pts_MatEuclideanDistance);
-
-	//sort by lowest Distance
-	cv::Mat all_pts_Idx;
-	cv::sortIdx(all_pts_MatEuclideanDistance, all_pts_Idx, cv::SORT_EVERY_COLUMN + cv::SORT_ASCENDING);
-
 	closest_pts.clear();
 
-	for (int j = (skipfirst ? 1 : 0); j < (skipfirst ? (numberPoints + 1) : numberPoints); j++)
-	{
-		closest_pts.push_back(all_pts[all_pts_Idx.at<int>(j)]);
-	}
+	std::vector<int> closest_idx;
+	index.knn(pt, skipfirst ? numberPoints + 1 : numberPoints, closest_idx);
 
-	//cleanUp
-	all_pts_Mat.release();
-	for (unsigned int j = 0; j < all_pts_Matsplitted.size(); j++)
+	for (unsigned int j = (skipfirst ? 1 : 0); j < closest_idx.size(); j++)
 	{
-		all_pts_Matsplitted.at(0).release();
+		closest_pts.push_back(index.getPoint(closest_idx[j]));
 	}
-	all_pts_Matsplitted.clear();
-
-	all_pts_Matx2.release();
-	all_pts_Maty2.release();
-	all_pts_Matx2y2.release();
-	all_pts_MatEuclideanDistance.release();
-	all_pts_Idx.release();
 
 	return closest_pts.size() > 0;
 }
@@ -574,7 +539,7 @@ bool LocalUndistortion::findNClosestPoint(int numberPoints, cv::Point2d pt, std:
 double LocalUndistortion::getHexagonalGridSize(cv::Point2d center)
 {
 	//set the cell center to center distance
-	std::vector<cv::Point2d> neigh = get6adjCells(center, detectedPoints);
+	std::vector<cv::Point2d> neigh = get6adjCells(center, detectedIndex);
 	double dY = 0;
 	for (unsigned int j = 0; j < neigh.size(); j++)
 	{
@@ -585,10 +550,10 @@ double LocalUndistortion::getHexagonalGridSize(cv::Point2d center)
 	return dY;
 }
 
-double LocalUndistortion::getHexagonalGridOrientation(cv::Point2d center, std::vector<cv::Point2d> all_pts)
+double LocalUndistortion::getHexagonalGridOrientation(cv::Point2d center, const NearestNeighbourIndex& index)
 {
 	std::vector<cv::Point2d> closestToCenter;
-	findNClosestPoint(6, center, closestToCenter, all_pts, true);
+	findNClosestPoint(6, center, closestToCenter, index, true);
 
 	cv::Mat angles = cv::Mat::zeros(1, 6,CV_64F);
 	cv::Mat perfectlyPlacedGrid = cv::Mat::zeros(1, 6,CV_64F);
@@ -637,12 +602,11 @@ double LocalUndistortion::getHexagonalGridOrientation(cv::Point2d center, std::v
 	return gridOrient.val[0];
 }
 
-std::vector<cv::Point2d> LocalUndistortion::get6adjCells(cv::Point2d center, std::vector<cv::Point2d> all_pts)
+std::vector<cv::Point2d> LocalUndistortion::get6adjCells(cv::Point2d center, const NearestNeighbourIndex& index)
 {
 	//returns the 6 closest cells to cp
-	//[note: dist is for all centroids, not just neighborhood of cp.]
 	std::vector<cv::Point2d> closestToCenter;
-	findNClosestPoint(6, center, closestToCenter, all_pts, true);
+	findNClosestPoint(6, center, closestToCenter, index, true);
 
 	cv::Mat angles = cv::Mat::zeros(1, 6,CV_64F);
 	std::vector<cv::Point2d> sixN;
@@ -688,29 +652,26 @@ std::vector<cv::Point2d> LocalUndistortion::get6adjCells(cv::Point2d center, std
 	return sixN;
 }
 
-bool LocalUndistortion::contains(cv::Point2d centercont, std::vector<cv::Point2d>& pts)
+bool LocalUndistortion::contains(cv::Point2d centercont, const std::set<std::pair<double, double> >& pts)
 {
-	for (auto pt : pts)
-	{
-		if (pt == centercont) return true;
-	}
-
-	return false;
+	return pts.find(std::make_pair(centercont.x, centercont.y)) != pts.end();
 }
 
 void LocalUndistortion::checkAndAddPoint(cv::Point2d centerdet, cv::Point2d ptA1cont, cv::Point2d ptA1det, double thresh, std::vector<double>& dy_vec, bool & newPoint)
 {
 	std::vector<cv::Point2d> ptB1det;
-	if (findNClosestPoint(1, ptA1det, ptB1det, detectedPoints, false) &&
+	if (findNClosestPoint(1, ptA1det, ptB1det, detectedIndex, false) &&
 		//Control point not yet present
-		!contains(ptA1cont, tmpPoints_references) &&
+		!contains(ptA1cont, referencesSet) &&
 		//Detected point not yet present
-		!contains(ptB1det[0], tmpPoints_distorted) &&
+		!contains(ptB1det[0], distortedSet) &&
 		//detected point close to expected one
 		(sqrt((ptA1det.x - ptB1det[0].x) * (ptA1det.x - ptB1det[0].x) + (ptA1det.y - ptB1det[0].y) * (ptA1det.y - ptB1det[0].y)) < thresh))
 	{
 		tmpPoints_references.push_back(cv::Point2d(ptA1cont.x, ptA1cont.y));
 		tmpPoints_distorted.push_back(cv::Point2d(ptB1det[0].x, ptB1det[0].y));
+		referencesSet.insert(std::make_pair(ptA1cont.x, ptA1cont.y));
+		distortedSet.insert(std::make_pair(ptB1det[0].x, ptB1det[0].y));
 		dy_vec.push_back(sqrt((centerdet.x - ptB1det[0].x) * (centerdet.x - ptB1det[0].x) + (centerdet.y - ptB1det[0].y) * (centerdet.y - ptB1det[0].y)));
 		newPoint = true;
 	}
@@ -776,6 +737,11 @@ void LocalUndistortion::setupHexagonalGrid(cv::Point2d center, double dY)
 	tmpPoints_references.push_back(center);
 	dy_vec.push_back(dY);
 
+	referencesSet.clear();
+	distortedSet.clear();
+	referencesSet.insert(std::make_pair(center.x, center.y));
+	distortedSet.insert(std::make_pair(center.x, center.y));
+
 	double dX = sin(M_PI / 3.0) * dY;
 	double dOffY = 0.5 * dY;
 
@@ -784,5 +750,7 @@ void LocalUndistortion::setupHexagonalGrid(cv::Point2d center, double dY)
 		addNeighbours(tmpPoints_references[i], tmpPoints_distorted[i], dY, dX, dOffY, dy_vec[i], dy_vec);
 	}
 	dy_vec.clear();
+	referencesSet.clear();
+	distortedSet.clear();
 }
 
@@ -31,6 +31,9 @@
 #include <QObject>
 
 #include <opencv2/opencv.hpp>
+#include <set>
+
+#include "processing/NearestNeighbourIndex.h"
 
 namespace xma
 {
@@ -43,12 +46,18 @@ namespace xma
 		virtual ~LocalUndistortion();
 
 		void computeUndistortion(bool recompute = false);
+		//Computes the undistortion of the camera on the calling thread without any ui. It is not counted as running
+		//instance, so the cameras can be undistorted concurrently from worker threads.
+		static void computeUndistortionBlocking(int camera, bool recompute = false);
 
 		static bool isRunning()
 		{
 			return (nbInstances > 0);
 		}
 
+		//Computes the local weighted mean polynomials mapping the control points to the detected points. Returns the maximal radius of influence.
+		static int computeLWM(cv::Mat& detectedPointsPtsInlier, cv::Mat& controlPtsInlier, cv::Mat& A, cv::Mat& B, cv::Mat& radii);
+
 		signals:
 		void localUndistortion_finished();
 
@@ -64,6 +73,12 @@ namespace xma
 		std::vector<cv::Point2d> tmpPoints_references;
 
 		std::vector<bool> tmpPoints_inlier;
+
+		//index over detectedPoints and the points already assigned while setting up the grid
+		NearestNeighbourIndex detectedIndex;
+		std::set<std::pair<double, double> > referencesSet;
+		std::set<std::pair<double, double> > distortedSet;
+
 		cv::Mat map_x;
 		cv::Mat map_y;
 
@@ -79,19 +94,19 @@ namespace xma
 		cv::Mat controlPts_inverse;
 
 		void localUndistortion_thread();
+		void releaseData();
 		QFutureWatcher<void>* m_FutureWatcher;
 		static int nbInstances;
 
 		void setupCorrespondances();
-		int computeLWM(cv::Mat& detectedPointsPtsInlier, cv::Mat& controlPtsInlier, cv::Mat& A, cv::Mat& B, cv::Mat& radii);
 		void setPointsByInlier(std::vector<cv::Point2d>& pts, cv::Mat& ptsInlier);
 		void createLookupTable(cv::Mat& controlPts, cv::Mat& A, cv::Mat& B, cv::Mat& radii, cv::Mat& outMat_x, cv::Mat& outMat_y, int gridSize);
 
-		bool findNClosestPoint(int numberPoints, cv::Point2d pt, std::vector<cv::Point2d>& closest_pts, std::vector<cv::Point2d> all_pts, bool skipfirst);
-		double getHexagonalGridOrientation(cv::Point2d center, std::vector<cv::Point2d> all_pts);
+		bool findNClosestPoint(int numberPoints, cv::Point2d pt, std::vector<cv::Point2d>& closest_pts, const NearestNeighbourIndex& index, bool skipfirst);
+		double getHexagonalGridOrientation(cv::Point2d center, const NearestNeighbourIndex& index);
 		double getHexagonalGridSize(cv::Point2d center);
-		std::vector<cv::Point2d> get6adjCells(cv::Point2d center, std::vector<cv::Point2d> all_pts);
-		bool contains(cv::Point2d centercont, std::vector<cv::Point2d>& pts);
+		std::vector<cv::Point2d> get6adjCells(cv::Point2d center, const NearestNeighbourIndex& index);
+		bool contains(cv::Point2d centercont, const std::set<std::pair<double, double> >& pts);
 		void checkAndAddPoint(cv::Point2d centerdet, cv::Point2d ptA1cont, cv::Point2d ptA1det, double thresh, std::vector<double>& dy_vec, bool & newPoint);
 		bool addNeighbours(cv::Point2d centercont, cv::Point2d centerdet, double dY, double dX, double dOffY, double dYdist, std::vector<double>& dy_vec);
 		void setupHexagonalGrid(cv::Point2d center, double dY);
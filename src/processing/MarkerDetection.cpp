@@ -36,6 +36,7 @@
 #include "core/Image.h"
 #include "core/Trial.h"
 #include "core/Marker.h"
+#include "core/Tracer.h"
 
 #include <QtCore>
 #include <QtConcurrent/QtConcurrent>
@@ -48,6 +49,75 @@ using namespace xma;
 
 int MarkerDetection::nbInstances = 0;
 
+namespace
+{
+	const int polynomialOrder = 4;
+	const int nbPolynomialCoefficients = 15;
+
+	//index of the coefficient of x^a * y^b. The coefficients are ordered by degree: 1, x, y, x^2, xy, y^2, x^3, x^2y, ...
+	inline int polynomialIndex(int a, int b)
+	{
+		return (a + b) * (a + b + 1) / 2 + b;
+	}
+
+	//table[k * n + i] = w_i^2 * u_i^k with the scaled coordinate u_i = (offset + i) / scale and the gaussian weight w_i of the unscaled coordinate
+	void fillWeightTable(double* table, int n, double offset, double scale, double inv_radius_sq_maskmult)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			double t = offset + i;
+			double u = t / scale;
+			double w = exp(t * t * inv_radius_sq_maskmult);
+			double val = w * w;
+			for (int k = 0; k <= 2 * polynomialOrder; k++)
+			{
+				table[k * n + i] = val;
+				val *= u;
+			}
+		}
+	}
+
+	//Solves the symmetric system N p = rhs with a Cholesky decomposition, returns false if N is not positive definite
+	bool solveCholesky(const double N[nbPolynomialCoefficients][nbPolynomialCoefficients], const double rhs[nbPolynomialCoefficients], double p[nbPolynomialCoefficients])
+	{
+		const int n = nbPolynomialCoefficients;
+		double L[nbPolynomialCoefficients][nbPolynomialCoefficients];
+		for (int j = 0; j < n; j++)
+		{
+			double sum = N[j][j];
+			for (int k = 0; k < j; k++)
+				sum -= L[j][k] * L[j][k];
+			if (!(sum > 0))
+				return false;
+			L[j][j] = sqrt(sum);
+
+			for (int i = j + 1; i < n; i++)
+			{
+				sum = N[i][j];
+				for (int k = 0; k < j; k++)
+					sum -= L[i][k] * L[j][k];
+				L[i][j] = sum / L[j][j];
+			}
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			double sum = rhs[i];
+			for (int k = 0; k < i; k++)
+				sum -= L[i][k] * p[k];
+			p[i] = sum / L[i][i];
+		}
+		for (int i = n - 1; i >= 0; i--)
+		{
+			double sum = p[i];
+			for (int k = i + 1; k < n; k++)
+				sum -= L[k][i] * p[k];
+			p[i] = sum / L[i][i];
+		}
+		return true;
+	}
+}
+
 #ifndef sign
 #define sign(a) ((a>=0)?1:(-1))
 #endif
@@ -70,6 +140,9 @@ MarkerDetection::MarkerDetection(int camera, int trial, int frame, int marker, d
 	m_x = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getPoints2D()[m_camera][m_frame].x;
 	m_y = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getPoints2D()[m_camera][m_frame].y;
 	m_searchArea = (int)(searcharea + 0.5);
+	m_gate_x = m_gate_y = 0;
+	m_gateRadius = -1;
+	m_bandWidth = Settings::getInstance()->getIntSetting("TrackingEpipolarBandWidth");
 
 	if (m_method == 1 || m_method == 6)
 	{
@@ -81,6 +154,22 @@ MarkerDetection::MarkerDetection(int camera, int trial, int frame, int marker, d
 		               (Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getSize() > 0) ? Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getSize() : 5;
 
 	m_thresholdOffset = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getThresholdOffset();
+
+	//after tracking the marker has to lie in the gate of the motion prediction, so the search area only has to cover the gate
+	if (m_refinementAfterTracking)
+	{
+		Marker* marker = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker];
+		double x, y, radius;
+		if (marker->getMarkerPrediction(m_camera, m_frame, x, y, true, &radius) != 2 || radius <= 0)
+			marker->getMarkerPrediction(m_camera, m_frame, x, y, false, &radius);
+
+		if (radius > 0)
+		{
+			int gate = (int)(sqrt((x - m_x) * (x - m_x) + (y - m_y) * (y - m_y)) + radius + 0.5 * m_input_size + 0.5);
+			int minimum = (m_method == 1 || m_method == 6) ? 50 : 10;
+			m_searchArea = std::max(minimum, (std::min)(m_searchArea, gate));
+		}
+	}
 #ifdef WRITEIMAGES
 	//fprintf(stderr, "Start Marker Detection : Camera %d Pos %lf %lf Size %lf\n", m_camera, cerx, y, m_input_size);
 #endif
@@ -90,6 +179,28 @@ MarkerDetection::~MarkerDetection()
 {
 }
 
+int MarkerDetection::getCamera()
+{
+	return m_camera;
+}
+
+void MarkerDetection::setEpipolarReference(int camera)
+{
+	Marker* marker = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker];
+	if (camera != m_camera && marker->getStatus2D()[camera][m_frame] > UNDEFINED)
+		m_epiline = marker->getEpipolarLine(camera, m_camera, m_frame);
+}
+
+void MarkerDetection::setPredictionGate(double x, double y, double radius)
+{
+	m_x = m_gate_x = x;
+	m_y = m_gate_y = y;
+	m_gateRadius = radius;
+
+	int minimum = (m_method == 1 || m_method == 6) ? 50 : 10;
+	m_searchArea = std::max(minimum, (int)(radius + 0.5 * m_input_size + 0.5));
+}
+
 void MarkerDetection::detectMarker()
 {
 	m_FutureWatcher = new QFutureWatcher<void>();
@@ -99,8 +210,11 @@ void MarkerDetection::detectMarker()
 	m_FutureWatcher->setFuture(future);
 }
 
-cv::Point2d MarkerDetection::detectionPoint(Image* image, int method, cv::Point2d center, int searchArea, int masksize, double threshold, double* size, std::vector <cv::Mat> * images, bool drawCrosshairs)
+cv::Point2d MarkerDetection::detectionPoint(Image* image, int method, cv::Point2d center, int searchArea, int masksize, double threshold, double* size, std::vector <cv::Mat> * images, bool drawCrosshairs,
+	const std::vector<cv::Point2d>* epiline, double bandWidth)
 {
+	bool constrained = epiline != NULL && !epiline->empty();
+
 	if (images != NULL) images->clear();
 
 	cv::Point2d point_out(center.x, center.y);
@@ -234,6 +348,9 @@ cv::Point2d MarkerDetection::detectionPoint(Image* image, int method, cv::Point2
 				cv::minEnclosingCircle(contours[i], detected_center, circle_radius);
 			}
 
+			if (constrained && cv::norm(Marker::getClosestPointOnEpipolarLine(*epiline, detected_center) - cv::Point2d(detected_center)) > 0.5 * bandWidth)
+				continue;
+
 			double distTmp = sqrt((center.x - detected_center.x) * (center.x - detected_center.x) + (center.y - detected_center.y) * (center.y - detected_center.y));
 			if (distTmp < dist)
 			{
@@ -380,6 +497,9 @@ cv::Point2d MarkerDetection::detectionPoint(Image* image, int method, cv::Point2
 			double dx = keypoints[i].pt.x - search_center;
 			double dy = keypoints[i].pt.y - search_center;
 			dist_sq = dx * dx + dy * dy;
+			if (constrained && cv::norm(Marker::getClosestPointOnEpipolarLine(*epiline, cv::Point2d(off_x + keypoints[i].pt.x, off_y + keypoints[i].pt.y))
+				- cv::Point2d(off_x + keypoints[i].pt.x, off_y + keypoints[i].pt.y)) > 0.5 * bandWidth)
+				continue;
 			if (dist_sq < dist_min_sq)
 			{
 				point_out.x = off_x + keypoints[i].pt.x;
@@ -403,9 +523,10 @@ cv::Point2d MarkerDetection::detectionPoint(Image* image, int method, cv::Point2
 
 void MarkerDetection::detectMarker_thread()
 {
+	XMA_TRACE_SCOPE("MarkerDetection");
 	if (m_method == 4) return;
 
-	cv::Point2d pt = detectionPoint(Project::getInstance()->getTrials()[m_trial]->getVideoStreams()[m_camera]->getImage(), m_method, cv::Point2d(m_x, m_y), m_searchArea, m_input_size, m_thresholdOffset, &m_size);
+	cv::Point2d pt = detectionPoint(Project::getInstance()->getTrials()[m_trial]->getVideoStreams()[m_camera]->getImage(), m_method, cv::Point2d(m_x, m_y), m_searchArea, m_input_size, m_thresholdOffset, &m_size, NULL, false, &m_epiline, m_bandWidth);
 
 	m_x = pt.x;
 	m_y = pt.y;
@@ -413,8 +534,13 @@ void MarkerDetection::detectMarker_thread()
 
 void MarkerDetection::detectMarker_threadFinished()
 {
-	Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->setSize(m_camera, m_frame, m_size);
-	Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->setPoint(m_camera, m_frame, m_x, m_y, m_refinementAfterTracking ? TRACKED : SET);
+	//without a detection the point stays at the prediction
+	double dist = sqrt((m_x - m_gate_x) * (m_x - m_gate_x) + (m_y - m_gate_y) * (m_y - m_gate_y));
+	if (m_gateRadius < 0 || (m_method != 4 && dist > 0 && dist <= m_gateRadius))
+	{
+		Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->setSize(m_camera, m_frame, m_size);
+		Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->setPoint(m_camera, m_frame, m_x, m_y, m_refinementAfterTracking ? TRACKED : SET);
+	}
 
 	delete m_FutureWatcher;
 	nbInstances--;
@@ -450,6 +576,10 @@ bool MarkerDetection::refinePointPolynomialFit(cv::Point2d& pt, double& radius_o
 	int refinementcount = 0;
 	double maxrefinements = limmult * radius / improverthresh; //if it takes more than maxrefinements to find centre correction, then move on
 
+	//weight tables of the columns and rows, reused by all refinement cycles
+	std::vector<double> tableX;
+	std::vector<double> tableY;
+
 	while (stillgood && (doextracycles > 0))
 	{
 		refinementcount = refinementcount + 1;
@@ -473,104 +603,107 @@ bool MarkerDetection::refinePointPolynomialFit(cv::Point2d& pt, double& radius_o
 			return false;
 		}
 
-		cv::Mat A;
-		A.create(subimage.cols * subimage.rows, 15, CV_64F);
-		cv::Mat B;
-		B.create(subimage.cols * subimage.rows, 1, CV_64F);
-		cv::Mat p;
-		p.create(15, 1, CV_64F);
-		int count = 0;
-		double tmpx, tmpy, tmpw;
+		//weighted least squares fit of a 4th order polynomial with the gaussian weights w(x,y) = wx(x) * wy(y). The
+		//weights are separable, so the normal equations are products of one dimensional moments of the tables and only
+		//the right hand side needs a pass over the pixels. The coordinates are scaled by w to keep the system well conditioned.
+		double scale = (w > 1) ? w : 1.0;
 		double inv_radius_sq_maskmult = -1.0 / (radius * radius * maskmult);
-		
-		// Use direct pointer access for better performance
-		double* A_ptr = A.ptr<double>();
-		double* B_ptr = B.ptr<double>();
-		const uchar* subimage_ptr = subimage.ptr<uchar>();
-		
-		for (int j = 0; j < subimage.cols; j++)
+		tableX.resize((2 * polynomialOrder + 1) * subimage.cols);
+		tableY.resize((2 * polynomialOrder + 1) * subimage.rows);
+		fillWeightTable(tableX.data(), subimage.cols, off_x - x, scale, inv_radius_sq_maskmult);
+		fillWeightTable(tableY.data(), subimage.rows, off_y - y, scale, inv_radius_sq_maskmult);
+
+		double momentX[2 * polynomialOrder + 1];
+		double momentY[2 * polynomialOrder + 1];
+		for (int k = 0; k <= 2 * polynomialOrder; k++)
 		{
+			momentX[k] = 0;
+			for (int j = 0; j < subimage.cols; j++)
+				momentX[k] += tableX[k * subimage.cols + j];
+			momentY[k] = 0;
 			for (int i = 0; i < subimage.rows; i++)
+				momentY[k] += tableY[k * subimage.rows + i];
+		}
+
+		double N[nbPolynomialCoefficients][nbPolynomialCoefficients];
+		for (int d1 = 0; d1 <= polynomialOrder; d1++)
+		{
+			for (int b1 = 0; b1 <= d1; b1++)
 			{
-				tmpx = off_x - x + j;
-				tmpy = off_y - y + i;
-				tmpw = exp((tmpx * tmpx + tmpy * tmpy) * inv_radius_sq_maskmult);
-				if (darkMarker)
+				for (int d2 = 0; d2 <= polynomialOrder; d2++)
 				{
-					B_ptr[count] = tmpw * (255 - subimage_ptr[i * subimage.cols + j]);
+					for (int b2 = 0; b2 <= d2; b2++)
+					{
+						N[polynomialIndex(d1 - b1, b1)][polynomialIndex(d2 - b2, b2)] = momentX[d1 - b1 + d2 - b2] * momentY[b1 + b2];
+					}
 				}
-				else
+			}
+		}
+
+		double rhs[nbPolynomialCoefficients] = {};
+		const uchar* subimage_ptr = subimage.ptr<uchar>();
+		for (int i = 0; i < subimage.rows; i++)
+		{
+			double rowSum[polynomialOrder + 1] = {};
+			const uchar* row = subimage_ptr + i * subimage.cols;
+			for (int j = 0; j < subimage.cols; j++)
+			{
+				double value = darkMarker ? 255 - row[j] : row[j];
+				for (int k = 0; k <= polynomialOrder; k++)
 				{
-					B_ptr[count] = tmpw * subimage_ptr[i * subimage.cols + j];
+					rowSum[k] += tableX[k * subimage.cols + j] * value;
 				}
-				A_ptr[count * 15] = tmpw;
-				int ocol = 1;
-				for (int order = 1; order <= 4; order++)
+			}
+			for (int d = 0; d <= polynomialOrder; d++)
+			{
+				for (int b = 0; b <= d; b++)
 				{
-					for (int ocol2 = ocol; ocol2 < ocol + order; ocol2++)
-					{
-						//std::cerr  << ocol2 << ": Add X to " << ocol2 - order << std::endl;
-						A_ptr[count * 15 + ocol2] = tmpx * A_ptr[count * 15 + ocol2 - order];
-					}
-					ocol = ocol + order;
-					//std::cerr << ocol << ": Add Y to " << ocol - order - 1 << std::endl;
-					A_ptr[count * 15 + ocol] = tmpy * A_ptr[count * 15 + ocol - order - 1];
-					ocol++;
+					rhs[polynomialIndex(d - b, b)] += tableY[b * subimage.rows + i] * rowSum[d - b];
 				}
-				count++;
 			}
 		}
 
-		cv::solve(A, B, p, cv::DECOMP_QR);
-		cv::Mat quadric;
-		quadric.create(subimage.size(), CV_64F);
+		double p[nbPolynomialCoefficients];
+		if (!solveCholesky(N, rhs, p))
+		{
+			//degenerate window, fall back to the least squares solution of the normal equations
+			cv::Mat p_mat(nbPolynomialCoefficients, 1, CV_64F, p);
+			cv::solve(cv::Mat(nbPolynomialCoefficients, nbPolynomialCoefficients, CV_64F, N), cv::Mat(nbPolynomialCoefficients, 1, CV_64F, rhs), p_mat, cv::DECOMP_SVD);
+		}
 
-		double val[6];
-		double val2;
-		
-		// Cache parameter values for faster access
-		double p0 = p.at<double>(0, 0);
-		double p1 = p.at<double>(1, 0);
-		double p2 = p.at<double>(2, 0);
-		double p3 = p.at<double>(3, 0);
-		double p4 = p.at<double>(4, 0);
-		double p5 = p.at<double>(5, 0);
-		
-		// Use direct pointer access for better performance
-		double* quadric_ptr = quadric.ptr<double>();
-		
-		for (int j = 0; j < subimage.cols; j++)
+		//coefficients of the unscaled coordinates
+		double scale_d = 1.0;
+		for (int d = 0; d <= polynomialOrder; d++)
 		{
-			for (int i = 0; i < subimage.rows; i++)
+			for (int b = 0; b <= d; b++)
 			{
-				tmpx = off_x - x + j;
-				tmpy = off_y - y + i;
+				p[polynomialIndex(d - b, b)] /= scale_d;
+			}
+			scale_d *= scale;
+		}
 
-				val[0] = 1;
-				int ocol = 1;
-				for (int order = 1; order <= 2; order++)
+		//the quadric part of the polynomial is only needed for the centroid correction
+		cv::Mat quadric;
+		if (!subpixpeak)
+		{
+			quadric.create(subimage.size(), CV_64F);
+			for (int j = 0; j < subimage.cols; j++)
+			{
+				for (int i = 0; i < subimage.rows; i++)
 				{
-					for (int ocol2 = ocol; ocol2 < ocol + order; ocol2++)
-					{
-						val[ocol2] = tmpx * val[ocol2 - order];
-					}
-					ocol = ocol + order;
-					val[ocol] = tmpy * val[ocol - order - 1];
-					ocol++;
+					double tmpx = off_x - x + j;
+					double tmpy = off_y - y + i;
+					quadric.at<double>(i, j) = p[0] + p[1] * tmpx + p[2] * tmpy + p[3] * tmpx * tmpx + p[4] * tmpx * tmpy + p[5] * tmpy * tmpy;
 				}
-
-				val2 = val[0] * p0 + val[1] * p1 + val[2] * p2 + 
-				       val[3] * p3 + val[4] * p4 + val[5] * p5;
-				quadric_ptr[i * subimage.cols + j] = val2;
 			}
 		}
 
-		double a = p.at<double>(3, 0);
-		double b = p.at<double>(4, 0) / 2.0;
-		double c = p.at<double>(5, 0);
-		double d = p.at<double>(1, 0) / 2.0;
-		double f = p.at<double>(2, 0) / 2.0;
-		double g = p.at<double>(0, 0);
+		double a = p[3];
+		double b = p[4] / 2.0;
+		double c = p[5];
+		double d = p[1] / 2.0;
+		double f = p[2] / 2.0;
+		double g = p[0];
 
 		J = a * c - b * b;
 		double xc = (b * f - c * d) / J;
@@ -582,10 +715,10 @@ bool MarkerDetection::refinePointPolynomialFit(cv::Point2d& pt, double& radius_o
 		rotation = 0.5 * (M_PI / 2.0 - atan((c - a) / 2 / b) + (a - c < 0)) * M_PI / 2.0;
 		double ct = cos(rotation);
 		double st = sin(rotation);
-		double P1 = p.at<double>(10, 0) * pow(ct, 4) - p.at<double>(11, 0) * pow(ct, 3) * st + p.at<double>(12, 0) * ct * ct * st * st - p.at<double>(13, 0) * ct * pow(st, 3) + p.at<double>(14, 0) * pow(st, 4);
-		double P2 = p.at<double>(10, 0) * pow(st, 4) + p.at<double>(11, 0) * pow(st, 3) * ct + p.at<double>(12, 0) * st * st * ct * ct + p.at<double>(13, 0) * st * pow(ct, 3) + p.at<double>(14, 0) * pow(ct, 4);
-		double Q1 = p.at<double>(3, 0) * ct * ct - p.at<double>(4, 0) * ct * st + p.at<double>(5, 0) * st * st;
-		double Q2 = p.at<double>(3, 0) * st * st + p.at<double>(4, 0) * st * ct + p.at<double>(5, 0) * ct * ct;
+		double P1 = p[10] * pow(ct, 4) - p[11] * pow(ct, 3) * st + p[12] * ct * ct * st * st - p[13] * ct * pow(st, 3) + p[14] * pow(st, 4);
+		double P2 = p[10] * pow(st, 4) + p[11] * pow(st, 3) * ct + p[12] * st * st * ct * ct + p[13] * st * pow(ct, 3) + p[14] * pow(ct, 4);
+		double Q1 = p[3] * ct * ct - p[4] * ct * st + p[5] * st * st;
+		double Q2 = p[3] * st * st + p[4] * st * ct + p[5] * ct * ct;
 		radius = fabs(sqrt(sqrt(Q1 * Q2 / P1 / P2 / 36))); //geometric mean
 
 		stillgood = (refinementcount <= maxrefinements) && (J > 0); //if not still good, stop at once...
@@ -604,12 +737,13 @@ bool MarkerDetection::refinePointPolynomialFit(cv::Point2d& pt, double& radius_o
 			}
 			eccentricity = sqrt(1 - (semiaxes1 * semiaxes1) / (semiaxes2 * semiaxes2));
 
-			skewness = (fabs(p.at<double>(6, 0)) + fabs(p.at<double>(7, 0)) + fabs(p.at<double>(8, 0)) + fabs(p.at<double>(9, 0))) * radius / J;
+			skewness = (fabs(p[6]) + fabs(p[7]) + fabs(p[8]) + fabs(p[9])) * radius / J;
 
 			if (!subpixpeak)
 			{
 				//calculate sub - pixel corrections based on centroid of image within particle
 				double xedge = 2 * radius / sqrt(pow(cos(rotation), 2) + pow(sin(rotation), 2) / (1 - eccentricity * eccentricity)) / (1 + sqrt(1 - eccentricity * eccentricity));
+				double tmpx, tmpy, tmpw;
 				cv::Mat inparticle;
 				inparticle.create(quadric.size(), CV_8UC1);
 				for (int j = 0; j < quadric.cols; j++)
@@ -653,10 +787,7 @@ bool MarkerDetection::refinePointPolynomialFit(cv::Point2d& pt, double& radius_o
 			}
 		}
 
-		p.release();
-		B.release();
 		subimage.release();
-		A.release();
 	}
 
 #ifdef WRITEIMAGES
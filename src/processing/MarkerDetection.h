@@ -44,13 +44,20 @@ namespace xma
 		MarkerDetection(int camera, int trial, int frame, int marker, double searcharea = 30.0, bool refinementAfterTracking = false);
 		virtual ~MarkerDetection();
 		void detectMarker();
+		//Searches the marker around a predicted position and only accepts it inside the radius, e.g. to recover a marker after an occlusion.
+		void setPredictionGate(double x, double y, double radius);
 
 		static bool isRunning()
 		{
 			return (nbInstances > 0);
 		}
 
-		static cv::Point2d detectionPoint(Image* image, int method, cv::Point2d center, int searchArea, int masksize, double threshold = 8, double* size = NULL, std::vector <cv::Mat> * images = NULL, bool drawCrosshairs = false);
+		//Restricts the selection of the detected marker to a band along the epipolar line of the point in another camera.
+		void setEpipolarReference(int camera);
+		int getCamera();
+
+		static cv::Point2d detectionPoint(Image* image, int method, cv::Point2d center, int searchArea, int masksize, double threshold = 8, double* size = NULL, std::vector <cv::Mat> * images = NULL, bool drawCrosshairs = false,
+			const std::vector<cv::Point2d>* epiline = NULL, double bandWidth = 0);
 
 		static bool refinePointPolynomialFit(cv::Point2d& pt, double& radius, bool darkMarker, int camera, int trial);
 
@@ -77,6 +84,12 @@ namespace xma
 
 		int m_searchArea;
 		bool m_refinementAfterTracking;
+
+		double m_gate_x, m_gate_y;
+		double m_gateRadius;
+
+		std::vector<cv::Point2d> m_epiline;
+		double m_bandWidth;
 	};
 }
 #endif // MARKERDETECTION_H
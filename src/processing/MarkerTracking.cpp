@@ -34,6 +34,8 @@
 #include "core/Image.h"
 #include "core/Trial.h"
 #include "core/Marker.h"
+#include "core/Tracer.h"
+#include "core/Settings.h"
 
 #include <QtCore>
 #include <QtConcurrent/QtConcurrent>
@@ -119,6 +121,15 @@ namespace
 
 int MarkerTracking::nbInstances = 0;
 
+//lower bound of the search area if it is derived from the motion prediction
+const int MarkerTracking::minimumSearchArea = 5;
+//the coarsest level of the pyramid search is downsampled by 2^maximumPyramidLevels
+const int MarkerTracking::maximumPyramidLevels = 3;
+//smallest template which is still matched on a downsampled level
+const int MarkerTracking::minimumPyramidTemplateSize = 7;
+//number of previous frames from which the displacement of the marker is taken
+const int MarkerTracking::displacementWindow = 3;
+
 MarkerTracking::MarkerTracking(int camera, int trial, int frame_from, int frame_to, int marker, bool forward) : QObject(),
 m_camera(camera), m_trial(trial), m_frame_from(frame_from), m_frame_to(frame_to), m_marker(marker), m_forward(forward)
 {
@@ -130,9 +141,39 @@ m_camera(camera), m_trial(trial), m_frame_from(frame_from), m_frame_to(frame_to)
     size = (int)(Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getSize() + 0.5);
     size = (size < 5) ? 5 : size;
 
+    m_pyramid = Settings::getInstance()->getBoolSetting("TrackingPyramid");
+    if (m_pyramid)
+    {
+        //the window follows the largest displacement of the last frames. If the motion is unknown the maximal window is searched
+        Marker* marker = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker];
+        int nbImages = Project::getInstance()->getTrials()[m_trial]->getNbImages();
+        int dir = m_forward ? 1 : -1;
+        double displacement = -1;
+        for (int k = 0; k < displacementWindow; k++)
+        {
+            int f = m_frame_from - k * dir;
+            int g = f - dir;
+            if (f < 0 || g < 0 || f >= nbImages || g >= nbImages || marker->getStatus2D()[m_camera][f] <= 0 || marker->getStatus2D()[m_camera][g] <= 0)
+                break;
+            displacement = std::max(displacement, cv::norm(marker->getPoints2D()[m_camera][f] - marker->getPoints2D()[m_camera][g]));
+        }
+
+        int maximumSearchArea = Settings::getInstance()->getIntSetting("TrackingPyramidSearchArea");
+        searchArea = (displacement >= 0) ? (int) ceil(2.0 * displacement) + size : maximumSearchArea;
+        searchArea = std::max(minimumSearchArea, std::min(searchArea, maximumSearchArea));
+    }
+    m_chosenSearchArea = searchArea;
+    m_trackingTime = 0;
+
     Project::getInstance()->getTrials()[m_trial]->getVideoStreams()[m_camera]->getImage()->getSubImage(templ, size + 3, x_from, y_from);
     templ_umat = templ.getUMat(cv::ACCESS_READ);
     maxPenalty = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getMaxPenalty();
+
+    //the prediction uses the rigid body poses, so it is computed here and not in the thread
+    prediction = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getMarkerPrediction(m_camera, m_frame_to, x_to, y_to, m_forward, &searchRadius);
+
+    m_epipolarCamera = -1;
+    m_bandWidth = Settings::getInstance()->getIntSetting("TrackingEpipolarBandWidth");
 #ifdef WRITEIMAGES
     cv::imwrite("Tra_Template.png", templ);
     fprintf(stderr, "Start Track Marker : Camera %d Pos %lf %lf Size %d\n", camera, x_from, y_from, size);
@@ -143,8 +184,36 @@ MarkerTracking::~MarkerTracking()
 {
 }
 
+int MarkerTracking::getCamera()
+{
+    return m_camera;
+}
+
+void MarkerTracking::addEpipolarDependent(MarkerTracking* tracker)
+{
+    tracker->m_epipolarCamera = m_camera;
+    m_dependents.push_back(tracker);
+}
+
 void MarkerTracking::trackMarker()
 {
+    Marker* marker = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker];
+    if (m_epipolarCamera >= 0 && marker->getStatus2D()[m_epipolarCamera][m_frame_to] > UNDEFINED)
+    {
+        m_epiline = marker->getEpipolarLine(m_epipolarCamera, m_camera, m_frame_to);
+
+        //center the search on the epipolar line
+        if (!m_epiline.empty())
+        {
+            cv::Point2d pt = Marker::getClosestPointOnEpipolarLine(m_epiline, cv::Point2d(x_to, y_to));
+            if (cv::norm(pt - cv::Point2d(x_to, y_to)) <= searchArea)
+            {
+                x_to = pt.x;
+                y_to = pt.y;
+            }
+        }
+    }
+
     m_FutureWatcher = new QFutureWatcher<void>();
     connect(m_FutureWatcher, SIGNAL(finished()), this, SLOT(trackMarker_threadFinished()));
 
@@ -154,13 +223,84 @@ void MarkerTracking::trackMarker()
 
 void MarkerTracking::trackMarker_thread()
 {
+    XMA_TRACE_SCOPE("MarkerTracking");
     ensureOpenClInitialized();
+    QElapsedTimer timer;
+    timer.start();
+
+    if (prediction <= 1) maxPenalty /= 3;
+
+    //shrink the search window if the motion is predictable
+    if (searchRadius > 0)
+        searchArea = std::min(searchArea, std::max(minimumSearchArea, (int) ceil(searchRadius)));
+    m_chosenSearchArea = searchArea;
+
+    //a large window is searched downsampled and the match is refined at full resolution in a window covering one coarse pixel
+    int levels = m_pyramid ? getPyramidLevels() : 0;
+    if (levels > 0 && searchCoarse(levels))
+        searchArea = (1 << levels) + 2;
+
+    searchFine();
+
+    m_trackingTime = timer.nsecsElapsed() * 1e-6;
+}
+
+int MarkerTracking::getPyramidLevels()
+{
+    int levels = 0;
+    while (levels < maximumPyramidLevels && (searchArea >> (levels + 1)) >= minimumSearchArea && (templ.cols >> (levels + 1)) >= minimumPyramidTemplateSize)
+    {
+        levels++;
+    }
+    return levels;
+}
+
+bool MarkerTracking::searchCoarse(int levels)
+{
+    XMA_TRACE_SCOPE("MarkerTracking coarse");
     cv::Mat ROI_to;
     int used_size = size + searchArea + 3;
+    int off_x = (int)(x_to - used_size + 0.5);
+    int off_y = (int)(y_to - used_size + 0.5);
 
-    int prediction = Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->getMarkerPrediction(m_camera, m_frame_to, x_to, y_to, m_forward);
+    Project::getInstance()->getTrials()[m_trial]->getVideoStreams()[m_camera]->getImage()->getSubImage(ROI_to, used_size, off_x, off_y);
 
-    if (prediction <= 1) maxPenalty /= 3;
+    std::vector<cv::Mat> roiPyramid;
+    std::vector<cv::Mat> templPyramid;
+    cv::buildPyramid(ROI_to, roiPyramid, levels);
+    cv::buildPyramid(templ, templPyramid, levels);
+
+    int result_cols = roiPyramid[levels].cols - templPyramid[levels].cols + 1;
+    int result_rows = roiPyramid[levels].rows - templPyramid[levels].rows + 1;
+    if (result_cols <= 0 || result_rows <= 0)
+        return false;
+
+    cv::Mat result;
+    cv::matchTemplate(roiPyramid[levels], templPyramid[levels], result, cv::TM_CCORR_NORMED);
+    cv::normalize(result, result, 0, (100 - maxPenalty), cv::NORM_MINMAX);
+
+    cv::Mat springforce;
+    cv::multiply(getNormalizedPenaltySurface(result_rows, result_cols).mat, cv::Scalar(static_cast<float>(maxPenalty)), springforce);
+    result = result - springforce;
+
+    double maxVal;
+    cv::Point maxLoc;
+    cv::minMaxLoc(result, NULL, &maxVal, NULL, &maxLoc);
+
+    //a pixel of the downsampled result covers 2^levels pixel of the full resolution result
+    x_to = (maxLoc.x << levels) + off_x + size + 3;
+    y_to = (maxLoc.y << levels) + off_y + size + 3;
+
+#ifdef WRITEIMAGES
+    fprintf(stderr, "Coarse Track Marker : Camera %d Pos %lf %lf Levels %d Val %lf\n", m_camera, x_to, y_to, levels, maxVal);
+#endif
+    return true;
+}
+
+void MarkerTracking::searchFine()
+{
+    cv::Mat ROI_to;
+    int used_size = size + searchArea + 3;
 
 #ifdef WRITEIMAGES
     fprintf(stderr, "Prediction Track Marker : Camera %d Pos %lf %lf\n", m_camera, x_to, y_to);
@@ -185,11 +325,19 @@ void MarkerTracking::trackMarker_thread()
 
     const auto& penaltyEntry = getNormalizedPenaltySurface(result_rows, result_cols);
 
+    //only correlate the positions inside the epipolar band
+    cv::Mat bandMask;
+    cv::Rect bounds(0, 0, result_cols, result_rows);
+    bool constrained = !m_epiline.empty() && getEpipolarBand(off_x, off_y, result_rows, result_cols, bandMask, bounds);
+    cv::Rect roiBounds(bounds.x, bounds.y, bounds.width + templ.cols - 1, bounds.height + templ.rows - 1);
+    cv::Mat outsideBand;
+    if (constrained) outsideBand = bandMask(bounds) == 0;
+
     if (cv::ocl::useOpenCL() && !templ_umat.empty())
     {
-        roi_buffer = ROI_to.getUMat(cv::ACCESS_READ);
-        result_buffer.create(result_rows, result_cols, CV_32FC1);
-        springforce_buffer.create(result_rows, result_cols, CV_32FC1);
+        roi_buffer = ROI_to(roiBounds).getUMat(cv::ACCESS_READ);
+        result_buffer.create(bounds.height, bounds.width, CV_32FC1);
+        springforce_buffer.create(bounds.height, bounds.width, CV_32FC1);
 
         cv::matchTemplate(roi_buffer, templ_umat, result_buffer, cv::TM_CCORR_NORMED);
         cv::normalize(result_buffer, result_buffer, 0, (100 - maxPenalty), cv::NORM_MINMAX);
@@ -199,7 +347,7 @@ void MarkerTracking::trackMarker_thread()
         cv::imwrite("Tra_Result.png", dbgResult);
 #endif
 
-        cv::multiply(penaltyEntry.umat, cv::Scalar(static_cast<float>(maxPenalty)), springforce_buffer);
+        cv::multiply(penaltyEntry.umat(bounds), cv::Scalar(static_cast<float>(maxPenalty)), springforce_buffer);
 
 #ifdef WRITEIMAGES
         cv::Mat dbgPenalty = springforce_buffer.getMat(cv::ACCESS_READ);
@@ -207,6 +355,7 @@ void MarkerTracking::trackMarker_thread()
 #endif
 
         cv::subtract(result_buffer, springforce_buffer, result_buffer);
+        if (constrained) result_buffer.setTo(cv::Scalar(-maxPenalty - 1), outsideBand);
 
 #ifdef WRITEIMAGES
         cv::Mat dbgPenResult = result_buffer.getMat(cv::ACCESS_READ);
@@ -219,7 +368,7 @@ void MarkerTracking::trackMarker_thread()
     cv::Point maxLoc;
     cv::minMaxLoc(result_buffer, &minVal, &maxVal, &minLoc, &maxLoc);
 
-        cv::Point matchLoc = maxLoc;
+        cv::Point matchLoc = maxLoc + bounds.tl();
         x_to = matchLoc.x + off_x + size + 3;
         y_to = matchLoc.y + off_y + size + 3;
 
@@ -233,9 +382,9 @@ void MarkerTracking::trackMarker_thread()
     else
     {
         cv::Mat result;
-        result.create(result_rows, result_cols, CV_32FC1);
+        result.create(bounds.height, bounds.width, CV_32FC1);
 
-        cv::matchTemplate(ROI_to, templ, result, cv::TM_CCORR_NORMED);
+        cv::matchTemplate(ROI_to(roiBounds), templ, result, cv::TM_CCORR_NORMED);
     normalize(result, result, 0, (100 - maxPenalty), cv::NORM_MINMAX, -1, cv::Mat());
 
 #ifdef WRITEIMAGES
@@ -243,13 +392,14 @@ void MarkerTracking::trackMarker_thread()
 #endif
 
     cv::Mat springforce;
-    cv::multiply(penaltyEntry.mat, cv::Scalar(static_cast<float>(maxPenalty)), springforce);
+    cv::multiply(penaltyEntry.mat(bounds), cv::Scalar(static_cast<float>(maxPenalty)), springforce);
 
 #ifdef WRITEIMAGES
         cv::imwrite("Tra_Penalty.png", springforce);
 #endif
 
         result = result - springforce;
+        if (constrained) result.setTo(cv::Scalar(-maxPenalty - 1), outsideBand);
 
 #ifdef WRITEIMAGES
         cv::imwrite("Tra_PenResult.png", result);
@@ -263,7 +413,7 @@ void MarkerTracking::trackMarker_thread()
 
     minMaxLoc(result, &minVal, &maxVal, &minLoc, &maxLoc, cv::Mat());
 
-        matchLoc = maxLoc;
+        matchLoc = maxLoc + bounds.tl();
 
         x_to = matchLoc.x + off_x + size + 3;
         y_to = matchLoc.y + off_y + size + 3;
@@ -282,9 +432,62 @@ void MarkerTracking::trackMarker_thread()
     ROI_to.release();
 }
 
+bool MarkerTracking::getEpipolarBand(int off_x, int off_y, int rows, int cols, cv::Mat& mask, cv::Rect& bounds)
+{
+    //image position of the result pixel (0,0)
+    cv::Point2d origin(off_x + size + 3, off_y + size + 3);
+    double halfWidth = 0.5 * m_bandWidth;
+
+    //segments of the epipolar line passing the search area
+    cv::Rect2d area(origin.x - halfWidth, origin.y - halfWidth, cols + 2 * halfWidth, rows + 2 * halfWidth);
+    std::vector<cv::Point2d> segment;
+    std::vector<std::vector<cv::Point2d> > segments;
+    for (unsigned int i = 1; i < m_epiline.size(); i++)
+    {
+        cv::Rect2d segmentBounds(std::min(m_epiline[i - 1].x, m_epiline[i].x) - 1, std::min(m_epiline[i - 1].y, m_epiline[i].y) - 1,
+            fabs(m_epiline[i].x - m_epiline[i - 1].x) + 2, fabs(m_epiline[i].y - m_epiline[i - 1].y) + 2);
+        if ((segmentBounds & area).area() > 0)
+        {
+            segment.clear();
+            segment.push_back(m_epiline[i - 1]);
+            segment.push_back(m_epiline[i]);
+            segments.push_back(segment);
+        }
+    }
+    if (segments.empty())
+        return false;
+
+    mask = cv::Mat::zeros(rows, cols, CV_8UC1);
+    for (int r = 0; r < rows; r++)
+    {
+        for (int c = 0; c < cols; c++)
+        {
+            cv::Point2d pt(origin.x + c, origin.y + r);
+            for (unsigned int s = 0; s < segments.size(); s++)
+            {
+                if (cv::norm(Marker::getClosestPointOnEpipolarLine(segments[s], pt) - pt) <= halfWidth)
+                {
+                    mask.at<uchar>(r, c) = 255;
+                    break;
+                }
+            }
+        }
+    }
+
+    bounds = cv::boundingRect(mask);
+    return bounds.area() > 0;
+}
+
 void MarkerTracking::trackMarker_threadFinished()
 {
+    Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->recordTracking(m_trackingTime, m_chosenSearchArea);
     Project::getInstance()->getTrials()[m_trial]->getMarkers()[m_marker]->setPoint(m_camera, m_frame_to, x_to, y_to, TRACKED);
+
+    //the dependent cameras can be constrained now that the point is known
+    for (unsigned int i = 0; i < m_dependents.size(); i++)
+    {
+        m_dependents[i]->trackMarker();
+    }
     delete m_FutureWatcher;
     nbInstances--;
     if (nbInstances == 0)
@@ -42,6 +42,9 @@ namespace xma
 		MarkerTracking(int camera, int trial, int frame_from, int frame_to, int marker, bool forward);
 		virtual ~MarkerTracking();
 		void trackMarker();
+		//The tracker is started after this one and searches along the epipolar line of the point tracked by this one.
+		void addEpipolarDependent(MarkerTracking* tracker);
+		int getCamera();
 
 		static bool isRunning()
 		{
@@ -56,8 +59,18 @@ namespace xma
 
 	private:
 		void trackMarker_thread();
+		//Template matching in the search area around x_to, y_to at full resolution
+		void searchFine();
+		//Template matching in the downsampled search area, moves x_to, y_to to the coarse match
+		bool searchCoarse(int levels);
+		int getPyramidLevels();
+		bool getEpipolarBand(int off_x, int off_y, int rows, int cols, cv::Mat& mask, cv::Rect& bounds);
 		QFutureWatcher<void>* m_FutureWatcher;
 		static int nbInstances;
+		static const int minimumSearchArea;
+		static const int maximumPyramidLevels;
+		static const int minimumPyramidTemplateSize;
+		static const int displacementWindow;
 
 		int m_camera;
 		int m_frame_from;
@@ -71,11 +84,22 @@ namespace xma
 
 		double x_to;
 		double y_to;
+		int prediction;
+		double searchRadius;
 
 		int size;
 		int searchArea;
 		int maxPenalty;
 
+		bool m_pyramid;
+		int m_chosenSearchArea;
+		double m_trackingTime;
+
+		int m_epipolarCamera;
+		double m_bandWidth;
+		std::vector<cv::Point2d> m_epiline;
+		std::vector<MarkerTracking*> m_dependents;
+
 		cv::Mat templ;
 		cv::UMat templ_umat;
 		cv::UMat roi_buffer;
@@ -0,0 +1,165 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file MotionPredictor.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/MotionPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace xma;
+
+namespace
+{
+	//innovations of the first measurements are dominated by the initial uncertainty and are not used for the scaling
+	const int nbInitialMeasurements = 3;
+	//initial variance of velocity and acceleration
+	const double initialVelocityVariance = 100.0;
+	const double initialAccelerationVariance = 10.0;
+}
+
+void MotionPredictor::filterAxis(const std::vector<double>& values, double r, double q, double& prediction, double& variance, double& nis, int& nbInnovations)
+{
+	//state position, velocity, acceleration with a time step of one frame
+	double x[3] = { values[0], 0.0, 0.0 };
+	double P[3][3] = { { r, 0, 0 }, { 0, initialVelocityVariance, 0 }, { 0, 0, initialAccelerationVariance } };
+
+	//discrete white noise jerk model
+	const double Q[3][3] = {
+		{ q / 20.0, q / 8.0, q / 6.0 },
+		{ q / 8.0, q / 3.0, q / 2.0 },
+		{ q / 6.0, q / 2.0, q }
+	};
+	const double F[3][3] = { { 1, 1, 0.5 }, { 0, 1, 1 }, { 0, 0, 1 } };
+
+	for (unsigned int i = 1; i <= values.size(); i++)
+	{
+		//predict x = F x, P = F P F' + Q
+		double xp[3];
+		for (int a = 0; a < 3; a++)
+			xp[a] = F[a][0] * x[0] + F[a][1] * x[1] + F[a][2] * x[2];
+
+		double FP[3][3];
+		for (int a = 0; a < 3; a++)
+		{
+			for (int b = 0; b < 3; b++)
+				FP[a][b] = F[a][0] * P[0][b] + F[a][1] * P[1][b] + F[a][2] * P[2][b];
+		}
+		for (int a = 0; a < 3; a++)
+		{
+			for (int b = 0; b < 3; b++)
+				P[a][b] = FP[a][0] * F[b][0] + FP[a][1] * F[b][1] + FP[a][2] * F[b][2] + Q[a][b];
+		}
+		for (int a = 0; a < 3; a++)
+			x[a] = xp[a];
+
+		if (i == values.size())
+			break;
+
+		//update with the position measurement
+		double S = P[0][0] + r;
+		double innovation = values[i] - x[0];
+		double K[3] = { P[0][0] / S, P[1][0] / S, P[2][0] / S };
+		for (int a = 0; a < 3; a++)
+			x[a] += K[a] * innovation;
+
+		double P0[3] = { P[0][0], P[0][1], P[0][2] };
+		for (int a = 0; a < 3; a++)
+		{
+			for (int b = 0; b < 3; b++)
+				P[a][b] -= K[a] * P0[b];
+		}
+
+		if ((int) i >= nbInitialMeasurements)
+		{
+			nis += innovation * innovation / S;
+			nbInnovations++;
+		}
+	}
+
+	prediction = x[0];
+	variance = P[0][0] + r;
+}
+
+double MotionPredictor::getInnovationScale(double nis, int nbInnovations)
+{
+	//the normalized innovation squared has an expectation of 1 per axis if the model fits
+	if (nbInnovations == 0)
+		return 1.0;
+	return std::max(1.0, nis / nbInnovations);
+}
+
+bool MotionPredictor::predict(const std::vector<cv::Point2d>& measurements, double measurementNoise, double processNoise, cv::Point2d& prediction, cv::Point2d& sigma)
+{
+	if (measurements.size() < 2)
+		return false;
+
+	std::vector<double> values[2];
+	for (unsigned int i = 0; i < measurements.size(); i++)
+	{
+		values[0].push_back(measurements[i].x);
+		values[1].push_back(measurements[i].y);
+	}
+
+	double pred[2], var[2];
+	double nis = 0;
+	int nbInnovations = 0;
+	for (int a = 0; a < 2; a++)
+		filterAxis(values[a], measurementNoise, processNoise, pred[a], var[a], nis, nbInnovations);
+
+	double scale = getInnovationScale(nis, nbInnovations);
+	prediction = cv::Point2d(pred[0], pred[1]);
+	sigma = cv::Point2d(sqrt(var[0] * scale), sqrt(var[1] * scale));
+	return true;
+}
+
+bool MotionPredictor::predict(const std::vector<cv::Point3d>& measurements, double measurementNoise, double processNoise, cv::Point3d& prediction, cv::Point3d& sigma)
+{
+	if (measurements.size() < 2)
+		return false;
+
+	std::vector<double> values[3];
+	for (unsigned int i = 0; i < measurements.size(); i++)
+	{
+		values[0].push_back(measurements[i].x);
+		values[1].push_back(measurements[i].y);
+		values[2].push_back(measurements[i].z);
+	}
+
+	double pred[3], var[3];
+	double nis = 0;
+	int nbInnovations = 0;
+	for (int a = 0; a < 3; a++)
+		filterAxis(values[a], measurementNoise, processNoise, pred[a], var[a], nis, nbInnovations);
+
+	double scale = getInnovationScale(nis, nbInnovations);
+	prediction = cv::Point3d(pred[0], pred[1], pred[2]);
+	sigma = cv::Point3d(sqrt(var[0] * scale), sqrt(var[1] * scale), sqrt(var[2] * scale));
+	return true;
+}
@@ -0,0 +1,52 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file MotionPredictor.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef MOTIONPREDICTOR_H
+#define MOTIONPREDICTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace xma
+{
+	/// Constant acceleration Kalman filter for the prediction of marker positions. The filter is run over the
+	/// recent measurements of a marker and predicts the position in the next frame together with its standard
+	/// deviation, which is used to size the search windows of the tracking and detection. The process noise is
+	/// scaled by the normalized innovations, so erratic motion leads to larger windows.
+	class MotionPredictor
+	{
+	public:
+		//Measurements are ordered from the oldest to the newest, one per frame. At least 2 measurements are required.
+		static bool predict(const std::vector<cv::Point2d>& measurements, double measurementNoise, double processNoise, cv::Point2d& prediction, cv::Point2d& sigma);
+		static bool predict(const std::vector<cv::Point3d>& measurements, double measurementNoise, double processNoise, cv::Point3d& prediction, cv::Point3d& sigma);
+
+	private:
+		//Filters a single axis. Returns the predicted value, the variance of the predicted measurement and the sum of the normalized innovations.
+		static void filterAxis(const std::vector<double>& values, double measurementNoise, double processNoise, double& prediction, double& variance, double& nis, int& nbInnovations);
+		static double getInnovationScale(double nis, int nbInnovations);
+	};
+}
+#endif // MOTIONPREDICTOR_H
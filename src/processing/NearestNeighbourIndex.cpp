@@ -0,0 +1,210 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file NearestNeighbourIndex.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "processing/NearestNeighbourIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace xma;
+
+NearestNeighbourIndex::NearestNeighbourIndex() : originX(0), originY(0), cellSize(1), gridWidth(0), gridHeight(0)
+{
+}
+
+NearestNeighbourIndex::NearestNeighbourIndex(const std::vector<cv::Point2d>& _points) : originX(0), originY(0), cellSize(1), gridWidth(0), gridHeight(0)
+{
+	build(_points);
+}
+
+NearestNeighbourIndex::~NearestNeighbourIndex()
+{
+}
+
+void NearestNeighbourIndex::build(const std::vector<cv::Point2d>& _points)
+{
+	points = _points;
+	buildGrid();
+}
+
+void NearestNeighbourIndex::build(const cv::Mat& _points)
+{
+	points.resize(_points.rows);
+	for (int i = 0; i < _points.rows; i++)
+	{
+		if (_points.channels() == 2)
+		{
+			points[i] = cv::Point2d(_points.at<cv::Vec2d>(i, 0)[0], _points.at<cv::Vec2d>(i, 0)[1]);
+		}
+		else
+		{
+			points[i] = cv::Point2d(_points.at<double>(i, 0), _points.at<double>(i, 1));
+		}
+	}
+	buildGrid();
+}
+
+void NearestNeighbourIndex::buildGrid()
+{
+	cellStart.clear();
+	cellIndices.clear();
+	gridWidth = 0;
+	gridHeight = 0;
+
+	if (points.empty())
+		return;
+
+	double minX = points[0].x, maxX = points[0].x;
+	double minY = points[0].y, maxY = points[0].y;
+	for (unsigned int i = 1; i < points.size(); i++)
+	{
+		minX = (std::min)(minX, points[i].x);
+		maxX = (std::max)(maxX, points[i].x);
+		minY = (std::min)(minY, points[i].y);
+		maxY = (std::max)(maxY, points[i].y);
+	}
+
+	//about two points per cell
+	double width = (std::max)(maxX - minX, 1e-6);
+	double height = (std::max)(maxY - minY, 1e-6);
+	cellSize = (std::max)(std::sqrt(2.0 * width * height / points.size()), 1e-6);
+	cellSize = (std::max)(cellSize, (std::max)(width, height) / 4096.0);
+
+	originX = minX;
+	originY = minY;
+	gridWidth = (int) std::floor(width / cellSize) + 1;
+	gridHeight = (int) std::floor(height / cellSize) + 1;
+
+	//counting sort of the points into the cells
+	std::vector<int> cells(points.size());
+	cellStart.assign(gridWidth * gridHeight + 1, 0);
+	for (unsigned int i = 0; i < points.size(); i++)
+	{
+		cells[i] = cellY(points[i].y) * gridWidth + cellX(points[i].x);
+		cellStart[cells[i] + 1]++;
+	}
+	for (int c = 0; c < gridWidth * gridHeight; c++)
+	{
+		cellStart[c + 1] += cellStart[c];
+	}
+
+	cellIndices.resize(points.size());
+	std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+	for (unsigned int i = 0; i < points.size(); i++)
+	{
+		cellIndices[fill[cells[i]]++] = i;
+	}
+}
+
+int NearestNeighbourIndex::cellX(double x) const
+{
+	return (std::min)((std::max)((int) std::floor((x - originX) / cellSize), 0), gridWidth - 1);
+}
+
+int NearestNeighbourIndex::cellY(double y) const
+{
+	return (std::min)((std::max)((int) std::floor((y - originY) / cellSize), 0), gridHeight - 1);
+}
+
+void NearestNeighbourIndex::knn(const cv::Point2d& pt, int k, std::vector<int>& indices, std::vector<double>* distances) const
+{
+	indices.clear();
+	if (distances)
+		distances->clear();
+
+	k = (std::min)(k, size());
+	if (k <= 0)
+		return;
+
+	//candidates as (squared distance, index), kept as a max heap of the k best
+	std::vector<std::pair<double, int> > best;
+	best.reserve(k + 1);
+
+	int cx = cellX(pt.x);
+	int cy = cellY(pt.y);
+	//distance of a query point outside of the grid to the grid
+	double outsideX = (std::max)((std::max)(originX - pt.x, pt.x - (originX + gridWidth * cellSize)), 0.0);
+	double outsideY = (std::max)((std::max)(originY - pt.y, pt.y - (originY + gridHeight * cellSize)), 0.0);
+	double outside = std::sqrt(outsideX * outsideX + outsideY * outsideY);
+	int maxRing = (std::max)((std::max)(cx, gridWidth - 1 - cx), (std::max)(cy, gridHeight - 1 - cy));
+
+	for (int ring = 0; ring <= maxRing; ring++)
+	{
+		//all points in this and the following rings are at least this far away
+		if ((int) best.size() == k)
+		{
+			double minDist = (std::max)(outside, (ring - 1) * cellSize);
+			if (minDist * minDist > best.front().first)
+				break;
+		}
+
+		for (int y = (std::max)(cy - ring, 0); y <= (std::min)(cy + ring, gridHeight - 1); y++)
+		{
+			bool fullRow = (y == cy - ring || y == cy + ring);
+			for (int x = (std::max)(cx - ring, 0); x <= (std::min)(cx + ring, gridWidth - 1); x++)
+			{
+				//inner rows of the ring only have their first and last cell
+				if (!fullRow && x != cx - ring && x != cx + ring)
+					continue;
+
+				int c = y * gridWidth + x;
+				for (int p = cellStart[c]; p < cellStart[c + 1]; p++)
+				{
+					int idx = cellIndices[p];
+					double dx = points[idx].x - pt.x;
+					double dy = points[idx].y - pt.y;
+					std::pair<double, int> candidate(dx * dx + dy * dy, idx);
+					if ((int) best.size() < k)
+					{
+						best.push_back(candidate);
+						std::push_heap(best.begin(), best.end());
+					}
+					else if (candidate < best.front())
+					{
+						std::pop_heap(best.begin(), best.end());
+						best.back() = candidate;
+						std::push_heap(best.begin(), best.end());
+					}
+				}
+			}
+		}
+	}
+
+	std::sort_heap(best.begin(), best.end());
+	indices.resize(best.size());
+	if (distances)
+		distances->resize(best.size());
+	for (unsigned int i = 0; i < best.size(); i++)
+	{
+		indices[i] = best[i].second;
+		if (distances)
+			(*distances)[i] = std::sqrt(best[i].first);
+	}
+}
@@ -0,0 +1,76 @@
+//  ----------------------------------
+//  XMALab -- Copyright (c) 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED "AS IS", INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file NearestNeighbourIndex.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef NEARESTNEIGHBOURINDEX_H
+#define NEARESTNEIGHBOURINDEX_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace xma
+{
+	/// Uniform grid over a set of 2D points for k-nearest-neighbour queries. The cell size is
+	/// chosen so each cell holds about two points and queries only visit rings of cells around
+	/// the query point until no closer point can be found. The index is read-only after build
+	/// and can be queried from multiple threads.
+	class NearestNeighbourIndex
+	{
+	public:
+		NearestNeighbourIndex();
+		explicit NearestNeighbourIndex(const std::vector<cv::Point2d>& points);
+		virtual ~NearestNeighbourIndex();
+
+		void build(const std::vector<cv::Point2d>& points);
+		//Builds the index from a Nx1 CV_64FC2 or Nx2 CV_64F matrix
+		void build(const cv::Mat& points);
+
+		int size() const { return points.size(); }
+		const cv::Point2d& getPoint(int idx) const { return points[idx]; }
+
+		//Returns the indices of the k closest points sorted by increasing distance.
+		//If distances is set the euclidean distances are returned as well.
+		void knn(const cv::Point2d& pt, int k, std::vector<int>& indices, std::vector<double>* distances = nullptr) const;
+
+	private:
+		void buildGrid();
+		int cellX(double x) const;
+		int cellY(double y) const;
+
+		std::vector<cv::Point2d> points;
+
+		double originX;
+		double originY;
+		double cellSize;
+		int gridWidth;
+		int gridHeight;
+
+		//point indices sorted by cell, the points of cell c are cellIndices[cellStart[c]..cellStart[c + 1])
+		std::vector<int> cellStart;
+		std::vector<int> cellIndices;
+	};
+}
+
+#endif // NEARESTNEIGHBOURINDEX_H
@@ -39,6 +39,7 @@
 #include "core/Marker.h"
 #include "core/CalibrationImage.h"
 #include "core/CalibrationObject.h"
+#include "core/Tracer.h"
 
 #include <math.h>
 
@@ -244,6 +245,7 @@ void RigidBodyPoseOptimization::setOutput()
 
 void RigidBodyPoseOptimization::optimizeRigidBodySetup()
 {
+	XMA_TRACE_SCOPE("RigidBodyOptimization");
 	double opts[LM_OPTS_SZ ], info[LM_INFO_SZ];
 	opts[0] = m_initial;
 	opts[1] = 1E-30;
@@ -29,14 +29,20 @@
 #endif
 
 #include "processing/ThreadScheduler.h"
-#include "processing/UpdateTrialFrame.h"
 
+#include "core/Project.h"
 #include "core/Trial.h"
 #include "core/RigidBody.h"
 
 #include <vector>
+#include <algorithm>
+#include <iostream>
 #include "ui/MainWindow.h"
+#include "ui/ProgressDialog.h"
+#include "ui/State.h"
 
+#include <QEventLoop>
+#include <QtConcurrent/QtConcurrent>
 
 using namespace xma;
 
@@ -45,7 +51,10 @@ ThreadScheduler* ThreadScheduler::instance = NULL;
 ThreadScheduler::ThreadScheduler()
 {
 	data_ptr = NULL;
-	running = false;
+	nbJobs = 0;
+	awaitedTrial = NULL;
+	nbScheduled = 0;
+	nbRecomputed = 0;
 }
 
 ThreadScheduler::~ThreadScheduler()
@@ -62,16 +71,26 @@ ThreadScheduler* ThreadScheduler::getInstance()
 	return instance;
 }
 
-void ThreadScheduler::updateTrialData(Trial* trial)
+void ThreadScheduler::recomputeTrials(std::vector<Trial*> trials, Trial* activeTrial)
 {
-	running = true;
-
-	trials.push_back(trial);
-	
-	std::vector<UpdateTrialFrame*> threads;
+	//the frames of the active trial are queued first
+	if (activeTrial != NULL)
+	{
+		std::vector<Trial*>::iterator it = std::find(trials.begin(), trials.end(), activeTrial);
+		if (it != trials.end())
+			std::rotate(trials.begin(), it, it + 1);
+	}
 
-	if (trial->getRequiresRecomputation())
+	std::vector<Trial*> scheduled;
+	for (auto trial : trials)
 	{
+		if (!trial->getRequiresRecomputation())
+			continue;
+
+		//a trial which changed while it is recomputed is queued again once it is finished
+		if (isRecomputing(trial))
+			continue;
+
 		//ensure that the vector sizes of the rigid bodies is of the length of nbImages
 		for (auto rb : trial->getRigidBodies())
 		{
@@ -80,33 +99,165 @@ void ThreadScheduler::updateTrialData(Trial* trial)
 				rb->init(trial->getNbImages());
 			}
 		}
+		pendingTrials[trial] = trial->getRecomputationRequest();
+		scheduled.push_back(trial);
+	}
 
-		for (int i = 0; i < trial->getNbImages(); i++)
+	if (!scheduled.empty())
+	{
+		if (nbJobs == 0)
 		{
-			UpdateTrialFrame* thread = new UpdateTrialFrame(trial, i);
-			connect(thread, SIGNAL(signal_finished()), this, SLOT(finalize_updateTrialData()));
-			threads.push_back(thread);
+			nbScheduled = 0;
+			nbRecomputed = 0;
+			timer.start();
 		}
-	}
+		nbScheduled += scheduled.size();
+		nbJobs++;
 
-	for (unsigned int i = 0; i < threads.size(); i++)
-	{
-		threads[i]->start();
+		QFutureWatcher<void>* watcher = new QFutureWatcher<void>();
+		connect(watcher, SIGNAL(finished()), this, SLOT(recompute_finished()));
+		connect(watcher, SIGNAL(finished()), watcher, SLOT(deleteLater()));
+		watcher->setFuture(QtConcurrent::run([this, scheduled]()
+		{
+			recompute(scheduled);
+		}));
 	}
+
+	if (activeTrial != NULL && isRecomputing(activeTrial))
+		awaitTrial(activeTrial);
 }
 
-void ThreadScheduler::finalize_updateTrialData()
+void ThreadScheduler::recompute(std::vector<Trial*> trials)
 {
-	for (auto & trial : trials) {
-		for (unsigned int i = 0; i < trial->getRigidBodies().size(); i++)
+	//all frames of all trials are distributed over the global thread pool. Each trial counts its
+	//finished frames and the thread finishing the last frame filters the rigid bodies of the trial.
+	std::vector<std::pair<int, int> > frames;
+	std::vector<QAtomicInt> nbFinished(trials.size(), QAtomicInt(0));
+	for (unsigned int t = 0; t < trials.size(); t++)
+	{
+		for (int i = 0; i < trials[t]->getNbImages(); i++)
+		{
+			frames.push_back(std::make_pair(t, i));
+		}
+	}
+
+	for (unsigned int t = 0; t < trials.size(); t++)
+	{
+		if (trials[t]->getNbImages() <= 0)
 		{
-			trial->getRigidBodies()[i]->makeRotationsContinous();
-			trial->getRigidBodies()[i]->filterTransformations();
+			trials[t]->filterRigidBodies();
+			Trial* trial = trials[t];
+			qint64 elapsed = timer.elapsed();
+			QMetaObject::invokeMethod(this, [this, trial, elapsed]() { trial_recomputed(trial, elapsed); }, Qt::QueuedConnection);
 		}
-		trial->setRequiresRecomputation(false);
 	}
-	trials.clear();
-	running = false;
-	MainWindow::getInstance()->redrawGL();
+
+	QtConcurrent::blockingMap(frames, [this, &trials, &nbFinished](const std::pair<int, int>& frame)
+	{
+		Trial* trial = trials[frame.first];
+		trial->recomputeFrame(frame.second);
+
+		int nbImages = trial->getNbImages();
+		int finished = nbFinished[frame.first].fetchAndAddOrdered(1) + 1;
+		if (finished == nbImages)
+		{
+			trial->filterRigidBodies();
+			qint64 elapsed = timer.elapsed();
+			QMetaObject::invokeMethod(this, [this, trial, elapsed]() { trial_recomputed(trial, elapsed); }, Qt::QueuedConnection);
+		}
+		else if (finished * 100 / nbImages != (finished - 1) * 100 / nbImages)
+		{
+			int percent = finished * 100 / nbImages;
+			QMetaObject::invokeMethod(this, [this, trial, percent]() { trial_progress(trial, percent); }, Qt::QueuedConnection);
+		}
+	});
+}
+
+void ThreadScheduler::awaitTrial(Trial* trial)
+{
+	if (awaitedTrial == trial)
+		return;
+
+	awaitedTrial = trial;
+	ProgressDialog::getInstance()->showProgressbar(0, 100, ("Recompute " + trial->getName()).toUtf8());
+}
+
+void ThreadScheduler::trial_progress(Trial* trial, int percent)
+{
+	if (trial == awaitedTrial)
+		ProgressDialog::getInstance()->setProgress(percent);
 }
 
+void ThreadScheduler::trial_recomputed(Trial* trial, qint64 elapsed)
+{
+	int request = pendingTrials[trial];
+	pendingTrials.erase(trial);
+
+	if (trial->getRecomputationRequest() != request && trial->getRequiresRecomputation())
+	{
+		//the trial changed while it was recomputed
+		nbScheduled--;
+		recomputeTrials(std::vector<Trial*>(1, trial), trial == awaitedTrial ? trial : NULL);
+		return;
+	}
+
+	trial->setRequiresRecomputation(false);
+	nbRecomputed++;
+	std::cout << "Recomputed trial " << trial->getName().toStdString() << " (" << nbRecomputed << "/" << nbScheduled << ") after " << elapsed << " ms" << std::endl;
+
+	if (trial == awaitedTrial)
+	{
+		awaitedTrial = NULL;
+		ProgressDialog::getInstance()->closeProgressbar();
+	}
+
+	Project* project = Project::getInstance();
+	int activeTrial = State::getInstance()->getActiveTrial();
+	if (activeTrial >= 0 && activeTrial < (int)project->getTrials().size() && project->getTrials()[activeTrial] == trial)
+		MainWindow::getInstance()->redrawGL();
+
+	checkFinished();
+}
+
+void ThreadScheduler::recompute_finished()
+{
+	nbJobs--;
+	checkFinished();
+}
+
+void ThreadScheduler::checkFinished()
+{
+	if (isRunning())
+		return;
+
+	std::cout << "Recomputed " << nbRecomputed << " trials in " << timer.elapsed() << " ms" << std::endl;
+	emit recomputeFinished();
+}
+
+void ThreadScheduler::updateTrialData(Trial* trial)
+{
+	recomputeTrials(std::vector<Trial*>(1, trial), trial);
+}
+
+bool ThreadScheduler::isRecomputing(Trial* trial)
+{
+	return pendingTrials.find(trial) != pendingTrials.end();
+}
+
+void ThreadScheduler::waitForFinished()
+{
+	if (!isRunning())
+		return;
+
+	bool showProgress = awaitedTrial == NULL;
+	if (showProgress)
+		ProgressDialog::getInstance()->showProgressbar(0, 0, "Recompute trials");
+
+	QEventLoop loop;
+	connect(this, SIGNAL(recomputeFinished()), &loop, SLOT(quit()));
+	if (isRunning())
+		loop.exec();
+
+	if (showProgress)
+		ProgressDialog::getInstance()->closeProgressbar();
+}
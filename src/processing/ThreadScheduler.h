@@ -28,6 +28,10 @@
 #define THREADSCHEDULER_H_
 
 #include <QObject>
+#include <QElapsedTimer>
+
+#include <map>
+#include <vector>
 
 namespace xma
 {
@@ -41,9 +45,23 @@ namespace xma
 		static ThreadScheduler* instance;
 
 		void* data_ptr;
-		bool running;
-		
-		std::vector<Trial*> trials;
+		int nbJobs;
+
+		//trials scheduled for recomputation which have not finished yet and their recomputation request when
+		//they were queued. A trial is queued again if it was requested again while being recomputed.
+		std::map<Trial*, int> pendingTrials;
+		//trial the gui waits for, its progress is shown in the ProgressDialog
+		Trial* awaitedTrial;
+
+		int nbScheduled;
+		int nbRecomputed;
+		QElapsedTimer timer;
+
+		void recompute(std::vector<Trial*> trials);
+		void awaitTrial(Trial* trial);
+		void trial_progress(Trial* trial, int percent);
+		void trial_recomputed(Trial* trial, qint64 elapsed);
+		void checkFinished();
 
 	protected:
 		ThreadScheduler();
@@ -52,13 +70,23 @@ namespace xma
 		virtual ~ThreadScheduler();
 		static ThreadScheduler* getInstance();
 
+		//Recomputes all trials which require a recomputation on the shared thread pool. The frames of
+		//activeTrial are processed first and the gui is blocked with a progress bar until it is finished,
+		//all other trials are recomputed in the background and become available as soon as they are done.
+		void recomputeTrials(std::vector<Trial*> trials, Trial* activeTrial = NULL);
 		void updateTrialData(Trial* trial);
+		bool isRecomputing(Trial* trial);
+		//Processes events until all scheduled trials are recomputed, e.g. before trials are deleted
+		void waitForFinished();
 		bool isRunning() {
-			return running;	
+			return nbJobs > 0 || !pendingTrials.empty();
 		}
 
+	signals:
+		void recomputeFinished();
+
 	public slots:
-		void finalize_updateTrialData();
+		void recompute_finished();
 	};
 }
 
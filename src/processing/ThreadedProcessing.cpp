@@ -32,6 +32,8 @@
 
 #include "ui/ProgressDialog.h"
 
+#include "core/Tracer.h"
+
 #include <QtCore>
 #include <QtConcurrent/QtConcurrent>
 
@@ -63,6 +65,8 @@ void ThreadedProcessing::start()
 
 void ThreadedProcessing::thread()
 {
+	//the class name of the task is static and can be used as span name
+	XMA_TRACE_SCOPE(metaObject()->className());
 	process();
 }
 
@@ -31,6 +31,16 @@
 #include "ui/ConsoleDockWidget.h"
 #include "ui_ConsoleDockWidget.h"
 #include "ui/MainWindow.h"
+#include "ui/State.h"
+
+#include "core/Project.h"
+#include "core/Trial.h"
+#include "core/Marker.h"
+#include "core/Camera.h"
+#include "core/VideoStream.h"
+#include "core/Settings.h"
+#include "core/HelperFunctions.h"
+#include "core/Tracer.h"
 
 #include <QLabel>
 #include <QColor>
@@ -38,6 +48,8 @@
 #include <QTextStream>
 #include <QScrollBar>
 #include <QCloseEvent>
+#include <QMenu>
+#include <QFileDialog>
 #include "ui/Shortcuts.h"
 
 using namespace xma;
@@ -71,6 +83,9 @@ ConsoleDockWidget::ConsoleDockWidget(QWidget* parent) :
 
 	LoadText = "";
 
+	dock->console->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(dock->console, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(showContextMenu(const QPoint&)));
+
 	Shortcuts::getInstance()->installEventFilterToChildren(this);
 }
 
@@ -188,6 +203,139 @@ void ConsoleDockWidget::logTimer()
 	}
 }
 
+void ConsoleDockWidget::showContextMenu(const QPoint& pos)
+{
+	QMenu* menu = dock->console->createStandardContextMenu();
+	menu->addSeparator();
+	menu->addAction("Show frame decode statistics", this, SLOT(printDecodeStatistics()));
+	menu->addAction("Reset frame decode statistics", this, SLOT(resetDecodeStatistics()));
+	menu->addAction("Show marker tracking statistics", this, SLOT(printTrackingStatistics()));
+	menu->addAction("Reset marker tracking statistics", this, SLOT(resetTrackingStatistics()));
+#ifdef XMA_WITH_TRACING
+	menu->addSeparator();
+	menu->addAction(Tracer::getInstance()->isEnabled() ? "Stop tracing" : "Start tracing", this, SLOT(toggleTracing()));
+	menu->addAction("Show trace summary", this, SLOT(printTraceSummary()));
+	menu->addAction("Save trace...", this, SLOT(saveTrace()));
+#endif
+	menu->exec(dock->console->mapToGlobal(pos));
+	delete menu;
+}
+
+void ConsoleDockWidget::printDecodeStatistics()
+{
+	if (State::getInstance()->getActiveTrial() < 0 || State::getInstance()->getActiveTrial() >= (int) Project::getInstance()->getTrials().size())
+		return;
+
+	Trial* trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
+	QString message = "Frame decode latency for trial " + trial->getName();
+	for (unsigned int c = 0; c < trial->getVideoStreams().size(); c++)
+	{
+		VideoStream* video = trial->getVideoStreams()[c];
+		message += "\nCamera " + QString::number(c + 1) + " (" + video->getFileBasename() + "): "
+			+ QString::number(video->getDecodeCount()) + " frames, mean " + QString::number(video->getDecodeTimeMean(), 'f', 2)
+			+ " ms, max " + QString::number(video->getDecodeTimeMax(), 'f', 2) + " ms\n  ";
+
+		double lower = 0;
+		double upper = 1;
+		for (int b = 0; b < VideoStream::nbDecodeHistogramBins; b++)
+		{
+			if (b == VideoStream::nbDecodeHistogramBins - 1)
+			{
+				message += ">" + QString::number(lower);
+			}
+			else
+			{
+				message += QString::number(lower) + "-" + QString::number(upper);
+			}
+			message += " ms: " + QString::number(video->getDecodeHistogram()[b]) + "  ";
+			lower = upper;
+			upper *= 2;
+		}
+	}
+	writeLog(message, 2);
+}
+
+void ConsoleDockWidget::resetDecodeStatistics()
+{
+	for (unsigned int t = 0; t < Project::getInstance()->getTrials().size(); t++)
+	{
+		for (unsigned int c = 0; c < Project::getInstance()->getTrials()[t]->getVideoStreams().size(); c++)
+		{
+			Project::getInstance()->getTrials()[t]->getVideoStreams()[c]->resetDecodeStatistics();
+		}
+	}
+}
+
+void ConsoleDockWidget::printTrackingStatistics()
+{
+	if (State::getInstance()->getActiveTrial() < 0 || State::getInstance()->getActiveTrial() >= (int) Project::getInstance()->getTrials().size())
+		return;
+
+	Trial* trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
+	QString message = "Marker tracking for trial " + trial->getName();
+	for (unsigned int m = 0; m < trial->getMarkers().size(); m++)
+	{
+		Marker* marker = trial->getMarkers()[m];
+		if (marker->getTrackingCount() == 0)
+			continue;
+
+		message += "\nMarker " + QString::number(m + 1) + " (" + marker->getDescription() + "): "
+			+ QString::number(marker->getTrackingCount()) + " frames, mean " + QString::number(marker->getTrackingTimeMean(), 'f', 2)
+			+ " ms, max " + QString::number(marker->getTrackingTimeMax(), 'f', 2) + " ms, search window mean "
+			+ QString::number(marker->getTrackingSearchAreaMean(), 'f', 1) + " px, max " + QString::number(marker->getTrackingSearchAreaMax()) + " px";
+	}
+	writeLog(message, 2);
+}
+
+void ConsoleDockWidget::resetTrackingStatistics()
+{
+	for (unsigned int t = 0; t < Project::getInstance()->getTrials().size(); t++)
+	{
+		for (unsigned int m = 0; m < Project::getInstance()->getTrials()[t]->getMarkers().size(); m++)
+		{
+			Project::getInstance()->getTrials()[t]->getMarkers()[m]->resetTrackingStatistics();
+		}
+	}
+}
+
+void ConsoleDockWidget::toggleTracing()
+{
+	Tracer* tracer = Tracer::getInstance();
+	if (tracer->isEnabled())
+	{
+		tracer->setEnabled(false);
+		writeLog("Tracing stopped", 2);
+		printTraceSummary();
+	}
+	else
+	{
+		tracer->clear();
+		tracer->setEnabled(true);
+		writeLog("Tracing started", 2);
+	}
+}
+
+void ConsoleDockWidget::printTraceSummary()
+{
+	writeLog(Tracer::getInstance()->getSummary(), 2);
+}
+
+void ConsoleDockWidget::saveTrace()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save trace as"), Settings::getInstance()->getLastUsedDirectory() + OS_SEP + "trace.json", tr("Chrome trace (*.json)"));
+	if (fileName.isEmpty())
+		return;
+
+	Settings::getInstance()->setLastUsedDirectory(fileName);
+	if (Tracer::getInstance()->writeChromeTrace(fileName))
+	{
+		writeLog("Trace written to " + fileName, 2);
+	}
+	else
+	{
+		writeLog("Could not write trace to " + fileName, 3);
+	}
+}
 
 void ConsoleDockWidget::closeEvent(QCloseEvent* event)
 {
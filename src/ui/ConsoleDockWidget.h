@@ -73,6 +73,14 @@ namespace xma
 		QTimer* timer;
 	public slots:
 		void logTimer();
+		void showContextMenu(const QPoint& pos);
+		void printDecodeStatistics();
+		void resetDecodeStatistics();
+		void printTrackingStatistics();
+		void resetTrackingStatistics();
+		void toggleTracing();
+		void printTraceSummary();
+		void saveTrace();
 	};
 }
 
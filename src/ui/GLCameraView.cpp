@@ -32,6 +32,7 @@
 #include "gl/MultisampleFrameBuffer.h"
 #include "gl/DistortionShader.h"
 #include "gl/BlendShader.h"
+#include "gl/OverlayBuffer.h"
 #include "ui/GLCameraView.h"
 #include "ui/State.h"
 #include "ui/ErrorDialog.h"
@@ -96,6 +97,7 @@ GLCameraView::GLCameraView(QWidget* parent)
 	distortionShader = 0;
 	blendShader = NULL; 
 	rigidbodyBufferUndistorted = NULL;
+	overlay = NULL;
 
 	LightAmbient[0] = LightAmbient[1] = LightAmbient[2] = 0.1f;
 	LightAmbient[3] = 1.0f;
@@ -112,6 +114,8 @@ GLCameraView::GLCameraView(QWidget* parent)
 
 GLCameraView::~GLCameraView()
 {
+	//the buffer objects and shaders belong to the context of this widget
+	makeCurrent();
 	if (blendShader)
 		delete blendShader;
 
@@ -120,6 +124,10 @@ GLCameraView::~GLCameraView()
 
 	if (distortionShader)
 		delete distortionShader;
+
+	if (overlay)
+		delete overlay;
+	doneCurrent();
 }
 
 void GLCameraView::setCamera(Camera* _camera)
@@ -203,6 +211,7 @@ void GLCameraView::mouseDoubleClickEvent(QMouseEvent* e)
 			double x = zoomRatio * (e->pos().x() * devicePixelRatio) - ((window_width * devicePixelRatio) * zoomRatio * 0.5 + x_offset);
 			double y = zoomRatio * (e->pos().y() * devicePixelRatio) - ((window_height * devicePixelRatio) * zoomRatio * 0.5 + y_offset);
 			camera->getCalibrationImages()[State::getInstance()->getActiveFrameCalibration()]->toggleInlier(x, y, State::getInstance()->getCalibrationVisImage() == DISTORTEDCALIBIMAGE);
+			State::getInstance()->invalidateDraw();
 			update();
 		}
 	}
@@ -928,16 +937,10 @@ void GLCameraView::paintGL()
 		}
 		glDisable(GL_BLEND);
 	}
-	if (State::getInstance()->getWorkspace() == UNDISTORTION)
-	{
-		if (camera->hasUndistortion())
-		{
-			camera->getUndistortionObject()->drawData(State::getInstance()->getUndistortionVisPoints());
-		}
-	}
-	else if ((State::getInstance()->getWorkspace() == CALIBRATION && Project::getInstance()->getCalibration() == INTERNAL))
+	drawOverlay();
+
+	if ((State::getInstance()->getWorkspace() == CALIBRATION && Project::getInstance()->getCalibration() == INTERNAL))
 	{
-		camera->getCalibrationImages()[State::getInstance()->getActiveFrameCalibration()]->draw(State::getInstance()->getCalibrationVisPoints());
 		if (State::getInstance()->getCalibrationVisText() > 0 ||
 			((!camera->getCalibrationImages()[State::getInstance()->getActiveFrameCalibration()]->isCalibrated() == 1)
 				&& WizardDockWidget::getInstance()->manualCalibrationRunning()))
@@ -950,14 +953,6 @@ void GLCameraView::paintGL()
 		if (!Settings::getInstance()->getBoolSetting("TrialDrawHideAll")){
 			if ((int)Project::getInstance()->getTrials().size() > State::getInstance()->getActiveTrial() && State::getInstance()->getActiveTrial() >= 0)
 			{
-
-				Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->drawPoints(this->camera->getID(), detailedView);
-
-				if (!detailedView)
-				{
-					if (Settings::getInstance()->getBoolSetting("TrialDrawRigidBodyConstellation"))
-						Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->drawRigidBodies(this->camera);
-				}
 				if (!detailedView || Settings::getInstance()->getBoolSetting("ShowIDsInDetail"))
 				{
 					if (Settings::getInstance()->getBoolSetting("TrialDrawMarkerIds"))
@@ -976,6 +971,80 @@ void GLCameraView::paintGL()
 	glFlush();
 }
 
+void GLCameraView::drawOverlay()
+{
+	//settings which change the content of the overlay
+	static const char* overlaySettings[] = { "TrialDrawHideAll", "TrialDrawMarkers", "ShowColoredMarkerCross", "AdvancedCrosshairDetailView",
+		"Show3dPointDetailView", "DrawProjected2DpositionsForAllPoints", "TrialDrawEpipolar", "ShowEpiLineDetailView",
+		"TrialDrawRigidBodyConstellation", "TrialDrawFiltered" };
+
+	work_state workspace = State::getInstance()->getWorkspace();
+	std::vector<int> key;
+	key.push_back(State::getInstance()->getDrawRevision());
+	key.push_back(workspace);
+	key.push_back(camera->getID());
+
+	Trial* trial = NULL;
+	if (workspace == UNDISTORTION)
+	{
+		key.push_back(camera->hasUndistortion());
+		key.push_back(State::getInstance()->getUndistortionVisPoints());
+	}
+	else if (workspace == CALIBRATION)
+	{
+		key.push_back(Project::getInstance()->getCalibration());
+		key.push_back(State::getInstance()->getActiveFrameCalibration());
+		key.push_back(State::getInstance()->getCalibrationVisPoints());
+	}
+	else if (workspace == DIGITIZATION)
+	{
+		key.push_back(State::getInstance()->getActiveTrial());
+		if ((int)Project::getInstance()->getTrials().size() > State::getInstance()->getActiveTrial() && State::getInstance()->getActiveTrial() >= 0)
+		{
+			trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
+			key.push_back(trial->getActiveFrame());
+			key.push_back(trial->getActiveMarkerIdx());
+		}
+		for (const char* name : overlaySettings)
+		{
+			key.push_back(Settings::getInstance()->getBoolSetting(name));
+		}
+	}
+
+	if (!overlay)
+		overlay = new OverlayBuffer();
+
+	//the overlay is only rebuilt if the data, the frame or the settings changed, e.g. not for zooming and panning
+	if (key != overlayKey)
+	{
+		overlayKey = key;
+		overlay->clear();
+
+		if (workspace == UNDISTORTION)
+		{
+			if (camera->hasUndistortion())
+			{
+				camera->getUndistortionObject()->drawData(State::getInstance()->getUndistortionVisPoints(), *overlay);
+			}
+		}
+		else if (workspace == CALIBRATION && Project::getInstance()->getCalibration() == INTERNAL)
+		{
+			camera->getCalibrationImages()[State::getInstance()->getActiveFrameCalibration()]->draw(State::getInstance()->getCalibrationVisPoints(), *overlay);
+		}
+		else if (workspace == DIGITIZATION && trial && !Settings::getInstance()->getBoolSetting("TrialDrawHideAll"))
+		{
+			trial->drawPoints(this->camera->getID(), detailedView, *overlay);
+
+			if (!detailedView && Settings::getInstance()->getBoolSetting("TrialDrawRigidBodyConstellation"))
+			{
+				trial->drawRigidBodies(this->camera, *overlay);
+			}
+		}
+	}
+
+	overlay->render();
+}
+
 void GLCameraView::setZoomRatio(double newZoomRation, bool newAutozoom)
 {
 	newZoomRation = (newZoomRation > 100.0 / 999.0) ? newZoomRation : 100.0 / 999.0;
@@ -28,6 +28,7 @@
 #define GLWIDGET_H_
 
 #include <QOpenGLWidget>
+#include <vector>
 
 namespace xma
 {
@@ -35,6 +36,7 @@ namespace xma
 	class FrameBuffer;
 	class DistortionShader;
 	class BlendShader;
+	class OverlayBuffer;
 	class GLCameraView : public QOpenGLWidget
 	{
 		Q_OBJECT
@@ -94,6 +96,7 @@ namespace xma
 		void renderText(double x, double y, double z, const QString &str, QColor fontColor, const QFont & font = QFont());
 		void renderPointText(bool calibration);
 		void drawTexture();
+		void drawOverlay();
 		void drawQuad();
 
 		double x_test, y_test;
@@ -107,6 +110,9 @@ namespace xma
 		FrameBuffer * rigidbodyBufferUndistorted;
 		bool doDistortion;
 		bool renderMeshes;
+
+		OverlayBuffer* overlay;
+		std::vector<int> overlayKey;
 	public:
 		signals :
 
@@ -62,6 +62,7 @@
 #include "ui/EventDockWidget.h"
 #include "ui/WelcomeDialog.h"
 #include "ui/TrialImportDeleteDialog.h"
+#include "ui/ProjectAutosave.h"
 
 #include "core/Project.h"
 #include "core/Camera.h"
@@ -76,6 +77,7 @@
 #include "processing/LocalUndistortion.h"
 #include "processing/MultiCameraCalibration.h"
 #include "processing/ThreadScheduler.h"
+#include "processing/Import2DPoints.h"
 
 #include <QSplitter>
 #include <QFileDialog>
@@ -213,6 +215,8 @@ MainWindow::MainWindow(QWidget* parent) :
 	resizeTimer.setSingleShot(true);
 	connect(&resizeTimer, SIGNAL(timeout()), SLOT(resizeDone()));
 
+	ProjectAutosave::getInstance()->start();
+
 	addDockWidget(Qt::LeftDockWidgetArea, WorldViewDockWidget::getInstance());
 
 	WizardDockWidget::getInstance();
@@ -299,6 +303,7 @@ MainWindow::MainWindow(QWidget* parent) :
 MainWindow::~MainWindow()
 {
 	closeProject();
+	delete ProjectAutosave::getInstance();
 	delete GLSharedWidget::getInstance();
 	delete WizardDockWidget::getInstance();
 	delete WorldViewDockWidget::getInstance();
@@ -950,6 +955,10 @@ void MainWindow::UndistortionAfterloadProjectFinished()
 
 void MainWindow::closeProject()
 {
+	//the autosave may still copy data from the archive of the project
+	ProjectAutosave::getInstance()->waitForFinished();
+	ThreadScheduler::getInstance()->waitForFinished();
+
 	if (project)
 	{
 		//prompt for save
@@ -992,15 +1001,10 @@ void MainWindow::closeProject()
 
 void MainWindow::updateBeforeSaveProject(std::vector <Trial*> trials) {
 	if (Settings::getInstance()->getBoolSetting("RecomputeWhenSaving")) {
-		for (auto &trial : trials) {
-			if (trial->getRequiresRecomputation()) {
-				ThreadScheduler::getInstance()->updateTrialData(trial);
-			}
-		}
-		while (ThreadScheduler::getInstance()->isRunning()) {
-			QApplication::processEvents();
-		}
+		ThreadScheduler::getInstance()->recomputeTrials(trials);
 	}
+	//the snapshot must not copy trials which are still recomputed in the background
+	ThreadScheduler::getInstance()->waitForFinished();
 }
 
 void MainWindow::saveProject()
@@ -1015,6 +1019,7 @@ void MainWindow::saveProject()
 		}
 
 		updateBeforeSaveProject(project->getTrials());
+		ProjectAutosave::getInstance()->waitForFinished();
 
 		m_FutureWatcher = new QFutureWatcher<int>();
 		connect(m_FutureWatcher, SIGNAL( finished() ), this, SLOT( saveProjectFinished() ));
@@ -1050,6 +1055,7 @@ void MainWindow::saveProjectAs(bool subset)
 
 			if (!subset){
 				updateBeforeSaveProject(project->getTrials());
+				ProjectAutosave::getInstance()->waitForFinished();
 
 				m_FutureWatcher = new QFutureWatcher<int>();
 				connect(m_FutureWatcher, SIGNAL(finished()), this, SLOT(saveProjectFinished()));
@@ -1069,6 +1075,7 @@ void MainWindow::saveProjectAs(bool subset)
 				if (ok)
 				{
 					updateBeforeSaveProject(diag->getTrials());
+					ProjectAutosave::getInstance()->waitForFinished();
 
 					m_FutureWatcher = new QFutureWatcher<int>();
 					connect(m_FutureWatcher, SIGNAL(finished()), this, SLOT(saveProjectFinished()));
@@ -1269,6 +1276,7 @@ void MainWindow::saveProjectFinished()
 
 void MainWindow::redrawGL()
 {
+	State::getInstance()->invalidateDraw();
 	if (!State::getInstance()->getDisableDraw())
 	{
 		for (unsigned int i = 0; i < cameraViews.size(); i++)
@@ -2137,8 +2145,6 @@ void MainWindow::on_actionImport2D_Points_triggered(bool checked)
 {
 	PointImportExportDialog* diag = new PointImportExportDialog(IMPORT2D, this);
 
-	int loadPoints = 0;
-
 	diag->exec();
 	if (diag->result())
 	{
@@ -2147,28 +2153,32 @@ void MainWindow::on_actionImport2D_Points_triggered(bool checked)
 
 		if (!fileNames.isEmpty())
 		{
-			ProgressDialog::getInstance()->showProgressbar(0, 0, "Importing points");
-			for (int i = 0; i < fileNames.size(); i++)
-			{
-				loadPoints += Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->load2dPoints(fileNames.at(i)
-																				       ,Settings::getInstance()->getBoolSetting("Import2DDistorted")
-																				       ,Settings::getInstance()->getBoolSetting("Import2DCount1")
-																				       ,Settings::getInstance()->getBoolSetting("Import2DYUp")
-																				       ,Settings::getInstance()->getBoolSetting("Import2DHeader")
-																				       ,Settings::getInstance()->getBoolSetting("Import2DOffsetCols")
-																					   , Settings::getInstance()->getBoolSetting("ImportStatusSet"));
-			}
-			ProgressDialog::getInstance()->closeProgressbar();
 			Settings::getInstance()->setLastUsedDirectory(fileNames.at(0));
-		}
 
-		redrawGL();
-		PointsDockWidget::getInstance()->reloadListFromObject();
-		PlotWindow::getInstance()->updateMarkers(true);
+			Import2DPoints* import = new Import2DPoints(Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()], fileNames
+														, Settings::getInstance()->getBoolSetting("Import2DDistorted")
+														, Settings::getInstance()->getBoolSetting("Import2DCount1")
+														, Settings::getInstance()->getBoolSetting("Import2DYUp")
+														, Settings::getInstance()->getBoolSetting("Import2DHeader")
+														, Settings::getInstance()->getBoolSetting("Import2DOffsetCols")
+														, Settings::getInstance()->getBoolSetting("ImportStatusSet"));
+			connect(import, SIGNAL(signal_progress(double)), ProgressDialog::getInstance(), SLOT(setProgress(double)));
+			connect(import, SIGNAL(signal_finished()), this, SLOT(import2DPointsFinished()));
+			ProgressDialog::getInstance()->showProgressbar(0, 100, "Importing points");
+			import->start();
+		}
 	}
 	delete diag;
 }
 
+void MainWindow::import2DPointsFinished()
+{
+	ProgressDialog::getInstance()->closeProgressbar();
+	redrawGL();
+	PointsDockWidget::getInstance()->reloadListFromObject();
+	PlotWindow::getInstance()->updateMarkers(true);
+}
+
 void MainWindow::on_actionImportTrial_triggered(bool checked)
 {
 	QString fileName = QFileDialog::getOpenFileName(this,
@@ -2191,6 +2201,7 @@ void MainWindow::on_actionImportTrial_triggered(bool checked)
 				if (trial->getIsDefault() && project->hasDefaultTrial())
 				{
 					if (ConfirmationDialog::getInstance()->showConfirmationDialog("You are about to replace your current Default trial. Are you sure you want to update it?")){
+						ThreadScheduler::getInstance()->waitForFinished();
 						Project::getInstance()->replaceTrial(Project::getInstance()->getDefaultTrail(), trial);
 					}
 					else
@@ -2241,6 +2252,7 @@ void MainWindow::on_actionDelete_multiple_trials_triggered(bool checked)
 			text_message += (str + QString("\n"));
 		if (ConfirmationDialog::getInstance()->showConfirmationDialog(text_message))
 		{
+			ThreadScheduler::getInstance()->waitForFinished();
 			for (auto &item : selected){
 				Trial* trial = Project::getInstance()->getTrialByName(item);
 				Project::getInstance()->deleteTrial(trial);
@@ -124,6 +124,7 @@ namespace xma
 		void UndistortionAfterloadProjectFinished();
 		void saveProjectFinished();
 		void newProjectFinished();
+		void import2DPointsFinished();
 
 		//custom slots for state
 		void workspaceChanged(work_state workspace);
@@ -420,6 +420,7 @@ void MarkerTreeWidget::action_ChangePoint_triggered()
 						bodiesToUpdate.push_back((*it));
 					}
 				}
+				Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->beginEdit();
 				for (int c = startCamera; c <= endCamera; c++)
 				{
 					for (int f = startFrame; f <= endFrame; f++)
@@ -436,6 +437,7 @@ void MarkerTreeWidget::action_ChangePoint_triggered()
 						Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getMarkers()[idx2]->setPoint(c, f,tmpx,tmpy,tmpStatus);
 					}
 				}
+				Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->commitEdit();
 
 				for (std::vector<RigidBody*>::iterator it = bodiesToUpdate.begin(); it != bodiesToUpdate.end(); ++it)
 				{
@@ -494,6 +496,7 @@ void MarkerTreeWidget::action_ResetPoints_triggered()
 	if (ok)
 	{
 		if (!ConfirmationDialog::getInstance()->showConfirmationDialog("Are you sure you want to reset the data for the selected Points?")) return;
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->beginEdit();
 		for (int i = 0; i < items.size(); i++)
 		{
 			if (items.at(i)->type() == MARKER)
@@ -502,6 +505,7 @@ void MarkerTreeWidget::action_ResetPoints_triggered()
 				                                                                                                                                                        fromTo->getFrom() - 1, fromTo->getTo() - 1);
 			}
 		}
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->commitEdit();
 		MainWindow::getInstance()->redrawGL();
 	}
 	delete fromTo;
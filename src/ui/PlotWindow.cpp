@@ -691,11 +691,13 @@ void PlotWindow::deleteData()
 	else if (dock->comboBoxPlotType->currentIndex() == 4 || dock->comboBoxPlotType->currentIndex() == 5)
 	{
 		if (!ConfirmationDialog::getInstance()->showConfirmationDialog("Are you sure you want to delete your data for " + cameras + " for all marker of Rigid Body " + dock->comboBoxRigidBody->currentText() + " from Frame " + QString::number(frameStart + 1) + " to " + QString::number(frameEnd + 1))) return;
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->beginEdit();
 		for (unsigned int i = 0; i < Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getRigidBodies()[dock->comboBoxRigidBody->currentIndex()]->getPointsIdx().size(); i++)
 		{
 			int idx = Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getRigidBodies()[dock->comboBoxRigidBody->currentIndex()]->getPointsIdx()[i];
 			Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getMarkers()[idx]->resetMultipleFrames(cam, frameStart, frameEnd);
 		}
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->commitEdit();
 
 		on_pushButtonUpdate_clicked();
 	}
@@ -1375,6 +1377,7 @@ void PlotWindow::deleteAllAboveError()
 		if (!ConfirmationDialog::getInstance()->showConfirmationDialog("Are you sure you want to delete your data for " + dock->comboBoxCamera->currentText() + " for Marker " + dock->comboBoxMarker1->currentText() + " for all frames with reprojection error higher than " + QString::number(dock->doubleSpinBoxError->value())))
 			return;
 
+		Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->beginEdit();
 		for (int i = 0; i < Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getNbImages(); i++)
 		{
 			if (isFrameAboveError(marker, i))
@@ -1393,6 +1396,7 @@ void PlotWindow::deleteAllAboveError()
 				}			
 			}
 		}
+		Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->commitEdit();
 	}
 	else if (dock->comboBoxPlotType->currentIndex() == 5)
 	{
@@ -1403,6 +1407,7 @@ void PlotWindow::deleteAllAboveError()
 			if (!ConfirmationDialog::getInstance()->showConfirmationDialog("Are you sure you want to delete your data for RigidBody " + dock->comboBoxRigidBody->currentText() + " for all frames with error higher than " + QString::number(dock->doubleSpinBoxErrorRB->value())))
 				return;
 
+			Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->beginEdit();
 			for (int i = 0; i < Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getNbImages(); i++)
 			{
 				if (isFrameAboveError(body, i))
@@ -1416,6 +1421,7 @@ void PlotWindow::deleteAllAboveError()
 					}
 				}
 			}
+			Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->commitEdit();
 		}
 	}
 	MainWindow::getInstance()->redrawGL();
@@ -3095,11 +3101,13 @@ void PlotWindow::setUntrackable()
 	else if (dock->comboBoxPlotType->currentIndex() == 4 || dock->comboBoxPlotType->currentIndex() == 5)
 	{
 		if (!ConfirmationDialog::getInstance()->showConfirmationDialog("Are you sure you want to delete your data and set it to untrackable for all markers of Rigid Body " + dock->comboBoxRigidBody->currentText() + " from Frame " + QString::number(frameStart + 1) + " to " + QString::number(frameEnd + 1))) return;
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->beginEdit();
 		for (unsigned int i = 0; i < Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getRigidBodies()[dock->comboBoxRigidBody->currentIndex()]->getPointsIdx().size(); i++)
 		{
 			int idx = Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getRigidBodies()[dock->comboBoxRigidBody->currentIndex()]->getPointsIdx()[i];
 			Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->getMarkers()[idx]->resetMultipleFrames(cam, frameStart, frameEnd, true);
 		}
+		Project::getInstance()->getTrials()[xma::State::getInstance()->getActiveTrial()]->commitEdit();
 
 		on_pushButtonUpdate_clicked();
 	}
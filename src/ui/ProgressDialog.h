@@ -55,13 +55,13 @@ namespace xma
 		~ProgressDialog() override;
 		static ProgressDialog* getInstance();
 
-		void setProgress(double progress);
 		void showProgressbar(int min, int max, const char* key = "Computing", bool cancelable = false);
 		void closeProgressbar();
 
 		bool getIsCanceled() const;
 
 	public slots:
+		void setProgress(double progress);
 		void on_cancelButton_clicked(); 
 #ifdef __APPLE__
 		void update();
@@ -0,0 +1,220 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file ProjectAutosave.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "ui/ProjectAutosave.h"
+#include "ui/ProjectFileIO.h"
+#include "ui/ProjectSnapshot.h"
+#include "ui/ProgressDialog.h"
+
+#include "core/Project.h"
+#include "core/Settings.h"
+#include "core/Camera.h"
+#include "core/Trial.h"
+
+#include "processing/ThreadedProcessing.h"
+#include "processing/ThreadScheduler.h"
+#include "processing/MarkerDetection.h"
+#include "processing/MarkerTracking.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
+
+#include <iostream>
+#include <algorithm>
+
+#ifdef WIN32
+#define OS_SEP "\\"
+#else
+	#define OS_SEP "/"
+#endif
+
+using namespace xma;
+
+ProjectAutosave* ProjectAutosave::instance = NULL;
+
+ProjectAutosave::ProjectAutosave() : m_FutureWatcher(NULL), snapshot(NULL)
+{
+	connect(&timer, SIGNAL(timeout()), SLOT(timeout()));
+}
+
+ProjectAutosave::~ProjectAutosave()
+{
+	stop();
+	waitForFinished();
+	instance = NULL;
+}
+
+ProjectAutosave* ProjectAutosave::getInstance()
+{
+	if (!instance)
+	{
+		instance = new ProjectAutosave();
+	}
+	return instance;
+}
+
+void ProjectAutosave::start()
+{
+	timer.stop();
+	updateInterval();
+}
+
+bool ProjectAutosave::updateInterval()
+{
+	int interval = Settings::getInstance()->getIntSetting("AutosaveInterval");
+	//a disabled autosave keeps checking the setting every minute
+	int msec = std::max(1, interval) * 60 * 1000;
+	if (!timer.isActive() || timer.interval() != msec)
+		timer.start(msec);
+
+	return interval > 0;
+}
+
+void ProjectAutosave::stop()
+{
+	timer.stop();
+}
+
+bool ProjectAutosave::isRunning()
+{
+	return m_FutureWatcher != NULL;
+}
+
+void ProjectAutosave::waitForFinished()
+{
+	if (m_FutureWatcher)
+	{
+		m_FutureWatcher->waitForFinished();
+		autosaveFinished();
+	}
+}
+
+QString ProjectAutosave::getAutosaveFolder()
+{
+	return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + OS_SEP + "autosave";
+}
+
+bool ProjectAutosave::canTakeSnapshot()
+{
+	//the project has to be in a consistent state, which is not the case while it is processed or edited in a dialog
+	if (Project::getInstance()->getCameras().empty())
+		return false;
+	if (ThreadedProcessing::isRunning() || MarkerDetection::isRunning() || MarkerTracking::isRunning() || ThreadScheduler::getInstance()->isRunning())
+		return false;
+	if (ProgressDialog::getInstance()->isVisible() || QApplication::activeModalWidget() != NULL)
+		return false;
+
+	return Project::getInstance()->isDirty() && getRevisions() != savedRevisions;
+}
+
+std::vector<std::pair<void*, int> > ProjectAutosave::getRevisions()
+{
+	std::vector<std::pair<void*, int> > revisions;
+	for (auto camera : Project::getInstance()->getCameras())
+		revisions.push_back(std::make_pair((void*) camera, camera->getRevision()));
+	for (auto trial : Project::getInstance()->getTrials())
+		revisions.push_back(std::make_pair((void*) trial, trial->getDataRevision()));
+	return revisions;
+}
+
+void ProjectAutosave::timeout()
+{
+	if (!updateInterval() || m_FutureWatcher || !canTakeSnapshot())
+		return;
+
+	QString folder = getAutosaveFolder();
+	if (!QDir().mkpath(folder))
+	{
+		std::cerr << "Autosave: Can not create folder " << folder.toStdString() << std::endl;
+		return;
+	}
+
+	basename = Project::getInstance()->getProjectBasename();
+	if (basename.isEmpty())
+		basename = "untitled";
+	filename = folder + OS_SEP + basename + "_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".xma";
+
+	savedRevisions = getRevisions();
+	snapshot = ProjectFileIO::getInstance()->createSnapshot(QDir::tempPath() + OS_SEP + "XROMM_autosave_tmp" + OS_SEP,
+		Project::getInstance()->getTrials(), false, true);
+
+	m_FutureWatcher = new QFutureWatcher<bool>();
+	connect(m_FutureWatcher, SIGNAL(finished()), this, SLOT(autosaveFinished()));
+
+	ProjectSnapshot* s = snapshot;
+	QString f = filename;
+	QFuture<bool> future = QtConcurrent::run([s, f]() -> bool {
+		return ProjectFileIO::getInstance()->writeSnapshot(s, f, true);
+	});
+	m_FutureWatcher->setFuture(future);
+}
+
+void ProjectAutosave::autosaveFinished()
+{
+	//called by the signal and by waitForFinished, whichever comes first
+	if (!m_FutureWatcher)
+		return;
+
+	bool success = m_FutureWatcher->result();
+	delete m_FutureWatcher;
+	m_FutureWatcher = NULL;
+
+	if (success)
+	{
+		std::cout << "Autosaved " << filename.toStdString() << " : snapshot " << snapshot->getSnapshotTime() << " ms (" << snapshot->getNbMarkers() << " markers copied), serialization "
+			<< snapshot->getSerializationTime() << " ms" << std::endl;
+		removeOldAutosaves(basename);
+	}
+	else
+	{
+		std::cerr << "Autosave to " << filename.toStdString() << " failed" << std::endl;
+		savedRevisions.clear();
+	}
+
+	delete snapshot;
+	snapshot = NULL;
+}
+
+void ProjectAutosave::removeOldAutosaves(QString name)
+{
+	int retention = std::max(1, Settings::getInstance()->getIntSetting("AutosaveRetention"));
+
+	QDir dir(getAutosaveFolder());
+	//the timestamp sorts the files by age
+	QStringList files = dir.entryList(QStringList() << name + "_????????_??????.xma", QDir::Files, QDir::Name | QDir::Reversed);
+	for (int i = retention; i < files.size(); i++)
+	{
+		QFile::remove(dir.absoluteFilePath(files[i]));
+	}
+}
@@ -0,0 +1,87 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file ProjectAutosave.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef PROJECTAUTOSAVE_H
+#define PROJECTAUTOSAVE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QFutureWatcher>
+
+#include <vector>
+
+namespace xma
+{
+	class ProjectSnapshot;
+
+	/// Periodically writes a copy of the project to the autosave folder. A snapshot of the project is
+	/// taken on the GUI thread and serialized in the background, so the user can continue working.
+	/// Autosaves do not change the project filename or the saved state of the project.
+	class ProjectAutosave : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		static ProjectAutosave* getInstance();
+		virtual ~ProjectAutosave();
+
+		//Starts the timer with the interval in minutes from the settings, an interval of 0 disables autosaving.
+		//The setting is read again whenever the timer fires.
+		void start();
+		void stop();
+
+		bool isRunning();
+		//Blocks until a running autosave is written
+		void waitForFinished();
+
+		static QString getAutosaveFolder();
+
+	private slots:
+		void timeout();
+		void autosaveFinished();
+
+	private:
+		ProjectAutosave();
+		static ProjectAutosave* instance;
+
+		//Returns false if autosaving is disabled
+		bool updateInterval();
+		bool canTakeSnapshot();
+		//Revisions of all cameras and trials, the project is only autosaved if they differ from the last autosave
+		std::vector<std::pair<void*, int> > getRevisions();
+		//Keeps the newest files of the project as given by the AutosaveRetention setting
+		void removeOldAutosaves(QString name);
+
+		QTimer timer;
+		QFutureWatcher<bool>* m_FutureWatcher;
+		ProjectSnapshot* snapshot;
+		QString filename;
+		QString basename;
+		std::vector<std::pair<void*, int> > savedRevisions;
+	};
+}
+
+#endif // PROJECTAUTOSAVE_H
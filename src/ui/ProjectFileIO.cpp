@@ -37,6 +37,7 @@
 #include "ui/WorkspaceNavigationFrame.h"
 #include "ui/NewProjectDialog.h"
 #include "ui/NewTrialDialog.h"
+#include "ui/ProjectSnapshot.h"
 
 #include "core/Project.h" 
 #include "core/Camera.h" 
@@ -54,12 +55,21 @@
 #include <QXmlStreamWriter>
 #include <QFileInfo>
 #include <QFile>
+#include <QElapsedTimer>
+#include <QSet>
 
 #include "quazip.h"
 #include "quazipfile.h"
 
+#include <iostream>
+#include <cstdio>
+
 #ifdef WIN32
 #define OS_SEP "\\"
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #else
 	#define OS_SEP "/"
 #endif
@@ -67,9 +77,37 @@
 
 using namespace xma;
 
+namespace
+{
+	//Entries are selected by prefix. A numbered prefix like Marker001 must not select Marker0010.
+	bool isSelectedEntry(QString name, const QStringList& prefixes)
+	{
+		name.replace('\\', '/');
+		for (const QString& prefix : prefixes)
+		{
+			if (name.startsWith(prefix) && (name.length() == prefix.length() || prefix.endsWith('/') || !name.at(prefix.length()).isDigit()))
+				return true;
+		}
+		return false;
+	}
+
+	//Errors of snapshots written in the background are printed instead of opening a dialog
+	thread_local bool quietErrors = false;
+
+	//Renames source to destination, replacing destination in a single step
+	bool replaceFile(const QString& source, const QString& destination)
+	{
+#ifdef WIN32
+		return MoveFileExW(reinterpret_cast<LPCWSTR>(source.utf16()), reinterpret_cast<LPCWSTR>(destination.utf16()), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return std::rename(QFile::encodeName(source).constData(), QFile::encodeName(destination).constData()) == 0;
+#endif
+	}
+}
+
 ProjectFileIO* ProjectFileIO::instance = NULL;
 
-ProjectFileIO::ProjectFileIO()
+ProjectFileIO::ProjectFileIO() : headless(false)
 {
 }
 
@@ -78,6 +116,28 @@ ProjectFileIO::~ProjectFileIO()
 	instance = NULL;
 }
 
+void ProjectFileIO::setHeadless(bool value)
+{
+	headless = value;
+}
+
+bool ProjectFileIO::isHeadless()
+{
+	return headless;
+}
+
+void ProjectFileIO::showError(const QString& message)
+{
+	if (headless || quietErrors)
+	{
+		std::cerr << "Error: " << message.toStdString() << std::endl;
+	}
+	else
+	{
+		ErrorDialog::getInstance()->showErrorDialog(message);
+	}
+}
+
 ProjectFileIO* ProjectFileIO::getInstance()
 {
 	if (!instance)
@@ -117,14 +177,42 @@ bool ProjectFileIO::removeDir(QString folder)
 
 int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bool subset)
 {
-	bool success = true;
 	if (!subset)
 		Project::getInstance()->projectFilename = filename;
-	
-	QString tmpDir_path = QDir::tempPath() + OS_SEP + "XROMM_tmp" + OS_SEP;
+
+	ProjectSnapshot* snapshot = createSnapshot(QDir::tempPath() + OS_SEP + "XROMM_tmp" + OS_SEP, trials, subset);
+	bool success = writeSnapshot(snapshot, filename);
+
+	if (success && !subset)
+	{
+		Project::getInstance()->setDirty(false);
+		cleanArchive = filename;
+	}
+
+	std::cout << "Saved " << filename.toStdString() << (snapshot->isIncremental() ? " incrementally" : "") << " in " << snapshot->getSnapshotTime() + snapshot->getSerializationTime() << " ms"
+		<< " (snapshot " << snapshot->getSnapshotTime() << " ms, serialization " << snapshot->getSerializationTime() << " ms)" << std::endl;
+
+	delete snapshot;
+
+	return success ? 0 : -1;
+}
+
+ProjectSnapshot* ProjectFileIO::createSnapshot(QString tmpDir_path, std::vector <Trial*> trials, bool subset, bool autosave)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	bool success = true;
+
+	//Unchanged cameras, markers and rigid bodies are copied from the archive the project was last saved to or loaded from
+	QString previousArchive = (!subset && QFile::exists(cleanArchive)) ? cleanArchive : QString("");
+	bool incremental = !previousArchive.isEmpty();
+	ProjectSnapshot* snapshot = new ProjectSnapshot(tmpDir_path, previousArchive);
+
+	removeDir(tmpDir_path);
 	if (!QDir().mkpath(tmpDir_path))
 	{
-		ErrorDialog::getInstance()->showErrorDialog("Can not create tmp folder " + tmpDir_path);
+		showError("Can not create tmp folder " + tmpDir_path);
 		success = false;
 	}
 
@@ -142,7 +230,7 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 			QString path = tmpDir_path + "projectMetaData";
 			if (!QDir().mkpath(path))
 			{
-				ErrorDialog::getInstance()->showErrorDialog("Can not create tmp folder " + path);
+				showError("Can not create tmp folder " + path);
 				success = false;
 			}
 			Project::getInstance()->saveXMLData(path + OS_SEP + "metadata.xml");
@@ -155,17 +243,22 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 		for (std::vector<Camera*>::const_iterator it = Project::getInstance()->getCameras().begin(); it != Project::getInstance()->getCameras().end(); ++it)
 		{
 			QString camera_path = tmpDir_path + (*it)->getName() + OS_SEP;
-			if (success)
+			if (incremental && !(*it)->isDirty())
+			{
+				snapshot->addCopiedEntry((*it)->getName() + "/");
+			}
+			else if (success)
 			{
 				if (!QDir().mkpath(camera_path))
 				{
-					ErrorDialog::getInstance()->showErrorDialog("Can not create tmp folder " + camera_path);
+					showError("Can not create tmp folder " + camera_path);
 					success = false;
 				}
 				else
 				{
 					QDir().mkpath(camera_path + OS_SEP + "data");
 					(*it)->save(camera_path);
+					snapshot->addCameraImages(*it, camera_path);
 				}
 			}
 		}
@@ -179,7 +272,7 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 			QString path = tmpDir_path + OS_SEP + "CalibrationObject" + OS_SEP;
 			if (!QDir().mkpath(path))
 			{
-				ErrorDialog::getInstance()->showErrorDialog("Can not create tmp folder " + path);
+				showError("Can not create tmp folder " + path);
 				success = false;
 			}
 			else
@@ -193,7 +286,12 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 	{
 		for (std::vector<Trial*>::const_iterator trial_it = trials.begin(); trial_it != trials.end(); ++trial_it)
 		{
-			if (!((*trial_it)->getRequiresRecomputation())) {
+			if (!((*trial_it)->getRequiresRecomputation()) && incremental && !(*trial_it)->isDirty()) {
+				snapshot->addCopiedEntry("PrecisionInfo_" + (*trial_it)->getName() + ".txt");
+				snapshot->addCopiedEntry("MarkerDistances_" + (*trial_it)->getName() + ".txt");
+			}
+			else if (!((*trial_it)->getRequiresRecomputation()) && !autosave) {
+				//derived from the markers and not needed to restore the project, autosaves skip it
 				(*trial_it)->savePrecisionInfo(tmpDir_path + OS_SEP + "PrecisionInfo_" + (*trial_it)->getName() + ".txt", 0, (*trial_it)->getNbImages());
 				(*trial_it)->saveMarkerToMarkerDistances(tmpDir_path + OS_SEP + "MarkerDistances_" + (*trial_it)->getName() + ".txt", 0, (*trial_it)->getNbImages());
 			}
@@ -202,7 +300,7 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 			QString path = tmpDir_path + OS_SEP + (*trial_it)->getName() + OS_SEP;
 			if (!QDir().mkpath(path))
 			{
-				ErrorDialog::getInstance()->showErrorDialog("Can not create tmp folder " + path);
+				showError("Can not create tmp folder " + path);
 				success = false;
 			}
 			else
@@ -222,26 +320,23 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 				}
 				for (unsigned int k = 0; k < (*trial_it)->getMarkers().size(); k++)
 				{
-					QString markerFilename = QString("Marker%1points2d.csv").arg(k, 3, 10, QChar('0'));
-					QString statusFilename = QString("Marker%1status2d.csv").arg(k, 3, 10, QChar('0'));
-					QString sizeFilename = QString("Marker%1size.csv").arg(k, 3, 10, QChar('0'));
-					QString points3DFilename = QString("Marker%1points3d.csv").arg(k, 3, 10, QChar('0'));
-					QString status3DFilename = QString("Marker%1status3d.csv").arg(k, 3, 10, QChar('0'));
-
-					(*trial_it)->getMarkers()[k]->save(path + OS_SEP + "data" + OS_SEP + markerFilename,
-					                                   path + OS_SEP + "data" + OS_SEP + statusFilename,
-					                                   path + OS_SEP + "data" + OS_SEP + sizeFilename);
-					(*trial_it)->getMarkers()[k]->save3DPoints(path + OS_SEP + "data" + OS_SEP + points3DFilename,
-					                                           path + OS_SEP + "data" + OS_SEP + status3DFilename);
-					(*trial_it)->getMarkers()[k]->saveInterpolation(path + OS_SEP + "data" + OS_SEP + QString("Marker%1interpolation.csv").arg(k, 3, 10, QChar('0')));
-
-					if ((*trial_it)->getMarkers()[k]->Reference3DPointSet())
+					if (incremental && !(*trial_it)->getMarkers()[k]->isDirty())
 					{
-						(*trial_it)->getMarkers()[k]->saveReference3DPoint(path + OS_SEP + "data" + OS_SEP + QString("Marker%1reference3Dpoint.csv").arg(k, 3, 10, QChar('0')));
+						snapshot->addCopiedEntry((*trial_it)->getName() + "/data/" + QString("Marker%1").arg(k, 3, 10, QChar('0')));
+						continue;
 					}
+
+					//the marker data is copied and written when the snapshot is serialized
+					snapshot->addMarker(*trial_it, k, path + OS_SEP + "data");
 				}
 				for (unsigned int k = 0; k < (*trial_it)->getRigidBodies().size(); k++)
 				{
+					if (incremental && !(*trial_it)->getRigidBodies()[k]->isDirty())
+					{
+						snapshot->addCopiedEntry((*trial_it)->getName() + "/data/" + QString("RigidBody%1").arg(k, 3, 10, QChar('0')));
+						continue;
+					}
+
 					if ((*trial_it)->getRigidBodies()[k]->isReferencesSet() == 2)
 					{
 						(*trial_it)->getRigidBodies()[k]->save(
@@ -266,13 +361,47 @@ int ProjectFileIO::saveProject(QString filename, std::vector <Trial*> trials, bo
 	}
 
 	//save Log
-	ConsoleDockWidget::getInstance()->save(tmpDir_path + OS_SEP + "log.html");
+	if (!headless)
+		ConsoleDockWidget::getInstance()->save(tmpDir_path + OS_SEP + "log.html");
 
-	zipFromFolderToFile(filename, tmpDir_path, "XROMM Project File");
+	snapshot->setValid(success);
+	snapshot->setSnapshotTime(timer.elapsed());
 
-	removeDir(tmpDir_path);
+	return snapshot;
+}
 
-	return success ? 0 : -1;
+bool ProjectFileIO::writeSnapshot(ProjectSnapshot* snapshot, QString filename, bool quiet)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	quietErrors = quiet;
+
+	bool success = snapshot->isValid();
+	if (success)
+	{
+		snapshot->writeCameraImages();
+		snapshot->writeMarkers();
+	}
+
+	//the archive is written next to the project and replaces it once complete
+	QString tmpArchive = filename + ".tmp";
+	if (success)
+		success = zipFromFolderToFile(tmpArchive, snapshot->getFolder(), "XROMM Project File", snapshot->getPreviousArchive(), snapshot->getCopiedEntries());
+	if (success && !replaceFile(tmpArchive, filename))
+	{
+		showError("Can not replace " + filename);
+		success = false;
+	}
+	if (!success)
+		QFile::remove(tmpArchive);
+
+	removeDir(snapshot->getFolder());
+
+	quietErrors = false;
+	snapshot->setSerializationTime(timer.elapsed());
+
+	return success;
 }
 
 int ProjectFileIO::loadProject(QString filename, QString filename_extraCalib)
@@ -291,7 +420,10 @@ int ProjectFileIO::loadProject(QString filename, QString filename_extraCalib)
 	if (QFile::exists(tmpDir_path + OS_SEP + "project.xml"))
 	{
 		readProjectFile(tmpDir_path + OS_SEP + "project.xml");
-		ConsoleDockWidget::getInstance()->load(tmpDir_path + OS_SEP + "log.html");
+		//a project merged from two files is written completely on the next save
+		cleanArchive = filename_extraCalib.isEmpty() ? filename : QString("");
+		if (!headless)
+			ConsoleDockWidget::getInstance()->load(tmpDir_path + OS_SEP + "log.html");
 	}
 	else
 	{
@@ -316,7 +448,8 @@ int ProjectFileIO::loadProject(QString filename, QString filename_extraCalib)
 		Project::getInstance()->projectFilename = filename;
 
 		for (int i = Project::getInstance()->getTrials().size() - 1; i >= 0; i--) {
-			WorkspaceNavigationFrame::getInstance()->removeTrial(Project::getInstance()->getTrials()[i]->getName());
+			if (!headless)
+				WorkspaceNavigationFrame::getInstance()->removeTrial(Project::getInstance()->getTrials()[i]->getName());
 			Project::getInstance()->deleteTrial(Project::getInstance()->getTrials()[i]);	
 		}
 
@@ -326,7 +459,8 @@ int ProjectFileIO::loadProject(QString filename, QString filename_extraCalib)
 			Trial* trial = loadTrials(filename, item);
 			trial->setRequiresRecomputation(true);
 			Project::getInstance()->addTrial(trial);
-			WorkspaceNavigationFrame::getInstance()->addTrial(item);
+			if (!headless)
+				WorkspaceNavigationFrame::getInstance()->addTrial(item);
 		}
 	}
 
@@ -376,7 +510,7 @@ QStringList ProjectFileIO::readTrials(QString filename)
 					}
 					if (xml.hasError())
 					{
-						ErrorDialog::getInstance()->showErrorDialog(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
+						showError(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
 					}
 					file.close();
 				}
@@ -439,7 +573,7 @@ Trial* ProjectFileIO::loadTrials(QString filename, QString trialname)
 										trial = new Trial();
 									}
 									else{
-										trial = new Trial(_trialname, littleHelper::adjustPathToOS(trialfolder));
+										trial = new Trial(_trialname, littleHelper::adjustPathToOS(trialfolder), attr.value("VideoInfo").toString());
 									}
 									int startFrame = attr.value("startFrame").toString().toInt();
 									trial->setStartFrame(startFrame);
@@ -662,7 +796,7 @@ Trial* ProjectFileIO::loadTrials(QString filename, QString trialname)
 					}
 					if (xml.hasError())
 					{
-						ErrorDialog::getInstance()->showErrorDialog(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
+						showError(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
 					}
 					file.close();
 				}
@@ -859,7 +993,7 @@ void ProjectFileIO::loadMarker(QString filename, QString trialname, Trial* trial
 					}
 					if (xml.hasError())
 					{
-						ErrorDialog::getInstance()->showErrorDialog(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
+						showError(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
 					}
 					file.close();
 				}
@@ -1011,7 +1145,7 @@ void ProjectFileIO::loadXMAPortalTrial(QString filename, NewTrialDialog* dialog)
 	} 
 	else
 	{
-		ErrorDialog::getInstance()->showErrorDialog("Not a valid xma file from the portal");
+		showError("Not a valid xma file from the portal");
 	}
 	removeDir(tmpDir_path);
 }
@@ -1629,6 +1763,8 @@ bool ProjectFileIO::writeProjectFile(QString filename, std::vector<Trial*> trial
 				xmlWriter.writeAttribute("cutOffFrequency", QString::number((*trial_it)->getCutoffFrequency()));
 				xmlWriter.writeAttribute("interpolate3D", QString::number((*trial_it)->getInterpolate3D()));
 				xmlWriter.writeAttribute("nbImages", QString::number((*trial_it)->getNbImages()));
+				if (!(*trial_it)->getIsDefault())
+					xmlWriter.writeAttribute("VideoInfo", (*trial_it)->getVideoInfo());
 
 				if ((*trial_it)->getHasStudyData()){
 					xmlWriter.writeAttribute("MetaData", (*trial_it)->getName() + OS_SEP + QString("metadata.xml"));
@@ -1957,7 +2093,7 @@ bool ProjectFileIO::readProjectFile(QString filename)
 							if (cam->getCalibrationImages().size() > 0){
 								if (!cam->setResolutions())
 								{
-									ErrorDialog::getInstance()->showErrorDialog(cam->getName() + " : Resolutions do not match");
+									showError(cam->getName() + " : Resolutions do not match");
 									return false;
 								}
 							}
@@ -1999,7 +2135,7 @@ bool ProjectFileIO::readProjectFile(QString filename)
 								trial = new Trial();
 							}
 							else{
-								trial = new Trial(trialname, littleHelper::adjustPathToOS(trialfolder));
+								trial = new Trial(trialname, littleHelper::adjustPathToOS(trialfolder), attr.value("VideoInfo").toString());
 							}
 							int startFrame = attr.value("startFrame").toString().toInt();
 							trial->setStartFrame(startFrame);
@@ -2232,13 +2368,14 @@ bool ProjectFileIO::readProjectFile(QString filename)
 
 
 							Project::getInstance()->addTrial(trial);
-							WorkspaceNavigationFrame::getInstance()->addTrial(trialname);
+							if (!headless)
+								WorkspaceNavigationFrame::getInstance()->addTrial(trialname);
 						}
 					}
 				}
 				if (xml.hasError())
 				{
-					ErrorDialog::getInstance()->showErrorDialog(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
+					showError(QString("QXSRExample::parseXML %1").arg(xml.errorString()));
 				}
 				file.close();
 
@@ -2254,6 +2391,9 @@ bool ProjectFileIO::readProjectFile(QString filename)
 		}
 	}
 
+	//the loaded data matches the archive, upgraded markers are marked as changed
+	Project::getInstance()->setDirty(false);
+
 	if (version < 0.2)
 	{
 		for (std::vector<Trial*>::const_iterator it = Project::getInstance()->getTrials().begin(); it < Project::getInstance()->getTrials().end(); ++it)
@@ -2291,7 +2431,7 @@ void ProjectFileIO::recurseAddDir(QDir d, QStringList& list)
 		}
 }
 
-bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir, const QString& comment)
+bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir, const QString& comment, const QString& sourceArchive, const QStringList& sourceEntries)
 {
 	//Make sure the zip file does not exist
 	if (QFile::exists(filePath))
@@ -2304,13 +2444,13 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 
 	if (!zip.open(QuaZip::mdCreate))
 	{
-		ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): zip.open(): %1").arg(zip.getZipError()));
+		showError(QString("zipFromFolderToFile(): zip.open(): %1").arg(zip.getZipError()));
 		return false;
 	}
 
 	if (!dir.exists())
 	{
-		ErrorDialog::getInstance()->showErrorDialog(QString("dir.exists(%1)=FALSE").arg(dir.absolutePath()));
+		showError(QString("dir.exists(%1)=FALSE").arg(dir.absolutePath()));
 		return false;
 	}
 
@@ -2323,8 +2463,10 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 	foreach (QString fn, sl) files << QFileInfo(fn);
 
 	QuaZipFile outFile(&zip);
+	QSet<QString> written;
 
-	char c;
+	QByteArray buffer;
+	const qint64 blockSize = 1 << 20;
 	foreach(QFileInfo fileInfo, files)
 		{
 			if (!fileInfo.isFile())
@@ -2336,20 +2478,20 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 
 			if (!inFile.open(QIODevice::ReadOnly))
 			{
-				ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): inFile.open(): %1").arg(inFile.errorString().toLocal8Bit().constData()));
+				showError(QString("zipFromFolderToFile(): inFile.open(): %1").arg(inFile.errorString().toLocal8Bit().constData()));
 				return false;
 			}
 
 			if (!outFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileNameWithRelativePath, fileInfo.filePath())))
 			{
-				ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): outFile.open(): %1").arg(outFile.getZipError()));
+				showError(QString("zipFromFolderToFile(): outFile.open(): %1").arg(outFile.getZipError()));
 				return false;
 			}
 
-			while (inFile.getChar(&c)){
-				if (!outFile.putChar(c))
+			while (!(buffer = inFile.read(blockSize)).isEmpty()){
+				if (outFile.write(buffer) != buffer.size())
 				{
-					ErrorDialog::getInstance()->showErrorDialog("Could not write file. Please check your diskspace and restart XMALab!");
+					showError("Could not write file. Please check your diskspace and restart XMALab!");
 					inFile.close();
 					outFile.close();
 					zip.close();
@@ -2359,7 +2501,7 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 
 			if (outFile.getZipError() != UNZ_OK)
 			{
-				ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): outFile.putChar(): %1").arg(outFile.getZipError()));
+				showError(QString("zipFromFolderToFile(): outFile.write(): %1").arg(outFile.getZipError()));
 				return false;
 			}
 
@@ -2367,13 +2509,80 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 
 			if (outFile.getZipError() != UNZ_OK)
 			{
-				ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): outFile.close(): %1").arg(outFile.getZipError()));
+				showError(QString("zipFromFolderToFile(): outFile.close(): %1").arg(outFile.getZipError()));
 				return false;
 			}
 
 			inFile.close();
+			written.insert(QString(fileNameWithRelativePath).replace('\\', '/'));
 		}
 
+	//The selected entries of the source archive are copied in their compressed form
+	if (!sourceArchive.isEmpty() && !sourceEntries.isEmpty())
+	{
+		QuaZip source(sourceArchive);
+		source.setFileNameCodec("IBM866");
+
+		if (!source.open(QuaZip::mdUnzip))
+		{
+			showError(QString("zipFromFolderToFile(): source.open(): %1").arg(source.getZipError()));
+			zip.close();
+			return false;
+		}
+
+		QuaZipFile sourceFile(&source);
+		QuaZipFileInfo64 info;
+		for (bool more = source.goToFirstFile(); more; more = source.goToNextFile())
+		{
+			if (!source.getCurrentFileInfo(&info))
+			{
+				showError(QString("zipFromFolderToFile(): getCurrentFileInfo(): %1").arg(source.getZipError()));
+				zip.close();
+				return false;
+			}
+
+			if (!isSelectedEntry(info.name, sourceEntries) || written.contains(QString(info.name).replace('\\', '/')))
+				continue;
+
+			int method, level;
+			if (!sourceFile.open(QIODevice::ReadOnly, &method, &level, true))
+			{
+				showError(QString("zipFromFolderToFile(): sourceFile.open(): %1").arg(sourceFile.getZipError()));
+				zip.close();
+				return false;
+			}
+
+			if (!outFile.open(QIODevice::WriteOnly, QuaZipNewInfo(info), NULL, info.crc, method, level, true))
+			{
+				showError(QString("zipFromFolderToFile(): outFile.open(): %1").arg(outFile.getZipError()));
+				sourceFile.close();
+				zip.close();
+				return false;
+			}
+
+			while (!(buffer = sourceFile.read(blockSize)).isEmpty()){
+				if (outFile.write(buffer) != buffer.size())
+				{
+					showError("Could not write file. Please check your diskspace and restart XMALab!");
+					sourceFile.close();
+					outFile.close();
+					zip.close();
+					return false;
+				};
+			}
+
+			outFile.close();
+			sourceFile.close();
+
+			if (outFile.getZipError() != UNZ_OK || sourceFile.getZipError() != UNZ_OK)
+			{
+				showError(QString("zipFromFolderToFile(): copy %1: %2").arg(info.name).arg(outFile.getZipError()));
+				zip.close();
+				return false;
+			}
+		}
+		source.close();
+	}
 
 	if (!comment.isEmpty())
 		zip.setComment(comment);
@@ -2382,7 +2591,7 @@ bool ProjectFileIO::zipFromFolderToFile(const QString& filePath, const QDir& dir
 
 	if (zip.getZipError() != 0)
 	{
-		ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile(): zip.close(): %1").arg(zip.getZipError()));
+		showError(QString("zipFromFolderToFile(): zip.close(): %1").arg(zip.getZipError()));
 		return false;
 	}
 
@@ -2398,7 +2607,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 	if (!zip.open(QuaZip::mdUnzip))
 	{
-		ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  zip.open(): %1").arg(zip.getZipError()));
+		showError(QString("zipFromFolderToFile():  zip.open(): %1").arg(zip.getZipError()));
 		return false;
 	}
 
@@ -2418,7 +2627,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 	{
 		if (!zip.getCurrentFileInfo(&info))
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  getCurrentFileInfo(): %1\n").arg(zip.getZipError()));
+			showError(QString("zipFromFolderToFile():  getCurrentFileInfo(): %1\n").arg(zip.getZipError()));
 			return false;
 		}
 
@@ -2428,7 +2637,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 		if (!file.open(QIODevice::ReadOnly))
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  file.open(): %1").arg(file.getZipError()));
+			showError(QString("zipFromFolderToFile():  file.open(): %1").arg(file.getZipError()));
 			return false;
 		}
 
@@ -2436,7 +2645,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 		if (file.getZipError() != UNZ_OK)
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  file.getFileName(): %1").arg(file.getZipError()));
+			showError(QString("zipFromFolderToFile():  file.getFileName(): %1").arg(file.getZipError()));
 			return false;
 		}
 
@@ -2452,7 +2661,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 		while (file.getChar(&c)){
 			if (!out.putChar(c))
 			{
-				ErrorDialog::getInstance()->showErrorDialog("Could not write file. Please check your diskspace and restart XMALab!");
+				showError("Could not write file. Please check your diskspace and restart XMALab!");
 				out.close();
 				file.close();
 				zip.close();
@@ -2463,13 +2672,13 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 		if (file.getZipError() != UNZ_OK)
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  file.getFileName(): %1").arg(file.getZipError()));
+			showError(QString("zipFromFolderToFile():  file.getFileName(): %1").arg(file.getZipError()));
 			return false;
 		}
 
 		if (!file.atEnd())
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  read all but not EOF"));
+			showError(QString("zipFromFolderToFile():  read all but not EOF"));
 			return false;
 		}
 
@@ -2477,7 +2686,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 		if (file.getZipError() != UNZ_OK)
 		{
-			ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  file.close(): %1").arg(file.getZipError()));
+			showError(QString("zipFromFolderToFile():  file.close(): %1").arg(file.getZipError()));
 			return false;
 		}
 	}
@@ -2486,7 +2695,7 @@ bool ProjectFileIO::unzipFromFileToFolder(const QString& filePath, const QString
 
 	if (zip.getZipError() != UNZ_OK)
 	{
-		ErrorDialog::getInstance()->showErrorDialog(QString("zipFromFolderToFile():  zip.close(): %1").arg(zip.getZipError()));
+		showError(QString("zipFromFolderToFile():  zip.close(): %1").arg(zip.getZipError()));
 		return false;
 	}
 
@@ -38,6 +38,7 @@ namespace xma
 	class NewProjectDialog;
 	class NewTrialDialog;
 	class Trial;
+	class ProjectSnapshot;
 
 	class ProjectFileIO
 	{
@@ -48,6 +49,13 @@ namespace xma
 		int saveProject(QString filename, std::vector <Trial*> trials, bool subset = false);
 		int loadProject(QString filename, QString filename_extraCalib);
 
+		//Writes the project files to folder and copies the marker data. Has to be called while the project is not modified.
+		//Autosave snapshots skip the precision info which is derived from the markers.
+		ProjectSnapshot* createSnapshot(QString folder, std::vector <Trial*> trials, bool subset = false, bool autosave = false);
+		//Writes the snapshot to filename and removes its folder. Can be called from a background thread,
+		//with quiet set errors are printed to stderr instead of opening a dialog.
+		bool writeSnapshot(ProjectSnapshot* snapshot, QString filename, bool quiet = false);
+
 		QStringList readTrials(QString filename);
 		Trial* loadTrials(QString filename, QString trialname);
 		void loadMarker(QString filename, QString trialname, Trial* trial);
@@ -60,15 +68,26 @@ namespace xma
 		void upgradeTo13(Trial *trial);
 		void writePortalFile(QString path, std::vector <Trial*> trials);
 		void addMetaData(QString filename, Trial * trial = NULL);
+
+		//When headless errors are printed to stderr and no widgets are touched
+		void setHeadless(bool value);
+		bool isHeadless();
 	private:
 
 		ProjectFileIO();
 		static ProjectFileIO* instance;
+		bool headless;
+		//archive the unchanged project data was last saved to or loaded from
+		QString cleanArchive;
+
+		void showError(const QString& message);
 
 		bool writeProjectFile(QString filename,std::vector <Trial*> trials);
 		bool readProjectFile(QString filename);
 
-		bool zipFromFolderToFile(const QString& filePath, const QDir& dir, const QString& comment = QString(""));
+		//Zips the folder. The entries of sourceArchive starting with one of the sourceEntries prefixes are copied without recompressing them.
+		bool zipFromFolderToFile(const QString& filePath, const QDir& dir, const QString& comment = QString(""),
+			const QString& sourceArchive = QString(""), const QStringList& sourceEntries = QStringList());
 		bool unzipFromFileToFolder(const QString& filePath, const QString& extDirPath, const QString& singleFileName = QString(""));
 		void recurseAddDir(QDir d, QStringList& list);
 		bool removeDir(QString folder);
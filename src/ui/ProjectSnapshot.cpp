@@ -0,0 +1,105 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file ProjectSnapshot.cpp
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "ui/ProjectSnapshot.h"
+
+#include "core/Trial.h"
+#include "core/Camera.h"
+#include "core/Marker.h"
+#include "core/MarkerStore.h"
+
+#ifdef WIN32
+#define OS_SEP "\\"
+#else
+	#define OS_SEP "/"
+#endif
+
+using namespace xma;
+
+ProjectSnapshot::ProjectSnapshot(QString _folder, QString _previousArchive) : folder(_folder), previousArchive(_previousArchive), valid(true), snapshotTime(0), serializationTime(0)
+{
+}
+
+ProjectSnapshot::~ProjectSnapshot()
+{
+	for (auto& m : markers)
+		delete m.marker;
+	markers.clear();
+
+	for (auto& s : stores)
+		delete s.second;
+	stores.clear();
+}
+
+void ProjectSnapshot::addMarker(Trial* trial, int idx, QString dataFolder)
+{
+	MarkerStore*& store = stores[trial];
+	if (!store)
+		store = new MarkerStore(trial->getMarkerStore());
+
+	MarkerCopy copy;
+	copy.marker = new Marker(*trial->getMarkers()[idx], store);
+	copy.dataFolder = dataFolder;
+	copy.idx = idx;
+	markers.push_back(copy);
+}
+
+void ProjectSnapshot::addCopiedEntry(QString entry)
+{
+	copiedEntries << entry;
+}
+
+void ProjectSnapshot::addCameraImages(Camera* camera, QString cameraFolder)
+{
+	cameraImages.push_back(std::make_pair(camera, cameraFolder));
+}
+
+void ProjectSnapshot::writeCameraImages() const
+{
+	for (auto& c : cameraImages)
+		c.first->saveImages(c.second);
+}
+
+void ProjectSnapshot::writeMarkers() const
+{
+	for (const MarkerCopy& m : markers)
+	{
+		QString prefix = m.dataFolder + OS_SEP + QString("Marker%1").arg(m.idx, 3, 10, QChar('0'));
+
+		m.marker->save(prefix + "points2d.csv", prefix + "status2d.csv", prefix + "size.csv");
+		m.marker->save3DPoints(prefix + "points3d.csv", prefix + "status3d.csv");
+		m.marker->saveInterpolation(prefix + "interpolation.csv");
+
+		if (m.marker->Reference3DPointSet())
+		{
+			m.marker->saveReference3DPoint(prefix + "reference3Dpoint.csv");
+		}
+	}
+}
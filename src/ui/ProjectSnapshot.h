@@ -0,0 +1,98 @@
+//  ----------------------------------
+//  XMALab -- Copyright � 2015, Brown University, Providence, RI.
+//  
+//  All Rights Reserved
+//   
+//  Use of the XMALab software is provided under the terms of the GNU General Public License version 3 
+//  as published by the Free Software Foundation at http://www.gnu.org/licenses/gpl-3.0.html, provided 
+//  that this copyright notice appear in all copies and that the name of Brown University not be used in 
+//  advertising or publicity pertaining to the use or distribution of the software without specific written 
+//  prior permission from Brown University.
+//  
+//  See license.txt for further information.
+//  
+//  BROWN UNIVERSITY DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE WHICH IS 
+//  PROVIDED �AS IS�, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS 
+//  FOR ANY PARTICULAR PURPOSE.  IN NO EVENT SHALL BROWN UNIVERSITY BE LIABLE FOR ANY 
+//  SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR FOR ANY DAMAGES WHATSOEVER RESULTING 
+//  FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR 
+//  OTHER TORTIOUS ACTION, OR ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN CONNECTION 
+//  WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. 
+//  ----------------------------------
+//  
+///\file ProjectSnapshot.h
+///\author Benjamin Knorlein
+///\date 10/19/2026
+
+#ifndef PROJECTSNAPSHOT_H
+#define PROJECTSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <map>
+
+namespace xma
+{
+	class Trial;
+	class Camera;
+	class Marker;
+	class MarkerStore;
+
+	/// Consistent state of a project which can be written to an archive from a background thread.
+	/// The small project files are written to the folder when the snapshot is taken, the marker
+	/// data is copied from the marker stores of the trials and written later by ProjectFileIO::writeSnapshot
+	/// together with the images of the changed cameras.
+	class ProjectSnapshot
+	{
+	public:
+		ProjectSnapshot(QString _folder, QString _previousArchive);
+		virtual ~ProjectSnapshot();
+
+		//Copies the marker, the data of all markers of the trial is copied with the first marker
+		void addMarker(Trial* trial, int idx, QString dataFolder);
+		void addCopiedEntry(QString entry);
+		//The images of the camera are decoded and encoded again, so they are written with the marker data
+		void addCameraImages(Camera* camera, QString cameraFolder);
+
+		const QString& getFolder() const { return folder; }
+		const QString& getPreviousArchive() const { return previousArchive; }
+		bool isIncremental() const { return !previousArchive.isEmpty(); }
+		const QStringList& getCopiedEntries() const { return copiedEntries; }
+		size_t getNbMarkers() const { return markers.size(); }
+
+		//Writes the files of the copied markers to their data folders
+		void writeMarkers() const;
+		void writeCameraImages() const;
+
+		bool isValid() const { return valid; }
+		void setValid(bool value) { valid = value; }
+
+		//Time in ms taken to create the snapshot
+		qint64 getSnapshotTime() const { return snapshotTime; }
+		void setSnapshotTime(qint64 value) { snapshotTime = value; }
+		//Time in ms taken to write the archive
+		qint64 getSerializationTime() const { return serializationTime; }
+		void setSerializationTime(qint64 value) { serializationTime = value; }
+
+	private:
+		struct MarkerCopy
+		{
+			Marker* marker;
+			QString dataFolder;
+			int idx;
+		};
+
+		QString folder;
+		QString previousArchive;
+		QStringList copiedEntries;
+		std::map<Trial*, MarkerStore*> stores;
+		std::vector<MarkerCopy> markers;
+		std::vector<std::pair<Camera*, QString> > cameraImages;
+		bool valid;
+		qint64 snapshotTime;
+		qint64 serializationTime;
+	};
+}
+
+#endif // PROJECTSNAPSHOT_H
@@ -81,6 +81,12 @@ SettingsDialog::SettingsDialog(QWidget* parent) :
 
 	diag->spinBoxEpiPrecision->setValue(Settings::getInstance()->getIntSetting("EpipolarLinePrecision"));
 	diag->comboBox_TriangulationMethod->setCurrentIndex(Settings::getInstance()->getIntSetting("TriangulationMethod"));
+	diag->comboBox_TrackingPredictor->setCurrentIndex(Settings::getInstance()->getIntSetting("TrackingPredictor"));
+	diag->checkBox_TrackingRigidBodyPrediction->setChecked(Settings::getInstance()->getBoolSetting("TrackingRigidBodyPrediction"));
+	diag->checkBox_TrackingEpipolarConstraint->setChecked(Settings::getInstance()->getBoolSetting("TrackingEpipolarConstraint"));
+	diag->spinBox_TrackingEpipolarBandWidth->setValue(Settings::getInstance()->getIntSetting("TrackingEpipolarBandWidth"));
+	diag->checkBox_TrackingPyramid->setChecked(Settings::getInstance()->getBoolSetting("TrackingPyramid"));
+	diag->spinBox_TrackingPyramidSearchArea->setValue(Settings::getInstance()->getIntSetting("TrackingPyramidSearchArea"));
 	diag->comboBox_DetectionMethodForCalibration->setCurrentIndex(Settings::getInstance()->getIntSetting("DetectionMethodForCalibration"));
 	diag->doubleSpinBox_MaxError->setValue(Settings::getInstance()->getFloatSetting("MaximumReprojectionError"));
 	diag->checkBox_RetrackOptimizedTrackedPoints->setChecked(Settings::getInstance()->getBoolSetting("RetrackOptimizedTrackedPoints"));
@@ -301,17 +307,49 @@ void SettingsDialog::on_spinBoxEpiPrecision_valueChanged(int value)
 	Settings::getInstance()->set("EpipolarLinePrecision", diag->spinBoxEpiPrecision->value());
 }
 
+void SettingsDialog::on_comboBox_TrackingPredictor_currentIndexChanged(int value)
+{
+	Settings::getInstance()->set("TrackingPredictor", diag->comboBox_TrackingPredictor->currentIndex());
+}
+
+void SettingsDialog::on_checkBox_TrackingRigidBodyPrediction_stateChanged(int state)
+{
+	Settings::getInstance()->set("TrackingRigidBodyPrediction", diag->checkBox_TrackingRigidBodyPrediction->isChecked());
+}
+
+void SettingsDialog::on_checkBox_TrackingEpipolarConstraint_stateChanged(int state)
+{
+	Settings::getInstance()->set("TrackingEpipolarConstraint", diag->checkBox_TrackingEpipolarConstraint->isChecked());
+}
+
+void SettingsDialog::on_spinBox_TrackingEpipolarBandWidth_valueChanged(int value)
+{
+	Settings::getInstance()->set("TrackingEpipolarBandWidth", diag->spinBox_TrackingEpipolarBandWidth->value());
+}
+
+void SettingsDialog::on_checkBox_TrackingPyramid_stateChanged(int state)
+{
+	Settings::getInstance()->set("TrackingPyramid", diag->checkBox_TrackingPyramid->isChecked());
+}
+
+void SettingsDialog::on_spinBox_TrackingPyramidSearchArea_valueChanged(int value)
+{
+	Settings::getInstance()->set("TrackingPyramidSearchArea", diag->spinBox_TrackingPyramidSearchArea->value());
+}
+
 void SettingsDialog::on_comboBox_TriangulationMethod_currentIndexChanged(int value)
 {
 	Settings::getInstance()->set("TriangulationMethod", diag->comboBox_TriangulationMethod->currentIndex());
 	if (!initPhase)
 	{
+		Trial* activeTrial = NULL;
 		for (unsigned int i = 0; i < Project::getInstance()->getTrials().size(); i++)
 		{
 			Project::getInstance()->getTrials()[i]->setRequiresRecomputation(true);
 			if (State::getInstance()->getActiveTrial() == i && State::getInstance()->getActiveTrial() >= 0 && State::getInstance()->getActiveTrial() < (int) Project::getInstance()->getTrials().size())
-				ThreadScheduler::getInstance()->updateTrialData(Project::getInstance()->getTrials()[i]);
+				activeTrial = Project::getInstance()->getTrials()[i];
 		}
+		ThreadScheduler::getInstance()->recomputeTrials(Project::getInstance()->getTrials(), activeTrial);
 	}
 }
 
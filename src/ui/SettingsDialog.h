@@ -87,6 +87,12 @@ namespace xma
 		
 		void on_spinBoxEpiPrecision_valueChanged(int value);
 		void on_comboBox_TriangulationMethod_currentIndexChanged(int value);
+		void on_comboBox_TrackingPredictor_currentIndexChanged(int value);
+		void on_checkBox_TrackingRigidBodyPrediction_stateChanged(int state);
+		void on_checkBox_TrackingEpipolarConstraint_stateChanged(int state);
+		void on_spinBox_TrackingEpipolarBandWidth_valueChanged(int value);
+		void on_checkBox_TrackingPyramid_stateChanged(int state);
+		void on_spinBox_TrackingPyramidSearchArea_valueChanged(int value);
 		void on_comboBox_DetectionMethodForCalibration_currentIndexChanged(int value);
 		void on_checkBox_ConfirmQuitXMALab_stateChanged(int state);
 		void on_doubleSpinBox_MaxError_valueChanged(double value);
@@ -51,6 +51,7 @@ State::State()
 	calibrationVisText = NOCALIBTEXT;
 	disableDraw = false;
 	loading = false;
+	drawRevision = 0;
 }
 
 State::~State()
@@ -204,6 +204,17 @@ namespace xma
 		bool isLoading();
 		void setLoading(bool value);
 
+		//Incremented whenever the displayed data may have changed. The views rebuild their cached overlays if it differs.
+		int getDrawRevision() const
+		{
+			return drawRevision;
+		}
+
+		void invalidateDraw()
+		{
+			drawRevision++;
+		}
+
 		signals:
 		void workspaceChanged(work_state workspace);
 		void displayChanged(ui_state display);
@@ -238,6 +249,7 @@ namespace xma
 
 		bool disableDraw;
 		bool loading;
+		int drawRevision;
 
 		State();
 		static State* instance;
@@ -39,6 +39,7 @@
 #include "core/Project.h"
 #include "core/Camera.h"
 #include "core/CalibrationImage.h"
+#include "core/AviVideo.h"
 
 #include "processing/ThreadScheduler.h"
 
@@ -96,6 +97,18 @@ TrialDialog::TrialDialog(Trial* trial, QWidget* parent) :
 		diag->checkBoxInterpolate->setEnabled(false);
 		diag->doubleSpinBoxCutoffFrq->setEnabled(false);
 	}
+
+	//proxies are only built for compressed avi videos
+	bool hasAvi = false;
+	for (auto stream : m_trial->getVideoStreams())
+	{
+		hasAvi = hasAvi || dynamic_cast<AviVideo*>(stream) != NULL;
+	}
+	diag->pushButton_BuildProxy->setEnabled(hasAvi);
+
+	//markers are matched between the cameras using the calibration
+	diag->pushButton_AutoDetect->setEnabled(Project::getInstance()->getCameras().size() >= 2 && Project::getInstance()->getCalibration() != NO_CALIBRATION);
+
 	diag->pushButton_OK->setFocus(Qt::NoFocusReason);
 }
 
@@ -188,3 +201,14 @@ void TrialDialog::on_pushButton_Denoise_clicked()
 	this->reject();
 }
 
+void TrialDialog::on_pushButton_BuildProxy_clicked()
+{
+	returnValue = TRIALDIALOGBUILDPROXY;
+	this->reject();
+}
+
+void TrialDialog::on_pushButton_AutoDetect_clicked()
+{
+	returnValue = TRIALDIALOGAUTODETECT;
+	this->reject();
+}
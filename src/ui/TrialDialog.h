@@ -46,7 +46,9 @@ namespace xma
 		TRIALDIALOGUPDATE = 2,
 		TRIALDIALOGCHANGE = 3,
 		TRIALDIALOGUPDATEFILTER = 4,
-		TRIALDIALOGDENOISE = 5
+		TRIALDIALOGDENOISE = 5,
+		TRIALDIALOGBUILDPROXY = 6,
+		TRIALDIALOGAUTODETECT = 7
 	};
 
 	class TrialDialog : public QDialog
@@ -76,6 +78,8 @@ namespace xma
 		void on_pushButton_ChangeTrialData_clicked();
 		void on_pushButton_Update_clicked();
 		void on_pushButton_Denoise_clicked();
+		void on_pushButton_BuildProxy_clicked();
+		void on_pushButton_AutoDetect_clicked();
 	};
 }
 
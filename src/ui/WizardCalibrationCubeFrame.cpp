@@ -43,6 +43,7 @@
 #include "core/CalibrationObject.h"
 
 #include "processing/BlobDetection.h"
+#include "processing/CalibrationSequenceDetection.h"
 #include "processing/CubeCalibration.h"
 #include "processing/CheckerboardDetection.h"
 #include "processing/Calibration.h"
@@ -809,7 +810,7 @@ bool WizardCalibrationCubeFrame::calibrateOtherFrames()
 	temporaryTransformationMatrix.clear();
 	temporaryCamIdx.clear();
 	temporaryFrameIdx.clear();
-	std::vector<BlobDetection *> detectors;
+	CalibrationSequenceDetection* detection = NULL;
 	bool isRunning = false;
 	std::vector<std::vector<cv::Mat> > CamJToCamKTransformation;
 	std::vector<std::vector<bool> > CamJToCamKTransformationSet;
@@ -870,9 +871,12 @@ bool WizardCalibrationCubeFrame::calibrateOtherFrames()
 								temporaryCamIdx.push_back(k);
 								temporaryFrameIdx.push_back(m);
 								temporaryTransformationMatrix.push_back(fj->getTransformationMatrix() * CamJToCamKTransformation[k][j]);
-								BlobDetection* blobdetection = new BlobDetection(k, m);
-								connect(blobdetection, SIGNAL(signal_finished()), this, SLOT(setTransformationMatrix()));
-								detectors.push_back(blobdetection);
+								if (detection == NULL)
+								{
+									detection = new CalibrationSequenceDetection();
+									connect(detection, SIGNAL(signal_finished()), this, SLOT(setTransformationMatrix()));
+								}
+								detection->addFrame(k, m);
 								isRunning = true;
 							}
 						}
@@ -894,9 +898,9 @@ bool WizardCalibrationCubeFrame::calibrateOtherFrames()
 	CamJToCamKTransformation.clear();
 	CamJToCamKTransformationSet.clear();
 
-	for (unsigned int i = 0; i < detectors.size(); i++)
+	if (detection != NULL)
 	{
-		detectors[i]->start();
+		detection->start();
 	}
 	return isRunning;
 }
@@ -43,6 +43,8 @@
 #include <processing/MarkerDetection.h>
 #include <processing/MarkerTracking.h>
 
+#include <algorithm>
+
 
 using namespace xma;
 
@@ -280,7 +282,9 @@ void WizardDigitizationFrame::trackSinglePoint()
 				trackers.push_back(markertracking);
 			}
 		}
+		orderTrackersEpipolar(trackID, endFrame, 0, trackers);
 
+		Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->beginEdit();
 		State::getInstance()->setDisableDraw(true);
 		State::getInstance()->changeActiveFrameTrial(endFrame);
 
@@ -317,6 +321,7 @@ void WizardDigitizationFrame::trackSinglePointFinished()
 			connect(markerdetection, SIGNAL(detectMarker_finished()), this, SLOT(checkIfValid()));
 		}
 	}
+	constrainDetectorsEpipolar(tmptrackID, State::getInstance()->getActiveFrameTrial(), 0, detectors);
 
 	if (detectors.size() > 0)
 	{
@@ -351,6 +356,7 @@ void WizardDigitizationFrame::trackRB()
 	std::vector<MarkerTracking *> trackers;
 	for (std::vector<int>::const_iterator it = markers.begin(); it < markers.end();++it)
 	{
+		unsigned int first = trackers.size();
 		for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
 		{
 			if (Project::getInstance()->getCameras()[i]->isVisible() && 
@@ -364,7 +370,9 @@ void WizardDigitizationFrame::trackRB()
 				trackers.push_back(markertracking);
 			}
 		}
+		orderTrackersEpipolar(*it, endFrame, first, trackers);
 	}
+	Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->beginEdit();
 	State::getInstance()->setDisableDraw(true);
 	State::getInstance()->changeActiveFrameTrial(endFrame);
 
@@ -431,6 +439,7 @@ void WizardDigitizationFrame::trackAll()
 	std::vector<MarkerTracking *> trackers;
 	for (unsigned int j = 0; j < Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers().size(); j++)
 	{
+		unsigned int first = trackers.size();
 		for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
 		{
 			if (Project::getInstance()->getCameras()[i]->isVisible() && 
@@ -444,7 +453,9 @@ void WizardDigitizationFrame::trackAll()
 				trackers.push_back(markertracking);
 			}
 		}
+		orderTrackersEpipolar(j, endFrame, first, trackers);
 	}
+	Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->beginEdit();
 	State::getInstance()->setDisableDraw(true);
 	State::getInstance()->changeActiveFrameTrial(endFrame);
 
@@ -467,6 +478,7 @@ void WizardDigitizationFrame::trackAllFinished()
 	std::vector<MarkerDetection *> detectors;
 	for (unsigned int j = 0; j < Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers().size(); j++)
 	{
+		unsigned int first = detectors.size();
 		for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
 		{
 			if (Project::getInstance()->getCameras()[i]->isVisible() && 
@@ -478,6 +490,26 @@ void WizardDigitizationFrame::trackAllFinished()
 				connect(markerdetection, SIGNAL(detectMarker_finished()), this, SLOT(checkIfValid()));
 			}
 		}
+		constrainDetectorsEpipolar(j, State::getInstance()->getActiveFrameTrial(), first, detectors);
+	}
+
+	if (Settings::getInstance()->getBoolSetting("TrackingRigidBodyPrediction"))
+	{
+		if (trackType == 2)
+		{
+			std::vector<int> markers = PointsDockWidget::getInstance()->getSelectedPoints();
+			for (std::vector<int>::const_iterator it = markers.begin(); it < markers.end(); ++it)
+			{
+				recoverOccludedMarker(*it, detectors);
+			}
+		}
+		else
+		{
+			for (unsigned int j = 0; j < Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers().size(); j++)
+			{
+				recoverOccludedMarker(j, detectors);
+			}
+		}
 	}
 
 	if (detectors.size() > 0)
@@ -494,9 +526,75 @@ void WizardDigitizationFrame::trackAllFinished()
 	}
 }
 
+void WizardDigitizationFrame::recoverOccludedMarker(int marker, std::vector<MarkerDetection *>& detectors)
+{
+	//markers which were lost in the previous frame are searched at the position predicted by their rigid body
+	int frame = State::getInstance()->getActiveFrameTrial();
+	int previousFrame = (trackDirection > 0) ? frame - 1 : frame + 1;
+	Marker* m = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers()[marker];
+	if (m->getMethod() == 4 || previousFrame < 0 || previousFrame >= (int) m->getStatus2D()[0].size())
+		return;
+
+	for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
+	{
+		double x, y, radius;
+		if (Project::getInstance()->getCameras()[i]->isVisible() &&
+			m->getStatus2D()[i][previousFrame] <= UNDEFINED && m->getStatus2D()[i][frame] == UNDEFINED &&
+			m->getRigidBodyPrediction(i, frame, x, y, trackDirection > 0, radius))
+		{
+			MarkerDetection* markerdetection = new MarkerDetection(i, State::getInstance()->getActiveTrial(), frame, marker, radius, true);
+			markerdetection->setPredictionGate(x, y, radius);
+			detectors.push_back(markerdetection);
+			connect(markerdetection, SIGNAL(detectMarker_finished()), this, SLOT(checkIfValid()));
+		}
+	}
+}
+
+void WizardDigitizationFrame::orderTrackersEpipolar(int marker, int frame, unsigned int first, std::vector<MarkerTracking *>& trackers)
+{
+	if (!Settings::getInstance()->getBoolSetting("TrackingEpipolarConstraint") || Project::getInstance()->getCalibration() == NO_CALIBRATION || trackers.size() < first + 2)
+		return;
+
+	//the most confident camera is tracked first and the other cameras are searched along its epipolar line
+	std::vector<int> cameras;
+	for (unsigned int i = first; i < trackers.size(); i++)
+	{
+		cameras.push_back(trackers[i]->getCamera());
+	}
+	int reference = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers()[marker]->getMostConfidentCamera(frame, trackDirection > 0, cameras);
+
+	MarkerTracking* referenceTracker = trackers[first + (std::find(cameras.begin(), cameras.end(), reference) - cameras.begin())];
+	for (unsigned int i = first; i < trackers.size(); i++)
+	{
+		if (trackers[i] != referenceTracker)
+			referenceTracker->addEpipolarDependent(trackers[i]);
+	}
+	trackers.resize(first);
+	trackers.push_back(referenceTracker);
+}
+
+void WizardDigitizationFrame::constrainDetectorsEpipolar(int marker, int frame, unsigned int first, std::vector<MarkerDetection *>& detectors)
+{
+	if (!Settings::getInstance()->getBoolSetting("TrackingEpipolarConstraint") || Project::getInstance()->getCalibration() == NO_CALIBRATION || detectors.size() < first + 2)
+		return;
+
+	std::vector<int> cameras;
+	for (unsigned int i = first; i < detectors.size(); i++)
+	{
+		cameras.push_back(detectors[i]->getCamera());
+	}
+	int reference = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getMarkers()[marker]->getMostConfidentCamera(frame, trackDirection > 0, cameras);
+
+	for (unsigned int i = first; i < detectors.size(); i++)
+	{
+		detectors[i]->setEpipolarReference(reference);
+	}
+}
 
 void WizardDigitizationFrame::checkIfValid()
 {
+	Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->commitEdit();
+
 	bool valid = true;
 	if (trackType == 1)
 	{
@@ -39,6 +39,9 @@ namespace Ui
 
 namespace xma
 {
+	class MarkerDetection;
+	class MarkerTracking;
+
 	class WizardDigitizationFrame : public QFrame
 	{
 		Q_OBJECT
@@ -75,6 +78,9 @@ namespace xma
 		void trackSinglePoint();
 		void trackRB();
 		void trackAll();
+		void recoverOccludedMarker(int marker, std::vector<MarkerDetection *>& detectors);
+		void orderTrackersEpipolar(int marker, int frame, unsigned int first, std::vector<MarkerTracking *>& trackers);
+		void constrainDetectorsEpipolar(int marker, int frame, unsigned int first, std::vector<MarkerDetection *>& detectors);
 
 		void uncheckTrackButtons();
 
@@ -39,7 +39,7 @@
 #include "core/Settings.h"
 #include "core/UndistortionObject.h"
 
-#include "processing/BlobDetection.h"
+#include "processing/CalibrationSequenceDetection.h"
 #include "processing/LocalUndistortion.h"
 #include <QInputDialog>
 
@@ -245,15 +245,16 @@ void WizardUndistortionFrame::on_pushButton_clicked()
 {
 	if (State::getInstance()->getUndistortion() == NOTUNDISTORTED)
 	{
+		CalibrationSequenceDetection* detection = new CalibrationSequenceDetection();
 		for (unsigned int i = 0; i < Project::getInstance()->getCameras().size(); i++)
 		{
 			if (Project::getInstance()->getCameras()[i]->hasUndistortion())
 			{
-				BlobDetection* blobdetection = new BlobDetection(i, -1);
-				connect(blobdetection, SIGNAL(signal_finished()), this, SLOT(computeUndistortion()));
-				blobdetection->start();
+				detection->addFrame(i, -1);
 			}
 		}
+		connect(detection, SIGNAL(signal_finished()), this, SLOT(computeUndistortion()));
+		detection->start();
 	}
 	else if (State::getInstance()->getUndistortion() == UNDISTORTED)
 	{
@@ -40,9 +40,13 @@
 #include "core/CalibrationImage.h"
 #include "core/HelperFunctions.h"
 #include "core/Settings.h"
+#include "core/AviVideo.h"
+#include "core/AviProxy.h"
 
 #include "processing/ThreadScheduler.h"
 #include "processing/DenoiseTrial.h"
+#include "processing/BuildVideoProxy.h"
+#include "processing/AutoMarkerDetection.h"
 
 #include "ui/CameraSelector.h"
 #include "ui/DetailViewDockWidget.h"
@@ -142,6 +146,10 @@ void WorkspaceNavigationFrame::closeProject()
 
 void WorkspaceNavigationFrame::workspaceChanged(work_state workspace)
 {
+	//the cameras can be changed outside of the digitization workspace
+	if (workspace != DIGITIZATION)
+		ThreadScheduler::getInstance()->waitForFinished();
+
 	if (workspace == UNDISTORTION)
 	{
 		frame->comboBoxViewspace->setEnabled(true);
@@ -171,7 +179,8 @@ void WorkspaceNavigationFrame::workspaceChanged(work_state workspace)
 		frame->comboBoxWorkspace->setCurrentIndex(frame->comboBoxWorkspace->findText("Marker tracking"));
 		if (!State::getInstance()->isLoading() && State::getInstance()->getActiveTrial() >= 0 && State::getInstance()->getActiveTrial() < (int) Project::getInstance()->getTrials().size())
 		{
-			ThreadScheduler::getInstance()->updateTrialData(Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]);
+			//all other trials are recomputed in the background
+			ThreadScheduler::getInstance()->recomputeTrials(Project::getInstance()->getTrials(), Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]);
 		}
 
 		if (Project::getInstance()->getTrials().size() > 0 && State::getInstance()->getActiveTrial() >= 0 && Project::getInstance()->getTrials().size() > State::getInstance()->getActiveTrial())
@@ -366,6 +375,24 @@ void WorkspaceNavigationFrame::on_toolButtonTrialSettings_clicked()
 				delete diag;
 			}			
 		}
+		else if (dialog->getDialogReturn() == TRIALDIALOGBUILDPROXY)
+		{
+			Trial* trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
+			for (auto stream : trial->getVideoStreams())
+			{
+				if (dynamic_cast<AviVideo*>(stream) != NULL && !AviProxy::isUpToDate(stream->getFilenames().at(0)))
+				{
+					BuildVideoProxy * thread = new BuildVideoProxy(stream->getFilenames().at(0));
+					thread->start();
+				}
+			}
+		}
+		else if (dialog->getDialogReturn() == TRIALDIALOGAUTODETECT)
+		{
+			Trial* trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
+			AutoMarkerDetection * thread = new AutoMarkerDetection(trial, trial->getStartFrame() - 1, trial->getEndFrame() - 1);
+			thread->start();
+		}
 		else if (dialog->getDialogReturn() == TRIALDIALOGCHANGE)
 		{
 			frame->comboBoxTrial->setItemText(State::getInstance()->getActiveTrial(), Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()]->getName());
@@ -390,6 +417,7 @@ void WorkspaceNavigationFrame::on_toolButtonTrialSettings_clicked()
 			Trial* trial = Project::getInstance()->getTrials()[State::getInstance()->getActiveTrial()];
 			int oldTrial = State::getInstance()->getActiveTrial();
 			int activeTrial = State::getInstance()->getActiveTrial();
+			ThreadScheduler::getInstance()->waitForFinished();
 			Project::getInstance()->deleteTrial(trial);
 			frame->comboBoxTrial->removeItem(oldTrial);
 
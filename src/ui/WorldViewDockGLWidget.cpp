@@ -41,6 +41,10 @@
 #include "core/Marker.h"
 #include "core/RigidBody.h"
 #include "core/CalibrationSequence.h"
+#include "core/Settings.h"
+
+#include "gl/OverlayBuffer.h"
+#include "gl/VertexBuffer.h"
 
 #include <QApplication>
 #include <QMouseEvent>
@@ -68,7 +72,10 @@ WorldViewDockGLWidget::WorldViewDockGLWidget(QWidget* parent)
 	h = 50;
 	setMinimumSize(50, 50);
 	setAutoFillBackground(false);
-	opengl_initialised = false;
+
+	sphere = NULL;
+	rigidBodyOverlay = NULL;
+	trajectoryOverlay = NULL;
 }
 
 void WorldViewDockGLWidget::setFrame(int value)
@@ -88,7 +95,12 @@ void WorldViewDockGLWidget::setFocalPlaneDistance(float distance)
 
 WorldViewDockGLWidget::~WorldViewDockGLWidget()
 {
-	if (opengl_initialised)gluDeleteQuadric(sphere_quadric);
+	//the buffer objects belong to the context of this widget
+	makeCurrent();
+	if (sphere) delete sphere;
+	if (rigidBodyOverlay) delete rigidBodyOverlay;
+	if (trajectoryOverlay) delete trajectoryOverlay;
+	doneCurrent();
 }
 
 void WorldViewDockGLWidget::setUseCustomTimeline(bool value)
@@ -220,6 +232,7 @@ void WorldViewDockGLWidget::paintGL()
 					drawCameras();
 					drawMarkers(trial, frame);
 					drawRigidBodies(trial, frame);
+					drawTrajectories(trial);
 				}
 			}
 		}
@@ -377,19 +390,64 @@ void WorldViewDockGLWidget::drawCameras()
 	}
 }
 
-void WorldViewDockGLWidget::drawMarkers(Trial* trial, int frame)
+void WorldViewDockGLWidget::drawSphere(double x, double y, double z)
 {
-	if (!opengl_initialised)
+	if (!sphere)
 	{
-		sphere_quadric = gluNewQuadric(); // Create A Pointer To The Quadric Object ( NEW )
-		gluQuadricNormals(sphere_quadric, GLU_SMOOTH); // Create Smooth Normals ( NEW )
-		gluQuadricTexture(sphere_quadric, GL_TRUE); // Create Texture Coords ( NEW )
+		//same radius and tesselation as the former gluSphere(0.3, 32, 32), stored as a triangle list
+		const int slices = 32;
+		const int stacks = 32;
+		const float radius = 0.3f;
+		std::vector<float> vertices;
+		std::vector<float> normals;
+		auto addVertex = [&](int slice, int stack)
+		{
+			double theta = 2.0 * _PI * slice / slices;
+			double phi = _PI * stack / stacks;
+			float nx = sin(phi) * cos(theta);
+			float ny = sin(phi) * sin(theta);
+			float nz = cos(phi);
+			normals.push_back(nx);
+			normals.push_back(ny);
+			normals.push_back(nz);
+			vertices.push_back(radius * nx);
+			vertices.push_back(radius * ny);
+			vertices.push_back(radius * nz);
+		};
+		for (int stack = 0; stack < stacks; stack++)
+		{
+			for (int slice = 0; slice < slices; slice++)
+			{
+				addVertex(slice, stack);
+				addVertex(slice, stack + 1);
+				addVertex(slice + 1, stack + 1);
+
+				addVertex(slice, stack);
+				addVertex(slice + 1, stack + 1);
+				addVertex(slice + 1, stack);
+			}
+		}
+		std::vector<unsigned int> indices(vertices.size() / 3);
+		for (unsigned int i = 0; i < indices.size(); i++)
+		{
+			indices[i] = i;
+		}
+
+		sphere = new VertexBuffer();
+		sphere->setData(indices.size(), &vertices[0], &normals[0], NULL, &indices[0]);
 	}
 
+	glPushMatrix();
+	glTranslated(x, y, z);
+	sphere->render();
+	glPopMatrix();
+}
+
+void WorldViewDockGLWidget::drawMarkers(Trial* trial, int frame)
+{
 	for (unsigned int i = 0; i < trial->getMarkers().size(); i++)
 	{
 		if (trial->getMarkers()[i]->getStatus3D()[frame] > 0){
-			glPushMatrix();
 			if (i == trial->getActiveMarkerIdx())
 			{
 				glColor3f(1.0, 0.0, 0.0);
@@ -399,42 +457,110 @@ void WorldViewDockGLWidget::drawMarkers(Trial* trial, int frame)
 				glColor3f(0.0, 1.0, 0.0);
 			}
 
-			glTranslated(trial->getMarkers()[i]->getPoints3D()[frame].x,
-				trial->getMarkers()[i]->getPoints3D()[frame].y,
-				trial->getMarkers()[i]->getPoints3D()[frame].z);
-
-			gluSphere(sphere_quadric, 0.3f, 32, 32);
-
-			glPopMatrix();
+			cv::Point3d pt = trial->getMarkers()[i]->getPoints3D()[frame];
+			drawSphere(pt.x, pt.y, pt.z);
 		}
 	}
 }
 
 void WorldViewDockGLWidget::drawRigidBodies(Trial* trial, int frame)
 {
-	for (unsigned int i = 0; i < trial->getRigidBodies().size(); i++)
+	std::vector<int> key;
+	key.push_back(trial->getDataRevision());
+	key.push_back(State::getInstance()->getActiveTrial());
+	key.push_back(frame);
+	key.push_back(Settings::getInstance()->getBoolSetting("TrialDrawFiltered"));
+
+	if (!rigidBodyOverlay)
+		rigidBodyOverlay = new OverlayBuffer();
+
+	if (key != rigidBodyOverlayKey)
 	{
-		trial->getRigidBodies()[i]->draw3D(frame);
+		rigidBodyOverlayKey = key;
+		rigidBodyOverlay->clear();
+		for (unsigned int i = 0; i < trial->getRigidBodies().size(); i++)
+		{
+			trial->getRigidBodies()[i]->draw3D(frame, *rigidBodyOverlay);
+		}
+	}
+	rigidBodyOverlay->render();
 
+	for (unsigned int i = 0; i < trial->getRigidBodies().size(); i++)
+	{
 		if (trial->getRigidBodies()[i]->getDrawMeshModel())
 			trial->getRigidBodies()[i]->drawMesh(frame);
 	}
 }
 
-void WorldViewDockGLWidget::drawCalibrationCube()
+void WorldViewDockGLWidget::drawTrajectories(Trial* trial)
 {
-	if (!opengl_initialised)
+	if (!Settings::getInstance()->getBoolSetting("WorldViewDrawTrajectories"))
+		return;
+
+	std::vector<int> key;
+	key.push_back(trial->getDataRevision());
+	key.push_back(State::getInstance()->getActiveTrial());
+	key.push_back(trial->getActiveMarkerIdx());
+	key.push_back(trial->getStartFrame());
+	key.push_back(trial->getEndFrame());
+
+	if (!trajectoryOverlay)
+		trajectoryOverlay = new OverlayBuffer();
+
+	//the trajectories do not depend on the frame and are only rebuilt if the data changed
+	if (key != trajectoryOverlayKey)
 	{
-		sphere_quadric = gluNewQuadric(); // Create A Pointer To The Quadric Object ( NEW )
-		gluQuadricNormals(sphere_quadric, GLU_SMOOTH); // Create Smooth Normals ( NEW )
-		gluQuadricTexture(sphere_quadric, GL_TRUE); // Create Texture Coords ( NEW )
+		trajectoryOverlayKey = key;
+		trajectoryOverlay->clear();
+		for (unsigned int i = 0; i < trial->getMarkers().size(); i++)
+		{
+			if (i == trial->getActiveMarkerIdx())
+			{
+				trajectoryOverlay->color(1.0f, 0.0f, 0.0f);
+			}
+			else
+			{
+				trajectoryOverlay->color(0.0f, 0.6f, 0.0f);
+			}
+
+			//one line strip per tracked segment, all strips are drawn with a single call
+			bool open = false;
+			for (int f = trial->getStartFrame() - 1; f < trial->getEndFrame() && f < trial->getNbImages(); f++)
+			{
+				if (trial->getMarkers()[i]->getStatus3D()[f] > 0)
+				{
+					if (!open)
+					{
+						trajectoryOverlay->begin(GL_LINE_STRIP);
+						open = true;
+					}
+					cv::Point3d pt = trial->getMarkers()[i]->getPoints3D()[f];
+					trajectoryOverlay->vertex(pt.x, pt.y, pt.z);
+				}
+				else if (open)
+				{
+					trajectoryOverlay->end();
+					open = false;
+				}
+			}
+			if (open)
+				trajectoryOverlay->end();
+		}
 	}
 
+	glDisable(GL_LIGHTING);
+	glLineWidth(1.0);
+	trajectoryOverlay->render();
+	glLineWidth(2.5);
+	glEnable(GL_LIGHTING);
+}
+
+void WorldViewDockGLWidget::drawCalibrationCube()
+{
 	if (CalibrationObject::getInstance()->isInitialised() && !CalibrationObject::getInstance()->isCheckerboard())
 	{
 		for (unsigned int i = 0; i < CalibrationObject::getInstance()->getFrameSpecifications().size(); i++)
 		{
-			glPushMatrix();
 			if (i == CalibrationObject::getInstance()->getReferenceIDs()[0])
 			{
 				glColor3f(1.0, 0.0, 0.0);
@@ -456,13 +582,9 @@ void WorldViewDockGLWidget::drawCalibrationCube()
 				glColor3f(1.0, 1.0, 1.0);
 			}
 
-			glTranslated(CalibrationObject::getInstance()->getFrameSpecifications()[i].x,
-			             CalibrationObject::getInstance()->getFrameSpecifications()[i].y,
-			             CalibrationObject::getInstance()->getFrameSpecifications()[i].z);
-
-			gluSphere(sphere_quadric, 0.3f, 32, 32);
-
-			glPopMatrix();
+			drawSphere(CalibrationObject::getInstance()->getFrameSpecifications()[i].x,
+			           CalibrationObject::getInstance()->getFrameSpecifications()[i].y,
+			           CalibrationObject::getInstance()->getFrameSpecifications()[i].z);
 		}
 	}
 }
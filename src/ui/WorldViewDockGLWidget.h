@@ -28,6 +28,7 @@
 #define WorldViewDockGLWidget_H_
 
 #include <QtOpenGLWidgets/QOpenGLWidget>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
@@ -43,6 +44,8 @@
 namespace xma
 {
 	class Trial;
+	class OverlayBuffer;
+	class VertexBuffer;
 
 	class WorldViewDockGLWidget : public QOpenGLWidget
 	{
@@ -82,12 +85,20 @@ namespace xma
 
 		void drawMarkers(Trial* trial, int frame);
 		void drawRigidBodies(Trial* trial, int frame);
+		void drawTrajectories(Trial* trial);
+		void drawSphere(double x, double y, double z);
 
 		void drawCalibrationCube();
 		void drawCameras();
 
-		GLUquadricObj* sphere_quadric;
-		bool opengl_initialised;
+		//one sphere mesh is shared by all markers
+		VertexBuffer* sphere;
+
+		//line overlays which are only rebuilt if the data or the frame changed
+		OverlayBuffer* rigidBodyOverlay;
+		std::vector<int> rigidBodyOverlayKey;
+		OverlayBuffer* trajectoryOverlay;
+		std::vector<int> trajectoryOverlayKey;
 	};
 }
 
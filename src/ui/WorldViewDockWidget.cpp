@@ -34,6 +34,7 @@
 #include "ui/Shortcuts.h"
 #include "core/Project.h"
 #include "core/Trial.h"
+#include "core/Settings.h"
 
 #include <QApplication>
 #include <QCloseEvent>
@@ -54,6 +55,7 @@ WorldViewDockWidget::WorldViewDockWidget(QWidget* parent) : QDockWidget(parent),
 	dock->spinBoxFrame->setMinimum(1);
 	dock->horizontalSlider->setValue(0);
 	dock->spinBoxFrame->setValue(1);
+	dock->checkBoxTrajectories->setChecked(Settings::getInstance()->getBoolSetting("WorldViewDrawTrajectories"));
 
 	connect(State::getInstance(), SIGNAL(workspaceChanged(work_state)), this, SLOT(workspaceChanged(work_state)));
 	connect(State::getInstance(), SIGNAL(activeTrialChanged(int)), this, SLOT(activeTrialChanged(int)));
@@ -252,6 +254,13 @@ void WorldViewDockWidget::on_checkBoxEnable_clicked(bool state)
 	draw();
 }
 
+void WorldViewDockWidget::on_checkBoxTrajectories_clicked(bool state)
+{
+	Settings::getInstance()->set("WorldViewDrawTrajectories", state);
+
+	draw();
+}
+
 void WorldViewDockWidget::on_horizontalSlider_valueChanged(int value)
 {
 	if (!updating)changeFrame(value);
@@ -75,6 +75,7 @@ namespace xma
 		void workspaceChanged(work_state workspace);
 
 		void on_checkBoxEnable_clicked(bool state);
+		void on_checkBoxTrajectories_clicked(bool state);
 		void on_horizontalSlider_valueChanged(int value);
 		void on_horizontalSlider_FocusPlane_valueChanged(int value);
 		void on_spinBoxFrame_valueChanged(int value);
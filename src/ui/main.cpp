@@ -32,6 +32,7 @@
 #include "ui/ErrorDialog.h"
 
 #include "core/Settings.h"
+#include "core/Tracer.h"
 
 #include <QApplication>
 #include <QFileOpenEvent>
@@ -70,6 +71,7 @@ public:
 
 	bool notify(QObject* object, QEvent* event)
 	{
+		XMA_TRACE_SCOPE("QtEvent");
 		try
 		{
 			return QApplication::notify(object, event);